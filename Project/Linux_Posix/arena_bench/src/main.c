@@ -0,0 +1,275 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * checks and costs of the heap arenas(TOS_CFG_MMHEAP_ARENA_EN):
+ *  - budget: a task bound to an arena with a budget is refused once the budget is used up
+ *  - cross-task free: blocks of an arena freed by a task not bound to it go back to the arena
+ *  - irq free: a block of an arena freed in interrupt context is given back by the next call on the arena
+ *  - destroy: refused(K_ERR_MMHEAP_ARENA_BUSY) while a block is in use or a task is bound, a bound task
+ *    destroyed is unbound, an arena cannot be created twice
+ *  - kernel objects: the stacks, pools and objects of the *_create_dyn called by a bound task come
+ *    from the shared heap, not from its arena
+ *  - cost: alloc/free of a shared heap block with no arena and with ARENA_NUM arenas created(the free
+ *    has to tell which heap the block is from), and of an arena block
+ */
+
+#define ARENA_NUM               4u
+#define ARENA_POOL_SIZE         (16u * 1024u)
+#define ARENA_BUDGET            1024u
+#define BLK_SIZE                64u
+#define BENCH_ROUNDS            1000000u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static k_stack_t stk_peer[STK_SIZE];
+static k_task_t task_peer;
+
+static k_mmheap_arena_t arena[ARENA_NUM];
+
+/* one array for all the pools, the arenas take one range of addresses */
+static cpu_addr_t arena_pool[ARENA_NUM][ARENA_POOL_SIZE / sizeof(cpu_addr_t)];
+
+static k_msg_q_t msg_q;
+static void *msg_pool[16];
+
+static uint32_t check_broken = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        ++check_broken;
+    }
+    printf("%-58s %s\n", what, ok ? "ok" : "BROKEN");
+}
+
+static k_mmheap_arena_info_t arena_info(k_mmheap_arena_t *a)
+{
+    k_mmheap_arena_info_t info;
+
+    tos_mmheap_arena_check(a, &info);
+    return info;
+}
+
+static void check_budget(void)
+{
+    k_mmheap_arena_info_t info;
+    void *blk[ARENA_BUDGET / BLK_SIZE + 1u];
+    uint32_t i, cnt = 0u;
+
+    tos_mmheap_arena_create(&arena[0], arena_pool[0], sizeof(arena_pool[0]), ARENA_BUDGET);
+    tos_mmheap_arena_bind(K_NULL, &arena[0]);
+
+    for (i = 0; i < sizeof(blk) / sizeof(blk[0]); ++i) {
+        blk[i] = tos_mmheap_alloc(BLK_SIZE);
+        if (blk[i]) {
+            ++cnt;
+        }
+    }
+
+    info = arena_info(&arena[0]);
+    check(cnt > 0u && cnt < sizeof(blk) / sizeof(blk[0]) && info.used <= ARENA_BUDGET && info.fail_cnt > 0u,
+            "budget: allocations refused once the budget is used up");
+
+    for (i = 0; i < sizeof(blk) / sizeof(blk[0]); ++i) {
+        tos_mmheap_free(blk[i]);
+    }
+
+    info = arena_info(&arena[0]);
+    check(info.used == 0u && info.free_cnt == cnt, "budget: every block back to the arena");
+}
+
+static void entry_peer(void *arg)
+{
+    void *blk;
+
+    // not bound to any arena, frees what the main task sends
+    while (K_TRUE) {
+        if (tos_msg_q_pend(&msg_q, &blk, TOS_TIME_FOREVER) != K_ERR_NONE) {
+            continue;
+        }
+        tos_mmheap_free(blk);
+    }
+}
+
+static void check_cross_free(void)
+{
+    k_mmheap_arena_info_t before, after;
+    k_mmheap_info_t shared_before, shared_after;
+    void *blk;
+    uint32_t i;
+
+    before = arena_info(&arena[0]);
+    tos_mmheap_check(&shared_before);
+
+    for (i = 0; i < 8u; ++i) {
+        blk = tos_mmheap_alloc(BLK_SIZE);
+        tos_msg_q_post(&msg_q, blk);
+    }
+    // the peer has a higher priority, it has freed them all already
+    after = arena_info(&arena[0]);
+    tos_mmheap_check(&shared_after);
+
+    check(after.used == 0u && after.alloc_cnt - before.alloc_cnt == 8u && after.free_cnt - before.free_cnt == 8u &&
+            shared_after.used == shared_before.used,
+            "cross-task free: blocks go back to the arena they are from");
+}
+
+static void check_irq_free(void)
+{
+    k_mmheap_arena_info_t info;
+    void *blk;
+    int queued;
+
+    blk = tos_mmheap_alloc(BLK_SIZE);
+
+    tos_knl_irq_enter();
+    tos_mmheap_free(blk);
+    tos_knl_irq_leave();
+
+    // the block is queued, given back by the next call on the arena
+    queued = arena[0].irq_free == blk && arena[0].used > 0u;
+    info = arena_info(&arena[0]);
+    check(queued && arena[0].irq_free == K_NULL && info.used == 0u,
+            "irq free: given back by the next call on the arena");
+}
+
+static void check_kernel_objects(void)
+{
+    k_mmheap_arena_info_t before, after;
+    k_task_t *task;
+    k_sem_t *sem;
+    k_mmblk_pool_t *mbp;
+    k_msg_q_t q;
+    int created;
+
+    before = arena_info(&arena[0]);
+
+    created = tos_task_create_dyn(&task, "dyn", entry_peer, K_NULL, 5, STK_SIZE, 0) == K_ERR_NONE &&
+                tos_sem_create_dyn(&sem, 0) == K_ERR_NONE &&
+                tos_mmblk_pool_create_dyn(&mbp, 16, BLK_SIZE) == K_ERR_NONE &&
+                tos_msg_q_create_dyn(&q, 16) == K_ERR_NONE;
+
+    // neither served nor refused by the arena
+    after = arena_info(&arena[0]);
+    check(created && after.alloc_cnt == before.alloc_cnt && after.fail_cnt == before.fail_cnt &&
+            after.used == 0u, "kernel objects: *_create_dyn of a bound task off its arena");
+    if (!created) {
+        return;
+    }
+
+    tos_msg_q_destroy_dyn(&q);
+    tos_mmblk_pool_destroy_dyn(mbp);
+    tos_sem_destroy_dyn(sem);
+    tos_task_destroy_dyn(task);
+
+    after = arena_info(&arena[0]);
+    check(after.free_cnt == before.free_cnt, "kernel objects: *_destroy_dyn off its arena");
+}
+
+static void check_destroy(void)
+{
+    void *blk;
+
+    check(tos_mmheap_arena_create(&arena[0], arena_pool[0], sizeof(arena_pool[0]), 0u) ==
+            K_ERR_MMHEAP_ARENA_ALREADY_CREATED, "destroy: an arena alive cannot be created again");
+
+    blk = tos_mmheap_alloc(BLK_SIZE);
+    tos_mmheap_arena_bind(K_NULL, K_NULL);
+    check(tos_mmheap_arena_destroy(&arena[0]) == K_ERR_MMHEAP_ARENA_BUSY,
+            "destroy: refused while a block is in use");
+    tos_mmheap_free(blk);
+
+    tos_mmheap_arena_bind(&task_peer, &arena[0]);
+    check(tos_mmheap_arena_destroy(&arena[0]) == K_ERR_MMHEAP_ARENA_BUSY,
+            "destroy: refused while a task is bound");
+
+    tos_task_destroy(&task_peer);
+    check(arena_info(&arena[0]).task_cnt == 0u && tos_mmheap_arena_destroy(&arena[0]) == K_ERR_NONE,
+            "destroy: a bound task destroyed is unbound");
+}
+
+static double bench_alloc_free(void)
+{
+    uint64_t begin;
+    uint32_t i;
+    void *blk;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        blk = tos_mmheap_alloc(BLK_SIZE);
+        tos_mmheap_free(blk);
+    }
+    return (double)(bench_now_ns() - begin) / BENCH_ROUNDS;
+}
+
+static void bench(void)
+{
+    double shared, shared_arenas, arena_blk;
+    uint32_t i;
+
+    shared = bench_alloc_free();
+
+    for (i = 0; i < ARENA_NUM; ++i) {
+        tos_mmheap_arena_create(&arena[i], arena_pool[i], sizeof(arena_pool[i]), 0u);
+    }
+    shared_arenas = bench_alloc_free();
+
+    tos_mmheap_arena_bind(K_NULL, &arena[ARENA_NUM - 1u]);
+    arena_blk = bench_alloc_free();
+    tos_mmheap_arena_bind(K_NULL, K_NULL);
+
+    for (i = 0; i < ARENA_NUM; ++i) {
+        tos_mmheap_arena_destroy(&arena[i]);
+    }
+
+    printf("\n%-40s %8.1f ns\n", "alloc+free, shared heap, no arena", shared);
+    printf("%-40s %8.1f ns\n", "alloc+free, shared heap, 4 arenas", shared_arenas);
+    printf("%-40s %8.1f ns\n", "alloc+free, arena", arena_blk);
+}
+
+static void entry_main(void *arg)
+{
+    printf("heap arenas, %s\n", TOS_CFG_SLAB_EN > 0u ? "slab caches" : "no slab caches");
+
+    tos_msg_q_create(&msg_q, msg_pool, sizeof(msg_pool) / sizeof(msg_pool[0]));
+    tos_task_create(&task_peer, "peer", entry_peer, K_NULL,
+                        2, stk_peer, sizeof(stk_peer), 0);
+
+    check_budget();
+    check_cross_free();
+    check_irq_free();
+    check_kernel_objects();
+    check_destroy();
+
+    bench();
+
+    printf("\n%s\n", check_broken == 0u ? "ok" : "BROKEN");
+
+    exit(check_broken == 0u ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        3, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * cost of a critical section(TOS_CPU_INT_DISABLE/TOS_CPU_INT_ENABLE) and of the kernel paths built
+ * on it, in the thread mode(mutex + signal mask) and in the single thread mode(interrupt
+ * disable counter, deferred interrupts) of the Linux port.
+ * everything is measured in a task with the systick running.
+ */
+
+#define BENCH_CRIT_ROUNDS       1000000u
+#define BENCH_SEM_ROUNDS        100000u
+#define BENCH_PINGPONG_MS       1000u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_stack_t stk_pong[STK_SIZE];
+
+static k_task_t task_bench;
+static k_task_t task_pong;
+
+static k_sem_t sem, sem_ping, sem_pong;
+
+static volatile int pong_stop = 0;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_crit(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t i;
+    uint64_t begin, ns;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_CRIT_ROUNDS; ++i) {
+        TOS_CPU_INT_DISABLE();
+        TOS_CPU_INT_ENABLE();
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("critical section     %10.1f ns\n", (double)ns / BENCH_CRIT_ROUNDS);
+}
+
+static void bench_sem(void)
+{
+    uint32_t i;
+    uint64_t begin, ns;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_SEM_ROUNDS; ++i) {
+        tos_sem_post(&sem);
+        tos_sem_pend(&sem, TOS_TIME_NOWAIT);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("sem post + pend      %10.1f ns\n", (double)ns / BENCH_SEM_ROUNDS);
+}
+
+static void bench_pingpong(void)
+{
+    uint64_t begin, ns, rounds = 0u;
+
+    begin = bench_now_ns();
+    do {
+        tos_sem_post(&sem_ping);
+        tos_sem_pend(&sem_pong, TOS_TIME_FOREVER);
+        ++rounds;
+        ns = bench_now_ns() - begin;
+    } while (ns < (uint64_t)BENCH_PINGPONG_MS * 1000000u);
+
+    pong_stop = 1;
+    tos_sem_post(&sem_ping);
+
+    printf("context switch       %10.1f ns(%llu ping-pongs)\n", (double)ns / (rounds * 2u),
+                (unsigned long long)rounds);
+}
+
+static void entry_pong(void *arg)
+{
+    while (!pong_stop) {
+        tos_sem_pend(&sem_ping, TOS_TIME_FOREVER);
+        tos_sem_post(&sem_pong);
+    }
+}
+
+static void entry_bench(void *arg)
+{
+    printf("%s mode\n", TOS_CFG_CPU_UCONTEXT_EN > 0u ? "single thread(ucontext)" : "thread");
+
+    bench_crit();
+    bench_sem();
+    bench_pingpong();
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_sem_create(&sem, 0);
+    tos_sem_create(&sem_ping, 0);
+    tos_sem_create(&sem_pong, 0);
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        3, stk_bench, sizeof(stk_bench), 0);
+    tos_task_create(&task_pong, "pong", entry_pong, K_NULL,
+                        3, stk_pong, sizeof(stk_pong), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * checks and costs of the EDF band(TOS_CFG_EDF_EN).
+ * the bench task has the highest priority and never waits, so the EDF tasks never run, they are
+ * delayed/suspended/throttled the way the kernel does it to them, and the systick is turned by hand
+ * (in the virtual time mode no one else turns it), so every check is on exact ticks:
+ *  - priority: tos_task_prio_change can not move an EDF task out of the band, nor a fixed priority
+ *    task into it, nor can tos_task_create create one in it; a mutex boost(task_prio_change) moves an EDF task out and back, keeping its
+ *    deadline and budget
+ *  - order: the EDF band is in absolute deadline order
+ *  - wakeup: an EDF task back from a delay keeps its deadline if the budget left fits in the time
+ *    left(CBS wakeup rule), or starts a new period; a resume is a wakeup too
+ *  - throttle: a throttled task wakes up on its next release with a full budget
+ *  - cost: readyqueue_remove + readyqueue_add of the EDF task with the latest deadline(walks the band)
+ *    with 1/8/32 EDF tasks ready
+ */
+
+#define EDF_TASK_MAX            32u
+#define EDF_PERIOD              10u
+#define EDF_RUNTIME             3u
+#define BENCH_ROUNDS            1000000u
+
+#define STK_SIZE                (20u * 1024u)
+
+static k_stack_t stk_edf[EDF_TASK_MAX][STK_SIZE];
+static k_task_t task_edf[EDF_TASK_MAX];
+
+static k_stack_t stk_fixed[STK_SIZE];
+static k_task_t task_fixed;
+
+static k_stack_t stk_plain[STK_SIZE];
+static k_task_t task_plain;
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static uint32_t check_broken = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        ++check_broken;
+    }
+    printf("%-64s %s\n", what, ok ? "ok" : "BROKEN");
+}
+
+static void entry_dummy(void *arg)
+{
+}
+
+/* what tos_task_delay does to the current task */
+static void task_delay(k_task_t *task, k_tick_t delay)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+    tick_list_add(task, delay);
+    readyqueue_remove(task);
+    TOS_CPU_INT_ENABLE();
+}
+
+static void tick_turn(k_tick_t ticks)
+{
+    while (ticks-- > 0u) {
+        tick_update((k_tick_t)1u);
+    }
+}
+
+static void check_prio(void)
+{
+    k_task_t *edf = &task_edf[0];
+    k_tick_t deadline = edf->edf_abs_deadline, budget = edf->edf_budget;
+
+    check(tos_task_prio_change(edf, 2) == K_ERR_TASK_PRIO_INVALID && edf->prio == TOS_CFG_EDF_PRIO,
+            "priority: an EDF task can not leave the band");
+    check(tos_task_prio_change(edf, TOS_CFG_EDF_PRIO) == K_ERR_NONE,
+            "priority: an EDF task may be set to the band");
+    check(tos_task_prio_change(&task_fixed, TOS_CFG_EDF_PRIO) == K_ERR_TASK_PRIO_INVALID &&
+            task_fixed.prio == TOS_CFG_EDF_PRIO + 2u,
+            "priority: a fixed priority task can not enter the band");
+    check(tos_task_create(&task_plain, "plain", entry_dummy, K_NULL,
+                            TOS_CFG_EDF_PRIO, stk_plain, sizeof(stk_plain), 0) == K_ERR_TASK_PRIO_INVALID,
+            "priority: a fixed priority task can not be created in the band");
+    check(tos_task_prio_change(&task_fixed, TOS_CFG_EDF_PRIO + 1u) == K_ERR_NONE &&
+            task_fixed.prio == TOS_CFG_EDF_PRIO + 1u,
+            "priority: a fixed priority task moves outside the band");
+
+    // what the priority inheritance of a mutex does
+    task_prio_change(edf, 2);
+    task_prio_change(edf, TOS_CFG_EDF_PRIO);
+    check(edf->prio == TOS_CFG_EDF_PRIO && edf->edf_abs_deadline == deadline && edf->edf_budget == budget,
+            "priority: a mutex boost keeps the deadline and the budget");
+}
+
+static void check_order(void)
+{
+    k_task_t *edf = &task_edf[0], *edf_short = &task_edf[1];
+
+    // a shorter relative deadline than task_edf[0], created at the same tick
+    tos_task_create_edf(edf_short, "edf", entry_dummy, K_NULL, stk_edf[1], sizeof(stk_edf[1]),
+                            EDF_PERIOD * 2u, 1u, EDF_PERIOD / 2u);
+
+    check(edf_short->edf_abs_deadline < edf->edf_abs_deadline &&
+            readyqueue_first_task_get(TOS_CFG_EDF_PRIO) == edf_short,
+            "order: the earliest deadline first");
+
+    tos_task_destroy(edf_short);
+    check(readyqueue_first_task_get(TOS_CFG_EDF_PRIO) == edf, "order: the next deadline after");
+}
+
+static void check_wakeup(void)
+{
+    k_task_t *edf = &task_edf[0];
+    k_tick_t deadline;
+
+    // ran 2 ticks of its budget, 1 tick left fits in the 8 ticks left: the deadline is kept
+    edf->edf_budget = 1u;
+    deadline = edf->edf_abs_deadline;
+    task_delay(edf, 2u);
+    tick_turn(2u);
+    check(task_state_is_ready(edf) && edf->edf_abs_deadline == deadline && edf->edf_budget == 1u,
+            "wakeup: back from a delay, the budget left fits, deadline kept");
+
+    // the full budget does not fit in the time left: a new period from now
+    edf->edf_budget = EDF_RUNTIME;
+    task_delay(edf, 2u);
+    tick_turn(2u);
+    check(task_state_is_ready(edf) && edf->edf_abs_deadline == k_tick_count + EDF_PERIOD &&
+            edf->edf_budget == EDF_RUNTIME,
+            "wakeup: back from a delay, the budget does not fit, new period");
+
+    // a resume is a wakeup too
+    tos_task_suspend(edf);
+    tick_turn(EDF_PERIOD - 1u);
+    tos_task_resume(edf);
+    check(task_state_is_ready(edf) && edf->edf_abs_deadline == k_tick_count + EDF_PERIOD &&
+            edf->edf_budget == EDF_RUNTIME,
+            "wakeup: resumed, the budget does not fit, new period");
+}
+
+static void check_throttle(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *edf = &task_edf[0];
+    k_tick_t release;
+    uint32_t ticks = 0u;
+
+    edf->edf_budget = 1u;
+    release = edf->edf_release + EDF_PERIOD;
+
+    TOS_CPU_INT_DISABLE();
+    edf_task_throttle(edf);
+    TOS_CPU_INT_ENABLE();
+
+    while (!task_state_is_ready(edf) && ticks++ < EDF_PERIOD * 2u) {
+        tick_turn(1u);
+    }
+    check(task_state_is_ready(edf) && k_tick_count == release && edf->edf_release == release &&
+            edf->edf_abs_deadline == release + EDF_PERIOD && edf->edf_budget == EDF_RUNTIME,
+            "throttle: woken up on the next release with a full budget");
+}
+
+static void bench(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    static const uint32_t ready[] = { 1u, 8u, EDF_TASK_MAX };
+    k_task_t *edf;
+    uint32_t task_cnt, i, j;
+    uint64_t begin, ns;
+
+    printf("\n%8s %20s\n", "ready", "remove+add(ns)");
+
+    for (j = 0; j < sizeof(ready) / sizeof(ready[0]); ++j) {
+        task_cnt = ready[j];
+        // the last one created has the latest deadline, it is added behind all the others
+        for (i = 1u; i < task_cnt; ++i) {
+            tos_task_create_edf(&task_edf[i], "edf", entry_dummy, K_NULL, stk_edf[i], sizeof(stk_edf[i]),
+                                    EDF_PERIOD * EDF_TASK_MAX, 1u,
+                                    i == task_cnt - 1u ? 0u : EDF_PERIOD * EDF_TASK_MAX / 2u);
+        }
+        edf = &task_edf[task_cnt - 1u];
+
+        begin = bench_now_ns();
+        for (i = 0; i < BENCH_ROUNDS; ++i) {
+            TOS_CPU_INT_DISABLE();
+            readyqueue_remove(edf);
+            readyqueue_add(edf);
+            TOS_CPU_INT_ENABLE();
+        }
+        ns = bench_now_ns() - begin;
+
+        printf("%8u %20.1f\n", task_cnt, (double)ns / BENCH_ROUNDS);
+
+        for (i = 1u; i < task_cnt; ++i) {
+            tos_task_destroy(&task_edf[i]);
+        }
+    }
+}
+
+static void entry_main(void *arg)
+{
+    printf("EDF band at priority %u\n", (unsigned)TOS_CFG_EDF_PRIO);
+
+    tos_task_create_edf(&task_edf[0], "edf", entry_dummy, K_NULL, stk_edf[0], sizeof(stk_edf[0]),
+                            EDF_PERIOD, EDF_RUNTIME, 0u);
+    tos_task_create(&task_fixed, "fixed", entry_dummy, K_NULL,
+                        TOS_CFG_EDF_PRIO + 2u, stk_fixed, sizeof(stk_fixed), 0);
+
+    check_prio();
+    check_order();
+    check_wakeup();
+    check_throttle();
+
+    bench();
+
+    printf("\n%s\n", check_broken == 0u ? "ok" : "BROKEN");
+
+    exit(check_broken == 0u ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        1, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef _TOS_CONFIG_H_
+#define _TOS_CONFIG_H_
+
+#include "stddef.h"
+#include "stdint.h"
+
+#define TOS_CFG_TASK_PRIO_MAX           10u
+
+#define TOS_CFG_ROUND_ROBIN_EN          0u
+
+#define TOS_CFG_OBJECT_VERIFY_EN        1u
+
+#define TOS_CFG_SEM_EN                  1u
+
+#define TOS_CFG_MMHEAP_EN               1u
+
+#define TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE    0x1000
+
+#define TOS_CFG_TIMER_EN                0u
+
+// TOS_CFG_EVENT_DRIVEN_EN is given by CMakeLists.txt, one executable with it and one without
+
+#define TOS_CFG_EVTDRV_STK_SIZE         (64u * 1024u)
+
+#define TOS_CFG_IDLE_TASK_STK_SIZE      256u
+
+#define TOS_CFG_CPU_TICK_PER_SECOND     1000u
+
+#define TOS_CFG_CPU_CLOCK               1000000u
+
+#endif
@@ -0,0 +1,134 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * a token passed around a ring of BENCH_RING_SIZE tasks for 1 second:
+ *  - evtdrv_bench_task: every task has a stack of its own, and passes the token to the next one
+ *    by a semaphore, every hop is a context switch
+ *  - evtdrv_bench_evtdrv: every task is an event-driven task(tos_task_create_evtdrv), and passes
+ *    the token by posting an event to the next one, every hop is a handler called on the shared stack
+ */
+
+#define BENCH_RING_SIZE         100u
+#define BENCH_RUN_MS            1000u
+
+#define STK_SIZE                (64u * 1024u)
+#define RING_STK_SIZE           (32u * 1024u)
+
+static k_stack_t stk_ctrl[STK_SIZE];
+static k_task_t task_ctrl;
+
+static k_task_t task_ring[BENCH_RING_SIZE];
+
+static volatile int bench_stop = 0;
+static volatile uint64_t hops = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+
+#define RING_STK_TOTAL          ((size_t)TOS_CFG_EVTDRV_STK_SIZE)
+
+static void handler_ring(void *arg, k_event_flag_t event, k_evtdrv_msg_t *msg)
+{
+    uint32_t i = (uint32_t)(cpu_addr_t)arg;
+
+    ++hops;
+    if (!bench_stop) {
+        tos_evtdrv_event_post(&task_ring[(i + 1u) % BENCH_RING_SIZE], 1u);
+    }
+}
+
+static void ring_create(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_RING_SIZE; ++i) {
+        tos_task_create_evtdrv(&task_ring[i], "ring", handler_ring, (void *)(cpu_addr_t)i, 4);
+    }
+}
+
+static void ring_kick(void)
+{
+    tos_evtdrv_event_post(&task_ring[0], 1u);
+}
+
+#else
+
+#define RING_STK_TOTAL          ((size_t)BENCH_RING_SIZE * RING_STK_SIZE)
+
+static k_stack_t stk_ring[BENCH_RING_SIZE][RING_STK_SIZE];
+static k_sem_t sem_ring[BENCH_RING_SIZE];
+
+static void entry_ring(void *arg)
+{
+    uint32_t i = (uint32_t)(cpu_addr_t)arg;
+
+    while (K_TRUE) {
+        tos_sem_pend(&sem_ring[i], TOS_TIME_FOREVER);
+
+        ++hops;
+        if (!bench_stop) {
+            tos_sem_post(&sem_ring[(i + 1u) % BENCH_RING_SIZE]);
+        }
+    }
+}
+
+static void ring_create(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_RING_SIZE; ++i) {
+        tos_sem_create(&sem_ring[i], 0);
+        tos_task_create(&task_ring[i], "ring", entry_ring, (void *)(cpu_addr_t)i,
+                            4, stk_ring[i], sizeof(stk_ring[i]), 0);
+    }
+}
+
+static void ring_kick(void)
+{
+    tos_sem_post(&sem_ring[0]);
+}
+
+#endif
+
+static void entry_ctrl(void *arg)
+{
+    uint64_t begin, ns;
+
+    printf("%s tasks, ring of %u\n", TOS_CFG_EVENT_DRIVEN_EN > 0u ? "event-driven" : "stack-per-task",
+                (unsigned)BENCH_RING_SIZE);
+    printf("ring stack           %10u KB\n", (unsigned)(RING_STK_TOTAL / 1024u));
+
+    begin = bench_now_ns();
+    ring_kick();
+    tos_task_delay(tos_millisec2tick(BENCH_RUN_MS));
+    bench_stop = 1;
+    ns = bench_now_ns() - begin;
+
+    printf("hop                  %10.1f ns(%llu hops)\n", (double)ns / hops, (unsigned long long)hops);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    ring_create();
+
+    tos_task_create(&task_ctrl, "ctrl", entry_ctrl, K_NULL,
+                        2, stk_ctrl, sizeof(stk_ctrl), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef _TOS_CONFIG_H_
+#define _TOS_CONFIG_H_
+
+#include "stddef.h"
+#include "stdint.h"
+
+#define TOS_CFG_TASK_PRIO_MAX           10u
+
+#define TOS_CFG_ROUND_ROBIN_EN          0u
+
+#define TOS_CFG_OBJECT_VERIFY_EN        1u
+
+#define TOS_CFG_SEM_EN                  1u
+
+#define TOS_CFG_MUTEX_EN                1u
+
+#define TOS_CFG_EVENT_EN                1u
+
+#define TOS_CFG_MESSAGE_QUEUE_EN        1u
+
+#define TOS_CFG_MAIL_QUEUE_EN           1u
+
+#define TOS_CFG_PRIORITY_MESSAGE_QUEUE_EN   1u
+
+#define TOS_CFG_PRIORITY_MAIL_QUEUE_EN  1u
+
+#define TOS_CFG_COMPLETION_EN           1u
+
+#define TOS_CFG_COUNTDOWNLATCH_EN       1u
+
+#define TOS_CFG_MMHEAP_EN               1u
+
+#define TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE    0x1000
+
+#define TOS_CFG_TIMER_EN                0u
+
+// the nanosecond delays and pends(tos_task_delay_ns, tos_xxx_pend_ns)
+#define TOS_CFG_HRTIMER_EN              1u
+
+// TOS_CFG_CPU_UCONTEXT_EN is given by CMakeLists.txt, one executable for each mode
+
+#define TOS_CFG_IDLE_TASK_STK_SIZE      256u
+
+#define TOS_CFG_CPU_TICK_PER_SECOND     1000u
+
+#define TOS_CFG_CPU_CLOCK               1000000u
+
+#endif
@@ -0,0 +1,265 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+/*
+ * how close to its deadline a task waking up on a timeout gets, with a 1ms systick:
+ *  - delay: tos_task_delay_ns against tos_task_delay with the deadline rounded up to ticks, for 100us,
+ *    250us and 500us deadlines. the tick one wakes up on the next tick, wherever it is(early or late),
+ *    the hrtimer one must never wake up early.
+ *  - pend timeout: every tos_xxx_pend_ns on an object nobody posts, with a 250us timeout, must come back
+ *    with K_ERR_PEND_TIMEOUT, never early.
+ *  - post: a tos_sem_pend_ns(10ms) posted after 100us must come back with K_ERR_NONE, and its hrtimer
+ *    must be gone: the pend(20ms) right after times out on its own deadline, not on the stale one.
+ */
+
+#define BENCH_ROUNDS            200u
+#define BENCH_PEND_NS           (250u * K_HRTIME_NSEC_PER_USEC)
+#define BENCH_POST_ROUNDS       50u
+#define BENCH_POST_PEND_NS      (10u * K_HRTIME_NSEC_PER_MSEC)
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_task_t task_bench;
+
+static k_stack_t stk_holder[STK_SIZE];
+static k_task_t task_holder;
+
+static k_stack_t stk_poster[STK_SIZE];
+static k_task_t task_poster;
+
+static k_sem_t sem;
+static k_sem_t sem_poster;
+static k_mutex_t mutex;
+static k_event_t event;
+static k_msg_q_t msg_q;
+static k_mail_q_t mail_q;
+static k_prio_msg_q_t prio_msg_q;
+static k_prio_mail_q_t prio_mail_q;
+static k_completion_t completion;
+static k_countdownlatch_t countdownlatch;
+
+static void *pool_msg[4];
+static uint32_t pool_mail[4];
+static void *pool_prio_msg[4];
+static uint32_t pool_prio_mail[4];
+
+static uint32_t bench_broken = 0u;
+
+typedef struct bench_stat_st {
+    int64_t     err_sum;
+    int64_t     err_max;
+    uint32_t    early;
+    uint32_t    cnt;
+} bench_stat_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void stat_add(bench_stat_t *stat, uint64_t wait, uint64_t deadline)
+{
+    int64_t err = (int64_t)wait - (int64_t)deadline;
+
+    if (err < 0) {
+        ++stat->early;
+    }
+    if (stat->cnt == 0u || err > stat->err_max) {
+        stat->err_max = err;
+    }
+    stat->err_sum += err;
+    ++stat->cnt;
+}
+
+static double stat_mean_us(bench_stat_t *stat)
+{
+    return (double)stat->err_sum / stat->cnt / 1000.0;
+}
+
+static void entry_holder(void *arg)
+{
+    tos_mutex_pend(&mutex);
+
+    // keep the mutex forever, so the bench task always has to wait for it
+    while (K_TRUE) {
+        tos_task_delay(TOS_TIME_FOREVER - 1u);
+    }
+}
+
+static void entry_poster(void *arg)
+{
+    while (K_TRUE) {
+        tos_sem_pend(&sem_poster, TOS_TIME_FOREVER);
+        tos_task_delay_ns(100u * K_HRTIME_NSEC_PER_USEC);
+        tos_sem_post(&sem);
+    }
+}
+
+static void bench_delay(uint32_t deadline_us)
+{
+    bench_stat_t tick = { 0 }, hr = { 0 };
+    k_hrtime_t deadline = (k_hrtime_t)deadline_us * K_HRTIME_NSEC_PER_USEC;
+    k_tick_t ticks = tos_millisec2tick((deadline_us + 999u) / 1000u);
+    uint64_t begin;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        begin = bench_now_ns();
+        tos_task_delay(ticks);
+        stat_add(&tick, bench_now_ns() - begin, deadline);
+
+        begin = bench_now_ns();
+        tos_task_delay_ns(deadline);
+        stat_add(&hr, bench_now_ns() - begin, deadline);
+    }
+
+    if (hr.early > 0u) {
+        ++bench_broken;
+    }
+
+    printf("%-12u %10.1f %10.1f %6u %10.1f %10.1f %6u\n", deadline_us,
+            stat_mean_us(&tick), (double)tick.err_max / 1000.0, tick.early,
+            stat_mean_us(&hr), (double)hr.err_max / 1000.0, hr.early);
+}
+
+static k_err_t pend_ns(uint32_t which)
+{
+    k_event_flag_t flag_match;
+    void *msg;
+    uint32_t mail;
+    size_t mail_size;
+
+    switch (which) {
+        case 0: return tos_sem_pend_ns(&sem, BENCH_PEND_NS);
+        case 1: return tos_mutex_pend_ns(&mutex, BENCH_PEND_NS);
+        case 2: return tos_event_pend_ns(&event, 0x1u, &flag_match, BENCH_PEND_NS, TOS_OPT_EVENT_PEND_ANY);
+        case 3: return tos_msg_q_pend_ns(&msg_q, &msg, BENCH_PEND_NS);
+        case 4: return tos_mail_q_pend_ns(&mail_q, &mail, &mail_size, BENCH_PEND_NS);
+        case 5: return tos_prio_msg_q_pend_ns(&prio_msg_q, &msg, BENCH_PEND_NS);
+        case 6: return tos_prio_mail_q_pend_ns(&prio_mail_q, &mail, &mail_size, BENCH_PEND_NS);
+        case 7: return tos_completion_pend_ns(&completion, BENCH_PEND_NS);
+        default: return tos_countdownlatch_pend_ns(&countdownlatch, BENCH_PEND_NS);
+    }
+}
+
+static void bench_pend_timeout(void)
+{
+    static const char *name[] = {
+        "sem", "mutex", "event", "msg_q", "mail_q", "prio_msg_q", "prio_mail_q", "completion", "countdownlatch",
+    };
+    bench_stat_t stat;
+    uint64_t begin;
+    uint32_t i, which, wrong;
+
+    printf("\npend timeout %uus\n", (unsigned)(BENCH_PEND_NS / K_HRTIME_NSEC_PER_USEC));
+    printf("%-16s %10s %10s %6s %6s\n", "object", "mean(us)", "max(us)", "early", "wrong");
+
+    for (which = 0; which < sizeof(name) / sizeof(name[0]); ++which) {
+        memset(&stat, 0, sizeof(stat));
+        wrong = 0u;
+
+        for (i = 0; i < BENCH_ROUNDS; ++i) {
+            begin = bench_now_ns();
+            if (pend_ns(which) != K_ERR_PEND_TIMEOUT) {
+                ++wrong;
+            }
+            stat_add(&stat, bench_now_ns() - begin, BENCH_PEND_NS);
+        }
+
+        if (stat.early > 0u || wrong > 0u) {
+            ++bench_broken;
+        }
+
+        printf("%-16s %10.1f %10.1f %6u %6u\n", name[which],
+                stat_mean_us(&stat), (double)stat.err_max / 1000.0, stat.early, wrong);
+    }
+}
+
+static void bench_pend_post(void)
+{
+    bench_stat_t stat = { 0 };
+    uint32_t i, wrong = 0u;
+    uint64_t begin;
+
+    for (i = 0; i < BENCH_POST_ROUNDS; ++i) {
+        tos_sem_post(&sem_poster);
+
+        if (tos_sem_pend_ns(&sem, BENCH_POST_PEND_NS) != K_ERR_NONE) {
+            ++wrong;
+        }
+
+        // the hrtimer of the pend posted is gone, this one times out on its own deadline, not on the stale one
+        begin = bench_now_ns();
+        if (tos_sem_pend_ns(&sem, BENCH_POST_PEND_NS * 2u) != K_ERR_PEND_TIMEOUT) {
+            ++wrong;
+        }
+        stat_add(&stat, bench_now_ns() - begin, BENCH_POST_PEND_NS * 2u);
+    }
+
+    if (tos_sem_pend_ns(&sem, 0u) != K_ERR_PEND_NOWAIT) {
+        ++wrong;
+    }
+
+    if (stat.early > 0u || wrong > 0u) {
+        ++bench_broken;
+    }
+
+    printf("\npend posted after 100us, then pend timeout %ums: %.1f us mean, %.1f us max, %u early, %u wrong\n",
+            (unsigned)(BENCH_POST_PEND_NS * 2u / K_HRTIME_NSEC_PER_MSEC),
+            stat_mean_us(&stat), (double)stat.err_max / 1000.0, stat.early, wrong);
+}
+
+static void entry_bench(void *arg)
+{
+    printf("hrtimer bench, %s mode, %u ticks per second\n",
+            TOS_CFG_CPU_UCONTEXT_EN > 0u ? "ucontext" : "thread", (unsigned)TOS_CFG_CPU_TICK_PER_SECOND);
+
+    tos_sem_create(&sem, 0);
+    tos_sem_create(&sem_poster, 0);
+    tos_mutex_create(&mutex);
+    tos_event_create(&event, (k_event_flag_t)0u);
+    tos_msg_q_create(&msg_q, pool_msg, 4);
+    tos_mail_q_create(&mail_q, pool_mail, 4, sizeof(uint32_t));
+    tos_prio_msg_q_create(&prio_msg_q, pool_prio_msg, 4);
+    tos_prio_mail_q_create(&prio_mail_q, pool_prio_mail, 4, sizeof(uint32_t));
+    tos_completion_create(&completion);
+    tos_countdownlatch_create(&countdownlatch, 1);
+
+    tos_task_create(&task_holder, "holder", entry_holder, K_NULL,
+                        2, stk_holder, sizeof(stk_holder), 0);
+    tos_task_create(&task_poster, "poster", entry_poster, K_NULL,
+                        2, stk_poster, sizeof(stk_poster), 0);
+
+    printf("\n%-12s %32s %32s\n", "", "tos_task_delay(ticks)", "tos_task_delay_ns");
+    printf("%-12s %10s %10s %6s %10s %10s %6s\n", "deadline(us)",
+            "mean(us)", "max(us)", "early", "mean(us)", "max(us)", "early");
+    bench_delay(100u);
+    bench_delay(250u);
+    bench_delay(500u);
+
+    bench_pend_timeout();
+    bench_pend_post();
+
+    printf("\n%s\n", bench_broken == 0u ? "ok" : "BROKEN");
+
+    exit(bench_broken == 0u ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        3, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
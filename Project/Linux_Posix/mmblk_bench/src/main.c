@@ -0,0 +1,236 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+/*
+ * the memory block pool with the free list behind a critical section against the lock-free one
+ * (TOS_CFG_MMBLK_LOCKFREE_EN), for 64 byte blocks(network buffers):
+ *  - single: one block allocated and freed again, over and over
+ *  - burst: BENCH_BURST blocks allocated then freed, one by one(tos_mmblk_alloc/free) against in
+ *    a batch(tos_mmblk_alloc_n/free_n)
+ *  - lock-free stress: BENCH_STRESS_THREADS host threads the kernel knows nothing about(standing for
+ *    ISRs and other cores) and the task allocate and free bursts of odd sizes from one small pool, every
+ *    block is stamped with its owner and checked before it goes back, the pool must be whole at the end
+ */
+
+#define BENCH_BLK_NUM           64u
+#define BENCH_BLK_SIZE          64u
+#define BENCH_BURST             32u
+#define BENCH_ROUNDS            100000u
+#define BENCH_STRESS_ROUNDS     1000000u
+#define BENCH_STRESS_THREADS    2u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_task_t task_bench;
+
+static cpu_addr_t pool[BENCH_BLK_NUM * BENCH_BLK_SIZE / sizeof(cpu_addr_t)];
+
+static k_mmblk_pool_t mmblk_pool;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_single(void)
+{
+    uint32_t i;
+    uint64_t begin, ns;
+    void *blk;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS * BENCH_BURST; ++i) {
+        tos_mmblk_alloc(&mmblk_pool, &blk);
+        tos_mmblk_free(&mmblk_pool, blk);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", "single", (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+}
+
+static void bench_burst(void)
+{
+    uint32_t i, j;
+    uint64_t begin, ns;
+    void *blk[BENCH_BURST];
+    size_t cnt;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_mmblk_alloc(&mmblk_pool, &blk[j]);
+        }
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_mmblk_free(&mmblk_pool, blk[j]);
+        }
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", "burst one by one", (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        tos_mmblk_alloc_n(&mmblk_pool, blk, BENCH_BURST, &cnt);
+        tos_mmblk_free_n(&mmblk_pool, blk, cnt);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", "burst batch", (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+}
+
+/* every block in the pool comes back once, and nothing else */
+static int pool_is_whole(void)
+{
+    void *blk[BENCH_BLK_NUM + 1u];
+    size_t cnt, i, j;
+
+    if (mmblk_pool.blk_free != BENCH_BLK_NUM) {
+        return K_FALSE;
+    }
+
+    tos_mmblk_alloc_n(&mmblk_pool, blk, BENCH_BLK_NUM + 1u, &cnt);
+    tos_mmblk_free_n(&mmblk_pool, blk, cnt);
+    if (cnt != BENCH_BLK_NUM) {
+        return K_FALSE;
+    }
+
+    for (i = 0; i < cnt; ++i) {
+        if ((uint8_t *)blk[i] < (uint8_t *)pool ||
+            (uint8_t *)blk[i] >= (uint8_t *)pool + sizeof(pool) ||
+            ((uint8_t *)blk[i] - (uint8_t *)pool) % BENCH_BLK_SIZE != 0u) {
+            return K_FALSE;
+        }
+        for (j = i + 1u; j < cnt; ++j) {
+            if (blk[i] == blk[j]) {
+                return K_FALSE;
+            }
+        }
+    }
+
+    return K_TRUE;
+}
+
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+
+static volatile uint32_t stress_broken = 0u;
+
+/* one round: take a burst of odd size, stamp it, check the stamps survived, give it back */
+static void stress_round(uint32_t owner, uint32_t round)
+{
+    void *blk[8];
+    size_t cnt, i;
+    uint32_t *stamp;
+
+    if (round % 4u == 0u) {
+        if (tos_mmblk_alloc(&mmblk_pool, &blk[0]) != K_ERR_NONE) {
+            return;
+        }
+        cnt = 1u;
+    } else if (tos_mmblk_alloc_n(&mmblk_pool, blk, round % 7u + 1u, &cnt) != K_ERR_NONE) {
+        return;
+    }
+
+    for (i = 0; i < cnt; ++i) {
+        stamp = (uint32_t *)blk[i];
+        stamp[0] = owner;
+        stamp[BENCH_BLK_SIZE / sizeof(uint32_t) - 1u] = round;
+    }
+
+    if (round % 64u == 0u) {
+        sched_yield();
+    }
+
+    for (i = 0; i < cnt; ++i) {
+        stamp = (uint32_t *)blk[i];
+        if (stamp[0] != owner || stamp[BENCH_BLK_SIZE / sizeof(uint32_t) - 1u] != round) {
+            __atomic_fetch_add(&stress_broken, 1u, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (round % 4u == 0u) {
+        tos_mmblk_free(&mmblk_pool, blk[0]);
+    } else {
+        tos_mmblk_free_n(&mmblk_pool, blk, cnt);
+    }
+}
+
+static void *stress_thread(void *arg)
+{
+    uint32_t i, owner = (uint32_t)(cpu_addr_t)arg;
+
+    for (i = 0; i < BENCH_STRESS_ROUNDS; ++i) {
+        stress_round(owner, i);
+    }
+
+    return NULL;
+}
+
+static void bench_stress(void)
+{
+    pthread_t thread[BENCH_STRESS_THREADS];
+    uint32_t i;
+    uint64_t begin, ns;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_STRESS_THREADS; ++i) {
+        pthread_create(&thread[i], NULL, stress_thread, (void *)(cpu_addr_t)(i + 1u));
+    }
+
+    for (i = 0; i < BENCH_STRESS_ROUNDS; ++i) {
+        stress_round(0u, i);
+    }
+
+    for (i = 0; i < BENCH_STRESS_THREADS; ++i) {
+        pthread_join(thread[i], NULL);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns(%u rounds x %u, %s)\n", "lock-free stress",
+                (double)ns / ((uint64_t)BENCH_STRESS_ROUNDS * (BENCH_STRESS_THREADS + 1u)),
+                (unsigned)BENCH_STRESS_ROUNDS, (unsigned)(BENCH_STRESS_THREADS + 1u),
+                stress_broken == 0u && pool_is_whole() ? "ok" : "BROKEN");
+}
+
+#endif
+
+static void entry_bench(void *arg)
+{
+    printf("%s pool, %s mode\n", TOS_CFG_MMBLK_LOCKFREE_EN > 0u ? "lock-free" : "locked",
+                TOS_CFG_CPU_UCONTEXT_EN > 0u ? "ucontext" : "thread");
+
+    tos_mmblk_pool_create(&mmblk_pool, pool, BENCH_BLK_NUM, BENCH_BLK_SIZE);
+
+    bench_single();
+    bench_burst();
+
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    bench_stress();
+#endif
+
+    printf("pool %s\n", pool_is_whole() ? "intact" : "BROKEN");
+
+    tos_mmblk_pool_destroy(&mmblk_pool);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        2, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * latency of every single tos_mmheap_alloc/tos_mmheap_free, put into a histogram, with and without
+ * the size class cache(TOS_CFG_MMHEAP_CACHE_EN) and the allocation profiler(TOS_CFG_MMHEAP_PROFILE_EN):
+ *  - fixed: one 64 byte buffer allocated and freed again, over and over
+ *  - mixed: BENCH_SLOT_NUM live blocks of the small sizes a kernel object or a buffer takes, a random
+ *    slot is freed and allocated again with a random size, so the heap is fragmented
+ * the heap must come back in one piece at the end, every block is filled and checked too.
+ */
+
+#define BENCH_ROUNDS            1000000u
+#define BENCH_SLOT_NUM          512u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_task_t task_bench;
+
+static const size_t bench_sizes[] = {
+    sizeof(k_sem_t), sizeof(k_task_t), 16u, 24u, 64u, 100u, 128u, 200u, 256u,
+};
+
+#define BENCH_SIZE_NUM          (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+static uint8_t *slot_ptr[BENCH_SLOT_NUM];
+static size_t slot_size[BENCH_SLOT_NUM];
+
+/* upper bounds of the buckets in ns, the last bucket takes the rest */
+static const uint32_t bucket_ns[] = { 25u, 50u, 100u, 200u, 500u, 1000u, 5000u };
+
+#define BUCKET_NUM              (sizeof(bucket_ns) / sizeof(bucket_ns[0]) + 1u)
+
+typedef struct latency_st {
+    uint64_t    bucket[BUCKET_NUM];
+    uint64_t    total_ns;
+    uint64_t    cnt;
+    uint32_t    max_ns;
+} latency_t;
+
+static uint32_t clock_cost_ns = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t bench_rand(void)
+{
+    static uint32_t seed = 0x12345678u;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+/* the cost of reading the clock twice, taken off every sample */
+static void clock_calibrate(void)
+{
+    uint64_t begin, ns, min = ~0ull;
+    uint32_t i;
+
+    for (i = 0; i < 100000u; ++i) {
+        begin = bench_now_ns();
+        ns = bench_now_ns() - begin;
+        if (ns < min) {
+            min = ns;
+        }
+    }
+    clock_cost_ns = (uint32_t)min;
+}
+
+static void latency_add(latency_t *lat, uint64_t ns)
+{
+    uint32_t i;
+
+    ns = ns > clock_cost_ns ? ns - clock_cost_ns : 0u;
+
+    for (i = 0; i < BUCKET_NUM - 1u && ns >= bucket_ns[i]; ++i) {
+        ;
+    }
+    ++lat->bucket[i];
+
+    lat->total_ns += ns;
+    ++lat->cnt;
+    if (ns > lat->max_ns) {
+        lat->max_ns = (uint32_t)ns;
+    }
+}
+
+static void latency_print(const char *name, latency_t *lat)
+{
+    uint32_t i;
+
+    printf("  %-6s mean %6.1f ns, max %6u ns |", name, (double)lat->total_ns / lat->cnt, (unsigned)lat->max_ns);
+    for (i = 0; i < BUCKET_NUM; ++i) {
+        printf(" %6.2f%%", lat->bucket[i] * 100.0 / lat->cnt);
+    }
+    printf("\n");
+}
+
+static void histogram_header(void)
+{
+    uint32_t i;
+
+    printf("  %-36s |", "");
+    for (i = 0; i < BUCKET_NUM - 1u; ++i) {
+        printf(" <%4uns", (unsigned)bucket_ns[i]);
+    }
+    printf(">=%4uns\n", (unsigned)bucket_ns[BUCKET_NUM - 2u]);
+}
+
+static uint8_t *timed_alloc(latency_t *lat, size_t size)
+{
+    uint64_t begin;
+    uint8_t *ptr;
+
+    begin = bench_now_ns();
+    ptr = tos_mmheap_alloc(size);
+    latency_add(lat, bench_now_ns() - begin);
+
+    if (!ptr) {
+        printf("out of memory\n");
+        exit(1);
+    }
+    memset(ptr, (int)size, size);
+
+    return ptr;
+}
+
+static void timed_free(latency_t *lat, uint8_t *ptr, size_t size)
+{
+    uint64_t begin;
+
+    if (ptr[0] != (uint8_t)size || ptr[size - 1u] != (uint8_t)size) {
+        printf("block corrupted\n");
+        exit(1);
+    }
+
+    begin = bench_now_ns();
+    tos_mmheap_free(ptr);
+    latency_add(lat, bench_now_ns() - begin);
+}
+
+static void bench_fixed(void)
+{
+    static latency_t lat_alloc, lat_free;
+    uint8_t *ptr;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        ptr = timed_alloc(&lat_alloc, 64u);
+        timed_free(&lat_free, ptr, 64u);
+    }
+
+    printf("fixed, 64 bytes\n");
+    latency_print("alloc", &lat_alloc);
+    latency_print("free", &lat_free);
+}
+
+static void bench_mixed(void)
+{
+    static latency_t lat_alloc, lat_free;
+    uint32_t i, slot;
+
+    for (i = 0; i < BENCH_SLOT_NUM; ++i) {
+        slot_size[i] = bench_sizes[bench_rand() % BENCH_SIZE_NUM];
+        slot_ptr[i] = tos_mmheap_alloc(slot_size[i]);
+        memset(slot_ptr[i], (int)slot_size[i], slot_size[i]);
+    }
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        slot = bench_rand() % BENCH_SLOT_NUM;
+        timed_free(&lat_free, slot_ptr[slot], slot_size[slot]);
+
+        slot_size[slot] = bench_sizes[bench_rand() % BENCH_SIZE_NUM];
+        slot_ptr[slot] = timed_alloc(&lat_alloc, slot_size[slot]);
+    }
+
+    for (i = 0; i < BENCH_SLOT_NUM; ++i) {
+        tos_mmheap_free(slot_ptr[i]);
+    }
+
+    printf("mixed, %u live blocks of %u to %u bytes\n", (unsigned)BENCH_SLOT_NUM,
+                (unsigned)bench_sizes[2], (unsigned)bench_sizes[BENCH_SIZE_NUM - 1u]);
+    latency_print("alloc", &lat_alloc);
+    latency_print("free", &lat_free);
+}
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+static void site_print(void)
+{
+    k_mmheap_site_t site[TOS_CFG_MMHEAP_PROFILE_SITE_NUM + 1];
+    k_mmheap_frag_t frag;
+    size_t i, cnt;
+
+    cnt = tos_mmheap_site_read(site, sizeof(site) / sizeof(site[0]));
+    for (i = 0; i < cnt; ++i) {
+        printf("  site %p: %u bytes in %u blocks, peak %u bytes\n", site[i].site,
+                    (unsigned)site[i].bytes, (unsigned)site[i].count, (unsigned)site[i].bytes_peak);
+    }
+
+    tos_mmheap_frag_check(&frag);
+    printf("  free %u bytes, largest %u bytes, fragmentation %u/1000\n",
+                (unsigned)frag.free_total, (unsigned)frag.free_largest, (unsigned)frag.frag_index);
+}
+
+#endif
+
+static void entry_bench(void *arg)
+{
+    k_mmheap_info_t info_begin, info;
+    k_mmheap_frag_t frag;
+
+    printf("mmheap, size class cache %s, profiler %s\n", TOS_CFG_MMHEAP_CACHE_EN > 0u ? "on" : "off",
+                TOS_CFG_MMHEAP_PROFILE_EN > 0u ? "on" : "off");
+
+    clock_calibrate();
+    printf("clock cost %u ns, taken off every sample\n", (unsigned)clock_cost_ns);
+    histogram_header();
+
+    tos_mmheap_check(&info_begin);
+
+    bench_fixed();
+    bench_mixed();
+
+    // the blocks left in the cache are free in both
+    tos_mmheap_check(&info);
+    tos_mmheap_frag_check(&frag);
+    printf("frag check %s(free %u bytes, heap check %u)\n", frag.free_total == info.free ? "agrees" : "DISAGREES",
+                (unsigned)frag.free_total, (unsigned)info.free);
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    // let the idle task give the cache back above TOS_CFG_MMHEAP_CACHE_KEEP_CNT, then the rest
+    tos_task_delay(tos_millisec2tick(10u));
+    tos_mmheap_cache_drain();
+#endif
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    site_print();
+#endif
+
+    tos_mmheap_check(&info);
+    printf("heap %s(free %u of %u bytes, used %u)\n",
+                info.free == info_begin.free && info.used == info_begin.used ? "intact" : "LEAKED",
+                (unsigned)info.free, (unsigned)info_begin.free, (unsigned)info.used);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        2, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
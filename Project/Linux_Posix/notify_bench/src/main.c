@@ -0,0 +1,171 @@
+#include "tos_k.h"
+#include "cmsis_os2.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * signalling a task three ways:
+ *  - event: through an event object, tos_event_post / tos_event_pend
+ *  - notify: straight to the task, tos_task_notify / tos_task_notify_wait
+ *  - thread flags: CMSIS-RTOS2 osThreadFlagsSet / osThreadFlagsWait, on top of the task notify
+ *
+ * measured:
+ *  - post + wait: a task signals itself and takes the signal back, BENCH_LOOP_ROUNDS times,
+ *    the cost of the calls alone, with no context switch
+ *  - ping-pong: two tasks ping-pong for 1 second, one wakeup each way per round
+ */
+
+#define BENCH_RUN_MS            1000u
+#define BENCH_LOOP_ROUNDS       1000000u
+
+#define BIT_PING                (1u << 0)
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_ctrl[STK_SIZE];
+static k_stack_t stk_ping[STK_SIZE];
+static k_stack_t stk_pong[STK_SIZE];
+
+static k_task_t task_ctrl;
+static k_task_t task_ping;
+static k_task_t task_pong;
+
+static k_event_t event_ping, event_pong;
+
+static volatile int bench_stop = 0;
+static volatile uint64_t rounds = 0u;
+
+typedef enum bench_mode_en {
+    BENCH_MODE_EVENT,
+    BENCH_MODE_NOTIFY,
+    BENCH_MODE_THREAD_FLAGS,
+} bench_mode_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_wakeup(bench_mode_t mode, k_event_t *event, k_task_t *task)
+{
+    if (mode == BENCH_MODE_EVENT) {
+        tos_event_post_keep(event, BIT_PING);
+    } else if (mode == BENCH_MODE_NOTIFY) {
+        tos_task_notify(task, BIT_PING);
+    } else {
+        osThreadFlagsSet((osThreadId_t)task, BIT_PING);
+    }
+}
+
+static void bench_wait(bench_mode_t mode, k_event_t *event)
+{
+    k_event_flag_t flag;
+    uint32_t notify;
+
+    if (mode == BENCH_MODE_EVENT) {
+        tos_event_pend(event, BIT_PING, &flag, TOS_TIME_FOREVER,
+                        TOS_OPT_EVENT_PEND_ANY | TOS_OPT_EVENT_PEND_CLR);
+    } else if (mode == BENCH_MODE_NOTIFY) {
+        tos_task_notify_wait(BIT_PING, &notify, TOS_TIME_FOREVER,
+                                TOS_OPT_TASK_NOTIFY_WAIT_ANY | TOS_OPT_TASK_NOTIFY_WAIT_CLR);
+    } else {
+        osThreadFlagsWait(BIT_PING, osFlagsWaitAny, osWaitForever);
+    }
+}
+
+static void entry_ping(void *arg)
+{
+    bench_mode_t mode = (bench_mode_t)(cpu_addr_t)arg;
+
+    while (!bench_stop) {
+        bench_wakeup(mode, &event_pong, &task_pong);
+        bench_wait(mode, &event_ping);
+        ++rounds;
+    }
+}
+
+static void entry_pong(void *arg)
+{
+    bench_mode_t mode = (bench_mode_t)(cpu_addr_t)arg;
+
+    while (K_TRUE) {
+        bench_wait(mode, &event_pong);
+        bench_wakeup(mode, &event_ping, &task_ping);
+    }
+}
+
+static void bench_loop(bench_mode_t mode, const char *name)
+{
+    uint32_t i;
+    uint64_t begin, ns;
+
+    tos_event_create(&event_ping, (k_event_flag_t)0u);
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_LOOP_ROUNDS; ++i) {
+        bench_wakeup(mode, &event_ping, &task_ctrl);
+        bench_wait(mode, &event_ping);
+    }
+    ns = bench_now_ns() - begin;
+
+    tos_event_destroy(&event_ping);
+
+    printf("%-14s post + wait %8.1f ns\n", name, (double)ns / BENCH_LOOP_ROUNDS);
+}
+
+static void bench_pingpong(bench_mode_t mode, const char *name)
+{
+    uint64_t begin, ns;
+
+    bench_stop = 0;
+    rounds = 0u;
+
+    tos_event_create(&event_ping, (k_event_flag_t)0u);
+    tos_event_create(&event_pong, (k_event_flag_t)0u);
+
+    begin = bench_now_ns();
+    tos_task_create(&task_pong, "pong", entry_pong, (void *)(cpu_addr_t)mode,
+                        3, stk_pong, sizeof(stk_pong), 0);
+    tos_task_create(&task_ping, "ping", entry_ping, (void *)(cpu_addr_t)mode,
+                        3, stk_ping, sizeof(stk_ping), 0);
+
+    tos_task_delay(tos_millisec2tick(BENCH_RUN_MS));
+    bench_stop = 1;
+    ns = bench_now_ns() - begin;
+
+    tos_task_destroy(&task_ping);
+    tos_task_destroy(&task_pong);
+    tos_event_destroy(&event_ping);
+    tos_event_destroy(&event_pong);
+
+    printf("%-14s ping-pong   %8.1f ns(%llu ping-pongs)\n", name, (double)ns / rounds, (unsigned long long)rounds);
+}
+
+static void entry_ctrl(void *arg)
+{
+    bench_loop(BENCH_MODE_EVENT, "event");
+    bench_loop(BENCH_MODE_NOTIFY, "notify");
+    bench_loop(BENCH_MODE_THREAD_FLAGS, "thread flags");
+
+    bench_pingpong(BENCH_MODE_EVENT, "event");
+    bench_pingpong(BENCH_MODE_NOTIFY, "notify");
+    bench_pingpong(BENCH_MODE_THREAD_FLAGS, "thread flags");
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_ctrl, "ctrl", entry_ctrl, K_NULL,
+                        2, stk_ctrl, sizeof(stk_ctrl), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * BENCH_WAITER_NUM tasks of different priorities pend for one semaphore:
+ *  - reprioritise: the priority of one more waiter(the one mutex priority inheritance
+ *    would boost) toggles between the highest and the lowest, every change takes it out
+ *    of the pend list and puts it back in priority order
+ *  - wakeup order: the semaphore is posted once per waiter, the waiters must come out
+ *    in priority order, FIFO within a priority
+ */
+
+#define BENCH_WAITER_NUM        100u
+#define BENCH_PRIO_CHANGE_NUM   1000000u
+
+#define BENCH_PRIO_HIGH         3u
+#define BENCH_PRIO_LOW          28u
+
+#define STK_SIZE                (64u * 1024u)
+#define WAITER_STK_SIZE         (32u * 1024u)
+
+static k_stack_t stk_ctrl[STK_SIZE];
+static k_task_t task_ctrl;
+
+static k_stack_t stk_waiter[BENCH_WAITER_NUM + 1u][WAITER_STK_SIZE];
+static k_task_t task_waiter[BENCH_WAITER_NUM + 1u];
+
+static k_sem_t sem;
+
+static uint32_t wakeup_seq[BENCH_WAITER_NUM + 1u];
+static volatile uint32_t wakeup_cnt = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void entry_waiter(void *arg)
+{
+    tos_sem_pend(&sem, TOS_TIME_FOREVER);
+    wakeup_seq[wakeup_cnt++] = (uint32_t)(cpu_addr_t)arg;
+}
+
+static int bench_wakeup_order_check(void)
+{
+    uint32_t i;
+    k_task_t *prev, *curr;
+
+    for (i = 1u; i < wakeup_cnt; ++i) {
+        prev = &task_waiter[wakeup_seq[i - 1u]];
+        curr = &task_waiter[wakeup_seq[i]];
+
+        if (prev->prio > curr->prio ||
+            (prev->prio == curr->prio && wakeup_seq[i - 1u] > wakeup_seq[i])) {
+            return K_FALSE;
+        }
+    }
+    return wakeup_cnt == BENCH_WAITER_NUM + 1u;
+}
+
+static void entry_ctrl(void *arg)
+{
+    uint32_t i;
+    k_task_t *target;
+    uint64_t begin, ns;
+
+    printf("%s pend list, %u waiters\n", TOS_CFG_PEND_PRIO_BITMAP_EN > 0u ? "bitmap" : "sorted",
+                (unsigned)BENCH_WAITER_NUM);
+
+    tos_sem_create(&sem, 0);
+
+    // the waiters spread over the priorities between the highest and the lowest
+    for (i = 0; i <= BENCH_WAITER_NUM; ++i) {
+        tos_task_create(&task_waiter[i], "waiter", entry_waiter, (void *)(cpu_addr_t)i,
+                            BENCH_PRIO_HIGH + 1u + i % (BENCH_PRIO_LOW - BENCH_PRIO_HIGH - 1u),
+                            stk_waiter[i], sizeof(stk_waiter[i]), 0);
+    }
+
+    // let them all pend
+    tos_task_delay(1);
+
+    target = &task_waiter[BENCH_WAITER_NUM];
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_PRIO_CHANGE_NUM; ++i) {
+        tos_task_prio_change(target, (i & 1u) ? BENCH_PRIO_HIGH : BENCH_PRIO_LOW);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("reprioritise         %10.1f ns\n", (double)ns / BENCH_PRIO_CHANGE_NUM);
+
+    // one by one, or the readyqueue decides the order they run in
+    for (i = 0; i <= BENCH_WAITER_NUM; ++i) {
+        tos_sem_post(&sem);
+        tos_task_delay(1);
+    }
+
+    printf("wakeup order         %10s\n", bench_wakeup_order_check() ? "ok" : "BROKEN");
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_ctrl, "ctrl", entry_ctrl, K_NULL,
+                        2, stk_ctrl, sizeof(stk_ctrl), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * a producer hands bursts of BENCH_BURST items to a consumer of a higher priority, pending on the
+ * queue, through every kind of queue:
+ *  - one by one: tos_xxx_post for every item, and tos_xxx_pend for every item, each post wakes the
+ *    consumer up, so every item costs a context switch each way
+ *  - batch: tos_xxx_post_n for the whole burst and tos_xxx_pend_n, the first item goes straight to
+ *    the consumer and the rest are queued, so a burst costs one context switch each way
+ * the consumer checks every item comes out once, in order for the fifo queues
+ */
+
+#define BENCH_ROUNDS            20000u
+#define BENCH_BURST             32u
+#define BENCH_QUEUE_CNT         64u
+
+#define STK_SIZE                (64u * 1024u)
+
+typedef enum bench_queue_en {
+    BENCH_MSG_Q,
+    BENCH_MAIL_Q,
+    BENCH_PRIO_MSG_Q,
+    BENCH_PRIO_MAIL_Q,
+} bench_queue_t;
+
+typedef struct sensor_sample_st {
+    uint32_t    seq;
+    uint32_t    value[3];
+} sensor_sample_t;
+
+static k_stack_t stk_ctrl[STK_SIZE];
+static k_stack_t stk_producer[STK_SIZE];
+static k_stack_t stk_consumer[STK_SIZE];
+
+static k_task_t task_ctrl;
+static k_task_t task_producer;
+static k_task_t task_consumer;
+
+static k_msg_q_t msg_q;
+static k_mail_q_t mail_q;
+static k_prio_msg_q_t prio_msg_q;
+static k_prio_mail_q_t prio_mail_q;
+
+static void *pool_msg[BENCH_QUEUE_CNT];
+static sensor_sample_t pool_mail[BENCH_QUEUE_CNT];
+
+static k_sem_t sem_done;
+
+static bench_queue_t bench_queue;
+static int bench_batch;
+static uint32_t broken;
+static uint64_t seq_sum;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_post(uint32_t seq)
+{
+    uint32_t i;
+    size_t sent, cnt;
+    void *msg[BENCH_BURST];
+    sensor_sample_t mail[BENCH_BURST];
+
+    for (i = 0; i < BENCH_BURST; ++i) {
+        msg[i]          = (void *)(cpu_addr_t)(seq + i);
+        mail[i].seq     = seq + i;
+    }
+
+    for (i = 0; i < BENCH_BURST; i += cnt) {
+        cnt = 1u;
+        if (bench_batch) {
+            if (bench_queue == BENCH_MSG_Q) {
+                tos_msg_q_post_n(&msg_q, &msg[i], BENCH_BURST - i, &sent);
+            } else if (bench_queue == BENCH_MAIL_Q) {
+                tos_mail_q_post_n(&mail_q, &mail[i], BENCH_BURST - i, sizeof(sensor_sample_t), &sent);
+            } else if (bench_queue == BENCH_PRIO_MSG_Q) {
+                tos_prio_msg_q_post_n(&prio_msg_q, &msg[i], BENCH_BURST - i, 0, &sent);
+            } else {
+                tos_prio_mail_q_post_n(&prio_mail_q, &mail[i], BENCH_BURST - i, sizeof(sensor_sample_t), 0, &sent);
+            }
+            cnt = sent;
+        } else if (bench_queue == BENCH_MSG_Q) {
+            tos_msg_q_post(&msg_q, msg[i]);
+        } else if (bench_queue == BENCH_MAIL_Q) {
+            tos_mail_q_post(&mail_q, &mail[i], sizeof(sensor_sample_t));
+        } else if (bench_queue == BENCH_PRIO_MSG_Q) {
+            tos_prio_msg_q_post(&prio_msg_q, msg[i], 0);
+        } else {
+            tos_prio_mail_q_post(&prio_mail_q, &mail[i], sizeof(sensor_sample_t), 0);
+        }
+    }
+}
+
+static size_t bench_pend(uint32_t *seq)
+{
+    size_t i, cnt = 1u, size;
+    void *msg[BENCH_BURST];
+    sensor_sample_t mail[BENCH_BURST];
+
+    if (bench_batch) {
+        if (bench_queue == BENCH_MSG_Q) {
+            tos_msg_q_pend_n(&msg_q, msg, BENCH_BURST, &cnt, TOS_TIME_FOREVER);
+        } else if (bench_queue == BENCH_MAIL_Q) {
+            tos_mail_q_pend_n(&mail_q, mail, BENCH_BURST, &cnt, TOS_TIME_FOREVER);
+        } else if (bench_queue == BENCH_PRIO_MSG_Q) {
+            tos_prio_msg_q_pend_n(&prio_msg_q, msg, BENCH_BURST, &cnt, TOS_TIME_FOREVER);
+        } else {
+            tos_prio_mail_q_pend_n(&prio_mail_q, mail, BENCH_BURST, &cnt, TOS_TIME_FOREVER);
+        }
+    } else if (bench_queue == BENCH_MSG_Q) {
+        tos_msg_q_pend(&msg_q, &msg[0], TOS_TIME_FOREVER);
+    } else if (bench_queue == BENCH_MAIL_Q) {
+        tos_mail_q_pend(&mail_q, &mail[0], &size, TOS_TIME_FOREVER);
+    } else if (bench_queue == BENCH_PRIO_MSG_Q) {
+        tos_prio_msg_q_pend(&prio_msg_q, &msg[0], TOS_TIME_FOREVER);
+    } else {
+        tos_prio_mail_q_pend(&prio_mail_q, &mail[0], &size, TOS_TIME_FOREVER);
+    }
+
+    for (i = 0; i < cnt; ++i, ++*seq) {
+        uint32_t got = (bench_queue == BENCH_MSG_Q || bench_queue == BENCH_PRIO_MSG_Q) ?
+                            (uint32_t)(cpu_addr_t)msg[i] : mail[i].seq;
+
+        /* the priority queues are heaps, equal priorities come out in no particular order */
+        if (got != *seq && (bench_queue == BENCH_MSG_Q || bench_queue == BENCH_MAIL_Q)) {
+            ++broken;
+        }
+        seq_sum += got;
+    }
+
+    return cnt;
+}
+
+static void entry_producer(void *arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        bench_post(i * BENCH_BURST);
+    }
+}
+
+static void entry_consumer(void *arg)
+{
+    uint32_t seq = 0u;
+
+    while (seq < BENCH_ROUNDS * BENCH_BURST) {
+        bench_pend(&seq);
+    }
+
+    tos_sem_post(&sem_done);
+}
+
+static void bench_run(bench_queue_t queue, int batch, const char *name)
+{
+    uint64_t begin, ns, total = (uint64_t)BENCH_ROUNDS * BENCH_BURST;
+
+    bench_queue = queue;
+    bench_batch = batch;
+    broken      = 0u;
+    seq_sum     = 0u;
+
+    begin = bench_now_ns();
+    tos_task_create(&task_consumer, "consumer", entry_consumer, K_NULL,
+                        3, stk_consumer, sizeof(stk_consumer), 0);
+    tos_task_create(&task_producer, "producer", entry_producer, K_NULL,
+                        4, stk_producer, sizeof(stk_producer), 0);
+
+    tos_sem_pend(&sem_done, TOS_TIME_FOREVER);
+    ns = bench_now_ns() - begin;
+
+    tos_task_destroy(&task_producer);
+    tos_task_destroy(&task_consumer);
+
+    printf("%-14s %-11s %8.1f ns(%s)\n", name, batch ? "batch" : "one by one", (double)ns / total,
+                broken || seq_sum != total * (total - 1u) / 2u ? "BROKEN" : "ok");
+}
+
+static void entry_ctrl(void *arg)
+{
+    tos_msg_q_create(&msg_q, pool_msg, BENCH_QUEUE_CNT);
+    bench_run(BENCH_MSG_Q, K_FALSE, "msg_q");
+    bench_run(BENCH_MSG_Q, K_TRUE, "msg_q");
+    tos_msg_q_destroy(&msg_q);
+
+    tos_mail_q_create(&mail_q, pool_mail, BENCH_QUEUE_CNT, sizeof(sensor_sample_t));
+    bench_run(BENCH_MAIL_Q, K_FALSE, "mail_q");
+    bench_run(BENCH_MAIL_Q, K_TRUE, "mail_q");
+    tos_mail_q_destroy(&mail_q);
+
+    tos_prio_msg_q_create(&prio_msg_q, pool_msg, BENCH_QUEUE_CNT);
+    bench_run(BENCH_PRIO_MSG_Q, K_FALSE, "prio_msg_q");
+    bench_run(BENCH_PRIO_MSG_Q, K_TRUE, "prio_msg_q");
+    tos_prio_msg_q_destroy(&prio_msg_q);
+
+    tos_prio_mail_q_create(&prio_mail_q, pool_mail, BENCH_QUEUE_CNT, sizeof(sensor_sample_t));
+    bench_run(BENCH_PRIO_MAIL_Q, K_FALSE, "prio_mail_q");
+    bench_run(BENCH_PRIO_MAIL_Q, K_TRUE, "prio_mail_q");
+    tos_prio_mail_q_destroy(&prio_mail_q);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_sem_create(&sem_done, 0);
+
+    tos_task_create(&task_ctrl, "ctrl", entry_ctrl, K_NULL,
+                        2, stk_ctrl, sizeof(stk_ctrl), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+/*
+ * the locked ring queue(tos_ring_q_create) against the lock-free single-producer/single-consumer
+ * one(tos_ring_q_create_spsc), for 1 byte items(a uart rx buffer) and 16 byte items(dma descriptors):
+ *  - throughput: a task enqueues a burst of BENCH_BURST items then dequeues them, the cost of one
+ *    enqueue + dequeue is counted, either item by item, or in place through
+ *    tos_ring_q_reserve/commit and tos_ring_q_peek/release
+ *  - chr fifo: the same for a character fifo, byte by byte(tos_chr_fifo_push/pop) against a stream
+ *    (tos_chr_fifo_push_stream/pop_stream)
+ *  - spsc stress: a host thread the kernel knows nothing about(standing for an ISR on another core)
+ *    enqueues a running sequence number, as fast as it can, while a task dequeues it, every item
+ *    must come out once and in order, each side yields the host cpu when the ring is full/empty,
+ *    once item by item and once in place, with chunks of odd sizes so the spans wrap around
+ */
+
+#define BENCH_ITEM_CNT          64u
+#define BENCH_BURST             32u
+#define BENCH_ROUNDS            100000u
+#define BENCH_STRESS_ITEMS      1000000u
+
+#define STK_SIZE                (64u * 1024u)
+
+typedef struct dma_desc_st {
+    uint32_t    addr;
+    uint32_t    len;
+    uint32_t    flags;
+    uint32_t    seq;
+} dma_desc_t;
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_task_t task_bench;
+
+static uint8_t pool_byte[BENCH_ITEM_CNT];
+static dma_desc_t pool_desc[BENCH_ITEM_CNT];
+
+static k_ring_q_t ring_q;
+static k_chr_fifo_t chr_fifo;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_throughput(const char *name, void *item, size_t item_size)
+{
+    uint32_t i, j;
+    uint64_t begin, ns;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_ring_q_enqueue(&ring_q, item, item_size);
+        }
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_ring_q_dequeue(&ring_q, item, K_NULL);
+        }
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", name, (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+}
+
+static void bench_in_place(const char *name)
+{
+    uint32_t i, j, k;
+    uint64_t begin, ns;
+    k_ring_q_span_t span;
+    dma_desc_t *desc;
+    volatile uint32_t sum = 0u;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        tos_ring_q_reserve(&ring_q, BENCH_BURST, &span);
+        for (j = 0; j < 2; ++j) {
+            desc = (dma_desc_t *)span.item[j];
+            for (k = 0; k < span.cnt[j]; ++k) {
+                desc[k].addr = k;
+            }
+        }
+        tos_ring_q_commit(&ring_q, BENCH_BURST);
+
+        tos_ring_q_peek(&ring_q, BENCH_BURST, &span);
+        for (j = 0; j < 2; ++j) {
+            desc = (dma_desc_t *)span.item[j];
+            for (k = 0; k < span.cnt[j]; ++k) {
+                sum += desc[k].addr;
+            }
+        }
+        tos_ring_q_release(&ring_q, BENCH_BURST);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", name, (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+}
+
+static void bench_chr_fifo(void)
+{
+    uint32_t i, j;
+    uint64_t begin, ns;
+    uint8_t stream[BENCH_BURST], byte;
+
+    memset(stream, 0x5a, sizeof(stream));
+    tos_chr_fifo_create(&chr_fifo, pool_byte, BENCH_ITEM_CNT);
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_chr_fifo_push(&chr_fifo, stream[j]);
+        }
+        for (j = 0; j < BENCH_BURST; ++j) {
+            tos_chr_fifo_pop(&chr_fifo, &byte);
+        }
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", "chr fifo byte by byte", (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        tos_chr_fifo_push_stream(&chr_fifo, stream, BENCH_BURST);
+        tos_chr_fifo_pop_stream(&chr_fifo, stream, BENCH_BURST);
+    }
+    ns = bench_now_ns() - begin;
+
+    printf("%-26s %8.1f ns\n", "chr fifo stream", (double)ns / ((uint64_t)BENCH_ROUNDS * BENCH_BURST));
+
+    tos_chr_fifo_destroy(&chr_fifo);
+}
+
+static volatile int stress_in_place = 0;
+
+static void *stress_producer(void *arg)
+{
+    k_ring_q_span_t span;
+    dma_desc_t desc = { 0u, 0u, 0u, 0u }, *slot;
+    uint32_t i, j, cnt;
+
+    while (desc.seq < BENCH_STRESS_ITEMS) {
+        if (!stress_in_place) {
+            desc.addr = desc.seq * 4u;
+            if (tos_ring_q_enqueue(&ring_q, &desc, sizeof(desc)) != K_ERR_NONE) {
+                sched_yield();
+                continue;
+            }
+            ++desc.seq;
+            continue;
+        }
+
+        cnt = tos_ring_q_reserve(&ring_q, desc.seq % 13u + 1u, &span);
+        if (cnt == 0u) {
+            sched_yield();
+            continue;
+        }
+        for (j = 0; j < 2; ++j) {
+            slot = (dma_desc_t *)span.item[j];
+            for (i = 0; i < span.cnt[j]; ++i) {
+                slot[i].seq     = desc.seq;
+                slot[i].addr    = desc.seq * 4u;
+                ++desc.seq;
+            }
+        }
+        tos_ring_q_commit(&ring_q, cnt);
+    }
+
+    return NULL;
+}
+
+static uint32_t stress_consume(uint32_t seq, uint32_t *broken)
+{
+    k_ring_q_span_t span;
+    dma_desc_t desc, *slot;
+    uint32_t i, j, cnt;
+
+    if (!stress_in_place) {
+        if (tos_ring_q_dequeue(&ring_q, &desc, K_NULL) != K_ERR_NONE) {
+            return 0u;
+        }
+        if (desc.seq != seq || desc.addr != seq * 4u) {
+            ++*broken;
+        }
+        return 1u;
+    }
+
+    cnt = tos_ring_q_peek(&ring_q, seq % 11u + 1u, &span);
+    for (j = 0; j < 2; ++j) {
+        slot = (dma_desc_t *)span.item[j];
+        for (i = 0; i < span.cnt[j]; ++i, ++seq) {
+            if (slot[i].seq != seq || slot[i].addr != seq * 4u) {
+                ++*broken;
+            }
+        }
+    }
+    tos_ring_q_release(&ring_q, cnt);
+
+    return cnt;
+}
+
+static void bench_stress(int in_place)
+{
+    pthread_t producer;
+    uint32_t cnt, seq = 0u, broken = 0u;
+    uint64_t begin, ns;
+
+    stress_in_place = in_place;
+    tos_ring_q_create_spsc(&ring_q, pool_desc, BENCH_ITEM_CNT, sizeof(dma_desc_t));
+
+    begin = bench_now_ns();
+    pthread_create(&producer, NULL, stress_producer, NULL);
+
+    while (seq < BENCH_STRESS_ITEMS) {
+        cnt = stress_consume(seq, &broken);
+        if (cnt == 0u) {
+            sched_yield();
+        }
+        seq += cnt;
+    }
+
+    pthread_join(producer, NULL);
+    ns = bench_now_ns() - begin;
+
+    tos_ring_q_destroy(&ring_q);
+
+    printf("%-26s %8.1f ns(%u items, %s)\n", in_place ? "spsc stress in place" : "spsc stress",
+                (double)ns / BENCH_STRESS_ITEMS, (unsigned)BENCH_STRESS_ITEMS, broken ? "BROKEN" : "ok");
+}
+
+static void entry_bench(void *arg)
+{
+    uint8_t byte = 0x5a;
+    dma_desc_t desc = { 0u, 0u, 0u, 0u };
+
+    printf("%s mode\n", TOS_CFG_CPU_UCONTEXT_EN > 0u ? "ucontext" : "thread");
+
+    tos_ring_q_create(&ring_q, pool_byte, BENCH_ITEM_CNT, sizeof(uint8_t));
+    bench_throughput("locked 1 byte item", &byte, sizeof(uint8_t));
+    tos_ring_q_destroy(&ring_q);
+
+    tos_ring_q_create_spsc(&ring_q, pool_byte, BENCH_ITEM_CNT, sizeof(uint8_t));
+    bench_throughput("spsc 1 byte item", &byte, sizeof(uint8_t));
+    tos_ring_q_destroy(&ring_q);
+
+    tos_ring_q_create(&ring_q, pool_desc, BENCH_ITEM_CNT, sizeof(dma_desc_t));
+    bench_throughput("locked 16 byte item", &desc, sizeof(dma_desc_t));
+    tos_ring_q_destroy(&ring_q);
+
+    tos_ring_q_create_spsc(&ring_q, pool_desc, BENCH_ITEM_CNT, sizeof(dma_desc_t));
+    bench_throughput("spsc 16 byte item", &desc, sizeof(dma_desc_t));
+    tos_ring_q_destroy(&ring_q);
+
+    tos_ring_q_create(&ring_q, pool_desc, BENCH_ITEM_CNT, sizeof(dma_desc_t));
+    bench_in_place("locked 16 byte in place");
+    tos_ring_q_destroy(&ring_q);
+
+    tos_ring_q_create_spsc(&ring_q, pool_desc, BENCH_ITEM_CNT, sizeof(dma_desc_t));
+    bench_in_place("spsc 16 byte in place");
+    tos_ring_q_destroy(&ring_q);
+
+    bench_chr_fifo();
+
+    bench_stress(K_FALSE);
+    bench_stress(K_TRUE);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        2, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
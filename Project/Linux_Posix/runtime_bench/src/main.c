@@ -0,0 +1,147 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * checks of the runtime accounting(TOS_CFG_TASK_RUNTIME_EN) against the wall clock, the idle task
+ * spins, so the cpu is never given away and the runtime of all the tasks must add up to the time
+ * elapsed, over a window of WINDOW_TICKS:
+ *  - total: the runtime of all the tasks taken by tos_task_runtime_snapshot adds up to the wall
+ *    clock time elapsed(what the VM or the host takes away is lost, hence the slack below)
+ *  - share: a worker busy half of every WORK_TICKS * 2 ticks gets half of the time elapsed
+ *  - load: tos_task_load_get tells the same half
+ */
+
+#define WORK_TICKS              5u
+#define WARMUP_TICKS            500u
+#define WINDOW_TICKS            2000u
+#define SNAPSHOT_MAX            8u
+
+// the share of the time elapsed the runtime of all the tasks must reach, in per mille
+#define TOTAL_MIN               900u
+#define TOTAL_MAX               1020u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static k_stack_t stk_worker[STK_SIZE];
+static k_task_t task_worker;
+
+static uint32_t check_broken = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        ++check_broken;
+    }
+    printf("%-52s %s\n", what, ok ? "ok" : "BROKEN");
+}
+
+static void entry_worker(void *arg)
+{
+    k_tick_t begin;
+
+    // busy for WORK_TICKS, asleep for WORK_TICKS
+    while (K_TRUE) {
+        begin = tos_systick_get();
+        while (tos_systick_get() - begin < WORK_TICKS) {
+            ;
+        }
+        tos_task_delay(WORK_TICKS);
+    }
+}
+
+static uint64_t runtime_of(k_task_runtime_t *snapshot, size_t cnt, k_task_t *task)
+{
+    size_t i;
+
+    for (i = 0; i < cnt; ++i) {
+        if (snapshot[i].task == task) {
+            return snapshot[i].runtime;
+        }
+    }
+    return 0u;
+}
+
+static uint64_t runtime_total(k_task_runtime_t *snapshot, size_t cnt)
+{
+    uint64_t total = 0u;
+    size_t i;
+
+    for (i = 0; i < cnt; ++i) {
+        total += snapshot[i].runtime;
+    }
+    return total;
+}
+
+static void entry_main(void *arg)
+{
+    k_task_runtime_t begin[SNAPSHOT_MAX], end[SNAPSHOT_MAX];
+    size_t begin_cnt, end_cnt, i;
+    uint64_t wall_begin, wall, total, worker;
+    uint32_t total_pm, worker_pm, load;
+
+    printf("runtime accounting, %s mode, %u ticks\n", TOS_CFG_CPU_UCONTEXT_EN > 0u ? "ucontext" : "thread",
+                (unsigned)WINDOW_TICKS);
+
+    tos_task_create(&task_worker, "worker", entry_worker, K_NULL,
+                        3, stk_worker, sizeof(stk_worker), 0);
+
+    // let the load settle
+    tos_task_delay(WARMUP_TICKS);
+
+    begin_cnt   = tos_task_runtime_snapshot(begin, SNAPSHOT_MAX);
+    wall_begin  = bench_now_ns();
+
+    tos_task_delay(WINDOW_TICKS);
+
+    end_cnt     = tos_task_runtime_snapshot(end, SNAPSHOT_MAX);
+    wall        = bench_now_ns() - wall_begin;
+    load        = tos_task_load_get();
+
+    printf("\n%-12s %16s\n", "task", "runtime(ms)");
+    for (i = 0; i < end_cnt; ++i) {
+        printf("%-12s %16.1f\n", end[i].task->name,
+                (double)(end[i].runtime - runtime_of(begin, begin_cnt, end[i].task)) / 1000000.0);
+    }
+
+    total       = runtime_total(end, end_cnt) - runtime_total(begin, begin_cnt);
+    worker      = runtime_of(end, end_cnt, &task_worker) - runtime_of(begin, begin_cnt, &task_worker);
+    total_pm    = (uint32_t)(total * 1000u / wall);
+    worker_pm   = (uint32_t)(worker * 1000u / wall);
+
+    printf("%-12s %16.1f\n", "(all)", (double)total / 1000000.0);
+    printf("%-12s %16.1f\n", "(elapsed)", (double)wall / 1000000.0);
+    printf("\ntotal %u, worker %u, load %u, per mille\n\n", (unsigned)total_pm, (unsigned)worker_pm, (unsigned)load);
+
+    check(total_pm >= TOTAL_MIN && total_pm <= TOTAL_MAX, "total: the runtimes add up to the time elapsed");
+    check(worker_pm >= 400u && worker_pm <= 600u, "share: the worker is busy half of the time");
+    check(load >= 400u && load <= 600u, "load: half of the time");
+
+    printf("\n%s\n", check_broken == 0u ? "ok" : "BROKEN");
+
+    exit(check_broken == 0u ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        2, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
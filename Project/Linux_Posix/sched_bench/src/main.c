@@ -0,0 +1,110 @@
+#include "tos_k.h"
+
+#include <time.h>
+
+/*
+ * measure the cost of the ready queue with 8/64/256 priorities.
+ * the tasks here are never really created(no stack, no context), we only
+ * put them into/take them off the ready queue, so what we measure is the
+ * ready queue itself, not the context switch.
+ *
+ * ready:   readyqueue_add_tail on a random task
+ * unready: readyqueue_remove on a random task
+ * pick:    the highest ready task blocks and the next one is picked,
+ *          only the lowest priority is left ready, the worst case of a lookup
+ */
+
+#define BENCH_TASK_MAX          (TOS_CFG_TASK_PRIO_MAX - 1u) /* all but the idle priority */
+#define BENCH_ROUNDS            20000u
+#define BENCH_PICK_ROUNDS       1000000u
+
+static k_task_t bench_tasks[BENCH_TASK_MAX];
+
+static uint32_t bench_order[BENCH_TASK_MAX];
+
+static uint32_t bench_seed = 20201017u;
+
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245u + 12345u;
+    return bench_seed >> 8;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_shuffle(void)
+{
+    uint32_t i, j, tmp;
+
+    for (i = BENCH_TASK_MAX - 1u; i > 0u; --i) {
+        j = bench_rand() % (i + 1u);
+        tmp = bench_order[i];
+        bench_order[i] = bench_order[j];
+        bench_order[j] = tmp;
+    }
+}
+
+int main(void)
+{
+    uint32_t i, round;
+    uint64_t begin, ready_ns = 0u, unready_ns = 0u, pick_ns;
+    k_task_t *highest, *lowest, *picked = K_NULL;
+
+    tos_knl_init();
+
+    for (i = 0; i < BENCH_TASK_MAX; ++i) {
+        bench_tasks[i].prio = (k_prio_t)i;
+        tos_list_init(&bench_tasks[i].pend_list);
+        bench_order[i] = i;
+    }
+
+    for (round = 0; round < BENCH_ROUNDS; ++round) {
+        bench_shuffle();
+
+        begin = bench_now_ns();
+        for (i = 0; i < BENCH_TASK_MAX; ++i) {
+            readyqueue_add_tail(&bench_tasks[bench_order[i]]);
+        }
+        ready_ns += bench_now_ns() - begin;
+
+        bench_shuffle();
+
+        begin = bench_now_ns();
+        for (i = 0; i < BENCH_TASK_MAX; ++i) {
+            readyqueue_remove(&bench_tasks[bench_order[i]]);
+        }
+        unready_ns += bench_now_ns() - begin;
+    }
+
+    highest = &bench_tasks[0];
+    lowest  = &bench_tasks[BENCH_TASK_MAX - 1u];
+    readyqueue_add_tail(lowest);
+
+    begin = bench_now_ns();
+    for (round = 0; round < BENCH_PICK_ROUNDS; ++round) {
+        readyqueue_add_tail(highest);
+        readyqueue_remove(highest);
+        picked = readyqueue_highest_ready_task_get();
+    }
+    pick_ns = bench_now_ns() - begin;
+
+    if (picked != lowest) {
+        printf("ready queue broken, picked prio %u\n", (uint32_t)picked->prio);
+        return -1;
+    }
+
+    printf("%8s %12s %12s %12s\n", "prios", "ready(ns)", "unready(ns)", "pick(ns)");
+    printf("%8u %12.1f %12.1f %12.1f\n",
+            (uint32_t)TOS_CFG_TASK_PRIO_MAX,
+            (double)ready_ns / ((double)BENCH_ROUNDS * BENCH_TASK_MAX),
+            (double)unready_ns / ((double)BENCH_ROUNDS * BENCH_TASK_MAX),
+            (double)pick_ns / BENCH_PICK_ROUNDS);
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * checks and costs of the kernel object caches(TOS_CFG_SLAB_EN), for every type a *_create_dyn
+ * creates(task, timer, mmblk pool, event, mutex, semaphore):
+ *  - create: OBJ_NUM objects created, obj_inuse goes up by OBJ_NUM and every object of the slabs
+ *    taken is either in use or cached(slab_cnt * TOS_CFG_SLAB_OBJ_CNT == obj_inuse + obj_free)
+ *  - destroy: all of them destroyed, obj_inuse back, the objects cached
+ *  - recreate: OBJ_NUM objects created again are served by the cache, no slab taken
+ *  - reap: destroyed again and reaped, no slab and no object cached left, and the heap is back to
+ *    where it was before the first create
+ *  - cost: tos_sem_create_dyn + tos_sem_destroy_dyn served by the cache, and with a reap every
+ *    round(a slab taken from the heap and constructed every create)
+ */
+
+#define OBJ_NUM                 (TOS_CFG_SLAB_OBJ_CNT * 2u + 1u)
+#define TASK_STK_SIZE           512u
+#define BENCH_ROUNDS            100000u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static void *obj[OBJ_NUM];
+
+static uint32_t check_broken = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void check(int ok, const char *type, const char *what)
+{
+    if (!ok) {
+        ++check_broken;
+    }
+    printf("%-12s %-44s %s\n", type, what, ok ? "ok" : "BROKEN");
+}
+
+static void entry_dummy(void *arg)
+{
+    while (K_TRUE) {
+        tos_task_delay(TOS_TIME_FOREVER - 1u);
+    }
+}
+
+static void timer_dummy(void *arg)
+{
+}
+
+static k_err_t obj_create(knl_obj_type_t type, void **the_obj)
+{
+    switch (type) {
+        case KNL_OBJ_TYPE_TASK:
+            return tos_task_create_dyn((k_task_t **)the_obj, "dyn", entry_dummy, K_NULL,
+                                        5, TASK_STK_SIZE, 0);
+        case KNL_OBJ_TYPE_TIMER:
+            return tos_timer_create_dyn((k_timer_t **)the_obj, 1000u, 0u, timer_dummy, K_NULL,
+                                        TOS_OPT_TIMER_ONESHOT);
+        case KNL_OBJ_TYPE_MMBLK_POOL:
+            return tos_mmblk_pool_create_dyn((k_mmblk_pool_t **)the_obj, 4, 32);
+        case KNL_OBJ_TYPE_EVENT:
+            return tos_event_create_dyn((k_event_t **)the_obj, (k_event_flag_t)0u);
+        case KNL_OBJ_TYPE_MUTEX:
+            return tos_mutex_create_dyn((k_mutex_t **)the_obj);
+        default:
+            return tos_sem_create_dyn((k_sem_t **)the_obj, 0);
+    }
+}
+
+static k_err_t obj_destroy(knl_obj_type_t type, void *the_obj)
+{
+    switch (type) {
+        case KNL_OBJ_TYPE_TASK:         return tos_task_destroy_dyn((k_task_t *)the_obj);
+        case KNL_OBJ_TYPE_TIMER:        return tos_timer_destroy_dyn((k_timer_t *)the_obj);
+        case KNL_OBJ_TYPE_MMBLK_POOL:   return tos_mmblk_pool_destroy_dyn((k_mmblk_pool_t *)the_obj);
+        case KNL_OBJ_TYPE_EVENT:        return tos_event_destroy_dyn((k_event_t *)the_obj);
+        case KNL_OBJ_TYPE_MUTEX:        return tos_mutex_destroy_dyn((k_mutex_t *)the_obj);
+        default:                        return tos_sem_destroy_dyn((k_sem_t *)the_obj);
+    }
+}
+
+static int obj_create_all(knl_obj_type_t type)
+{
+    uint32_t i;
+    int ok = K_TRUE;
+
+    for (i = 0; i < OBJ_NUM; ++i) {
+        if (obj_create(type, &obj[i]) != K_ERR_NONE) {
+            obj[i] = K_NULL;
+            ok = K_FALSE;
+        }
+    }
+    return ok;
+}
+
+static int obj_destroy_all(knl_obj_type_t type)
+{
+    uint32_t i;
+    int ok = K_TRUE;
+
+    for (i = 0; i < OBJ_NUM; ++i) {
+        if (obj[i] && obj_destroy(type, obj[i]) != K_ERR_NONE) {
+            ok = K_FALSE;
+        }
+    }
+    return ok;
+}
+
+static k_slab_info_t slab_info(knl_obj_type_t type)
+{
+    k_slab_info_t info;
+
+    tos_slab_check(type, &info);
+    return info;
+}
+
+/* every object of the slabs taken is either in use or cached */
+static int slab_consistent(k_slab_info_t *info)
+{
+    return info->slab_cnt * TOS_CFG_SLAB_OBJ_CNT == info->obj_inuse + info->obj_free &&
+            info->obj_inuse_max >= info->obj_inuse;
+}
+
+static void check_type(knl_obj_type_t type, const char *name)
+{
+    k_slab_info_t before, info;
+    k_mmheap_info_t heap_before, heap_after;
+    size_t slab_cnt;
+    int ok;
+
+    tos_slab_reap();
+    tos_mmheap_check(&heap_before);
+    before = slab_info(type);
+
+    ok = obj_create_all(type);
+    info = slab_info(type);
+    check(ok && info.obj_inuse == before.obj_inuse + OBJ_NUM && info.obj_size > 0u && slab_consistent(&info),
+            name, "create: objects in use, the rest cached");
+    slab_cnt = info.slab_cnt;
+
+    ok = obj_destroy_all(type);
+    info = slab_info(type);
+    check(ok && info.obj_inuse == before.obj_inuse && info.obj_free >= OBJ_NUM && slab_consistent(&info),
+            name, "destroy: objects back to the cache");
+
+    ok = obj_create_all(type);
+    info = slab_info(type);
+    check(ok && info.slab_cnt == slab_cnt && info.obj_inuse == before.obj_inuse + OBJ_NUM && slab_consistent(&info),
+            name, "recreate: served by the cache, no slab taken");
+
+    ok = obj_destroy_all(type);
+    tos_slab_reap();
+    info = slab_info(type);
+    tos_mmheap_check(&heap_after);
+    check(ok && info.slab_cnt == 0u && info.obj_free == 0u && info.obj_inuse == 0u &&
+            heap_after.used == heap_before.used,
+            name, "reap: slabs back to the heap");
+}
+
+static double bench_sem(int reap)
+{
+    uint64_t begin;
+    uint32_t i;
+    k_sem_t *sem;
+
+    begin = bench_now_ns();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        tos_sem_create_dyn(&sem, 0);
+        tos_sem_destroy_dyn(sem);
+        if (reap) {
+            tos_slab_reap();
+        }
+    }
+    return (double)(bench_now_ns() - begin) / BENCH_ROUNDS;
+}
+
+static void entry_main(void *arg)
+{
+    printf("kernel object caches, %u objects a slab\n", (unsigned)TOS_CFG_SLAB_OBJ_CNT);
+
+    check_type(KNL_OBJ_TYPE_TASK,       "task");
+    check_type(KNL_OBJ_TYPE_TIMER,      "timer");
+    check_type(KNL_OBJ_TYPE_MMBLK_POOL, "mmblk_pool");
+    check_type(KNL_OBJ_TYPE_EVENT,      "event");
+    check_type(KNL_OBJ_TYPE_MUTEX,      "mutex");
+    check_type(KNL_OBJ_TYPE_SEMAPHORE,  "sem");
+
+    printf("\n%-40s %8.1f ns\n", "sem create+destroy, cached", bench_sem(K_FALSE));
+    printf("%-40s %8.1f ns\n", "sem create+destroy+reap, slab each time", bench_sem(K_TRUE));
+
+    printf("\n%s\n", check_broken == 0u ? "ok" : "BROKEN");
+
+    exit(check_broken == 0u ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        3, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * throughput of the SMP Linux port(TOS_CFG_SMP_EN), every cpu is a host thread:
+ *  - compute: one worker per cpu runs compute chunks, with a semaphore post + pend(which
+ *    takes the kernel lock) after each chunk, the chunks done in 1 second are counted
+ *  - cross cpu ping-pong: two tasks pinned to cpu 0 and cpu 1 by tos_task_affinity_set
+ *    ping-pong through two semaphores, every wakeup of the other one is an ipi
+ */
+
+#define BENCH_RUN_MS            1000u
+#define BENCH_CHUNK_ROUNDS      10000u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+static k_stack_t stk_worker[TOS_CFG_CPU_NUM][STK_SIZE];
+static k_stack_t stk_ping[STK_SIZE];
+static k_stack_t stk_pong[STK_SIZE];
+
+static k_task_t task_bench;
+static k_task_t task_worker[TOS_CFG_CPU_NUM];
+static k_task_t task_ping;
+static k_task_t task_pong;
+
+static k_sem_t sem_worker[TOS_CFG_CPU_NUM];
+static k_sem_t sem_ping, sem_pong, sem_done;
+
+static volatile int bench_stop = 0;
+static volatile uint64_t chunks[TOS_CFG_CPU_NUM];
+static volatile uint64_t pingpongs = 0u;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void entry_worker(void *arg)
+{
+    k_sem_t *sem = (k_sem_t *)arg;
+    volatile uint32_t acc = 0u;
+    uint32_t i, id = sem - &sem_worker[0];
+
+    while (!bench_stop) {
+        for (i = 0; i < BENCH_CHUNK_ROUNDS; ++i) {
+            acc = acc * 31u + i;
+        }
+        tos_sem_post(sem);
+        tos_sem_pend(sem, TOS_TIME_NOWAIT);
+        ++chunks[id];
+    }
+
+    tos_sem_post(&sem_done);
+}
+
+static void entry_ping(void *arg)
+{
+    tos_task_affinity_set(K_NULL, K_CPU_AFFINITY_BIT(0u));
+
+    while (!bench_stop) {
+        tos_sem_post(&sem_ping);
+        tos_sem_pend(&sem_pong, TOS_TIME_FOREVER);
+        ++pingpongs;
+    }
+
+    tos_sem_post(&sem_ping);
+    tos_sem_post(&sem_done);
+}
+
+static void entry_pong(void *arg)
+{
+    tos_task_affinity_set(K_NULL, K_CPU_AFFINITY_BIT(1u));
+
+    while (!bench_stop) {
+        tos_sem_pend(&sem_ping, TOS_TIME_FOREVER);
+        tos_sem_post(&sem_pong);
+    }
+
+    tos_sem_post(&sem_done);
+}
+
+static void bench_compute(void)
+{
+    uint32_t i;
+    uint64_t begin, ns, total = 0u;
+
+    bench_stop = 0;
+
+    begin = bench_now_ns();
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        tos_sem_create(&sem_worker[i], 0);
+        tos_task_create(&task_worker[i], "worker", entry_worker, &sem_worker[i],
+                            4, stk_worker[i], sizeof(stk_worker[i]), 0);
+    }
+
+    tos_task_delay(tos_millisec2tick(BENCH_RUN_MS));
+    bench_stop = 1;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        tos_sem_pend(&sem_done, TOS_TIME_FOREVER);
+    }
+    ns = bench_now_ns() - begin;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        total += chunks[i];
+        printf("  cpu %u: %8llu chunks\n", (unsigned)task_worker[i].cpu_id, (unsigned long long)chunks[i]);
+        tos_task_destroy(&task_worker[i]);
+    }
+
+    printf("compute              %10.1f chunks/s\n", (double)total * 1000000000.0 / ns);
+}
+
+static void bench_pingpong(void)
+{
+    uint64_t begin, ns;
+
+    bench_stop = 0;
+
+    tos_sem_create(&sem_ping, 0);
+    tos_sem_create(&sem_pong, 0);
+
+    begin = bench_now_ns();
+    tos_task_create(&task_ping, "ping", entry_ping, K_NULL,
+                        4, stk_ping, sizeof(stk_ping), 0);
+    tos_task_create(&task_pong, "pong", entry_pong, K_NULL,
+                        4, stk_pong, sizeof(stk_pong), 0);
+
+    tos_task_delay(tos_millisec2tick(BENCH_RUN_MS));
+    bench_stop = 1;
+
+    tos_sem_pend(&sem_done, TOS_TIME_FOREVER);
+    tos_sem_pend(&sem_done, TOS_TIME_FOREVER);
+    ns = bench_now_ns() - begin;
+
+    printf("cross cpu ping-pong  %10.1f ns(%llu ping-pongs)\n", (double)ns / pingpongs,
+                (unsigned long long)pingpongs);
+}
+
+static void entry_bench(void *arg)
+{
+    printf("%u cpu(s)\n", (unsigned)TOS_CFG_CPU_NUM);
+
+    bench_compute();
+
+    if (TOS_CFG_CPU_NUM > 1u) {
+        bench_pingpong();
+    }
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_sem_create(&sem_done, 0);
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        2, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
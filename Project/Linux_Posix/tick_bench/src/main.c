@@ -0,0 +1,158 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * compare the task tick list engines(delta list vs. timing wheel) with 10/100/1000 tasks delayed.
+ * the bench task has the highest priority and never waits, so the tasks never run, a task "delays"
+ * the way tos_task_delay puts it to sleep, and the systick is turned by hand(in the virtual time
+ * mode no one else turns it), so what we measure is the tick list itself, not the scheduler:
+ *  - delay: putting a task to sleep(tick_list_add)
+ *  - abort/redelay: tos_task_delay_abort on a random sleeping task, and putting it to sleep again
+ *  - tick: tick_update per tick, including waking up the tasks due
+ * every task woken up is checked to wake up on the very tick it asked for, and goes to sleep again
+ * at once, so the number of tasks sleeping stays the same.
+ */
+
+#define BENCH_TASK_MAX          1000u
+#define BENCH_ABORT_ROUNDS      10000u
+
+#define STK_SIZE                (20u * 1024u)
+
+static k_stack_t stk_bench[BENCH_TASK_MAX][STK_SIZE];
+static k_task_t task_bench[BENCH_TASK_MAX];
+static k_tick_t task_expires[BENCH_TASK_MAX];
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static uint32_t bench_seed = 20201017u;
+
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245u + 12345u;
+    return bench_seed >> 8;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void entry_dummy(void *arg)
+{
+}
+
+/* what tos_task_delay does to the current task */
+static void task_delay(k_task_t *task, k_tick_t delay)
+{
+    tick_list_add(task, delay);
+    readyqueue_remove(task);
+}
+
+static void bench_run(uint32_t task_cnt)
+{
+    uint32_t i, which, wakeups = 0u, late = 0u;
+    k_tick_t delay_max, delay, tick;
+    uint64_t begin, delay_ns, abort_ns = 0u, tick_ns = 0u;
+
+    delay_max = (k_tick_t)task_cnt * 4u;
+
+    for (i = 0; i < task_cnt; ++i) {
+        tos_task_create(&task_bench[i], "bench", entry_dummy, K_NULL,
+                            5, stk_bench[i], sizeof(stk_bench[i]), 0);
+    }
+
+    begin = bench_now_ns();
+    for (i = 0; i < task_cnt; ++i) {
+        delay = (k_tick_t)(bench_rand() % delay_max) + 1u;
+        task_expires[i] = k_tick_count + delay;
+        task_delay(&task_bench[i], delay);
+    }
+    delay_ns = bench_now_ns() - begin;
+
+    for (i = 0; i < BENCH_ABORT_ROUNDS; ++i) {
+        which = bench_rand() % task_cnt;
+        delay = (k_tick_t)(bench_rand() % delay_max) + 1u;
+
+        begin = bench_now_ns();
+        tos_task_delay_abort(&task_bench[which]);
+        task_delay(&task_bench[which], delay);
+        abort_ns += bench_now_ns() - begin;
+
+        task_expires[which] = k_tick_count + delay;
+    }
+
+    for (tick = 0; tick < delay_max * 4u; ++tick) {
+        begin = bench_now_ns();
+        tick_update((k_tick_t)1u);
+        tick_ns += bench_now_ns() - begin;
+
+        for (i = 0; i < task_cnt; ++i) {
+            if (task_state_is_sleeping(&task_bench[i])) {
+                if (task_expires[i] < k_tick_count) {
+                    // should have been woken up already
+                    ++late;
+                    task_expires[i] = TOS_TIME_FOREVER;
+                }
+                continue;
+            }
+
+            ++wakeups;
+            if (task_expires[i] != k_tick_count) {
+                ++late;
+            }
+
+            delay = (k_tick_t)(bench_rand() % delay_max) + 1u;
+            task_expires[i] = k_tick_count + delay;
+            task_delay(&task_bench[i], delay);
+        }
+    }
+
+    for (i = 0; i < task_cnt; ++i) {
+        tos_task_delay_abort(&task_bench[i]);
+        tos_task_destroy(&task_bench[i]);
+    }
+
+    printf("%8u %12llu %14llu %12llu %10u %6u\n",
+            task_cnt,
+            (unsigned long long)(delay_ns / task_cnt),
+            (unsigned long long)(abort_ns / BENCH_ABORT_ROUNDS),
+            (unsigned long long)(tick_ns / (delay_max * 4u)),
+            wakeups, late);
+}
+
+static void entry_main(void *arg)
+{
+    uint32_t task_cnt;
+
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+    printf("tick list engine: wheel(%u slots)\n", (uint32_t)K_TICK_WHEEL_SLOT_NUM);
+#else
+    printf("tick list engine: delta list\n");
+#endif
+    printf("%8s %12s %14s %12s %10s %6s\n",
+            "tasks", "delay(ns)", "abort+delay(ns)", "tick(ns)", "wakeups", "late");
+
+    for (task_cnt = 10u; task_cnt <= BENCH_TASK_MAX; task_cnt *= 10u) {
+        bench_run(task_cnt);
+    }
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        2, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * what the idle task costs on the Linux port, and how late a task wakes up:
+ *  - busy: no power management, the idle task spins
+ *  - tick: TOS_CFG_PWR_MGR_EN, the idle task sleeps until the next tick
+ *  - tickless: TOS_CFG_TICKLESS_EN, the systick is reprogrammed as a one-shot alarm to the next
+ *    expiry, the idle task sleeps until then
+ * a task sleeps BENCH_DELAY_MS for BENCH_ROUNDS times, the process cpu time is compared to
+ * the wall time at last.
+ */
+
+#define BENCH_ROUNDS            20u
+#define BENCH_DELAY_MS          100u
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_bench[STK_SIZE];
+
+static k_task_t task_bench;
+
+static uint64_t bench_clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#if TOS_CFG_TICKLESS_EN > 0u
+
+static int bench_alarm_init(void)
+{
+    return 0;
+}
+
+static int bench_alarm_setup(k_time_t millisecond)
+{
+    cpu_systick_expires_set(millisecond);
+    cpu_systick_resume();
+    return 0;
+}
+
+static int bench_alarm_dismiss(void)
+{
+    return 0;
+}
+
+/* the systick itself works as the wakeup alarm of the sleep mode */
+static k_tickless_wkup_alarm_t bench_alarm = {
+    .init       = bench_alarm_init,
+    .setup      = bench_alarm_setup,
+    .dismiss    = bench_alarm_dismiss,
+    .max_delay  = cpu_systick_max_delay_millisecond,
+};
+
+int tos_bsp_tickless_setup(void)
+{
+    tos_tickless_wkup_alarm_install(TOS_LOW_POWER_MODE_SLEEP, &bench_alarm);
+    return tos_tickless_wkup_alarm_init(TOS_LOW_POWER_MODE_SLEEP);
+}
+
+#endif
+
+static void entry_bench(void *arg)
+{
+    uint32_t i;
+    uint64_t wall, cpu, begin, late, late_sum = 0u, late_max = 0u;
+
+#if TOS_CFG_TICKLESS_EN > 0u
+    tos_pm_cpu_lpwr_mode_set(TOS_LOW_POWER_MODE_SLEEP);
+    printf("tickless idle\n");
+#elif TOS_CFG_PWR_MGR_EN > 0u
+    printf("sleep idle(periodic tick)\n");
+#else
+    printf("busy idle\n");
+#endif
+
+    wall = bench_clock_ns(CLOCK_MONOTONIC);
+    cpu = bench_clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        begin = bench_clock_ns(CLOCK_MONOTONIC);
+        tos_task_delay(tos_millisec2tick(BENCH_DELAY_MS));
+        late = bench_clock_ns(CLOCK_MONOTONIC) - begin;
+        late = late > (uint64_t)BENCH_DELAY_MS * 1000000u ? late - (uint64_t)BENCH_DELAY_MS * 1000000u : 0u;
+
+        late_sum += late;
+        if (late > late_max) {
+            late_max = late;
+        }
+    }
+
+    wall = bench_clock_ns(CLOCK_MONOTONIC) - wall;
+    cpu = bench_clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    printf("wakeup latency avg   %10.1f us\n", (double)late_sum / BENCH_ROUNDS / 1000.0);
+    printf("wakeup latency max   %10.1f us\n", (double)late_max / 1000.0);
+    printf("cpu usage            %10.2f %%\n", (double)cpu * 100.0 / wall);
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_bench, "bench", entry_bench, K_NULL,
+                        3, stk_bench, sizeof(stk_bench), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include "tos_k.h"
+
+#include <time.h>
+
+/*
+ * compare the cost of the soft timer engines(sorted list vs. timing wheel)
+ * with 10/100/1000/10000 timers running.
+ * everything is done before tos_knl_start, the systick is turned by hand,
+ * so what we measure is the timer engine itself, not the scheduler.
+ */
+
+#define BENCH_TIMER_MAX         10000u
+#define BENCH_RESTART_ROUNDS    10000u
+
+static k_timer_t bench_timers[BENCH_TIMER_MAX];
+
+static uint32_t bench_seed = 20201017u;
+
+static uint32_t bench_fires = 0u;
+
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245u + 12345u;
+    return bench_seed >> 8;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_timer_callback(void *arg)
+{
+    ++bench_fires;
+}
+
+static void bench_tick(k_tick_t ticks)
+{
+    while (ticks--) {
+        tick_update((k_tick_t)1u);
+        soft_timer_update();
+    }
+}
+
+/*
+ * a running periodic timer restarted(delay 0, so it goes by the period) must fire one period after
+ * the restart, neither at once nor a revolution of the wheel late, and once it fired the engine must
+ * know when the next one is due, not keep looking at every tick.
+ */
+static int check_restart(void)
+{
+    k_timer_t *tmr = &bench_timers[0];
+    int ok = K_TRUE;
+
+    tos_timer_create(tmr, 0u, 10u, bench_timer_callback, K_NULL, TOS_OPT_TIMER_PERIODIC);
+    tos_timer_start(tmr);
+
+    bench_fires = 0u;
+    bench_tick(4u);
+    tos_timer_start(tmr);
+
+    bench_tick(9u);
+    ok = ok && bench_fires == 0u;
+    bench_tick(1u);
+    ok = ok && bench_fires == 1u;
+
+    ok = ok && k_timer_ctl.next_expires == k_tick_count + 10u;
+
+    bench_tick(10u);
+    ok = ok && bench_fires == 2u;
+
+    tos_timer_destroy(tmr);
+    return ok;
+}
+
+#define SLACK_TIMER_NUM         8u
+
+static k_tick_t slack_fire_tick[SLACK_TIMER_NUM];
+
+static void slack_timer_callback(void *arg)
+{
+    slack_fire_tick[(cpu_addr_t)arg] = k_tick_count;
+}
+
+/*
+ * SLACK_TIMER_NUM oneshot timers due on consecutive ticks, started with no slack and then with a slack
+ * wider than the spread: return on how many different ticks they fired, and check every one fired
+ * inside its window [expires, expires + slack].
+ */
+static uint32_t check_slack(k_tick_t slack, int *ok)
+{
+    k_tick_t begin;
+    uint32_t i, j, ticks = 0u;
+
+    begin = k_tick_count;
+    for (i = 0; i < SLACK_TIMER_NUM; ++i) {
+        tos_timer_create_slack(&bench_timers[i], 100u + i, 0u, slack, slack_timer_callback,
+                                (void *)(cpu_addr_t)i, TOS_OPT_TIMER_ONESHOT);
+        tos_timer_start(&bench_timers[i]);
+        slack_fire_tick[i] = 0u;
+    }
+
+    bench_tick(100u + SLACK_TIMER_NUM + slack);
+
+    for (i = 0; i < SLACK_TIMER_NUM; ++i) {
+        if (slack_fire_tick[i] < begin + 100u + i || slack_fire_tick[i] > begin + 100u + i + slack) {
+            *ok = K_FALSE;
+        }
+
+        for (j = 0; j < i && slack_fire_tick[j] != slack_fire_tick[i]; ++j) {
+            ;
+        }
+        if (j == i) {
+            ++ticks;
+        }
+
+        tos_timer_destroy(&bench_timers[i]);
+    }
+
+    return ticks;
+}
+
+static void bench_run(uint32_t timer_cnt)
+{
+    uint32_t i, which;
+    k_tick_t delay, ticks;
+    uint64_t begin, start_ns, stop_ns = 0u, restart_ns = 0u, tick_ns;
+
+    ticks = (k_tick_t)timer_cnt * 4u;
+
+    for (i = 0; i < timer_cnt; ++i) {
+        delay = (k_tick_t)(bench_rand() % ticks) + 1u;
+        tos_timer_create(&bench_timers[i], delay, delay,
+                            bench_timer_callback, K_NULL, TOS_OPT_TIMER_PERIODIC);
+    }
+
+    begin = bench_now_ns();
+    for (i = 0; i < timer_cnt; ++i) {
+        tos_timer_start(&bench_timers[i]);
+    }
+    start_ns = bench_now_ns() - begin;
+
+    for (i = 0; i < BENCH_RESTART_ROUNDS; ++i) {
+        which = bench_rand() % timer_cnt;
+
+        begin = bench_now_ns();
+        tos_timer_stop(&bench_timers[which]);
+        stop_ns += bench_now_ns() - begin;
+
+        begin = bench_now_ns();
+        tos_timer_start(&bench_timers[which]);
+        restart_ns += bench_now_ns() - begin;
+    }
+
+    bench_fires = 0u;
+    begin = bench_now_ns();
+    bench_tick(ticks);
+    tick_ns = bench_now_ns() - begin;
+
+    for (i = 0; i < timer_cnt; ++i) {
+        tos_timer_destroy(&bench_timers[i]);
+    }
+
+    printf("%8u %12llu %12llu %12llu %12llu %10u\n",
+            timer_cnt,
+            (unsigned long long)(start_ns / timer_cnt),
+            (unsigned long long)(stop_ns / BENCH_RESTART_ROUNDS),
+            (unsigned long long)(restart_ns / BENCH_RESTART_ROUNDS),
+            (unsigned long long)(tick_ns / ticks),
+            bench_fires);
+}
+
+int main(void)
+{
+    uint32_t timer_cnt, ticks_no_slack, ticks_slack;
+    int ok;
+
+    tos_knl_init();
+
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+    printf("timer engine: wheel(%u slots)\n", (uint32_t)K_TIMER_WHEEL_SLOT_NUM);
+#else
+    printf("timer engine: sorted list\n");
+#endif
+    printf("restart a running timer: %s\n", check_restart() ? "ok" : "BROKEN");
+
+    ok = K_TRUE;
+    ticks_no_slack  = check_slack(0u, &ok);
+    ticks_slack     = check_slack(16u, &ok);
+    printf("%u timers due on consecutive ticks fire on %u ticks, on %u with a slack of 16: %s\n",
+            (unsigned)SLACK_TIMER_NUM, (unsigned)ticks_no_slack, (unsigned)ticks_slack,
+            ok && ticks_slack < ticks_no_slack ? "ok" : "BROKEN");
+
+    printf("%8s %12s %12s %12s %12s %10s\n",
+            "timers", "start(ns)", "stop(ns)", "restart(ns)", "tick(ns)", "fires");
+
+    for (timer_cnt = 10u; timer_cnt <= BENCH_TIMER_MAX; timer_cnt *= 10u) {
+        bench_run(timer_cnt);
+    }
+
+    return 0;
+}
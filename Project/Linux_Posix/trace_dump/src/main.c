@@ -0,0 +1,276 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * run a small workload with the kernel trace on(TOS_CFG_TRACE_EN), then dump the trace buffer:
+ *  - trace.bin: the raw k_trace_event_t array, exactly what a target would dump over a debugger
+ *  - trace.json: Chrome trace event format, open it in chrome://tracing or https://ui.perfetto.dev
+ *
+ * usage:
+ *  trace_dump                          run the workload, write trace.bin and trace.json
+ *  trace_dump -c in.bin out.json       convert a raw dump to Chrome trace event format
+ */
+
+#define DUMP_RUN_MS             500u
+#define DUMP_TASK_MAX           32u
+
+#define STK_SIZE                4096u
+
+static k_stack_t stk_ctrl[STK_SIZE];
+static k_stack_t stk_producer[STK_SIZE];
+static k_stack_t stk_consumer[STK_SIZE];
+
+static k_task_t task_ctrl;
+static k_task_t task_producer;
+static k_task_t task_consumer;
+
+static k_sem_t sem;
+static k_timer_t timer;
+
+static k_trace_event_t events[K_TRACE_EVENT_NUM];
+
+static const char *event_name[] = {
+    "none",
+    "task_create",
+    "task_switch",
+    "pend",
+    "wakeup",
+    "tick",
+    "mmheap_alloc",
+    "mmheap_free",
+    "timer_fire",
+    "post",
+};
+
+typedef struct dump_task_st {
+    uint64_t    task;
+    char        name[sizeof(uint64_t) + 1];
+} dump_task_t;
+
+static dump_task_t dump_tasks[DUMP_TASK_MAX];
+static uint32_t dump_task_cnt = 0u;
+
+/* tid in the json of a task, the first one seen gets 1; 0 is "no task running" */
+static uint32_t dump_task_tid(uint64_t task)
+{
+    uint32_t i;
+
+    if (!task) {
+        return 0u;
+    }
+
+    for (i = 0; i < dump_task_cnt; ++i) {
+        if (dump_tasks[i].task == task) {
+            return i + 1u;
+        }
+    }
+
+    if (dump_task_cnt == DUMP_TASK_MAX) {
+        return 0u;
+    }
+
+    dump_tasks[dump_task_cnt].task = task;
+    snprintf(dump_tasks[dump_task_cnt].name, sizeof(dump_tasks[0].name), "%llx", (unsigned long long)task);
+
+    return ++dump_task_cnt;
+}
+
+static void dump_task_name(uint64_t task, uint64_t packed)
+{
+    uint32_t tid;
+    uint8_t i;
+    char *name;
+
+    tid = dump_task_tid(task);
+    if (!tid) {
+        return;
+    }
+
+    name = dump_tasks[tid - 1u].name;
+    for (i = 0; i < sizeof(uint64_t); ++i) {
+        name[i] = (char)(packed >> (i * 8u));
+    }
+    name[sizeof(uint64_t)] = '\0';
+}
+
+static int dump_json(const char *path, const k_trace_event_t *event, size_t cnt)
+{
+    FILE *fp;
+    size_t i;
+    uint32_t tid, running = 0u;
+    uint64_t origin;
+    double ts;
+
+    fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    // names first, a task created before the oldest event in the buffer keeps its address as name
+    for (i = 0; i < cnt; ++i) {
+        if (event[i].type == K_TRACE_EVENT_TASK_CREATE) {
+            dump_task_name(event[i].obj, event[i].arg);
+        } else if (event[i].type == K_TRACE_EVENT_TASK_SWITCH) {
+            dump_task_tid(event[i].obj);
+            dump_task_tid(event[i].arg);
+        }
+    }
+
+    origin = cnt ? event[0].timestamp : 0u;
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"TobudOS\"}}");
+    fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"kernel\"}}");
+    for (i = 0; i < dump_task_cnt; ++i) {
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    (unsigned)i + 1u, dump_tasks[i].name);
+    }
+
+    for (i = 0; i < cnt; ++i) {
+        ts = (double)(event[i].timestamp - origin) / 1000.0;
+
+        switch (event[i].type) {
+            case K_TRACE_EVENT_TASK_SWITCH:
+                // a slice per task, from switched in to switched out
+                if (running) {
+                    fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                dump_tasks[running - 1u].name, running, ts);
+                }
+                running = dump_task_tid(event[i].arg);
+                if (running) {
+                    fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                dump_tasks[running - 1u].name, running, ts);
+                }
+                break;
+
+            case K_TRACE_EVENT_PEND:
+            case K_TRACE_EVENT_WAKEUP:
+                // on the lane of the task blocked/waken up
+                tid = dump_task_tid(event[i].arg);
+                fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                            "\"args\":{\"obj\":\"0x%llx\",\"info\":%u}}",
+                            event_name[event[i].type], tid, ts,
+                            (unsigned long long)event[i].obj, (unsigned)event[i].info);
+                break;
+
+            case K_TRACE_EVENT_TICK:
+                fprintf(fp, ",\n{\"name\":\"tick\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":0,\"ts\":%.3f,"
+                            "\"args\":{\"tick\":%llu}}",
+                            ts, (unsigned long long)event[i].arg);
+                break;
+
+            case K_TRACE_EVENT_TASK_CREATE:
+            case K_TRACE_EVENT_MMHEAP_ALLOC:
+            case K_TRACE_EVENT_MMHEAP_FREE:
+            case K_TRACE_EVENT_TIMER_FIRE:
+            case K_TRACE_EVENT_POST:
+                // on the lane of whoever is running
+                fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                            "\"args\":{\"obj\":\"0x%llx\",\"arg\":\"0x%llx\"}}",
+                            event_name[event[i].type], running, ts,
+                            (unsigned long long)event[i].obj, (unsigned long long)event[i].arg);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+
+    return 0;
+}
+
+static int dump_convert(const char *bin_path, const char *json_path)
+{
+    FILE *fp;
+    size_t cnt;
+
+    fp = fopen(bin_path, "rb");
+    if (!fp) {
+        perror(bin_path);
+        return -1;
+    }
+
+    cnt = fread(events, sizeof(k_trace_event_t), K_TRACE_EVENT_NUM, fp);
+    fclose(fp);
+
+    printf("%u events read from %s\n", (unsigned)cnt, bin_path);
+
+    return dump_json(json_path, events, cnt);
+}
+
+static void timer_callback(void *arg)
+{
+    tos_sem_post(&sem);
+}
+
+static void entry_producer(void *arg)
+{
+    void *mem;
+
+    while (K_TRUE) {
+        mem = tos_mmheap_alloc(64u);
+        tos_sem_post(&sem);
+        tos_task_delay(5u);
+        tos_mmheap_free(mem);
+    }
+}
+
+static void entry_consumer(void *arg)
+{
+    while (K_TRUE) {
+        tos_sem_pend(&sem, TOS_TIME_FOREVER);
+    }
+}
+
+static void entry_ctrl(void *arg)
+{
+    FILE *fp;
+    size_t cnt;
+
+    tos_task_delay(tos_millisec2tick(DUMP_RUN_MS));
+
+    cnt = tos_trace_read(events, K_TRACE_EVENT_NUM);
+    printf("%u events traced, %u in the buffer\n", (unsigned)k_trace.head, (unsigned)cnt);
+
+    fp = fopen("trace.bin", "wb");
+    if (fp) {
+        fwrite(events, sizeof(k_trace_event_t), cnt, fp);
+        fclose(fp);
+    }
+
+    if (dump_json("trace.json", events, cnt) == 0) {
+        printf("trace.bin & trace.json written\n");
+    }
+
+    exit(0);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && strcmp(argv[1], "-c") == 0) {
+        return dump_convert(argv[2], argv[3]) == 0 ? 0 : 1;
+    }
+
+    tos_knl_init();
+
+    tos_sem_create(&sem, 0);
+    tos_timer_create(&timer, 7u, 7u, timer_callback, K_NULL, TOS_OPT_TIMER_PERIODIC);
+    tos_timer_start(&timer);
+
+    tos_task_create(&task_ctrl, "ctrl", entry_ctrl, K_NULL,
+                        1, stk_ctrl, sizeof(stk_ctrl), 0);
+    tos_task_create(&task_consumer, "consumer", entry_consumer, K_NULL,
+                        3, stk_consumer, sizeof(stk_consumer), 0);
+    tos_task_create(&task_producer, "producer", entry_producer, K_NULL,
+                        4, stk_producer, sizeof(stk_producer), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * soak of the virtual time mode(TOS_CFG_VIRTUAL_TIME_EN): SOAK_TASK_NUM tasks sleep random delays,
+ * a periodic soft timer fires every SOAK_TIMER_PERIOD ticks, for SOAK_HOURS hours of virtual time.
+ * every wakeup(task and tick) and every timer fire is folded into a FNV-1a hash, a task waking up
+ * on any other tick than the one it asked for is counted as late.
+ * the hash must be the same on every run, and with both engines(list or timing wheel).
+ */
+
+#define SOAK_HOURS              3u
+#define SOAK_TICKS              ((k_tick_t)SOAK_HOURS * 3600u * TOS_CFG_CPU_TICK_PER_SECOND)
+#define SOAK_TASK_NUM           4u
+#define SOAK_DELAY_MAX          50u
+#define SOAK_TIMER_PERIOD       7u
+
+#define STK_SIZE                (16u * 1024u)
+
+static k_stack_t stk_soak[SOAK_TASK_NUM][STK_SIZE];
+static k_task_t task_soak[SOAK_TASK_NUM];
+
+static k_stack_t stk_main[STK_SIZE];
+static k_task_t task_main;
+
+static k_timer_t timer_soak;
+
+static uint64_t soak_hash = 0xcbf29ce484222325ull;
+static uint64_t soak_wakeups = 0u, soak_fires = 0u, soak_late = 0u;
+
+static void hash_add(uint64_t value)
+{
+    uint32_t i;
+
+    for (i = 0; i < 8u; ++i) {
+        soak_hash ^= (value >> (i * 8u)) & 0xffu;
+        soak_hash *= 0x100000001b3ull;
+    }
+}
+
+static uint64_t wall_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void timer_soak_callback(void *arg)
+{
+    ++soak_fires;
+    hash_add(0xffu);
+    hash_add(k_tick_count);
+}
+
+static void entry_soak(void *arg)
+{
+    uint32_t id = (uint32_t)(cpu_addr_t)arg, seed = 0x9e3779b9u * (id + 1u);
+    k_tick_t delay, expires;
+
+    while (K_TRUE) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        delay = (k_tick_t)(seed % SOAK_DELAY_MAX) + 1u;
+
+        expires = k_tick_count + delay;
+        tos_task_delay(delay);
+
+        if (k_tick_count != expires) {
+            ++soak_late;
+        }
+        ++soak_wakeups;
+        hash_add(id);
+        hash_add(k_tick_count);
+    }
+}
+
+static void entry_main(void *arg)
+{
+    uint64_t begin, ns;
+    uint32_t i;
+
+    printf("virtual time soak, %s engines, %u hours\n",
+                TOS_CFG_TICK_WHEEL_EN > 0u ? "wheel" : "list", (unsigned)SOAK_HOURS);
+
+    begin = wall_now_ns();
+
+    tos_timer_create(&timer_soak, SOAK_TIMER_PERIOD, SOAK_TIMER_PERIOD, timer_soak_callback, K_NULL,
+                        TOS_OPT_TIMER_PERIODIC);
+    tos_timer_start(&timer_soak);
+
+    for (i = 0; i < SOAK_TASK_NUM; ++i) {
+        tos_task_create(&task_soak[i], "soak", entry_soak, (void *)(cpu_addr_t)i,
+                            3, stk_soak[i], sizeof(stk_soak[i]), 0);
+    }
+
+    tos_task_delay(SOAK_TICKS);
+
+    ns = wall_now_ns() - begin;
+
+    printf("%llu ticks in %.2f s, %llu task wakeups(%llu late), %llu timer fires\n",
+            (unsigned long long)k_tick_count, (double)ns / 1e9, (unsigned long long)soak_wakeups,
+            (unsigned long long)soak_late, (unsigned long long)soak_fires);
+    printf("event hash %016llx\n", (unsigned long long)soak_hash);
+
+    exit(soak_late == 0u && soak_fires == SOAK_TICKS / SOAK_TIMER_PERIOD ? 0 : 1);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_task_create(&task_main, "main", entry_main, K_NULL,
+                        2, stk_main, sizeof(stk_main), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
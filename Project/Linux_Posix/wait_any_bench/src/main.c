@@ -0,0 +1,144 @@
+#include "tos_k.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * a gateway task services a message queue, a semaphore and an event, a producer posts to them
+ * in turn and waits for the gateway to ack, the time from post to ack is the latency:
+ *  - polling: the gateway pends each object with TOS_TIME_NOWAIT, sleeps a tick if none is ready
+ *  - wait any: the gateway blocks in tos_wait_any on all three, then takes the one ready
+ */
+
+#define BENCH_ROUNDS            1000u
+
+#define EVENT_RX                (k_event_flag_t)(1u << 0)
+
+#define STK_SIZE                (64u * 1024u)
+
+static k_stack_t stk_producer[STK_SIZE];
+static k_stack_t stk_gateway[STK_SIZE];
+
+static k_task_t task_producer;
+static k_task_t task_gateway;
+
+static k_msg_q_t msg_q;
+static void *msg_pool[4];
+static k_sem_t sem;
+static k_event_t event;
+
+static k_sem_t sem_ack;
+
+static volatile int use_wait_any = K_FALSE;
+static uint32_t serviced[3];
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// take what object idx has, K_TRUE if there was anything
+static int gateway_take(uint32_t idx)
+{
+    void *msg;
+    k_event_flag_t flag;
+
+    if (idx == 0u) {
+        return tos_msg_q_pend(&msg_q, &msg, TOS_TIME_NOWAIT) == K_ERR_NONE;
+    } else if (idx == 1u) {
+        return tos_sem_pend(&sem, TOS_TIME_NOWAIT) == K_ERR_NONE;
+    }
+    return tos_event_pend(&event, EVENT_RX, &flag, TOS_TIME_NOWAIT,
+                            TOS_OPT_EVENT_PEND_ANY | TOS_OPT_EVENT_PEND_CLR) == K_ERR_NONE;
+}
+
+static void entry_gateway(void *arg)
+{
+    uint32_t i, ready;
+    pend_obj_t *objects[3] = { &msg_q.pend_obj, &sem.pend_obj, &event.pend_obj };
+
+    while (K_TRUE) {
+        if (use_wait_any) {
+            if (tos_wait_any(objects, 3u, TOS_TIME_FOREVER, &ready) != K_ERR_NONE) {
+                continue;
+            }
+            if (gateway_take(ready)) {
+                ++serviced[ready];
+                tos_sem_post(&sem_ack);
+            }
+            continue;
+        }
+
+        for (i = 0; i < 3u; ++i) {
+            if (gateway_take(i)) {
+                ++serviced[i];
+                tos_sem_post(&sem_ack);
+                break;
+            }
+        }
+        if (i == 3u) {
+            tos_task_delay(1);
+        }
+    }
+}
+
+static void bench_run(const char *name)
+{
+    uint32_t i;
+    uint64_t begin, ns = 0u;
+
+    serviced[0] = serviced[1] = serviced[2] = 0u;
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        begin = bench_now_ns();
+
+        if (i % 3u == 0u) {
+            tos_msg_q_post(&msg_q, (void *)&msg_q);
+        } else if (i % 3u == 1u) {
+            tos_sem_post(&sem);
+        } else {
+            tos_event_post_keep(&event, EVENT_RX);
+        }
+        tos_sem_pend(&sem_ack, TOS_TIME_FOREVER);
+
+        ns += bench_now_ns() - begin;
+    }
+
+    printf("%-10s latency %10.1f us(msg_q %u, sem %u, event %u)\n", name, (double)ns / BENCH_ROUNDS / 1000.0,
+                (unsigned)serviced[0], (unsigned)serviced[1], (unsigned)serviced[2]);
+}
+
+static void entry_producer(void *arg)
+{
+    bench_run("polling");
+
+    use_wait_any = K_TRUE;
+    // wait for the gateway to finish its sleep and block in tos_wait_any
+    tos_task_delay(2);
+
+    bench_run("wait any");
+
+    exit(0);
+}
+
+int main(void)
+{
+    tos_knl_init();
+
+    tos_msg_q_create(&msg_q, msg_pool, sizeof(msg_pool) / sizeof(msg_pool[0]));
+    tos_sem_create(&sem, 0);
+    tos_event_create(&event, (k_event_flag_t)0u);
+    tos_sem_create(&sem_ack, 0);
+
+    tos_task_create(&task_gateway, "gateway", entry_gateway, K_NULL,
+                        3, stk_gateway, sizeof(stk_gateway), 0);
+    tos_task_create(&task_producer, "producer", entry_producer, K_NULL,
+                        4, stk_producer, sizeof(stk_producer), 0);
+
+    tos_knl_start();
+
+    return 0;
+}
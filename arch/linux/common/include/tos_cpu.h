@@ -20,6 +20,21 @@
 
 typedef void (*task_code)( void * );
 
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+
+typedef struct cpu_context_st {
+    ucontext_t *uc;         /* the task really runs on its stack, below this context */
+    k_stack_t *stk_alloc;   /* the stack allocated by the port if the task one is too small, or K_NULL */
+    pthread_t thread_id;    /* every task runs on the main thread */
+    task_code entry;
+    task_code exit;
+    void *arg;
+    uint32_t int_nest;      /* interrupt disable nesting of the task, saved when switched out */
+    uint32_t irq_nest;      /* non-zero if the task is switched out in an interrupt handler */
+} cpu_context_t;
+
+#else
+
 typedef struct cpu_context_st {
     pthread_t thread_id;
     task_code entry;
@@ -27,6 +42,8 @@ typedef struct cpu_context_st {
     void *arg;
 } cpu_context_t;
 
+#endif
+
 __API__ uint32_t        tos_cpu_clz(uint32_t val);
 
 __API__ void            tos_cpu_int_disable(void);
@@ -69,6 +86,12 @@ __KNL__ k_stack_t      *cpu_task_stk_init(void *entry,
                                                           k_stack_t *stk_base,
                                                           size_t stk_size);
 
+#if TOS_CFG_CPU_TASK_STK_DEINIT_EN > 0u
+
+__KNL__ void            cpu_task_stk_deinit(k_task_t *task);
+
+#endif
+
 #if TOS_CFG_TICKLESS_EN > 0u
 
 __KNL__ void            cpu_systick_resume(void);
@@ -87,6 +110,46 @@ __KNL__ void            cpu_systick_reset(void);
 
 #endif
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+__KNL__ uint64_t        cpu_task_runtime_get(k_task_t *task);
+
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+
+__KNL__ uint64_t        cpu_trace_clock_get(void);
+
+#endif
+
+#if TOS_CFG_SMP_EN > 0u
+
+__KNL__ uint32_t        cpu_id_get(void);
+
+__KNL__ void            cpu_ipi_send(uint32_t cpu_id);
+
+__KNL__ void            cpu_relax(void);
+
+#endif
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+
+__KNL__ void            cpu_virtual_time_stall(void);
+
+#endif
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__KNL__ void            cpu_hrtimer_deadline_init(void);
+
+__KNL__ uint64_t        cpu_hrtimer_clock_get(void);
+
+__KNL__ void            cpu_hrtimer_deadline_set(uint64_t deadline);
+
+__KNL__ void            cpu_hrtimer_deadline_cancel(void);
+
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0u
 
 __KNL__ void            cpu_sleep_mode_enter(void);
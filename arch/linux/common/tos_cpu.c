@@ -172,6 +172,124 @@ __KNL__ void cpu_systick_reset(void)
 
 #endif /* TOS_CFG_TICKLESS_EN */
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+/**
+ * @brief Get the runtime clock of a task, only the difference of two readings makes sense
+ *
+ * @param task The task, every task is simulated by a thread
+ *
+ * @return CPU time consumed by the thread of the task, in nanosecond
+ */
+__KNL__ uint64_t cpu_task_runtime_get(k_task_t *task)
+{
+    cpu_context_t *context = (cpu_context_t *)task->sp;
+
+    return port_thread_runtime_get(context->thread_id);
+}
+
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+
+/**
+ * @brief Get the timestamp for the trace events
+ *
+ * @return time of the monotonic clock, in nanosecond
+ */
+__KNL__ uint64_t cpu_trace_clock_get(void)
+{
+    return port_trace_clock_get();
+}
+
+#endif
+
+#if TOS_CFG_SMP_EN > 0u
+
+/**
+ * @brief Get the id of the calling cpu
+ *
+ * @return every cpu is simulated by a thread, the index of the thread
+ */
+__KNL__ uint32_t cpu_id_get(void)
+{
+    return port_cpu_id_get();
+}
+
+/**
+ * @brief Send an IPI to a cpu, the cpu reschedules when it comes
+ *
+ * @param cpu_id The cpu to interrupt
+ *
+ * @return None
+ */
+__KNL__ void cpu_ipi_send(uint32_t cpu_id)
+{
+    port_ipi_send(cpu_id);
+}
+
+/**
+ * @brief Called while spinning on a lock or idle, let the other cpus(threads) go on
+ *
+ * @return None
+ */
+__KNL__ void cpu_relax(void)
+{
+    port_cpu_relax();
+}
+
+#endif
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+
+/**
+ * @brief Called by the idle task when every task waits for something never going to expire
+ *
+ * @return None
+ */
+__KNL__ void cpu_virtual_time_stall(void)
+{
+    port_virtual_time_stall();
+}
+
+#endif
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__KNL__ void cpu_hrtimer_deadline_init(void)
+{
+    port_hrtimer_deadline_init();
+}
+
+/**
+ * @brief Get the time of the monotonic high resolution clock
+ *
+ * @return time in nanosecond
+ */
+__KNL__ uint64_t cpu_hrtimer_clock_get(void)
+{
+    return port_hrtimer_clock_get();
+}
+
+/**
+ * @brief Program the deadline interrupt, tos_hrtimer_handler should be called when the deadline comes
+ *
+ * @param deadline The deadline in nanosecond, on the clock of cpu_hrtimer_clock_get
+ *
+ * @return None
+ */
+__KNL__ void cpu_hrtimer_deadline_set(uint64_t deadline)
+{
+    port_hrtimer_deadline_set(deadline);
+}
+
+__KNL__ void cpu_hrtimer_deadline_cancel(void)
+{
+    port_hrtimer_deadline_cancel();
+}
+
+#endif /* TOS_CFG_HRTIMER_EN */
+
 #if TOS_CFG_PWR_MGR_EN > 0u
 
 __KNL__ void cpu_sleep_mode_enter(void)
@@ -200,7 +318,7 @@ __KNL__ k_stack_t *cpu_task_stk_init(void *entry,
     cpu_context_t *sp;
 
     sp = (cpu_context_t *)&stk_base[stk_size];
-    sp = (cpu_context_t *)(((cpu_addr_t)sp & 0xFFFFFFFFFFFFFFF8)-sizeof(cpu_context_t));
+    sp = (cpu_context_t *)(((cpu_addr_t)sp & ~(cpu_addr_t)0x7)-sizeof(cpu_context_t));
 
 #if TOS_CFG_TASK_STACK_DRAUGHT_DEPTH_DETACT_EN > 0u
     uint8_t *slot = (uint8_t *)&stk_base[0];
@@ -212,11 +330,28 @@ __KNL__ k_stack_t *cpu_task_stk_init(void *entry,
     sp->entry = entry;
     sp->arg = arg;
     sp->exit = exit;
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+    port_context_init(sp, stk_base, (uint8_t *)sp - (uint8_t *)stk_base);
+#else
     sp->thread_id = port_create_thread(sp);
+#endif
 
     return (k_stack_t *)sp;
 }
 
+#if TOS_CFG_CPU_TASK_STK_DEINIT_EN > 0u
+
+__KNL__ void cpu_task_stk_deinit(k_task_t *task)
+{
+#if TOS_CFG_SMP_EN > 0u
+    port_context_deinit(task->sp, smp_task_is_running(task), task->cpu_id);
+#else
+    port_context_deinit(task->sp, knl_is_self(task), 0u);
+#endif
+}
+
+#endif
+
 #if TOS_CFG_TASK_STACK_DRAUGHT_DEPTH_DETACT_EN > 0u
 
 __KNL__ k_err_t cpu_task_stack_draught_depth(k_stack_t *stk_base, size_t stk_size, int *depth)
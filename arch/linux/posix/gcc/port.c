@@ -53,11 +53,20 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <limits.h>
-
-extern k_task_t            *k_curr_task;
-extern k_task_t            *k_next_task;
+#include <string.h>
+#include <sys/syscall.h>
+#include <semaphore.h>
+#include <linux/futex.h>
 
 __PORT__ void _handle_tick_signal();
+__PORT__ void _tick_irq(void);
+#if TOS_CFG_HRTIMER_EN > 0u
+__PORT__ void _hrtimer_irq(void);
+#endif
+#if TOS_CFG_SMP_EN > 0u
+__PORT__ void _handle_ipi_signal();
+__PORT__ void _ipi_irq(void);
+#endif
 __PORT__ void _handle_context_switch();
 __PORT__ void _suspend_thread(pthread_t thread_id);
 __PORT__ void _resume_thread(pthread_t thread_id);
@@ -71,52 +80,563 @@ __PORT__ void _install_signal(int sig,void (*func)(int));
 __PORT__ void _filter_signal(sigset_t *sigset);
 __PORT__ uint64_t _get_time_ms(void);
 
-typedef struct {
-    sigset_t signal_mask;
-    uint32_t count;
-}interrupt_manager;
-
-interrupt_manager _int_manager={
-    .count = 0
-};
-
 static uint64_t tick_ms = 0;
+static uint32_t systick_period_usec = 0;
+static uint32_t systick_reload_usec = 0;
 static pthread_t main_thread_id;
-static pthread_mutex_t cpsr_mutex;
 
 #define CHECK_IS_MAIN_THREAD(main_thread_id) \
     if(main_thread_id != pthread_self()) return
 
+#if TOS_CFG_PWR_MGR_EN > 0u
+
+/*
+ * sleep modes: the idle task blocks on wkup_sem, every "interrupt" posts it.
+ * wkup_cnt counts the interrupts, an interrupt coming after the snapshot(taken when the wakeup
+ * alarm is armed, or when we woke up last time) makes the sleep return at once, just like
+ * what a WFI does with an interrupt pending.
+ */
+
+static sem_t wkup_sem;
+static volatile uint32_t wkup_cnt = 0;
+static volatile uint32_t wkup_snapshot = 0;
+
+#define PORT_WKUP_POST() \
+    do { \
+        __atomic_add_fetch(&wkup_cnt, 1u, __ATOMIC_RELAXED); \
+        sem_post(&wkup_sem); \
+    } while (0)
+
+#else
+
+#define PORT_WKUP_POST()
+
+#endif
+
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+
+/*
+ * single thread mode: the tasks are ucontexts on the main thread, a context switch is just a
+ * swapcontext.
+ * the "interrupts"(the tick & hrtimer signals) are never blocked, disabling them just counts
+ * int_nest up: a signal handler coming while int_nest is not 0(or in another handler) only
+ * records the interrupt as pending, and the one who enables the interrupts at last handles
+ * the pending ones, so a critical section costs no system call.
+ * the interrupt nesting goes with the task, so a task switched out in a handler gets its
+ * handler finished when switched back in.
+ */
+
+typedef struct port_cpu_st {
+    pthread_t           thread_id;      /* the thread simulating the cpu */
+    volatile uint32_t   int_nest;
+    volatile uint32_t   irq_nest;
+    volatile uint32_t   tick_pending;
+#if TOS_CFG_HRTIMER_EN > 0u
+    volatile uint32_t   hrtimer_pending;
+#endif
+#if TOS_CFG_SMP_EN > 0u
+    volatile uint32_t   ipi_pending;
+#endif
+    k_stack_t          *stk_dead;       /* stack allocated for a task destroyed while running here */
+} port_cpu_t;
+
+static port_cpu_t port_cpu[TOS_CFG_CPU_NUM];
+
+#if TOS_CFG_SMP_EN > 0u
+
+/*
+ * SMP: every cpu is a thread running the ucontexts of the tasks living on it, the main thread is
+ * cpu 0 and takes the tick.
+ * the outermost interrupt disable of a cpu takes the kernel lock too, the lock goes with the
+ * int_nest of the task: a task is always switched out and in with int_nest > 0, the cpu holds
+ * the lock through the switch and the task switched in releases it.
+ * a task may be switched in on another cpu than the one it was switched out(tos_task_affinity_set),
+ * so never keep a port_cpu_t pointer across a context switch.
+ */
+static __thread uint32_t port_cpu_id = 0;
+
+#define PORT_CPU_SELF()     (&port_cpu[port_cpu_id])
+
+#else
+
+#define PORT_CPU_SELF()     (&port_cpu[0])
+
+#endif
+
+#define PORT_IRQ_ENTER()    ++PORT_CPU_SELF()->irq_nest
+#define PORT_IRQ_LEAVE()    _irq_leave()
+
+#define PORT_IRQ_DEFER(pending) \
+    if (PORT_CPU_SELF()->int_nest > 0 || PORT_CPU_SELF()->irq_nest > 0) { \
+        __atomic_add_fetch(&PORT_CPU_SELF()->pending, 1u, __ATOMIC_RELAXED); \
+        return; \
+    }
+
+__STATIC__ void _irq_pending_handle(void)
+{
+    while (PORT_CPU_SELF()->tick_pending > 0) {
+        __atomic_sub_fetch(&PORT_CPU_SELF()->tick_pending, 1u, __ATOMIC_RELAXED);
+        _tick_irq();
+    }
+
+#if TOS_CFG_HRTIMER_EN > 0u
+    if (__atomic_exchange_n(&PORT_CPU_SELF()->hrtimer_pending, 0u, __ATOMIC_RELAXED) > 0) {
+        _hrtimer_irq();
+    }
+#endif
+
+#if TOS_CFG_SMP_EN > 0u
+    if (__atomic_exchange_n(&PORT_CPU_SELF()->ipi_pending, 0u, __ATOMIC_RELAXED) > 0) {
+        _ipi_irq();
+    }
+#endif
+}
+
+__STATIC__ void _irq_leave(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+
+    // an interrupt may come in a handler finished after a context switch(signals not blocked)
+    if (--cpu->irq_nest == 0 && cpu->int_nest == 0) {
+        _irq_pending_handle();
+    }
+}
+
+__PORT__ void port_int_disable(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+
+#if TOS_CFG_SMP_EN > 0u
+    if (cpu->int_nest++ == 0) {
+        tos_spin_lock(&k_knl_lock);
+    }
+#else
+    ++cpu->int_nest;
+#endif
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+__PORT__ void port_int_enable(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    if (cpu->int_nest == 0) {
+        return;
+    }
+
+#if TOS_CFG_SMP_EN > 0u
+    // release before int_nest goes 0, an interrupt handled in between would take the lock again
+    if (cpu->int_nest == 1) {
+        tos_spin_unlock(&k_knl_lock);
+    }
+#endif
+
+    if (--cpu->int_nest == 0 && cpu->irq_nest == 0) {
+        _irq_pending_handle();
+    }
+}
+
+__PORT__ cpu_cpsr_t port_cpsr_save(void)
+{
+    port_int_disable();
+    return (cpu_cpsr_t)PORT_CPU_SELF()->int_nest;
+}
+
+__PORT__ void port_cpsr_restore(cpu_cpsr_t cpsr)
+{
+    port_int_enable();
+}
+
+/* the task destroyed while running is switched out now, its stack can go */
+__STATIC__ void _stk_dead_free(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+
+    if (cpu->stk_dead) {
+        free(cpu->stk_dead);
+        cpu->stk_dead = K_NULL;
+    }
+}
+
+__STATIC__ void _context_entry(void)
+{
+    cpu_context_t *context = (cpu_context_t *)k_curr_task->sp;
+
+    _stk_dead_free();
+    port_int_enable();
+
+    context->entry(context->arg);
+    context->exit(context->arg);
+}
+
+__PORT__ void port_context_init(void *arg, k_stack_t *stk_base, size_t stk_size)
+{
+    cpu_context_t *context = (cpu_context_t *)arg;
+    k_stack_t *stk_alloc = K_NULL;
+    ucontext_t *uc;
+
+    if (stk_size < sizeof(ucontext_t) + PORT_UCONTEXT_STK_SIZE_MIN) {
+        /* freed by port_context_deinit when the task is destroyed */
+        stk_alloc = (k_stack_t *)malloc(PORT_UCONTEXT_STK_SIZE);
+        stk_base = stk_alloc;
+        stk_size = PORT_UCONTEXT_STK_SIZE;
+        if (!stk_base) {
+            printf("alloc task stack problem.\n");
+            exit(1);
+        }
+    }
+
+    /* the ucontext on the top of the stack, the task runs below it */
+    uc = (ucontext_t *)(((cpu_addr_t)&stk_base[stk_size] - sizeof(ucontext_t)) & ~(cpu_addr_t)0xF);
+
+    getcontext(uc);
+    uc->uc_stack.ss_sp = stk_base;
+    uc->uc_stack.ss_size = (uint8_t *)uc - (uint8_t *)stk_base;
+    uc->uc_link = NULL;
+    /* a task starts with the interrupts disabled, just like a task switched in from knl_sched,
+       and enables them in _context_entry.
+     */
+    sigdelset(&uc->uc_sigmask, SIG_TICK);
+#ifdef SIG_HRTIMER
+    sigdelset(&uc->uc_sigmask, SIG_HRTIMER);
+#endif
+#if TOS_CFG_SMP_EN > 0u
+    sigdelset(&uc->uc_sigmask, SIG_IPI);
+#endif
+    makecontext(uc, _context_entry, 0);
+
+    context->uc = uc;
+    context->stk_alloc = stk_alloc;
+    context->thread_id = main_thread_id;
+    context->int_nest = 1;
+    context->irq_nest = 0;
+}
+
+__PORT__ void port_context_deinit(void *arg, int is_running, uint32_t cpu_id)
+{
+    cpu_context_t *context = (cpu_context_t *)arg;
+
+    if (!context->stk_alloc) {
+        return;
+    }
+
+    if (is_running) {
+        // still on it, the task switched in next on its cpu frees it
+        port_cpu[cpu_id].stk_dead = context->stk_alloc;
+    } else {
+        free(context->stk_alloc);
+    }
+    context->stk_alloc = K_NULL;
+}
+
+__PORT__ pthread_t port_create_thread(void *arg)
+{
+    return main_thread_id;
+}
+
+__STATIC__ __NO_RETURN__ void _cpu_start(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+    cpu_context_t *context;
+
+    k_curr_task = k_next_task;
+    context = (cpu_context_t *)k_curr_task->sp;
+
+#if TOS_CFG_SMP_EN > 0u
+    // the task switched in releases the kernel lock, interrupts wait until then
+    cpu->int_nest = 1;
+    tos_spin_lock(&k_knl_lock);
+#endif
+
+    cpu->int_nest = context->int_nest;
+    cpu->irq_nest = context->irq_nest;
+    setcontext(context->uc);
+
+    while (1) {
+        ;
+    }
+}
+
+#if TOS_CFG_SMP_EN > 0u
+
+__STATIC__ void *_cpu_entry(void *arg)
+{
+    port_cpu_id = (uint32_t)(cpu_addr_t)arg;
+
+    _cpu_start();
+
+    return NULL;
+}
+
+#endif
+
+__PORT__ void port_sched_start(void)
+{
+#if TOS_CFG_SMP_EN > 0u
+    uint32_t i;
+    sigset_t all, old;
+
+    /* hold the kernel lock until all the cpus are created, so that an IPI never finds a cpu
+       without a thread.
+       the cpus are created with all the signals blocked(the mask is inherited), an IPI coming
+       before the cpu knows its id waits until the first task is switched in.
+     */
+    PORT_CPU_SELF()->int_nest = 1;
+    tos_spin_lock(&k_knl_lock);
+
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    for (i = 1; i < TOS_CFG_CPU_NUM; ++i) {
+        if (0 != pthread_create(&port_cpu[i].thread_id, NULL, _cpu_entry, (void *)(cpu_addr_t)i)) {
+            printf("create cpu %u problem.\n", (unsigned)i);
+            exit(1);
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    tos_spin_unlock(&k_knl_lock);
+#endif
+
+    _cpu_start();
+}
+
+__STATIC__ void _switch_context(void)
+{
+    port_cpu_t *cpu = PORT_CPU_SELF();
+    cpu_context_t *from, *to;
+
+    from = (cpu_context_t *)k_curr_task->sp;
+    to = (cpu_context_t *)k_next_task->sp;
+
+    from->int_nest = cpu->int_nest;
+    from->irq_nest = cpu->irq_nest;
+
+    k_curr_task = k_next_task;
+    cpu->int_nest = to->int_nest;
+    cpu->irq_nest = to->irq_nest;
+
+    swapcontext(from->uc, to->uc);
+
+    _stk_dead_free();
+}
+
+__PORT__ void port_context_switch(void)
+{
+    _switch_context();
+}
+
+__PORT__ void port_irq_context_switch(void)
+{
+    _switch_context();
+}
+
+#if TOS_CFG_SMP_EN > 0u
+
+__PORT__ uint32_t port_cpu_id_get(void)
+{
+    return port_cpu_id;
+}
+
+__PORT__ void port_ipi_send(uint32_t cpu_id)
+{
+    pthread_kill(port_cpu[cpu_id].thread_id, SIG_IPI);
+}
+
+__PORT__ void port_cpu_relax(void)
+{
+    /* the cpus may be more than the host cores, let the lock holder run */
+    sched_yield();
+}
+
+__PORT__ void _handle_ipi_signal()
+{
+    PORT_IRQ_DEFER(ipi_pending);
+    _ipi_irq();
+}
+
+__PORT__ void _ipi_irq(void)
+{
+    // nothing to do but reschedule, which tos_knl_irq_leave does
+    PORT_IRQ_ENTER();
+    tos_knl_irq_enter();
+    tos_knl_irq_leave();
+    PORT_IRQ_LEAVE();
+}
+
+#endif
+
+#else
+
+/*
+ * thread mode: every task is a thread, only the one of k_curr_task runs, the others wait in
+ * _wait_resume; the "interrupts"(the tick & hrtimer signals) are handled on the main thread.
+ * disabling the interrupts takes int_lock(0 free, 1 taken, 2 taken with waiters, a futex),
+ * int_nest of the thread counts the nesting, the signal masks are never touched, so a critical
+ * section costs two atomic operations and no system call.
+ * an interrupt coming while int_lock is taken is never waited for, it is recorded as pending
+ * and the one who releases int_lock handles it, on its own thread.
+ * a SIG_SUSPEND coming to a thread with int_nest > 0 is recorded in suspend_pending, the thread
+ * suspends itself when it enables the interrupts at last, so a suspended thread never holds
+ * int_lock.
+ */
+
+typedef struct port_int_st {
+    volatile uint32_t   lock;
+    volatile uint32_t   tick_pending;
+#if TOS_CFG_HRTIMER_EN > 0u
+    volatile uint32_t   hrtimer_pending;
+#endif
+} port_int_t;
+
+static port_int_t port_int = { 0 };
+
+static __thread volatile uint32_t int_nest = 0;
+static __thread volatile uint32_t suspend_pending = 0;
+
+#define PORT_IRQ_ENTER()
+#define PORT_IRQ_LEAVE()
+
+#define PORT_IRQ_DEFER(pending) \
+    __atomic_add_fetch(&port_int.pending, 1u, __ATOMIC_SEQ_CST); \
+    _irq_pending_try(); \
+    return;
+
+__STATIC__ int _int_lock_try(void)
+{
+    uint32_t lock = 0u;
+
+    return __atomic_compare_exchange_n(&port_int.lock, &lock, 1u, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+__STATIC__ void _suspend_pending_handle(void)
+{
+    if (suspend_pending) {
+        suspend_pending = 0;
+        _wait_resume();
+    }
+}
+
+/* called with int_nest 1 */
+__STATIC__ void _int_lock_take(void)
+{
+    uint32_t lock, take = 1u;
+
+    while (K_TRUE) {
+        lock = 0u;
+        if (__atomic_compare_exchange_n(&port_int.lock, &lock, take, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            return;
+        }
+
+        /* wait with int_nest 0: the tick may switch this task out meanwhile, then the SIG_SUSPEND
+           must park the thread at once instead of letting it run on as the current task.
+         */
+        int_nest = 0;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        _suspend_pending_handle();
+
+        if (lock == 2u ||
+            __atomic_compare_exchange_n(&port_int.lock, &lock, 2u, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            syscall(SYS_futex, &port_int.lock, FUTEX_WAIT_PRIVATE, 2u, NULL, NULL, 0);
+        }
+
+        // there may be other waiters, the one woken up takes it as contended
+        take = 2u;
+        int_nest = 1;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+__STATIC__ void _int_lock_release(void)
+{
+    if (__atomic_exchange_n(&port_int.lock, 0u, __ATOMIC_SEQ_CST) == 2u) {
+        syscall(SYS_futex, &port_int.lock, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+__STATIC__ int _irq_is_pending(void)
+{
+#if TOS_CFG_HRTIMER_EN > 0u
+    if (__atomic_load_n(&port_int.hrtimer_pending, __ATOMIC_SEQ_CST) > 0) {
+        return K_TRUE;
+    }
+#endif
+    return __atomic_load_n(&port_int.tick_pending, __ATOMIC_SEQ_CST) > 0;
+}
+
+__STATIC__ void _irq_pending_handle(void)
+{
+    while (port_int.tick_pending > 0) {
+        __atomic_sub_fetch(&port_int.tick_pending, 1u, __ATOMIC_SEQ_CST);
+        _tick_irq();
+    }
+
+#if TOS_CFG_HRTIMER_EN > 0u
+    if (__atomic_exchange_n(&port_int.hrtimer_pending, 0u, __ATOMIC_SEQ_CST) > 0) {
+        _hrtimer_irq();
+    }
+#endif
+}
+
+/* an interrupt on the main thread, handled now if int_lock is free, or by its holder */
+__STATIC__ void _irq_pending_try(void)
+{
+    if (int_nest > 0) {
+        // came in the middle of the main thread handling the pending ones, it goes on with this one
+        return;
+    }
+
+    int_nest = 1;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    if (_int_lock_try()) {
+        port_int_enable();
+        return;
+    }
+
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    int_nest = 0;
+}
+
 __PORT__ void port_int_disable(void)
 {
-    sigset_t signal_mask,*manager_mask=NULL;
-    if(_int_manager.count == 0){
-        pthread_mutex_lock(&cpsr_mutex);
-        manager_mask = &(_int_manager.signal_mask);
-        sigfillset(&signal_mask);
-        _filter_signal(&signal_mask);
-        pthread_sigmask(SIG_BLOCK,&signal_mask,manager_mask);
+    if (int_nest++ == 0) {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        _int_lock_take();
     }
-    _int_manager.count ++;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
 }
 
 __PORT__ void port_int_enable(void)
 {
-    if(_int_manager.count == 0) return;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    if (int_nest == 0) {
+        return;
+    }
 
-    _int_manager.count--;
-    if(_int_manager.count == 0){
-        sigaddset(&(_int_manager.signal_mask),SIG_RESUME); //ensure SIG_RESUME is blocked
-        _filter_signal(&(_int_manager.signal_mask));
-        pthread_mutex_unlock(&cpsr_mutex);
-        pthread_sigmask(SIG_SETMASK,&(_int_manager.signal_mask),NULL);
+    if (int_nest > 1) {
+        --int_nest;
+        return;
     }
+
+    /* release with int_nest still 1, a SIG_SUSPEND coming in between is deferred. an interrupt
+       recorded after we handled the pending ones but before the release found int_lock taken,
+       so look again after the release, it is ours if int_lock is still free.
+     */
+    do {
+        _irq_pending_handle();
+        _int_lock_release();
+    } while (_irq_is_pending() && _int_lock_try());
+
+    int_nest = 0;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    _suspend_pending_handle();
 }
 
 __PORT__ cpu_cpsr_t port_cpsr_save(void)
 {
     port_int_disable();
-    return (cpu_cpsr_t)_int_manager.count;
+    return (cpu_cpsr_t)int_nest;
 }
 
 __PORT__ void port_cpsr_restore(cpu_cpsr_t cpsr)
@@ -127,7 +647,17 @@ __PORT__ void port_cpsr_restore(cpu_cpsr_t cpsr)
 __PORT__ pthread_t  port_create_thread(void *arg)
 {
     pthread_t thread_id;
+    sigset_t mask, old;
+
+    /* the mask is inherited: a task thread never takes the tick, the interval timer signal goes
+       to the main thread, and a SIG_RESUME coming before the thread waits for it must be kept.
+     */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIG_TICK);
+    sigaddset(&mask, SIG_RESUME);
+    pthread_sigmask(SIG_BLOCK, &mask, &old);
     pthread_create(&thread_id,NULL,_thread_entry,arg);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
     return thread_id;
 }
 
@@ -151,6 +681,8 @@ __PORT__ void port_irq_context_switch(void)
     raise(SIG_CONTEXT_SWITCH);
 }
 
+#endif /* TOS_CFG_CPU_UCONTEXT_EN */
+
 __PORT__ void port_cpu_reset(void)
 {
     printf("func %s\n",__FUNCTION__);
@@ -162,6 +694,14 @@ __PORT__ void port_systick_config(uint32_t cycle_per_tick)
     struct itimerval itimer, oitimer;
     uint32_t timeer_usec = cycle_per_tick/(TOS_CFG_CPU_CLOCK/1000000u);
 
+    systick_period_usec = timeer_usec;
+    systick_reload_usec = timeer_usec;
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+    /* the tick is driven by the idle task, see knl_virtual_time_advance */
+    return;
+#endif
+
     _install_signal(SIG_TICK,_handle_tick_signal);
 
 	/* Initialise the structure with the current timer information. */
@@ -190,10 +730,20 @@ __PORT__ void port_systick_config(uint32_t cycle_per_tick)
 __PORT__ void port_init(void)
 {
     main_thread_id = pthread_self();
-    pthread_mutex_init(&cpsr_mutex,NULL);
+#if TOS_CFG_PWR_MGR_EN > 0u
+    sem_init(&wkup_sem, 0, 0);
+#endif
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+    port_cpu[0].thread_id = main_thread_id;
+#endif
+#if TOS_CFG_SMP_EN > 0u
+    _install_signal(SIG_IPI, _handle_ipi_signal);
+#endif
+#if TOS_CFG_CPU_UCONTEXT_EN == 0u
     _install_signal(SIG_SUSPEND, _handle_suspend_thread);
     _install_signal(SIG_RESUME, _handle_resume_thread);
     _install_signal(SIG_CONTEXT_SWITCH, _handle_context_switch);
+#endif
 }
 
 __PORT__ void port_delay_ms(uint32_t ms)
@@ -220,7 +770,12 @@ __PORT__ void _install_signal(int sig,void (*func)(int))
 {
     struct sigaction sig_install;
 
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+    /* the tasks share the thread, a system call of a task should not fail for a tick */
+    sig_install.sa_flags = SA_RESTART;
+#else
     sig_install.sa_flags = 0;
+#endif
 	sig_install.sa_handler = func;
 	sigfillset( &sig_install.sa_mask );
 
@@ -232,15 +787,37 @@ __PORT__ void _install_signal(int sig,void (*func)(int))
 
 __PORT__ void _handle_tick_signal()
 {
+    PORT_WKUP_POST();
+#if TOS_CFG_SMP_EN > 0u
+    // the interval timer signal goes to any thread, while the tick belongs to cpu 0
+    if (!pthread_equal(main_thread_id, pthread_self())) {
+        pthread_kill(main_thread_id, SIG_TICK);
+        return;
+    }
+#endif
     CHECK_IS_MAIN_THREAD(main_thread_id);
+#if TOS_CFG_TICKLESS_EN > 0u
+    if (systick_reload_usec != systick_period_usec) {
+        // the wakeup alarm of tickless, just to wake the idle task up, tickless_leave fixes the tick
+        return;
+    }
+#endif
     tick_ms ++;
     if(tos_knl_is_running()) {
-        tos_knl_irq_enter();
-        tos_tick_handler();
-        tos_knl_irq_leave();
+        PORT_IRQ_DEFER(tick_pending);
+        _tick_irq();
     }
 }
 
+__PORT__ void _tick_irq(void)
+{
+    PORT_IRQ_ENTER();
+    tos_knl_irq_enter();
+    tos_tick_handler();
+    tos_knl_irq_leave();
+    PORT_IRQ_LEAVE();
+}
+
 __PORT__ void _suspend_thread(pthread_t thread_id)
 {
     pthread_kill(thread_id,SIG_SUSPEND);
@@ -277,6 +854,13 @@ __PORT__ void _wait_resume()
 
 __PORT__ void _handle_suspend_thread()
 {
+#if TOS_CFG_CPU_UCONTEXT_EN == 0u
+    // never park a thread in the critical section, port_int_enable does it
+    if (int_nest > 0) {
+        suspend_pending = 1;
+        return;
+    }
+#endif
     _wait_resume();
 }
 
@@ -302,29 +886,166 @@ __PORT__ void _handle_context_switch()
 
 #if TOS_CFG_TICKLESS_EN > 0u
 
-__PORT__ k_time_t port_systick_max_delay_millisecond(void)
+__STATIC__ void _systick_arm(uint32_t usec)
 {
+    struct itimerval itimer;
 
+    /* periodic as a systick, all zero disarms the timer */
+    itimer.it_interval.tv_sec = usec / 1000000u;
+    itimer.it_interval.tv_usec = usec % 1000000u;
+    itimer.it_value = itimer.it_interval;
+
+    if (0 != setitimer(TIMER_TYPE, &itimer, NULL)) {
+        printf("set timer problem.\n");
+    }
 }
 
-__PORT__ void port_systick_resume(void)
+__PORT__ k_time_t port_systick_max_delay_millisecond(void)
 {
+    /* cpu_systick_expires_set turns the delay into a k_cycle_t */
+    return (k_time_t)((uint64_t)(k_cycle_t)-1 * K_TIME_MILLISEC_PER_SEC / TOS_CFG_CPU_CLOCK);
+}
 
+__PORT__ void port_systick_resume(void)
+{
+    wkup_snapshot = wkup_cnt;
+    _systick_arm(systick_reload_usec);
 }
 
 __PORT__ void port_systick_suspend(void)
 {
-
+    _systick_arm(0u);
 }
 
 __PORT__ void port_systick_reload(uint32_t cycle_per_tick)
 {
-
+    systick_reload_usec = cycle_per_tick / (TOS_CFG_CPU_CLOCK / 1000000u);
 }
 
 __PORT__ void port_systick_pending_reset(void)
 {
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+    PORT_CPU_SELF()->tick_pending = 0;
+#else
+    port_int.tick_pending = 0;
+#endif
+}
+
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+__PORT__ uint64_t port_thread_runtime_get(pthread_t thread_id)
+{
+    clockid_t clock_id = CLOCK_THREAD_CPUTIME_ID;
+    struct timespec ts;
+
+    /* the switch may be done by the tick on the main thread, then we need the cpu-time clock
+       of another thread, which is just what CLOCK_THREAD_CPUTIME_ID is for the thread itself.
+     */
+    if (!pthread_equal(thread_id, pthread_self()) &&
+        pthread_getcpuclockid(thread_id, &clock_id) != 0) {
+        return 0u;
+    }
+
+    clock_gettime(clock_id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+
+__PORT__ uint64_t port_trace_clock_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+
+__PORT__ void port_virtual_time_stall(void)
+{
+    /* no interrupt in the virtual time, no one will ever wake up */
+    printf("all the tasks are blocked forever at tick %llu\n", (unsigned long long)k_tick_count);
+    exit(1);
+}
+
+#endif
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+static timer_t hrtimer_id;
+
+__PORT__ void _handle_hrtimer_signal()
+{
+    PORT_WKUP_POST();
+    CHECK_IS_MAIN_THREAD(main_thread_id);
+    PORT_IRQ_DEFER(hrtimer_pending);
+    _hrtimer_irq();
+}
+
+__PORT__ void _hrtimer_irq(void)
+{
+    PORT_IRQ_ENTER();
+    tos_knl_irq_enter();
+    tos_hrtimer_handler();
+    tos_knl_irq_leave();
+    PORT_IRQ_LEAVE();
+}
+
+__PORT__ void port_hrtimer_deadline_init(void)
+{
+    struct sigevent sev;
+
+    _install_signal(SIG_HRTIMER, _handle_hrtimer_signal);
+
+    /* the deadline "interrupt" must always come to the main thread, as the tick does */
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIG_HRTIMER;
+    sev._sigev_un._tid = syscall(SYS_gettid);
+
+    if (0 != timer_create(CLOCK_MONOTONIC, &sev, &hrtimer_id)) {
+        printf("create hrtimer problem.\n");
+    }
+}
+
+__PORT__ uint64_t port_hrtimer_clock_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+__PORT__ void port_hrtimer_deadline_set(uint64_t deadline)
+{
+    struct itimerspec its;
+
+    /* an all-zero it_value disarms the timer, the deadline must be in the future of 0 */
+    if (deadline == 0u) {
+        deadline = 1u;
+    }
+
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = deadline / 1000000000u;
+    its.it_value.tv_nsec = deadline % 1000000000u;
 
+    /* a deadline already passed fires immediately */
+    timer_settime(hrtimer_id, TIMER_ABSTIME, &its, NULL);
+}
+
+__PORT__ void port_hrtimer_deadline_cancel(void)
+{
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+    timer_settime(hrtimer_id, 0, &its, NULL);
 }
 
 #endif
@@ -333,17 +1054,29 @@ __PORT__ void port_systick_pending_reset(void)
 
 __PORT__ void port_sleep_mode_enter(void)
 {
+    // forget the interrupts we have already seen
+    while (sem_trywait(&wkup_sem) == 0) {
+        ;
+    }
 
+    if (wkup_cnt == wkup_snapshot) {
+        while (sem_wait(&wkup_sem) != 0 && errno == EINTR) {
+            ;
+        }
+    }
+
+    wkup_snapshot = wkup_cnt;
 }
 
+/* no deeper sleep on the host, the devices are suspended by pm_cpu_lpwr_mode_enter anyway */
 __PORT__ void port_stop_mode_enter(void)
 {
-
+    port_sleep_mode_enter();
 }
 
 __PORT__ void port_standby_mode_enter(void)
 {
-
+    port_sleep_mode_enter();
 }
 
 #endif
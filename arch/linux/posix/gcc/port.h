@@ -45,6 +45,21 @@
 
 #include <pthread.h>
 
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+#include <ucontext.h>
+
+/* a task stack smaller than this is too small to run on the host(a signal frame alone may take
+   several KB), such a task runs on a stack of PORT_UCONTEXT_STK_SIZE allocated by the port */
+#define PORT_UCONTEXT_STK_SIZE_MIN  (16u * 1024u)
+#define PORT_UCONTEXT_STK_SIZE      (64u * 1024u)
+
+/* a context is made on the shared stack every time the event-driven tasks are switched in,
+   it must be big enough not to be replaced by an allocated one */
+#if (TOS_CFG_EVENT_DRIVEN_EN > 0u) && (TOS_CFG_EVTDRV_STK_SIZE < PORT_UCONTEXT_STK_SIZE)
+#error  "INVALID config, TOS_CFG_EVTDRV_STK_SIZE must be >= PORT_UCONTEXT_STK_SIZE on the Linux port"
+#endif
+#endif
+
 #define SIG_SUSPEND					SIGUSR1
 #define SIG_RESUME					SIGUSR2
 #ifdef __APPLE__
@@ -54,6 +69,10 @@
 #define SIG_CONTEXT_SWITCH          SIGRTMIN
 #endif
 #define SIG_TICK					SIGALRM
+#ifndef __APPLE__
+#define SIG_HRTIMER                 (SIGRTMIN + 1)
+#define SIG_IPI                     (SIGRTMIN + 2)
+#endif
 #define TIMER_TYPE					ITIMER_REAL
 
 #if TOS_CFG_FAULT_BACKTRACE_EN > 0u
@@ -98,6 +117,14 @@ __PORT__ void       port_init(void);
 
 __PORT__ pthread_t  port_create_thread(void *arg);
 
+#if TOS_CFG_CPU_UCONTEXT_EN > 0u
+
+__PORT__ void       port_context_init(void *context, k_stack_t *stk_base, size_t stk_size);
+
+__PORT__ void       port_context_deinit(void *context, int is_running, uint32_t cpu_id);
+
+#endif
+
 __PORT__ void       port_delay_ms(uint32_t ms);
 
 #if TOS_CFG_TICKLESS_EN > 0u
@@ -114,6 +141,46 @@ __PORT__ k_time_t   port_systick_max_delay_millisecond(void);
 
 #endif
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+__PORT__ uint64_t   port_thread_runtime_get(pthread_t thread_id);
+
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+
+__PORT__ uint64_t   port_trace_clock_get(void);
+
+#endif
+
+#if TOS_CFG_SMP_EN > 0u
+
+__PORT__ uint32_t   port_cpu_id_get(void);
+
+__PORT__ void       port_ipi_send(uint32_t cpu_id);
+
+__PORT__ void       port_cpu_relax(void);
+
+#endif
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+
+__PORT__ void       port_virtual_time_stall(void);
+
+#endif
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__PORT__ void       port_hrtimer_deadline_init(void);
+
+__PORT__ uint64_t   port_hrtimer_clock_get(void);
+
+__PORT__ void       port_hrtimer_deadline_set(uint64_t deadline);
+
+__PORT__ void       port_hrtimer_deadline_cancel(void);
+
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0u
 
 __PORT__ void       port_sleep_mode_enter(void);
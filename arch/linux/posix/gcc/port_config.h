@@ -26,6 +26,34 @@
 #define TOS_CFG_CPU_LEAD_ZEROS_ASM_PRESENT      0u
 #define TOS_CFG_CPU_BYTE_ORDER                  CPU_BYTE_ORDER_LITTLE_ENDIAN
 
+/* 0: every task is simulated by a thread, switched by signals
+   1: all the tasks run on the main thread, each on a ucontext of its own, switched in user space
+ */
+#ifndef TOS_CFG_CPU_UCONTEXT_EN
+#if (TOS_CFG_VIRTUAL_TIME_EN > 0u) || (TOS_CFG_SMP_EN > 0u) || (TOS_CFG_EVENT_DRIVEN_EN > 0u)
+#define TOS_CFG_CPU_UCONTEXT_EN                 1u
+#else
+#define TOS_CFG_CPU_UCONTEXT_EN                 0u
+#endif
+#endif
+
+/* the ucontext mode allocates the stack of a task whose stack is too small, it goes when the task is destroyed */
+#define TOS_CFG_CPU_TASK_STK_DEINIT_EN          TOS_CFG_CPU_UCONTEXT_EN
+
+#if (TOS_CFG_VIRTUAL_TIME_EN > 0u) && (TOS_CFG_CPU_UCONTEXT_EN == 0u)
+#error  "INVALID config, virtual time needs the single thread mode(TOS_CFG_CPU_UCONTEXT_EN)"
+#endif
+
+/* SMP: every cpu is a thread, running the ucontexts of its tasks */
+#if (TOS_CFG_SMP_EN > 0u) && (TOS_CFG_CPU_UCONTEXT_EN == 0u)
+#error  "INVALID config, SMP needs the ucontext mode(TOS_CFG_CPU_UCONTEXT_EN)"
+#endif
+
+/* event-driven: a new context on the shared stack for every dispatch, a thread each is too much */
+#if (TOS_CFG_EVENT_DRIVEN_EN > 0u) && (TOS_CFG_CPU_UCONTEXT_EN == 0u)
+#error  "INVALID config, event-driven tasks need the ucontext mode(TOS_CFG_CPU_UCONTEXT_EN)"
+#endif
+
 #if (defined(__VFP_FP__) && !defined(__SOFTFP__))
 #define TOS_CFG_CPU_ARM_FPU_EN      1u
 #else
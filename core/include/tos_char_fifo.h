@@ -145,6 +145,68 @@ __API__ k_err_t tos_chr_fifo_pop(k_chr_fifo_t *chr_fifo, uint8_t *out);
  */
 __API__ int     tos_chr_fifo_pop_stream(k_chr_fifo_t *chr_fifo, uint8_t *buffer, size_t size);
 
+/**
+ * @brief Reserve space in character fifo.
+ * Hand out up to size free bytes of the character fifo to be written in place(for example by a dma
+ * engine), the bytes are pushed by tos_chr_fifo_commit.
+ *
+ * @attention only one producer may hold a reservation at a time, nothing else may push into the
+ *            character fifo until the reservation is committed.
+ *
+ * @param[in]   fifo        pointer to the handler of the character fifo.
+ * @param[in]   size        number of bytes wanted.
+ * @param[OUT]  span        the bytes reserved, in up to two regions.
+ *
+ * @return  the actual number of the bytes reserved.
+ */
+__API__ size_t  tos_chr_fifo_reserve(k_chr_fifo_t *chr_fifo, size_t size, k_ring_q_span_t *span);
+
+/**
+ * @brief Commit space reserved in character fifo.
+ * Push the first size bytes reserved by tos_chr_fifo_reserve.
+ *
+ * @attention None
+ *
+ * @param[in]   fifo        pointer to the handler of the character fifo.
+ * @param[in]   size        number of bytes written, not more than the ones reserved.
+ *
+ * @return  errno
+ * @retval  #K_ERR_RING_Q_ITEM_CNT_INVALID  the character fifo has not size bytes free.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_chr_fifo_commit(k_chr_fifo_t *chr_fifo, size_t size);
+
+/**
+ * @brief Peek data in character fifo.
+ * Hand out up to size bytes of the character fifo to be read in place(for example by a parser), the
+ * bytes are poped by tos_chr_fifo_release.
+ *
+ * @attention only one consumer may peek at a time, nothing else may pop from the character fifo until
+ *            the bytes peeked are released.
+ *
+ * @param[in]   fifo        pointer to the handler of the character fifo.
+ * @param[in]   size        number of bytes wanted.
+ * @param[OUT]  span        the bytes peeked, in up to two regions.
+ *
+ * @return  the actual number of the bytes peeked.
+ */
+__API__ size_t  tos_chr_fifo_peek(k_chr_fifo_t *chr_fifo, size_t size, k_ring_q_span_t *span);
+
+/**
+ * @brief Release data peeked in character fifo.
+ * Pop the first size bytes of the character fifo, after they are read in place.
+ *
+ * @attention None
+ *
+ * @param[in]   fifo        pointer to the handler of the character fifo.
+ * @param[in]   size        number of bytes read, not more than the ones peeked.
+ *
+ * @return  errno
+ * @retval  #K_ERR_RING_Q_ITEM_CNT_INVALID  the character fifo has not size bytes.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_chr_fifo_release(k_chr_fifo_t *chr_fifo, size_t size);
+
 /**
  * @brief Flush character fifo.
  * Flush/reset the character fifo.
@@ -33,6 +33,9 @@
 /* function with __PORT__ is architecture depended */
 #define __PORT__
 
+/* __MEMORY_BARRIER__(): loads and stores before it are not reordered with the ones after it, except
+   a store before it with a load after it, good enough to publish data to a lock-free reader */
+
 /* CPP header guards */
 #ifdef __cplusplus
 #define __CDECLS_BEGIN          extern "C" {
@@ -69,6 +72,8 @@
 #define __CONST__           __attribute__((__const__))
 #define __NO_RETURN__       __attribute__((__noreturn__))
 #define __WEAK__            __attribute__((weak))
+#define __MEMORY_BARRIER__()    __dmb(0xF)
+#define __RETURN_ADDRESS__()    __return_address()
 
 /*------------------ ARM Compiler V6 -------------------*/
 #elif defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
@@ -93,6 +98,8 @@
 #define __NO_RETURN__       __attribute__((__noreturn__))
 #define __NAKED__           __attribute__((naked))
 #define __WEAK__            __attribute__((weak))
+#define __MEMORY_BARRIER__()    __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#define __RETURN_ADDRESS__()    __builtin_return_address(0)
 
 /*------------------ ICC Compiler ----------------------*/
 #elif defined(__ICCARM__)  || defined(__ICC430__) // __IAR_SYSTEMS_ICC__
@@ -115,6 +122,8 @@
 #define __NO_RETURN__
 #define __NAKED__
 #define __WEAK__            __weak
+#define __MEMORY_BARRIER__()    __ASM__ __VOLATILE__("" ::: "memory")
+#define __RETURN_ADDRESS__()    ((void *)0) // no intrinsic for it, every call comes from one place
 
 /*------------------ ICC Compiler for STM8/AVR ----------------------*/
 #elif defined(__IAR_SYSTEMS_ICC__)
@@ -137,6 +146,8 @@
 #define __NO_RETURN__
 #define __NAKED__
 #define __WEAK__            __weak
+#define __MEMORY_BARRIER__()    __ASM__ __VOLATILE__("" ::: "memory")
+#define __RETURN_ADDRESS__()    ((void *)0) // no intrinsic for it, every call comes from one place
 
 /*------------------ GNU Compiler ----------------------*/
 #elif defined(__GNUC__)
@@ -159,6 +170,8 @@
 #define __NO_RETURN__       __attribute__((__noreturn__))
 #define __NAKED__           __attribute__((naked))
 #define __WEAK__            __attribute__((weak))
+#define __MEMORY_BARRIER__()    __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#define __RETURN_ADDRESS__()    __builtin_return_address(0)
 
 #endif
 
@@ -76,6 +76,28 @@ __API__ k_err_t tos_completion_destroy(k_completion_t *completion);
  */
 __API__ k_err_t tos_completion_pend_timed(k_completion_t *completion, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a completion with a nanosecond timeout.
+ * pend a completion, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention None
+ *
+ * @param[in]   completion  pointer to the handler of the completion.
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the completion we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_completion_pend_ns(k_completion_t *completion, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Pend a completion.
  * pend a completion.
@@ -30,22 +30,158 @@
 #endif
 #endif
 
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap cache requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && ((TOS_CFG_MMHEAP_CACHE_CLASS_NUM == 0u) || (TOS_CFG_MMHEAP_CACHE_CLASS_NUM > 8u))
+#error  "INVALID config, TOS_CFG_MMHEAP_CACHE_CLASS_NUM must be 1 to 8"
+#endif
+
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && (TOS_CFG_MMHEAP_CACHE_SLAB_CNT == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_MMHEAP_CACHE_SLAB_CNT"
+#endif
+
+#if     (TOS_CFG_MMHEAP_PROFILE_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap profiler requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMHEAP_PROFILE_EN > 0u) && (TOS_CFG_MMHEAP_PROFILE_SITE_NUM == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_MMHEAP_PROFILE_SITE_NUM"
+#endif
+
+#if     (TOS_CFG_MMHEAP_ARENA_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap arena requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMBLK_LOCKFREE_EN > 0u) && !(defined(__GNUC__) || defined(__clang__))
+#error  "INVALID config, lock-free mmblk pool requires the __atomic builtins of gcc or clang"
+#endif
+
+#if     (TOS_CFG_SLAB_EN > 0u) && !(TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u)
+#error  "INVALID config, kernel object slab requires TOS_CFG_OBJ_DYNAMIC_CREATE_EN"
+#endif
+
+#if     (TOS_CFG_SLAB_EN > 0u) && (TOS_CFG_SLAB_OBJ_CNT == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_SLAB_OBJ_CNT"
+#endif
+
+#if     TOS_CFG_EVTDRV_STK_SIZE == 0u
+#error  "INVALID config, must define a valid TOS_CFG_EVTDRV_STK_SIZE"
+#endif
+
+#if     (TOS_CFG_SMP_EN > 0u) || (TOS_CFG_EDF_EN > 0u)
+#error  "INVALID config, SMP and EDF not supported in event-driven yet"
+#endif
+
 #else /* TOS_CFG_EVENT_DRIVEN_EN */
 
 #if     TOS_CFG_TASK_PRIO_MAX < 8u
 #error  "INVALID config, TOS_CFG_TASK_PRIO_MAX must be >= 8"
 #endif
 
+#if     TOS_CFG_TASK_PRIO_MAX > 1024u
+#error  "INVALID config, TOS_CFG_TASK_PRIO_MAX must be <= 1024(32 slots of 32 priorities)"
+#endif
+
+#if     (TOS_CFG_TICK_WHEEL_EN > 0u) && \
+        ((TOS_CFG_TICK_WHEEL_SIZE == 0u) || ((TOS_CFG_TICK_WHEEL_SIZE & (TOS_CFG_TICK_WHEEL_SIZE - 1u)) != 0u))
+#error  "INVALID config, TOS_CFG_TICK_WHEEL_SIZE must be a power of 2"
+#endif
+
+#if     (TOS_CFG_WAIT_ANY_EN > 0u) && (TOS_CFG_WAIT_ANY_OBJ_MAX == 0u)
+#error  "INVALID config, TOS_CFG_WAIT_ANY_OBJ_MAX must be > 0"
+#endif
+
 #if     ((TOS_CFG_TIMER_EN > 0u) && !defined(TOS_CFG_TIMER_AS_PROC))
 #error  "UNDECLARED config, TOS_CFG_TIMER_AS_PROC"
 #endif
 
+#if     (TOS_CFG_TIMER_EN > 0u) && (TOS_CFG_TIMER_WHEEL_EN > 0u) && \
+        ((TOS_CFG_TIMER_WHEEL_SIZE == 0u) || ((TOS_CFG_TIMER_WHEEL_SIZE & (TOS_CFG_TIMER_WHEEL_SIZE - 1u)) != 0u))
+#error  "INVALID config, TOS_CFG_TIMER_WHEEL_SIZE must be a power of 2"
+#endif
+
+#if     (TOS_CFG_TRACE_EN > 0u) && \
+        ((TOS_CFG_TRACE_BUF_SIZE == 0u) || ((TOS_CFG_TRACE_BUF_SIZE & (TOS_CFG_TRACE_BUF_SIZE - 1u)) != 0u))
+#error  "INVALID config, TOS_CFG_TRACE_BUF_SIZE must be a power of 2"
+#endif
+
+#if     (TOS_CFG_EDF_EN > 0u) && (TOS_CFG_EDF_PRIO >= TOS_CFG_TASK_PRIO_MAX - 1u)
+#error  "INVALID config, TOS_CFG_EDF_PRIO must be higher than the idle priority"
+#endif
+
+#if     (TOS_CFG_EDF_EN > 0u) && ((TOS_CFG_EDF_UTIL_MAX == 0u) || (TOS_CFG_EDF_UTIL_MAX > 100u))
+#error  "INVALID config, TOS_CFG_EDF_UTIL_MAX must be in (0, 100]"
+#endif
+
+#if     (TOS_CFG_VIRTUAL_TIME_EN > 0u) && (TOS_CFG_TICKLESS_EN > 0u)
+#error  "INVALID config, virtual time and tickless cannot be enabled together"
+#endif
+
+#if     (TOS_CFG_VIRTUAL_TIME_EN > 0u) && (TOS_CFG_HRTIMER_EN > 0u)
+#error  "INVALID config, hrtimer runs on a real clock, cannot be enabled with virtual time"
+#endif
+
+#if     (TOS_CFG_SMP_EN > 0u) && ((TOS_CFG_CPU_NUM == 0u) || (TOS_CFG_CPU_NUM > 32u))
+#error  "INVALID config, TOS_CFG_CPU_NUM must be in [1, 32]"
+#endif
+
+#if     (TOS_CFG_SMP_EN > 0u) && ((TOS_CFG_ROUND_ROBIN_EN > 0u) || (TOS_CFG_EDF_EN > 0u))
+#error  "INVALID config, round robin and EDF are not supported in SMP yet"
+#endif
+
+#if     (TOS_CFG_SMP_EN > 0u) && \
+        ((TOS_CFG_PWR_MGR_EN > 0u) || (TOS_CFG_TICKLESS_EN > 0u) || (TOS_CFG_VIRTUAL_TIME_EN > 0u))
+#error  "INVALID config, power management, tickless and virtual time are not supported in SMP yet"
+#endif
+
+#if     (TOS_CFG_SMP_EN > 0u) && (TOS_CFG_TASK_RUNTIME_EN > 0u)
+#error  "INVALID config, task runtime accounting is not supported in SMP yet"
+#endif
+
 #if     (TOS_CFG_MMHEAP_EN > 0u) && (TOS_CFG_MMHEAP_DEFAULT_POOL_EN > 0u)
 #if     !defined(TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE) || (TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE == 0u)
 #error  "INVALID config, must define a valid TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE"
 #endif
 #endif
 
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap cache requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && ((TOS_CFG_MMHEAP_CACHE_CLASS_NUM == 0u) || (TOS_CFG_MMHEAP_CACHE_CLASS_NUM > 8u))
+#error  "INVALID config, TOS_CFG_MMHEAP_CACHE_CLASS_NUM must be 1 to 8"
+#endif
+
+#if     (TOS_CFG_MMHEAP_CACHE_EN > 0u) && (TOS_CFG_MMHEAP_CACHE_SLAB_CNT == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_MMHEAP_CACHE_SLAB_CNT"
+#endif
+
+#if     (TOS_CFG_MMHEAP_PROFILE_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap profiler requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMHEAP_PROFILE_EN > 0u) && (TOS_CFG_MMHEAP_PROFILE_SITE_NUM == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_MMHEAP_PROFILE_SITE_NUM"
+#endif
+
+#if     (TOS_CFG_MMHEAP_ARENA_EN > 0u) && (TOS_CFG_MMHEAP_EN == 0u)
+#error  "INVALID config, mmheap arena requires TOS_CFG_MMHEAP_EN"
+#endif
+
+#if     (TOS_CFG_MMBLK_LOCKFREE_EN > 0u) && !(defined(__GNUC__) || defined(__clang__))
+#error  "INVALID config, lock-free mmblk pool requires the __atomic builtins of gcc or clang"
+#endif
+
+#if     (TOS_CFG_SLAB_EN > 0u) && !(TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u)
+#error  "INVALID config, kernel object slab requires TOS_CFG_OBJ_DYNAMIC_CREATE_EN"
+#endif
+
+#if     (TOS_CFG_SLAB_EN > 0u) && (TOS_CFG_SLAB_OBJ_CNT == 0u)
+#error  "INVALID config, must define a valid TOS_CFG_SLAB_OBJ_CNT"
+#endif
+
 #ifndef  TOS_CFG_CPU_HRTIMER_EN
 #error  "UNDECLARED config, TOS_CFG_CPU_HRTIMER_EN should be declared in 'port_config.h'"
 #elif   (TOS_CFG_CPU_HRTIMER_EN > 0u) && !defined(TOS_CFG_CPU_HRTIMER_SIZE)
@@ -78,6 +78,15 @@
 /////////////////////////////////////////
 
 
+/////////////////////////////////////////
+// single cpu
+#ifdef TOS_CFG_CPU_NUM
+#undef  TOS_CFG_CPU_NUM
+#endif
+#define TOS_CFG_CPU_NUM                     1u
+/////////////////////////////////////////
+
+
 /////////////////////////////////////////
 // disable stack draught depth detact
 #ifdef TOS_CFG_TASK_STACK_DRAUGHT_DEPTH_DETACT_EN
@@ -96,6 +105,46 @@
 #ifndef TOS_CFG_MMHEAP_DEFAULT_POOL_EN
 #define TOS_CFG_MMHEAP_DEFAULT_POOL_EN          1u
 #endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_EN
+#define TOS_CFG_MMHEAP_CACHE_EN                 0u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_CLASS_NUM
+#define TOS_CFG_MMHEAP_CACHE_CLASS_NUM          5u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_SLAB_CNT
+#define TOS_CFG_MMHEAP_CACHE_SLAB_CNT           8u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_KEEP_CNT
+#define TOS_CFG_MMHEAP_CACHE_KEEP_CNT           8u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_PROFILE_EN
+#define TOS_CFG_MMHEAP_PROFILE_EN               0u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_PROFILE_SITE_NUM
+#define TOS_CFG_MMHEAP_PROFILE_SITE_NUM         16u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_ARENA_EN
+#define TOS_CFG_MMHEAP_ARENA_EN                 0u
+#endif
+
+#ifndef TOS_CFG_MMBLK_LOCKFREE_EN
+#define TOS_CFG_MMBLK_LOCKFREE_EN               0u
+#endif
+
+#ifndef TOS_CFG_SLAB_EN
+#define TOS_CFG_SLAB_EN                         0u
+#endif
+
+#ifndef TOS_CFG_SLAB_OBJ_CNT
+#define TOS_CFG_SLAB_OBJ_CNT                    4u
+#endif
 /////////////////////////////////////////
 
 
@@ -123,6 +172,26 @@
 #define TOS_CFG_TICKLESS_EN                 0u
 #endif
 
+#ifndef TOS_CFG_PEND_PRIO_BITMAP_EN
+#define TOS_CFG_PEND_PRIO_BITMAP_EN         0u
+#endif
+
+#ifndef TOS_CFG_WAIT_ANY_EN
+#define TOS_CFG_WAIT_ANY_EN                 0u
+#endif
+
+#if (TOS_CFG_WAIT_ANY_EN > 0u) && !defined(TOS_CFG_WAIT_ANY_OBJ_MAX)
+#define TOS_CFG_WAIT_ANY_OBJ_MAX            8u
+#endif
+
+#ifndef TOS_CFG_TASK_NOTIFY_EN
+#define TOS_CFG_TASK_NOTIFY_EN              0u
+#endif
+
+#ifndef TOS_CFG_RING_QUEUE_SPSC_EN
+#define TOS_CFG_RING_QUEUE_SPSC_EN          0u
+#endif
+
 
 /////////////////////////////////////////
 // we donot really need these, it's a compromise to the compiler.
@@ -136,6 +205,14 @@
 /////////////////////////////////////////
 
 
+/////////////////////////////////////////
+// the stack shared by all the event-driven tasks(tos_task_create_evtdrv)
+#ifndef TOS_CFG_EVTDRV_STK_SIZE
+#define TOS_CFG_EVTDRV_STK_SIZE             512u
+#endif
+/////////////////////////////////////////
+
+
 /////////////////////////////////////////
 
 #else /* TOS_CFG_EVENT_DRIVEN_EN */
@@ -188,6 +265,61 @@
 #define TOS_CFG_TIMER_AS_PROC               0u
 #endif
 
+#ifndef TOS_CFG_TIMER_WHEEL_EN
+#define  TOS_CFG_TIMER_WHEEL_EN             0u
+#endif
+
+#if (TOS_CFG_TIMER_WHEEL_EN > 0u) && !defined(TOS_CFG_TIMER_WHEEL_SIZE)
+#define  TOS_CFG_TIMER_WHEEL_SIZE           64u
+#endif
+
+#ifndef TOS_CFG_HRTIMER_EN
+#define  TOS_CFG_HRTIMER_EN                 0u
+#endif
+
+#ifndef TOS_CFG_EDF_EN
+#define  TOS_CFG_EDF_EN                     0u
+#endif
+
+#ifndef TOS_CFG_TRACE_EN
+#define  TOS_CFG_TRACE_EN                   0u
+#endif
+
+#if (TOS_CFG_TRACE_EN > 0u) && !defined(TOS_CFG_TRACE_BUF_SIZE)
+#define  TOS_CFG_TRACE_BUF_SIZE             1024u
+#endif
+
+#ifndef TOS_CFG_VIRTUAL_TIME_EN
+#define  TOS_CFG_VIRTUAL_TIME_EN            0u
+#endif
+
+#ifndef TOS_CFG_TASK_RUNTIME_EN
+#define  TOS_CFG_TASK_RUNTIME_EN            0u
+#endif
+
+#ifndef TOS_CFG_SMP_EN
+#define  TOS_CFG_SMP_EN                     0u
+#endif
+
+#if TOS_CFG_SMP_EN == 0u
+#undef   TOS_CFG_CPU_NUM
+#define  TOS_CFG_CPU_NUM                    1u
+#elif !defined(TOS_CFG_CPU_NUM)
+#define  TOS_CFG_CPU_NUM                    2u
+#endif
+
+#if (TOS_CFG_TASK_RUNTIME_EN > 0u) && !defined(TOS_CFG_TASK_RUNTIME_LOAD_WINDOW)
+#define  TOS_CFG_TASK_RUNTIME_LOAD_WINDOW   TOS_CFG_CPU_TICK_PER_SECOND
+#endif
+
+#if (TOS_CFG_EDF_EN > 0u) && !defined(TOS_CFG_EDF_PRIO)
+#define  TOS_CFG_EDF_PRIO                   (TOS_CFG_TASK_PRIO_MAX / 2u)
+#endif
+
+#if (TOS_CFG_EDF_EN > 0u) && !defined(TOS_CFG_EDF_UTIL_MAX)
+#define  TOS_CFG_EDF_UTIL_MAX               100u
+#endif
+
 #ifndef TOS_CFG_IDLE_TASK_STK_SIZE
 #define  TOS_CFG_IDLE_TASK_STK_SIZE         128u
 #endif
@@ -224,6 +356,34 @@
 #define  TOS_CFG_TASK_PRIO_MAX                  8u
 #endif
 
+#ifndef TOS_CFG_TICK_WHEEL_EN
+#define  TOS_CFG_TICK_WHEEL_EN                  0u
+#endif
+
+#if     (TOS_CFG_TICK_WHEEL_EN > 0u) && !defined(TOS_CFG_TICK_WHEEL_SIZE)
+#define  TOS_CFG_TICK_WHEEL_SIZE                64u
+#endif
+
+#ifndef TOS_CFG_PEND_PRIO_BITMAP_EN
+#define  TOS_CFG_PEND_PRIO_BITMAP_EN            0u
+#endif
+
+#ifndef TOS_CFG_WAIT_ANY_EN
+#define  TOS_CFG_WAIT_ANY_EN                    0u
+#endif
+
+#if     (TOS_CFG_WAIT_ANY_EN > 0u) && !defined(TOS_CFG_WAIT_ANY_OBJ_MAX)
+#define  TOS_CFG_WAIT_ANY_OBJ_MAX               8u
+#endif
+
+#ifndef TOS_CFG_TASK_NOTIFY_EN
+#define  TOS_CFG_TASK_NOTIFY_EN                 0u
+#endif
+
+#ifndef TOS_CFG_RING_QUEUE_SPSC_EN
+#define  TOS_CFG_RING_QUEUE_SPSC_EN             0u
+#endif
+
 #ifndef TOS_CFG_MMHEAP_EN
 #define TOS_CFG_MMHEAP_EN                       0u
 #endif
@@ -232,6 +392,46 @@
 #define TOS_CFG_MMHEAP_DEFAULT_POOL_EN          1u
 #endif
 
+#ifndef TOS_CFG_MMHEAP_CACHE_EN
+#define TOS_CFG_MMHEAP_CACHE_EN                 0u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_CLASS_NUM
+#define TOS_CFG_MMHEAP_CACHE_CLASS_NUM          5u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_SLAB_CNT
+#define TOS_CFG_MMHEAP_CACHE_SLAB_CNT           8u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_CACHE_KEEP_CNT
+#define TOS_CFG_MMHEAP_CACHE_KEEP_CNT           8u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_PROFILE_EN
+#define TOS_CFG_MMHEAP_PROFILE_EN               0u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_PROFILE_SITE_NUM
+#define TOS_CFG_MMHEAP_PROFILE_SITE_NUM         16u
+#endif
+
+#ifndef TOS_CFG_MMHEAP_ARENA_EN
+#define TOS_CFG_MMHEAP_ARENA_EN                 0u
+#endif
+
+#ifndef TOS_CFG_MMBLK_LOCKFREE_EN
+#define TOS_CFG_MMBLK_LOCKFREE_EN               0u
+#endif
+
+#ifndef TOS_CFG_SLAB_EN
+#define TOS_CFG_SLAB_EN                         0u
+#endif
+
+#ifndef TOS_CFG_SLAB_OBJ_CNT
+#define TOS_CFG_SLAB_OBJ_CNT                    4u
+#endif
+
 #ifndef TOS_CFG_PWR_MGR_EN
 #define TOS_CFG_PWR_MGR_EN                  0u
 #endif
@@ -72,6 +72,27 @@ __API__ k_err_t tos_countdownlatch_destroy(k_countdownlatch_t *countdownlatch);
  */
 __API__ k_err_t tos_countdownlatch_pend_timed(k_countdownlatch_t *countdownlatch, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a countdown-latch with a nanosecond timeout.
+ * pend a countdown-latch, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention The task will keep blocked until the countdown-latch is obtained or a timeout comes.
+ *
+ * @param[in]   countdownlatch  pointer to the handler of the countdown-latch.
+ * @param[in]   ns              how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_countdownlatch_pend_ns(k_countdownlatch_t *countdownlatch, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Pend a countdown-latch.
  * pend a countdown latch.
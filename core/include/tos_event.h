@@ -130,6 +130,33 @@ __API__ k_err_t tos_event_destroy_dyn(k_event_t *event);
  */
 __API__ k_err_t tos_event_pend(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_tick_t timeout, k_opt_t opt);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend an event with a nanosecond timeout.
+ * pend an event, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention if opt is TOS_OPT_EVENT_PEND_ANY, any of the flag_expect is set is ok;
+ *            if opt is TOS_OPT_EVENT_PEND_ALL�� must all the flag_expect is set is ok.
+ *
+ * @param[in]   event       pointer to the handler of the event.
+ * @param[in]   flag_expect the flag we expect from the event.
+ * @param[OUT]  flag_match  if we get the flag we expect, what exactly they are?
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ * @param[in]   opt         option for pend.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_EVENT_PEND_OPT_INVALID     opt is invalid
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the event we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_event_pend_ns(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_hrtime_t ns, k_opt_t opt);
+
+#endif
+
 /**
  * @brief Post an event.
  * post an event.
@@ -0,0 +1,84 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#ifndef _TOS_EVTDRV_H_
+#define  _TOS_EVTDRV_H_
+
+__CDECLS_BEGIN
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+
+/**
+ * message to an event-driven task, embed it in the message structure of your own.
+ * a message is linked into the task's queue as it is, nothing is copied, so it must stay alive
+ * and must not be posted again until the handler gets it.
+ */
+typedef struct k_evtdrv_msg_st {
+    k_list_t    list;
+} k_evtdrv_msg_t;
+
+/**
+ * handler of an event-driven task, it runs to completion on the shared stack and must not block.
+ *
+ * @param[in]   arg         argument given to tos_task_create_evtdrv.
+ * @param[in]   event       the events posted since the last dispatch, 0 if dispatched just for a message.
+ * @param[in]   msg         the oldest message posted, K_NULL if none.
+ */
+typedef void (*k_evtdrv_handler_t)(void *arg, k_event_flag_t event, k_evtdrv_msg_t *msg);
+
+/**
+ * @brief Post events to an event-driven task.
+ * the events are or-ed into the ones not handled yet, the task is dispatched with all of them.
+ *
+ * @attention could be called in interrupt context.
+ *
+ * @param[in]   task        pointer to the handler of the event-driven task.
+ * @param[in]   event       events to post.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_NOT_EVTDRV  the task is not an event-driven task.
+ * @retval  #K_ERR_NONE             return successfully.
+ */
+__API__ k_err_t tos_evtdrv_event_post(k_task_t *task, k_event_flag_t event);
+
+/**
+ * @brief Post a message to an event-driven task.
+ * the messages are queued in order, the task is dispatched once for every message.
+ *
+ * @attention could be called in interrupt context.
+ *
+ * @param[in]   task        pointer to the handler of the event-driven task.
+ * @param[in]   msg         the message to post.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_NOT_EVTDRV  the task is not an event-driven task.
+ * @retval  #K_ERR_NONE             return successfully.
+ */
+__API__ k_err_t tos_evtdrv_msg_post(k_task_t *task, k_evtdrv_msg_t *msg);
+
+__KNL__ void        evtdrv_task_entry(void *arg);
+
+__KNL__ void        evtdrv_task_idle(k_task_t *task);
+
+__KNL__ k_task_t   *evtdrv_task_next_get(k_task_t *task);
+
+#endif
+
+__CDECLS_END
+
+#endif /* _TOS_EVTDRV_H_ */
+
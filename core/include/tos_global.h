@@ -18,32 +18,76 @@
 #ifndef _TOS_GLOBAL_H_
 #define  _TOS_GLOBAL_H_
 
+#if TOS_CFG_SMP_EN > 0u
+
+/* kernel state of every cpu                    */
+extern k_cpu_t              k_cpu[TOS_CFG_CPU_NUM];
+
+/* the big kernel lock                          */
+extern k_spinlock_t         k_knl_lock;
+
+/* the per-cpu state below, of the calling cpu  */
+#define k_irq_nest_cnt          (k_cpu[cpu_id_get()].irq_nest_cnt)
+#define k_sched_lock_nest_cnt   (k_cpu[cpu_id_get()].sched_lock_nest_cnt)
+#define k_rdyq                  (k_cpu[cpu_id_get()].rdyq)
+#define k_curr_task             (k_cpu[cpu_id_get()].curr_task)
+#define k_next_task             (k_cpu[cpu_id_get()].next_task)
+
+#else
+
 /* interrupt nesting count                      */
 extern k_nesting_t          k_irq_nest_cnt;
 
 /* schedule lock nesting count                  */
 extern k_nesting_t          k_sched_lock_nest_cnt;
 
-/* kernel running state                         */
-extern knl_state_t          k_knl_state;
-
 /* ready queue of tasks                         */
 extern readyqueue_t         k_rdyq;
 
-/* ticks since boot up                          */
-extern k_tick_t             k_tick_count;
-
 /* current task                                 */
 extern k_task_t            *k_curr_task;
 /* next task to run                             */
 extern k_task_t            *k_next_task;
 
-/* idle task related stuff                      */
+#endif
+
+/* kernel running state                         */
+extern knl_state_t          k_knl_state;
+
+/* ticks since boot up                          */
+extern k_tick_t             k_tick_count;
+
+/* idle task related stuff(one for each cpu in SMP) */
+#if TOS_CFG_SMP_EN > 0u
+extern k_task_t             k_idle_task[TOS_CFG_CPU_NUM];
+#else
 extern k_task_t             k_idle_task;
+#endif
 extern k_stack_t            k_idle_task_stk[];
 extern k_stack_t           *const k_idle_task_stk_addr;
 extern size_t               const k_idle_task_stk_size;
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+/* the stack shared by all the event-driven tasks */
+extern k_stack_t            k_evtdrv_stk[];
+extern k_stack_t           *const k_evtdrv_stk_addr;
+extern size_t               const k_evtdrv_stk_size;
+/* the event-driven task whose handler is on the shared stack(running or preempted), K_NULL if none */
+extern k_task_t            *k_evtdrv_curr;
+#endif
+
+#if TOS_CFG_EDF_EN > 0u
+/* sum of the density(runtime / deadline) of all the EDF tasks, in K_EDF_DENSITY_ONE units */
+extern uint32_t             k_edf_density;
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+/* sum of the runtime of all the tasks switched out, in the unit of cpu_task_runtime_get */
+extern uint64_t             k_runtime_total;
+/* rolling system load in per mille, derived from the idle task runtime */
+extern uint32_t             k_knl_load;
+#endif
+
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 /* list to hold all the destroyed dynamic created tasks */
 extern k_list_t             k_dead_task_list;
@@ -52,8 +96,13 @@ extern k_list_t             k_dead_task_list;
 /* list to hold all the tasks for statistics */
 extern k_list_t             k_stat_list;
 
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+/* timing wheel to hold all the tasks delayed or pend for timeout */
+extern tick_wheel_t         k_tick_wheel;
+#else
 /* list to hold all the tasks delayed or pend for timeout */
 extern k_list_t             k_tick_list;
+#endif
 
 /* how many ticks will be triggered in a second */
 extern k_tick_t             k_cpu_tick_per_second;
@@ -74,6 +123,19 @@ extern uint8_t              k_mmheap_default_pool[] __ALIGNED__(4);
 extern k_mmheap_ctl_t       k_mmheap_ctl;
 #endif
 
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+/* heap arenas created, to find the arena a block to be freed is from */
+extern k_list_t             k_mmheap_arena_list;
+/* lowest start and highest end of the pools of every arena ever created, a block out of it is from the shared heap */
+extern cpu_addr_t           k_mmheap_arena_addr_lo;
+extern cpu_addr_t           k_mmheap_arena_addr_hi;
+#endif
+
+#if (TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u) && (TOS_CFG_SLAB_EN > 0u)
+/* kernel object caches, one for each type created by the *_create_dyn */
+extern k_slab_cache_t       k_slab_cache[K_SLAB_CACHE_NUM];
+#endif
+
 #if TOS_CFG_ROUND_ROBIN_EN > 0u
 extern k_timeslice_t        k_robin_default_timeslice;
 #endif
@@ -90,6 +152,16 @@ extern size_t               const k_timer_task_stk_size;
 #endif
 #endif
 
+#if TOS_CFG_HRTIMER_EN > 0u
+/* list holding all the running hrtimers, in deadline order */
+extern k_list_t             k_hrtimer_list;
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+/* kernel event trace ring buffer */
+extern k_trace_t            k_trace;
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0u
 extern pm_device_ctl_t      k_pm_device_ctl;
 
@@ -0,0 +1,167 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#ifndef _TOS_HRTIMER_H_
+#define  _TOS_HRTIMER_H_
+
+__CDECLS_BEGIN
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+#define K_HRTIME_NSEC_PER_USEC          (k_hrtime_t)1000u
+#define K_HRTIME_NSEC_PER_MSEC          (k_hrtime_t)1000000u
+#define K_HRTIME_NSEC_PER_SEC           (k_hrtime_t)1000000000u
+
+#define K_HRTIME_MAX                    (k_hrtime_t)(-1)
+
+/**
+ * state for high resolution timer
+ */
+typedef enum hrtimer_state_en {
+    HRTIMER_STATE_UNUSED,       /**< the hrtimer has been destroyed */
+    HRTIMER_STATE_STOPPED,      /**< the hrtimer has been created but not been started, or just be stopped */
+    HRTIMER_STATE_RUNNING,      /**< the hrtimer has been started, waiting for the deadline */
+    HRTIMER_STATE_COMPLETED,    /**< the deadline came, the hrtimer has fired */
+} hrtimer_state_t;
+
+// callback function type for a high resolution timer
+typedef void (*k_hrtimer_callback_t)(void *arg);
+
+/**
+ * high resolution timer control block
+ */
+typedef struct k_hrtimer_st {
+    knl_obj_t               knl_obj;    /**< just for verification, test whether current object is really a hrtimer */
+
+    k_hrtimer_callback_t    cb;         /**< callback when the deadline comes, called in interrupt context */
+    void                   *cb_arg;     /**< argument for callback */
+    k_list_t                list;       /**< list for hooking us to the k_hrtimer_list */
+    k_hrtime_t              deadline;   /**< when(in nanosecond, on the hrtimer clock) shall we fire */
+    hrtimer_state_t         state;      /**< state for the hrtimer, see HRTIMER_STATE_* */
+} k_hrtimer_t;
+
+/**
+ * @brief Create a high resolution timer.
+ * Create a one-shot timer with nanosecond deadline, which is independent of the systick.
+ *
+ * @attention the callback is called in interrupt context.
+ *
+ * @param[in]   hrtimer     pointer to the handler of the hrtimer.
+ * @param[in]   callback    callback function called when the deadline comes.
+ * @param[in]   cb_arg      argument for the callback.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_hrtimer_create(k_hrtimer_t *hrtimer, k_hrtimer_callback_t callback, void *cb_arg);
+
+/**
+ * @brief Delete a high resolution timer.
+ *
+ * @attention None
+ *
+ * @param[in]   hrtimer     pointer to the handler of the hrtimer.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INACTIVE         the hrtimer is not active yet.
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_hrtimer_destroy(k_hrtimer_t *hrtimer);
+
+/**
+ * @brief Start a high resolution timer.
+ * Fire the hrtimer after a relative time.
+ *
+ * @attention if the hrtimer is running, it is restarted.
+ *
+ * @param[in]   hrtimer     pointer to the handler of the hrtimer.
+ * @param[in]   ns          how much time(in nanosecond) from now to fire.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INACTIVE         the hrtimer is not active yet.
+ * @retval  #K_ERR_TIMER_INVALID_DELAY    ns is zero.
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_hrtimer_start(k_hrtimer_t *hrtimer, k_hrtime_t ns);
+
+/**
+ * @brief Start a high resolution timer with an absolute deadline.
+ *
+ * @attention if the deadline has already passed, the hrtimer fires as soon as possible.
+ *
+ * @param[in]   hrtimer     pointer to the handler of the hrtimer.
+ * @param[in]   deadline    when(in nanosecond, on the clock of tos_hrtime_get) to fire.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INACTIVE         the hrtimer is not active yet.
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_hrtimer_start_abs(k_hrtimer_t *hrtimer, k_hrtime_t deadline);
+
+/**
+ * @brief Stop a high resolution timer.
+ *
+ * @attention None
+ *
+ * @param[in]   hrtimer     pointer to the handler of the hrtimer.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INACTIVE       the hrtimer is not active yet.
+ * @retval  #K_ERR_TIMER_STOPPED        the hrtimer is not running.
+ * @retval  #K_ERR_NONE                 return successfully.
+ */
+__API__ k_err_t tos_hrtimer_stop(k_hrtimer_t *hrtimer);
+
+/**
+ * @brief Get the time of the hrtimer clock.
+ *
+ * @attention None
+ *
+ * @param   None
+ *
+ * @return  monotonic time in nanosecond
+ */
+__API__ k_hrtime_t tos_hrtime_get(void);
+
+/**
+ * @brief High resolution timer interrupt handler.
+ * Fire all the hrtimers whose deadline has come, and program the next deadline.
+ *
+ * @attention called from the hrtimer deadline interrupt entrance.
+ *
+ * @param   None
+ *
+ * @return  None
+ */
+__API__ void tos_hrtimer_handler(void);
+
+__KNL__ void hrtimer_init(void);
+
+__KNL__ void hrtimer_task_init(k_task_t *task);
+
+__KNL__ void hrtimer_task_sleep(k_task_t *task, k_hrtime_t ns);
+
+__KNL__ int  hrtimer_task_is_sleeping(k_task_t *task);
+
+__KNL__ void hrtimer_task_takeoff(k_task_t *task);
+
+#endif
+
+__CDECLS_END
+
+#endif /* _TOS_HRTIMER_H_ */
+
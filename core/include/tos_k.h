@@ -44,6 +44,8 @@
 #include <tos_priority_queue.h>
 #include <tos_priority_mail_queue.h>
 #include <tos_priority_message_queue.h>
+#include <tos_hrtimer.h>
+#include <tos_evtdrv.h>
 #include <tos_task.h>
 #include <tos_robin.h>
 #include <tos_mutex.h>
@@ -58,14 +60,17 @@
 #include <tos_stopwatch.h>
 #include <tos_mmblk.h>
 #include <tos_mmheap.h>
+#include <tos_slab.h>
 #include <tos_tick.h>
 #include <tos_sched.h>
+#include <tos_smp.h>
 #if TOS_CFG_PWR_MGR_EN > 0u
 #include <tos_pm.h>
 #if TOS_CFG_TICKLESS_EN > 0u
 #include <tos_tickless.h>
 #endif
 #endif
+#include <tos_trace.h>
 #include <tos_global.h>
 #include <tos_version.h>
 
@@ -52,12 +52,15 @@ typedef enum k_err_en {
     K_ERR_MMBLK_INVALID_POOL_ADDR,
     K_ERR_MMBLK_POOL_OUT_OF_MEMORY,
     K_ERR_MMBLK_OUT_OF_MEMORY,
+    K_ERR_MMBLK_INVALID_BLK_NUM,
 
     K_ERR_MMHEAP_INVALID_POOL_ADDR              = 800u,
     K_ERR_MMHEAP_INVALID_POOL_SIZE,
     K_ERR_MMHEAP_POOL_OVERFLOW,
     K_ERR_MMHEAP_POOL_ALREADY_EXIST,
     K_ERR_MMHEAP_POOL_NOT_EXIST,
+    K_ERR_MMHEAP_ARENA_BUSY,
+    K_ERR_MMHEAP_ARENA_ALREADY_CREATED,
 
     K_ERR_MUTEX_NOT_OWNER                       = 1000u,
     K_ERR_MUTEX_NESTING,
@@ -75,6 +78,8 @@ typedef enum k_err_en {
     K_ERR_PEND_TIMEOUT,
     K_ERR_PEND_DESTROY,
     K_ERR_PEND_OWNER_DIE,
+    K_ERR_PEND_ANY_COUNT_INVALID,
+    K_ERR_PEND_ANY_NOT_SUPPORTED,
 
     K_ERR_PM_DEVICE_ALREADY_REG                 = 1300u,
     K_ERR_PM_DEVICE_OVERFLOW,
@@ -88,6 +93,7 @@ typedef enum k_err_en {
     K_ERR_RING_Q_FULL                           = 1500u,
     K_ERR_RING_Q_EMPTY,
     K_ERR_RING_Q_ITEM_SIZE_NOT_MATCH,
+    K_ERR_RING_Q_ITEM_CNT_INVALID,
 
     K_ERR_RWLOCK_READERS_TO_MANY            = 1600u,
     K_ERR_RWLOCK_IS_READING,
@@ -111,6 +117,13 @@ typedef enum k_err_en {
     K_ERR_TASK_SUSPEND_IDLE,
     K_ERR_TASK_STK_OVERFLOW,
     K_ERR_TASK_STK_SIZE_INVALID,
+    K_ERR_TASK_EDF_PARAM_INVALID,
+    K_ERR_TASK_EDF_OVERLOAD,
+    K_ERR_TASK_NOT_EDF,
+    K_ERR_TASK_AFFINITY_INVALID,
+    K_ERR_TASK_NOT_EVTDRV,
+    K_ERR_TASK_EVTDRV_BUSY,
+    K_ERR_TASK_NOTIFY_OPT_INVALID,
 
     K_ERR_TICKLESS_WKUP_ALARM_NOT_INSTALLED     = 2000u,
     K_ERR_TICKLESS_WKUP_ALARM_NO_INIT,
@@ -125,6 +138,7 @@ typedef enum k_err_en {
     K_ERR_TIMER_INVALID_OPT,
     K_ERR_TIMER_STOPPED,
     K_ERR_TIMER_RUNNING,
+    K_ERR_TIMER_SLACK_FOREVER,
 } k_err_t;
 
 #endif /* _TOS_ERR_H_ */
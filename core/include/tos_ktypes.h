@@ -21,7 +21,11 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#if TOS_CFG_TASK_PRIO_MAX > 255u
+typedef uint16_t            k_prio_t; /* K_TASK_PRIO_INVALID(TOS_CFG_TASK_PRIO_MAX) must fit in */
+#else
 typedef uint8_t             k_prio_t;
+#endif
 typedef uint8_t             k_stack_t;
 typedef uint8_t             k_task_state_t;
 typedef struct k_task_st    k_task_t;
@@ -40,6 +44,10 @@ typedef uint32_t            k_timeslice_t;
 
 typedef uint32_t            k_cycle_t;
 
+typedef uint64_t            k_hrtime_t;
+
+typedef uint32_t            k_cpu_affinity_t;
+
 #if TOS_CFG_CPU_DATA_SIZE == CPU_WORD_SIZE_08
 typedef uint32_t            k_tick_t;
 #else
@@ -53,5 +61,15 @@ typedef uint64_t            k_tick_t;
 #define  K_NULL             0
 #endif
 
+/* priority bitmap of the readyqueue and the pend objects(TOS_CFG_PEND_PRIO_BITMAP_EN) */
+#define K_PRIO_TBL_SIZE         ((TOS_CFG_TASK_PRIO_MAX + 31) / 32)
+#define K_PRIO_TBL_SLOT_SIZE    (8 * sizeof(uint32_t))
+
+#define K_PRIO_NDX(prio)        ((prio) >> 5u) /* prio / 32u */
+#define K_PRIO_BIT(prio)        ((uint32_t)1u << (K_PRIO_TBL_SLOT_SIZE - 1u - ((prio) & (K_PRIO_TBL_SLOT_SIZE - 1u))))
+
+/* bit n of prio_group is set if prio_mask[n] is not zero(MSB first, the same as K_PRIO_BIT) */
+#define K_PRIO_GRP_BIT(ndx)     ((uint32_t)1u << (K_PRIO_TBL_SLOT_SIZE - 1u - (ndx)))
+
 #endif /* _TOS_KTYPES_H_ */
 
@@ -119,6 +119,30 @@ __API__ k_err_t tos_mail_q_flush(k_mail_q_t *mail_q);
  */
 __API__ k_err_t tos_mail_q_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a mail queue with a nanosecond timeout.
+ * pend a mail queue, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention we WILL perform a memcpy when mail_buf is received(a MAIL is a buffer with a certain size).
+ *
+ * @param[in]   mail_q      pointer to the handler of the mail queue.
+ * @param[OUT]  mail_buf    a pointer to the mail buffer we wanna receive.
+ * @param[OUT]  mail_size   size of the mail buffer received(should be consistent with the mail_size passed to tos_mail_q_create).
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_mail_q_pend_ns(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Post a mail queue.
  * post a mail queue and wakeup one pending task.
@@ -151,6 +175,48 @@ __API__ k_err_t tos_mail_q_post(k_mail_q_t *mail_q, void *mail_buf, size_t mail_
  */
 __API__ k_err_t tos_mail_q_post_all(k_mail_q_t *mail_q, void *mail_buf, size_t mail_size);
 
+/**
+ * @brief Post a batch of mails to a mail queue.
+ * post up to mail_cnt mails to a mail queue, in one critical section: the first ones go straight to the
+ * tasks pending(one each, in the order they wait), the rest are queued as long as they fit.
+ *
+ * @attention the scheduler is called at most once for the whole batch.
+ *
+ * @param[in]   mail_q      pointer to the handler of the mail queue.
+ * @param[in]   mail_buf    the mails to post, mail_cnt of them one after another.
+ * @param[in]   mail_cnt    number of mails to post.
+ * @param[in]   mail_size   the size of each mail(should be consistent with the mail_size passed to tos_mail_q_create).
+ * @param[OUT]  mail_sent   number of mails actually posted.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_RING_Q_ITEM_SIZE_NOT_MATCH mail_size is not consistent with the mail_size passed on creation.
+ * @retval  #K_ERR_RING_Q_FULL                the mail queue is full, nothing posted.
+ * @retval  #K_ERR_NONE                       return successfully(maybe fewer than mail_cnt posted, see mail_sent).
+ */
+__API__ k_err_t tos_mail_q_post_n(k_mail_q_t *mail_q, void *mail_buf, size_t mail_cnt, size_t mail_size, size_t *mail_sent);
+
+/**
+ * @brief Pend a batch of mails from a mail queue.
+ * take up to mail_cnt mails queued in a mail queue, in one critical section, if there is none, wait for
+ * the first one, and take whatever else is queued by the time we are woken up.
+ *
+ * @attention None
+ *
+ * @param[in]   mail_q      pointer to the handler of the mail queue.
+ * @param[OUT]  mail_buf    buffer to hold the mails received, one after another.
+ * @param[in]   mail_cnt    number of mails the buffer can hold.
+ * @param[OUT]  mail_recv   number of mails received.
+ * @param[in]   timeout     how much time(in k_tick_t) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_mail_q_pend_n(k_mail_q_t *mail_q, void *mail_buf, size_t mail_cnt, size_t *mail_recv, k_tick_t timeout);
+
 #endif
 
 __CDECLS_END
@@ -116,6 +116,29 @@ __API__ k_err_t tos_msg_q_flush(k_msg_q_t *msg_q);
  */
 __API__ k_err_t tos_msg_q_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a message queue with a nanosecond timeout.
+ * pend a message queue, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention we DONNOT perform a memcpy when msg_ptr is received(a MESSAGE is just a pointer).
+ *
+ * @param[in]   msg_q       pointer to the handler of the message queue.
+ * @param[OUT]  msg_ptr     a pointer to the message we wanna receive.
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_msg_q_pend_ns(k_msg_q_t *msg_q, void **msg_ptr, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Post a message queue.
  * post a message queue and wakeup one pending task.
@@ -146,6 +169,46 @@ __API__ k_err_t tos_msg_q_post(k_msg_q_t *msg_q, void *msg_ptr);
  */
 __API__ k_err_t tos_msg_q_post_all(k_msg_q_t *msg_q, void *msg_ptr);
 
+/**
+ * @brief Post a batch of messages to a message queue.
+ * post up to msg_cnt messages to a message queue, in one critical section: the first ones go straight to the
+ * tasks pending(one each, in the order they wait), the rest are queued as long as they fit.
+ *
+ * @attention the scheduler is called at most once for the whole batch.
+ *
+ * @param[in]   msg_q       pointer to the handler of the message queue.
+ * @param[in]   msg_ptr     the messages to post(a MESSAGE is just a pointer).
+ * @param[in]   msg_cnt    number of messages to post.
+ * @param[OUT]  msg_sent   number of messages actually posted.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_RING_Q_FULL              the message queue is full, nothing posted.
+ * @retval  #K_ERR_NONE                     return successfully(maybe fewer than msg_cnt posted, see msg_sent).
+ */
+__API__ k_err_t tos_msg_q_post_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt, size_t *msg_sent);
+
+/**
+ * @brief Pend a batch of messages from a message queue.
+ * take up to msg_cnt messages queued in a message queue, in one critical section, if there is none, wait for
+ * the first one, and take whatever else is queued by the time we are woken up.
+ *
+ * @attention None
+ *
+ * @param[in]   msg_q       pointer to the handler of the message queue.
+ * @param[OUT]  msg_ptr     buffer to hold the messages received.
+ * @param[in]   msg_cnt    number of messages the buffer can hold.
+ * @param[OUT]  msg_recv   number of messages received.
+ * @param[in]   timeout     how much time(in k_tick_t) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_msg_q_pend_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt, size_t *msg_recv, k_tick_t timeout);
+
 #endif
 
 __CDECLS_END
@@ -23,11 +23,33 @@ __CDECLS_BEGIN
 #define K_MMBLK_NEXT_BLK(blk_curr, blk_size)        ((void *)((cpu_addr_t)blk_curr + blk_size))
 #define K_MMBLK_ALIGN_MASK                          (sizeof(void *) - 1u)
 
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+
+/*
+ * the lock-free free list head is one cpu_addr_t: the low half is the index of the first free block
+ * (block i of the pool is i + 1, 0 is the end of the list), the high half is a tag bumped by every
+ * push or pop, so a compare-and-swap on a head popped and pushed back in between(ABA) fails.
+ * on a 32-bit cpu the tag is 16 bits: it wraps after 65536 pushes and pops, a pop preempted for that
+ * long between its load of the head and its compare-and-swap may still take a stale next index.
+ */
+#define K_MMBLK_LF_IDX_BITS                         (sizeof(cpu_addr_t) * 4u)
+#define K_MMBLK_LF_IDX_MASK                         (((cpu_addr_t)1u << K_MMBLK_LF_IDX_BITS) - 1u)
+#define K_MMBLK_LF_TAG_ONE                          ((cpu_addr_t)1u << K_MMBLK_LF_IDX_BITS)
+
+/* most blocks a lock-free pool can hold */
+#define K_MMBLK_LF_BLK_NUM_MAX                      ((size_t)K_MMBLK_LF_IDX_MASK)
+
+#endif
+
 typedef struct k_mmblk_pool_st {
     knl_obj_t   knl_obj;
 
     void       *pool_start;
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    cpu_addr_t  free_head;  /**< tag and index of the first free block, see K_MMBLK_LF_IDX_BITS */
+#else
     void       *free_list;
+#endif
     size_t      blk_size;
     size_t      blk_max;
     size_t      blk_free;
@@ -37,7 +59,8 @@ typedef struct k_mmblk_pool_st {
  * @brief Create a memory manage block pool.
  * Create a memory manage block pool.
  *
- * @attention None
+ * @attention in lock-free mode(TOS_CFG_MMBLK_LOCKFREE_EN) on a 32-bit cpu, the ABA tag of the free list
+ *            is 16 bits, see K_MMBLK_LF_IDX_BITS.
  *
  * @param[in]   mbp         pointer to the memory block pool handler.
  * @param[in]   pool_start  start address of the pool.
@@ -47,6 +70,7 @@ typedef struct k_mmblk_pool_st {
  * @return  errcode
  * @retval  #K_ERR_MMBLK_INVALID_POOL_ADDR  start address of the pool is invalid.
  * @retval  #K_ERR_MMBLK_INVALID_BLK_SIZE   size of the block is invalid.
+ * @retval  #K_ERR_MMBLK_INVALID_BLK_NUM    no block, or more than K_MMBLK_LF_BLK_NUM_MAX in lock-free mode.
  * @retval  #K_ERR_NONE                     return successfully.
  */
 __API__ k_err_t tos_mmblk_pool_create(k_mmblk_pool_t *mbp, void *pool_start, size_t blk_num, size_t blk_size);
@@ -78,6 +102,7 @@ __API__ k_err_t tos_mmblk_pool_destroy(k_mmblk_pool_t *mbp);
  * @return  errcode
  * @retval  #K_ERR_MMBLK_INVALID_POOL_ADDR  start address of the pool is invalid.
  * @retval  #K_ERR_MMBLK_INVALID_BLK_SIZE   size of the block is invalid.
+ * @retval  #K_ERR_MMBLK_INVALID_BLK_NUM    no block, or more than K_MMBLK_LF_BLK_NUM_MAX in lock-free mode.
  * @retval  #K_ERR_NONE                     return successfully.
  */
 __API__ k_err_t tos_mmblk_pool_create_dyn(k_mmblk_pool_t **mbp, size_t blk_num, size_t blk_size);
@@ -126,6 +151,41 @@ __API__ k_err_t tos_mmblk_alloc(k_mmblk_pool_t *mbp, void **blk);
  */
 __API__ k_err_t tos_mmblk_free(k_mmblk_pool_t *mbp, void *blk);
 
+/**
+ * @brief Allocate a batch of memory manage blocks.
+ * Allocate up to blk_cnt blocks in one go: one critical section for the whole batch(one
+ * compare-and-swap in lock-free mode).
+ *
+ * @attention None
+ *
+ * @param[in]   mbp         pointer to the memory block pool handler.
+ * @param[OUT]  blk         buffer to hold the start addresses of the blocks allocated.
+ * @param[in]   blk_cnt     number of blocks to allocate.
+ * @param[OUT]  blk_alloc   number of blocks actually allocated.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_MMBLK_POOL_EMPTY   the pool is empty, nothing allocated.
+ * @retval  #K_ERR_NONE               return successfully(maybe fewer than blk_cnt allocated, see blk_alloc).
+ */
+__API__ k_err_t tos_mmblk_alloc_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt, size_t *blk_alloc);
+
+/**
+ * @brief Free a batch of memory manage blocks.
+ * Free blk_cnt blocks in one go: the blocks are chained first, then the chain goes onto the free list
+ * in one critical section(one compare-and-swap in lock-free mode).
+ *
+ * @attention all or nothing, if the blocks do not fit in the pool none of them is freed.
+ *
+ * @param[in]   mbp         pointer to the memory block pool handler.
+ * @param[in]   blk         start addresses of the blocks to free.
+ * @param[in]   blk_cnt     number of blocks to free.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_MMBLK_POOL_FULL    the pool can not take blk_cnt more blocks, nothing freed.
+ * @retval  #K_ERR_NONE               return successfully.
+ */
+__API__ k_err_t tos_mmblk_free_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt);
+
 #endif
 
 __CDECLS_END
@@ -129,6 +129,81 @@ typedef struct mmheap_blk_st {
 
 #define K_MMHEAP_POOL_MAX               3
 
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+/**
+ * The profiler keeps a tag in the last bytes of every block allocated: the index of the callsite
+ * in the tally, or one of the values below.
+ */
+#define K_MMHEAP_TAG_SIZE               sizeof(uint32_t)
+
+#define K_MMHEAP_TAG_SITE_OTHER         TOS_CFG_MMHEAP_PROFILE_SITE_NUM /**< the sites which do not fit in the tally */
+#define K_MMHEAP_TAG_CACHED             0xFFFFFFFFu                     /**< the block is in the size class cache */
+
+typedef struct k_mmheap_site_st {
+    void       *site;       /**< return address of the call to tos_mmheap_alloc & co, K_NULL for the sites which do not fit */
+    size_t      bytes;      /**< bytes of the blocks allocated by the site and not freed yet */
+    size_t      bytes_peak; /**< peak of bytes */
+    size_t      count;      /**< blocks allocated by the site and not freed yet */
+} k_mmheap_site_t;
+
+typedef enum k_mmheap_blk_state_en {
+    K_MMHEAP_BLK_STATE_FREE,
+    K_MMHEAP_BLK_STATE_USED,
+    K_MMHEAP_BLK_STATE_CACHED,
+} k_mmheap_blk_state_t;
+
+typedef struct k_mmheap_blk_record_st {
+    void                   *addr;   /**< start of the memory of the block */
+    size_t                  size;
+    k_mmheap_blk_state_t    state;
+    void                   *site;   /**< return address of the call which allocated the block, K_NULL if not used */
+} k_mmheap_blk_rec_t;
+
+#else
+
+#define K_MMHEAP_TAG_SIZE               0u
+
+#endif
+
+/**
+ * Free blocks of the heap, first-level class 0 holds the blocks smaller than K_MMHEAP_SMALL_BLOCK_SIZE,
+ * class n(n > 0) the blocks from (K_MMHEAP_SMALL_BLOCK_SIZE << (n - 1)) to (K_MMHEAP_SMALL_BLOCK_SIZE << n).
+ * The blocks in the size class cache are free blocks too, as in tos_mmheap_check.
+ */
+typedef struct k_mmheap_fragment_st {
+    size_t      free_cnt[K_MMHEAP_FL_INDEX_COUNT];      /**< free blocks of each first-level class */
+    size_t      free_bytes[K_MMHEAP_FL_INDEX_COUNT];    /**< bytes of the free blocks of each first-level class */
+    size_t      free_total;                             /**< bytes of all the free blocks, the same as the free of tos_mmheap_check */
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    size_t      free_cached;                            /**< bytes of the free blocks held by the size class cache */
+#endif
+    size_t      free_largest;                           /**< size of the largest free block */
+    uint32_t    frag_index;                             /**< 1000 * (1 - free_largest / free_total), 0 for no fragmentation at all */
+} k_mmheap_frag_t;
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+/**
+ * Size classes of the cache, class n serves the sizes up to (K_MMHEAP_CACHE_CLASS_SIZE_MIN << n),
+ * its blocks have room for the profiler tag too. A class smaller than K_MMHEAP_BLK_SIZE_MIN is never used.
+ */
+#define K_MMHEAP_CACHE_CLASS_SIZE_MIN_LOG2  4
+#define K_MMHEAP_CACHE_CLASS_SIZE_MIN       (1 << K_MMHEAP_CACHE_CLASS_SIZE_MIN_LOG2)
+#define K_MMHEAP_CACHE_CLASS_SIZE(cls)      (((size_t)K_MMHEAP_CACHE_CLASS_SIZE_MIN << (cls)) + K_MMHEAP_TAG_SIZE)
+#define K_MMHEAP_CACHE_CLASS_SIZE_MAX       K_MMHEAP_CACHE_CLASS_SIZE(TOS_CFG_MMHEAP_CACHE_CLASS_NUM - 1u)
+
+/**
+ * Blocks of a size class, they stay used blocks of the TLSF heap while cached,
+ * linked through next_free.
+ */
+typedef struct mmheap_cache_class_st {
+    mmheap_blk_t   *free;
+    size_t          cnt;
+} mmheap_cache_class_t;
+
+#endif
+
 /**
  * memory heap control
  */
@@ -142,8 +217,52 @@ typedef struct k_mmheap_control_st {
     uint32_t        sl_bitmap[K_MMHEAP_FL_INDEX_COUNT];
 
     mmheap_blk_t   *blocks[K_MMHEAP_FL_INDEX_COUNT][K_MMHEAP_SL_INDEX_COUNT]; /**< Head of free lists. */
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    mmheap_cache_class_t    cache[TOS_CFG_MMHEAP_CACHE_CLASS_NUM]; /**< Size class cache in front of the free lists. */
+#endif
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    k_mmheap_site_t site[TOS_CFG_MMHEAP_PROFILE_SITE_NUM + 1]; /**< Allocation tally of the callsites, the last one for the sites which do not fit. */
+#endif
 } k_mmheap_ctl_t;
 
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+
+/**
+ * heap arena, a TLSF heap of its own for the tasks bound to it, with a byte budget
+ */
+typedef struct k_mmheap_arena_st {
+    knl_obj_t       knl_obj;
+
+    k_list_t        list;                           /**< hooked to k_mmheap_arena_list */
+    k_mmheap_ctl_t  ctl;                            /**< heap control of the pools of the arena */
+    cpu_addr_t      pool_end[K_MMHEAP_POOL_MAX];    /**< end of each pool in ctl.pool_start, to tell which arena a block is from */
+
+    size_t          budget;                         /**< most bytes the arena hands out at a time, 0 for no budget */
+    size_t          used;                           /**< bytes of the blocks allocated and not freed yet */
+    size_t          used_peak;                      /**< peak of used */
+    size_t          alloc_cnt;                      /**< allocations served */
+    size_t          free_cnt;                       /**< blocks given back */
+    size_t          fail_cnt;                       /**< allocations refused, out of budget or out of memory */
+    size_t          task_cnt;                       /**< tasks bound to the arena */
+
+    void           *irq_free;                       /**< blocks freed in interrupt context, given back by the next call on the arena in a task */
+} k_mmheap_arena_t;
+
+typedef struct k_mmheap_arena_information_st {
+    size_t  budget;     /**< most bytes the arena hands out at a time, 0 for no budget */
+    size_t  used;       /**< bytes of the blocks allocated and not freed yet */
+    size_t  used_peak;  /**< peak of used */
+    size_t  free;       /**< bytes of the free blocks of the pools */
+    size_t  alloc_cnt;  /**< allocations served */
+    size_t  free_cnt;   /**< blocks given back */
+    size_t  fail_cnt;   /**< allocations refused, out of budget or out of memory */
+    size_t  task_cnt;   /**< tasks bound to the arena */
+} k_mmheap_arena_info_t;
+
+#endif
+
 /**
  * @brief Add a pool.
  * Add addtional pool to the heap.
@@ -181,7 +300,8 @@ __API__ k_err_t tos_mmheap_pool_rmv(void *pool_start);
  * @brief Alloc memory.
  * Allocate size bytes and returns a pointer to the allocated memory.
  *
- * @attention size should no bigger than K_MMHEAP_BLK_SIZE_MAX.
+ * @attention size should no bigger than K_MMHEAP_BLK_SIZE_MAX, sizes up to K_MMHEAP_CACHE_CLASS_SIZE_MAX
+ * are served by the size class cache if TOS_CFG_MMHEAP_CACHE_EN is enabled.
  *
  * @param[in]   size    size of the memory.
  *
@@ -258,6 +378,198 @@ __API__ k_err_t tos_mmheap_pool_check(void *pool_start, k_mmheap_info_t *info);
  */
 __API__ k_err_t tos_mmheap_check(k_mmheap_info_t *info);
 
+/**
+ * @brief Get the largest free block.
+ * Get the size of the largest free block of the heap.
+ *
+ * @attention the blocks in the size class cache are not counted.
+ *
+ * @return  size of the largest free block.
+ */
+__API__ size_t  tos_mmheap_largest_free(void);
+
+/**
+ * @brief Check the fragmentation of the heap.
+ * Get the free block histogram of the heap, the largest free block and the fragmentation index.
+ *
+ * @attention the free lists and the size class cache are walked with the interrupt disabled, the time
+ * taken grows with the number of free blocks.
+ *
+ * @param[out]  frag        pointer to the fragmentation struct.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_OBJ_PTR_NULL             frag is NULL.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_mmheap_frag_check(k_mmheap_frag_t *frag);
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+/**
+ * @brief Read the allocation tally.
+ * Copy the callsites which ever allocated from the heap out.
+ *
+ * @attention the site is the return address of the call to tos_mmheap_alloc, tos_mmheap_calloc,
+ * tos_mmheap_aligned_alloc or tos_mmheap_realloc, look it up in the map file of the image, every
+ * allocation takes K_MMHEAP_TAG_SIZE more bytes for the tag of the site.
+ *
+ * @param[out]  site        buffer to hold the sites.
+ * @param[in]   cnt         how many sites the buffer can hold.
+ *
+ * @return  how many sites are copied.
+ */
+__API__ size_t  tos_mmheap_site_read(k_mmheap_site_t *site, size_t cnt);
+
+/**
+ * @brief Read the heap map.
+ * Copy the blocks of the heap out, pool by pool, in the order of address.
+ *
+ * @attention the heap is walked with the interrupt disabled, read a big heap in several calls
+ * with first moving on.
+ *
+ * @param[in]   first       index of the first block to copy.
+ * @param[out]  rec         buffer to hold the blocks.
+ * @param[in]   cnt         how many blocks the buffer can hold.
+ *
+ * @return  how many blocks are copied, less than cnt if the end of the heap is reached.
+ */
+__API__ size_t  tos_mmheap_map_read(size_t first, k_mmheap_blk_rec_t *rec, size_t cnt);
+
+#endif
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+/**
+ * @brief Drain the size class cache.
+ * Give every block held by the size class cache back to the heap.
+ *
+ * @attention the idle task gives the blocks above TOS_CFG_MMHEAP_CACHE_KEEP_CNT of each class back on
+ * its own, call this before tos_mmheap_pool_rmv, or to get the heap back in one piece at once.
+ *
+ * @return  None.
+ */
+__API__ void    tos_mmheap_cache_drain(void);
+
+__KNL__ void    mmheap_cache_trim(void);
+
+#endif
+
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+
+/**
+ * @brief Create a heap arena.
+ * Create a heap arena over a pool, the tasks bound to it allocate from the arena instead of the shared heap.
+ *
+ * @attention the arena has its own free lists, the handler takes about as much memory as the heap control
+ * of the shared heap(sizeof(k_mmheap_arena_t)). the free lists are worked on with the scheduler locked
+ * instead of the interrupts disabled, a block of an arena freed in interrupt context is given back by
+ * the next call on the arena in a task, and cannot be resized there(tos_mmheap_realloc returns K_NULL).
+ * the kernel's own allocations(stacks of tos_task_create_dyn, pools of the *_create_dyn, slabs) always
+ * come from the shared heap.
+ *
+ * @param[in]   arena       pointer to the arena handler.
+ * @param[in]   pool_start  start address of the pool.
+ * @param[in]   pool_size   size of the pool.
+ * @param[in]   budget      most bytes the arena hands out at a time(sizes of the blocks, rounded up), 0 for no budget.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_MMHEAP_INVALID_POOL_ADDR     start address of the pool is invalid.
+ * @retval  #K_ERR_MMHEAP_INVALID_POOL_SIZE     size of the pool is invalid.
+ * @retval  #K_ERR_MMHEAP_ARENA_ALREADY_CREATED the arena is already created and not destroyed(TOS_CFG_OBJECT_VERIFY_EN).
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_create(k_mmheap_arena_t *arena, void *pool_start, size_t pool_size, size_t budget);
+
+/**
+ * @brief Destroy a heap arena.
+ * Destroy a heap arena.
+ *
+ * @attention the arena must have no block in use and no task bound.
+ *
+ * @param[in]   arena       pointer to the arena handler.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_OBJ_INVALID                  arena is not a valid arena handler.
+ * @retval  #K_ERR_MMHEAP_ARENA_BUSY            a block of the arena is in use, or a task is bound to it.
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_destroy(k_mmheap_arena_t *arena);
+
+/**
+ * @brief Add a pool to a heap arena.
+ * Add addtional pool to a heap arena.
+ *
+ * @attention None
+ *
+ * @param[in]   arena       pointer to the arena handler.
+ * @param[in]   pool_start  start address of the pool.
+ * @param[in]   pool_size   size of the pool.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_MMHEAP_INVALID_POOL_ADDR     start address of the pool is invalid.
+ * @retval  #K_ERR_MMHEAP_INVALID_POOL_SIZE     size of the pool is invalid.
+ * @retval  #K_ERR_MMHEAP_POOL_OVERFLOW         too many pools are added.
+ * @retval  #K_ERR_MMHEAP_POOL_ALREADY_EXIST    the pool is already exist.
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_pool_add(k_mmheap_arena_t *arena, void *pool_start, size_t pool_size);
+
+/**
+ * @brief Set the budget of a heap arena.
+ * Set how many bytes the arena hands out at most at a time.
+ *
+ * @attention a budget below the bytes in use only refuses the next allocations.
+ *
+ * @param[in]   arena       pointer to the arena handler.
+ * @param[in]   budget      the budget in bytes, 0 for no budget.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_OBJ_INVALID                  arena is not a valid arena handler.
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_budget_set(k_mmheap_arena_t *arena, size_t budget);
+
+/**
+ * @brief Bind a task to a heap arena.
+ * Route the tos_mmheap_alloc & co of a task to a heap arena.
+ *
+ * @attention the allocations in interrupt context always go to the shared heap, tos_mmheap_free and
+ * tos_mmheap_realloc find the arena of a block themselves, whichever task calls them. a task destroyed
+ * is unbound.
+ *
+ * @param[in]   task        pointer to the task handler, K_NULL for the current task.
+ * @param[in]   arena       pointer to the arena handler, K_NULL to go back to the shared heap.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_OBJ_INVALID                  task is not a valid task, or arena is not a valid arena handler.
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_bind(k_task_t *task, k_mmheap_arena_t *arena);
+
+/**
+ * @brief Check a heap arena.
+ * Get the budget and the allocation statistics of a heap arena.
+ *
+ * @attention None
+ *
+ * @param[in]   arena       pointer to the arena handler.
+ * @param[out]  info        pointer to the information struct.
+ *
+ * @return  errcode.
+ * @retval  #K_ERR_OBJ_PTR_NULL                 info is NULL.
+ * @retval  #K_ERR_OBJ_INVALID                  arena is not a valid arena handler.
+ * @retval  #K_ERR_NONE                         return successfully.
+ */
+__API__ k_err_t tos_mmheap_arena_check(k_mmheap_arena_t *arena, k_mmheap_arena_info_t *info);
+
+__KNL__ void    mmheap_arena_unbind(k_task_t *task);
+
+#endif
+
+__KNL__ void   *mmheap_shared_alloc(size_t size);
+
+__KNL__ void    mmheap_shared_free(void *ptr);
+
 __KNL__ k_err_t mmheap_init(void);
 
 __KNL__ k_err_t mmheap_init_with_pool(void *pool_start, size_t pool_size);
@@ -108,6 +108,30 @@ __API__ k_err_t tos_mutex_destroy_dyn(k_mutex_t *mutex);
  */
 __API__ k_err_t tos_mutex_pend_timed(k_mutex_t *mutex, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a mutex with a nanosecond timeout.
+ * pend a mutex, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention The task will keep blocked until the mutex is obtained or a timeout comes.
+ *
+ * @param[in]   mutex       pointer to the handler of the mutex.
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_MUTEX_NESTING_OVERFLOW     we are the owner of the mutex, and we are nesting pend too much on this mutex.
+ * @retval  #K_ERR_MUTEX_NESTING              we are the owner of the mutex, and we are nesting pend on it.
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the mutex we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_mutex_pend_ns(k_mutex_t *mutex, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Pend a mutex.
  * pend a mutex.
@@ -37,10 +37,53 @@ typedef enum opt_post_en {
     OPT_POST_ALL,
 } opt_post_t;
 
+/**
+ * the tasks pending for the object are kept in list in priority order(FIFO within a priority).
+ * with TOS_CFG_PEND_PRIO_BITMAP_EN, the object also remembers the first task of every priority
+ * pending and a bitmap of the priorities pending(the same layout as readyqueue_t), a task goes
+ * right before the first task of the next lower priority, so no walk of the list is needed.
+ */
 typedef struct pend_object_st {
     k_list_t        list;
+#if TOS_CFG_PEND_PRIO_BITMAP_EN > 0u
+    k_task_t       *prio_first[TOS_CFG_TASK_PRIO_MAX];
+    uint32_t        prio_group;
+    uint32_t        prio_mask[K_PRIO_TBL_SIZE];
+#endif
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    k_list_t        any_list;                       /**< the tos_wait_any callers waiting for us to get ready. */
+    int           (*is_ready)(struct pend_object_st *object); /**< would a pend with no wait succeed? K_NULL if the object does not support tos_wait_any. */
+#endif
 } pend_obj_t;
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+struct pend_any_st;
+
+typedef struct pend_any_node_st {
+    k_list_t            list;   /**< in the any_list of the object waited for. */
+    struct pend_any_st *any;
+} pend_any_node_t;
+
+/**
+ * lives on the stack of a tos_wait_any caller, the caller pends for pend_obj,
+ * the first object getting ready wakes it up.
+ */
+typedef struct pend_any_st {
+    pend_obj_t          pend_obj;
+    uint32_t            count;
+    uint32_t            ready;  /**< index of the object that woke us up. */
+    pend_any_node_t     node[TOS_CFG_WAIT_ANY_OBJ_MAX];
+} pend_any_t;
+
+#define PEND_OBJ_READY_SET(object, ready_fn)    ((object)->is_ready = (ready_fn))
+
+#else
+
+#define PEND_OBJ_READY_SET(object, ready_fn)
+
+#endif
+
 __KNL__ void        pend_object_init(pend_obj_t *object);
 
 __KNL__ void        pend_object_deinit(pend_obj_t *object);
@@ -53,7 +96,7 @@ __KNL__ k_task_t   *pend_highest_pending_task_get(pend_obj_t *object);
 
 __KNL__ void        pend_list_remove(k_task_t *task);
 
-__KNL__ void        pend_list_adjust(k_task_t *task);
+__KNL__ void        pend_list_adjust(k_task_t *task, k_prio_t prio_new);
 
 __KNL__ k_err_t     pend_state2errno(pend_state_t state);
 
@@ -61,12 +104,51 @@ __KNL__ void        pend_task_wakeup(k_task_t *task, pend_state_t state);
 
 __KNL__ void        pend_task_block(k_task_t *task, pend_obj_t *object, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+__KNL__ void        pend_task_block_ns(k_task_t *task, pend_obj_t *object, k_hrtime_t ns);
+#endif
+
+__KNL__ void        pend_task_block_timed(k_task_t *task, pend_obj_t *object, k_tick_t timeout, k_hrtime_t ns);
+
 __KNL__ void        pend_wakeup_one(pend_obj_t *object, pend_state_t state);
 
 __KNL__ void        pend_wakeup_all(pend_obj_t *object, pend_state_t state);
 
 __KNL__ void        pend_wakeup(pend_obj_t *object, pend_state_t state, opt_post_t opt);
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+__KNL__ int         pend_any_wakeup(pend_obj_t *object, pend_state_t state);
+
+__KNL__ void        pend_any_detach(pend_any_t *any);
+
+/**
+ * @brief Wait for any of several objects.
+ * block until one of the objects is ready, that is, a pend on it with no wait would succeed.
+ *
+ * @attention the objects are not taken, pend the one reported ready with TOS_TIME_NOWAIT afterwards,
+ *            another task may have taken it in between, so be ready to wait again.
+ *            supported objects are semaphore, event(ready while any flag is set), message queue and
+ *            mail queue, pass the address of their pend_obj(e.g. &sem.pend_obj).
+ *
+ * @param[in]   objects     the objects to wait for.
+ * @param[in]   count       how many objects, no more than TOS_CFG_WAIT_ANY_OBJ_MAX.
+ * @param[in]   timeout     how much time(in k_tick_t) we would like to wait.
+ * @param[out]  ready       index of the object ready(or destroyed) in objects.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_ANY_COUNT_INVALID     count is zero or greater than TOS_CFG_WAIT_ANY_OBJ_MAX.
+ * @retval  #K_ERR_PEND_ANY_NOT_SUPPORTED     one of the objects does not support tos_wait_any.
+ * @retval  #K_ERR_PEND_NOWAIT                none is ready, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, none is ready.
+ * @retval  #K_ERR_PEND_DESTROY               the object at ready is destroyed.
+ * @retval  #K_ERR_NONE                       the object at ready is ready.
+ */
+__API__ k_err_t     tos_wait_any(pend_obj_t *objects[], uint32_t count, k_tick_t timeout, uint32_t *ready);
+
+#endif
+
 __CDECLS_END
 
 #endif /* _TOS_PEND_H_ */
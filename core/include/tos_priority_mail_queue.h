@@ -125,6 +125,34 @@ __API__ k_err_t tos_prio_mail_q_flush(k_prio_mail_q_t *prio_mail_q);
  */
 __API__ k_err_t tos_prio_mail_q_pend(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a priority mail queue with a nanosecond timeout.
+ * pend a priority mail queue, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention
+ * 1. we WILL perform a memcpy when mail_buf is received(a MAIL is a buffer with a certain size).
+ * 2. With priority mail queue, if the poster has post several mail with different priority, the pender will receive
+ *    the mail in priority order(numerically bigger, actually smaller, means the mail with highest priority(numerically
+ *    smallest) will be received first, then the second highest priority mail, and so on).
+ *
+ * @param[in]   prio_mail_q pointer to the handler of the priority mail queue.
+ * @param[OUT]  mail_buf    a pointer to the mail buffer we wanna receive.
+ * @param[OUT]  mail_size   size of the mail buffer received(should be consistent with the mail_size passed to tos_prio_mail_q_create).
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_prio_mail_q_pend_ns(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Post a priority mail queue.
  * post a priority mail queue and wakeup one pending task.
@@ -159,6 +187,49 @@ __API__ k_err_t tos_prio_mail_q_post(k_prio_mail_q_t *prio_mail_q, void *mail_bu
  */
 __API__ k_err_t tos_prio_mail_q_post_all(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t mail_size, k_prio_t prio);
 
+/**
+ * @brief Post a batch of mails to a priority mail queue.
+ * post up to mail_cnt mails to a priority mail queue, in one critical section: the first ones go straight to the
+ * tasks pending(one each, in the order they wait), the rest are queued as long as they fit.
+ *
+ * @attention the scheduler is called at most once for the whole batch.
+ *
+ * @param[in]   prio_mail_q pointer to the handler of the priority mail queue.
+ * @param[in]   mail_buf    the mails to post, mail_cnt of them one after another.
+ * @param[in]   mail_cnt    number of mails to post.
+ * @param[in]   mail_size   the size of each mail(should be consistent with the mail_size passed to tos_prio_mail_q_create).
+ * @param[in]   prio        priority of the mails.
+ * @param[OUT]  mail_sent   number of mails actually posted.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PRIO_Q_ITEM_SIZE_NOT_MATCH mail_size is not consistent with the mail_size passed on creation.
+ * @retval  #K_ERR_PRIO_Q_FULL                the priority mail queue is full, nothing posted.
+ * @retval  #K_ERR_NONE                       return successfully(maybe fewer than mail_cnt posted, see mail_sent).
+ */
+__API__ k_err_t tos_prio_mail_q_post_n(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t mail_cnt, size_t mail_size, k_prio_t prio, size_t *mail_sent);
+
+/**
+ * @brief Pend a batch of mails from a priority mail queue.
+ * take up to mail_cnt mails queued in a priority mail queue, in one critical section, if there is none, wait for
+ * the first one, and take whatever else is queued by the time we are woken up.
+ *
+ * @attention None
+ *
+ * @param[in]   prio_mail_q pointer to the handler of the priority mail queue.
+ * @param[OUT]  mail_buf    buffer to hold the mails received, one after another.
+ * @param[in]   mail_cnt    number of mails the buffer can hold.
+ * @param[OUT]  mail_recv   number of mails received.
+ * @param[in]   timeout     how much time(in k_tick_t) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the queue we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_prio_mail_q_pend_n(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t mail_cnt, size_t *mail_recv, k_tick_t timeout);
+
 #endif /* TOS_CFG_PRIORITY_MAIL_QUEUE_EN */
 
 __CDECLS_END
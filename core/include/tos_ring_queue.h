@@ -18,6 +18,13 @@
 #ifndef _TOS_RING_QUEUE_H_
 #define  _TOS_RING_QUEUE_H_
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+typedef enum ring_queue_mode_en {
+    RING_Q_MODE_LOCKED,     /* any number of producers and consumers, guarded by the interrupt */
+    RING_Q_MODE_SPSC,       /* one producer and one consumer, lock-free */
+} ring_q_mode_t;
+#endif
+
 typedef struct k_ring_queue_st {
     knl_obj_t   knl_obj;
 
@@ -29,12 +36,33 @@ typedef struct k_ring_queue_st {
 
     size_t      item_size;
     size_t      item_cnt;
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    ring_q_mode_t           mode;
+    size_t                  mask;
+    /* free running indices, a word each so every one is loaded and stored in one go, the
+       head is only written by the consumer, the tail only by the producer */
+    volatile cpu_data_t     spsc_head;
+    volatile cpu_data_t     spsc_tail;
+#endif
 } k_ring_q_t;
 
+/* up to two contiguous regions of a ring queue, the second one is used when the span wraps around
+   the end of the pool */
+typedef struct k_ring_queue_span_st {
+    uint8_t    *item[2];    /* first item of each region */
+    size_t      cnt[2];     /* item count of each region */
+} k_ring_q_span_t;
+
 #define RING_HEAD_ITEM(ring_q)      (uint8_t *)(&ring_q->pool[ring_q->head * ring_q->item_size])
 #define RING_TAIL_ITEM(ring_q)      (uint8_t *)(&ring_q->pool[ring_q->tail * ring_q->item_size])
 #define RING_NEXT(ring_q, index)    ((index + 1) % ring_q->item_cnt)
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+#define RING_SPSC_ITEM(ring_q, index)   (uint8_t *)(&ring_q->pool[((index) & ring_q->mask) * ring_q->item_size])
+#define RING_SPSC_CNT_MAX               (((cpu_data_t)~0u >> 1) + 1u)
+#endif
+
 /**
  * @brief Create a ring queue.
  * create a ring queue.
@@ -51,6 +79,31 @@ typedef struct k_ring_queue_st {
  */
 __API__ k_err_t tos_ring_q_create(k_ring_q_t *ring_q, void *pool, size_t item_cnt, size_t item_size);
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+
+/**
+ * @brief Create a single-producer/single-consumer ring queue.
+ * create a ring queue for exactly one producer and one consumer(for example an ISR feeding a task, a
+ * uart rx buffer, or a task handing dma descriptors to an ISR), tos_ring_q_enqueue and
+ * tos_ring_q_dequeue on it take no critical section, the producer and the consumer only publish
+ * their own index behind a memory barrier.
+ *
+ * @attention only one context may enqueue and only one may dequeue(tos_ring_q_flush counts as a
+ *            dequeue), the item_cnt must be a power of two, not larger than half the range of a cpu_data_t.
+ *
+ * @param[in]   ring_q      pointer to the handler of the ring queue.
+ * @param[in]   pool        pool buffer of the ring queue.
+ * @param[in]   item_cnt    item count of the ring queue.
+ * @param[in]   item_size   size of each item of the ring queue.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_NONE                     return successfully.
+ * @retval  #K_ERR_RING_Q_ITEM_CNT_INVALID  item_cnt is not a power of two, or is too large.
+ */
+__API__ k_err_t tos_ring_q_create_spsc(k_ring_q_t *ring_q, void *pool, size_t item_cnt, size_t item_size);
+
+#endif
+
 /**
  * @brief Destroy a ring queue.
  * destroy a ring queue.
@@ -169,5 +222,67 @@ __API__ int     tos_ring_q_is_empty(k_ring_q_t *ring_q);
  */
 __API__ int     tos_ring_q_is_full(k_ring_q_t *ring_q);
 
+/**
+ * @brief Reserve free items of a ring queue.
+ * hand out up to item_cnt free items at the tail of the ring queue, to be written in place(for
+ * example by a dma engine or a parser), and made visible to the consumer by tos_ring_q_commit.
+ *
+ * @attention only one producer may hold a reservation at a time, nothing else may enqueue on the
+ *            ring queue until the reservation is committed.
+ *
+ * @param[in]   ring_q      pointer to the handler of the ring queue.
+ * @param[in]   item_cnt    number of items wanted.
+ * @param[out]  span        the items reserved, in up to two regions.
+ *
+ * @return  the number of items reserved, less than item_cnt if the ring queue has not that many free.
+ */
+__API__ size_t  tos_ring_q_reserve(k_ring_q_t *ring_q, size_t item_cnt, k_ring_q_span_t *span);
+
+/**
+ * @brief Commit items reserved.
+ * make the first item_cnt items reserved by tos_ring_q_reserve visible to the consumer.
+ *
+ * @attention None
+ *
+ * @param[in]   ring_q      pointer to the handler of the ring queue.
+ * @param[in]   item_cnt    number of items written, not more than the ones reserved.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_NONE                     return successfully.
+ * @retval  #K_ERR_RING_Q_ITEM_CNT_INVALID  the ring queue has not item_cnt free items.
+ */
+__API__ k_err_t tos_ring_q_commit(k_ring_q_t *ring_q, size_t item_cnt);
+
+/**
+ * @brief Peek items of a ring queue.
+ * hand out up to item_cnt items at the head of the ring queue, to be read in place, and given back
+ * to the producer by tos_ring_q_release.
+ *
+ * @attention only one consumer may peek at a time, nothing else may dequeue from the ring queue until
+ *            the items peeked are released.
+ *
+ * @param[in]   ring_q      pointer to the handler of the ring queue.
+ * @param[in]   item_cnt    number of items wanted.
+ * @param[out]  span        the items peeked, in up to two regions.
+ *
+ * @return  the number of items peeked, less than item_cnt if the ring queue has not that many.
+ */
+__API__ size_t  tos_ring_q_peek(k_ring_q_t *ring_q, size_t item_cnt, k_ring_q_span_t *span);
+
+/**
+ * @brief Release items peeked.
+ * drop the first item_cnt items of the ring queue, after they are read in place.
+ *
+ * @attention None
+ *
+ * @param[in]   ring_q      pointer to the handler of the ring queue.
+ * @param[in]   item_cnt    number of items read, not more than the ones peeked.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_NONE                     return successfully.
+ * @retval  #K_ERR_RING_Q_ITEM_CNT_INVALID  the ring queue has not item_cnt items.
+ */
+__API__ k_err_t tos_ring_q_release(k_ring_q_t *ring_q, size_t item_cnt);
+
 #endif
 
@@ -20,14 +20,15 @@
 
 __CDECLS_BEGIN
 
-#define K_PRIO_TBL_SIZE         ((TOS_CFG_TASK_PRIO_MAX + 31) / 32)
-#define K_PRIO_TBL_SLOT_SIZE    (8 * sizeof(uint32_t))
-
-#define K_PRIO_NDX(prio)        ((prio) >> 5u) /* prio / 32u */
-#define K_PRIO_BIT(prio)        ((uint32_t)1u << (K_PRIO_TBL_SLOT_SIZE - 1u - ((prio) & (K_PRIO_TBL_SLOT_SIZE - 1u))))
+#if TOS_CFG_EDF_EN > 0u
+#define K_EDF_DENSITY_SHIFT     16u
+#define K_EDF_DENSITY_ONE       ((uint32_t)1u << K_EDF_DENSITY_SHIFT)
+#define K_EDF_DENSITY_MAX       ((uint32_t)((K_EDF_DENSITY_ONE * (uint64_t)TOS_CFG_EDF_UTIL_MAX) / 100u))
+#endif
 
 typedef struct readyqueue_st {
     k_list_t    task_list_head[TOS_CFG_TASK_PRIO_MAX];
+    uint32_t    prio_group;
     uint32_t    prio_mask[K_PRIO_TBL_SIZE];
     k_prio_t    highest_prio;
 } readyqueue_t;
@@ -50,6 +51,24 @@ __KNL__ void         readyqueue_remove(k_task_t *task);
 
 __KNL__ void         readyqueue_move_head_to_tail(k_prio_t prio);
 
+#if TOS_CFG_EDF_EN > 0u
+
+__KNL__ k_err_t      edf_bandwidth_reserve(k_tick_t runtime, k_tick_t deadline, uint32_t *density);
+
+__KNL__ void         edf_bandwidth_release(uint32_t density);
+
+__KNL__ void         edf_task_init(k_task_t *task, k_tick_t period, k_tick_t runtime, k_tick_t deadline, uint32_t density);
+
+__KNL__ void         edf_task_exit(k_task_t *task);
+
+__KNL__ void         edf_task_wakeup(k_task_t *task);
+
+__KNL__ void         edf_task_throttle(k_task_t *task);
+
+__KNL__ void         edf_tick(void);
+
+#endif
+
 __CDECLS_END
 
 #endif /* _TOS_SCHED_H_ */
@@ -136,6 +136,28 @@ __API__ k_err_t tos_sem_destroy_dyn(k_sem_t *sem);
  */
 __API__ k_err_t tos_sem_pend(k_sem_t *sem, k_tick_t timeout);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Pend a semaphore with a nanosecond timeout.
+ * pend a semaphore, the timeout is handled by a high resolution timer instead of the systick.
+ *
+ * @attention None
+ *
+ * @param[in]   sem         pointer to the handler of the semaphore.
+ * @param[in]   ns          how much time(in nanosecond) we would like to wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_PEND_NOWAIT                we get nothing, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, we get nothing.
+ * @retval  #K_ERR_PEND_DESTROY               the semaphore we are pending is destroyed.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_sem_pend_ns(k_sem_t *sem, k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Post a semaphore.
  * post a semaphore and wakeup one pending task.
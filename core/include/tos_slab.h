@@ -0,0 +1,128 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#ifndef _TOS_SLAB_H_
+#define  _TOS_SLAB_H_
+
+__CDECLS_BEGIN
+
+#if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
+
+/**
+ * Constructor of a kernel object, puts the parts of the object which are the same for every
+ * object of the type(pend object, alloc type, ...) in place. A destroyed object goes back to
+ * the cache in this constructed state, so the next create skips them.
+ */
+typedef void (*k_slab_ctor_t)(void *obj);
+
+#if TOS_CFG_SLAB_EN > 0u
+
+/* kernel object types created by the *_create_dyn, one cache each */
+#define K_SLAB_CACHE_NUM            6u
+
+typedef struct slab_st {
+    struct slab_st     *next;
+    size_t              obj_inuse;  /**< objects of this slab handed out */
+} slab_t;
+
+/* in front of every object of a slab */
+typedef struct slab_obj_header_st {
+    slab_t                      *slab;
+    struct slab_obj_header_st   *next_free;
+} slab_obj_hdr_t;
+
+typedef struct k_slab_cache_st {
+    knl_obj_type_t      type;
+    size_t              obj_size;
+
+    slab_t             *slab_list;
+    slab_obj_hdr_t     *free_list;
+
+    size_t              slab_cnt;
+    size_t              obj_inuse;
+    size_t              obj_inuse_max;
+    size_t              obj_free;
+} k_slab_cache_t;
+
+typedef struct k_slab_information_st {
+    size_t      obj_size;       /* size of an object, 0 if no object of the type is ever created */
+    size_t      slab_cnt;       /* slabs taken from the heap */
+    size_t      obj_inuse;      /* objects created and not destroyed yet */
+    size_t      obj_inuse_max;  /* peak of obj_inuse */
+    size_t      obj_free;       /* objects constructed and cached for the next create */
+} k_slab_info_t;
+
+/**
+ * @brief Check a kernel object cache.
+ * Get the usage counters of the cache of a kernel object type.
+ *
+ * @attention None
+ *
+ * @param[in]   type        type of the kernel object(KNL_OBJ_TYPE_SEMAPHORE, KNL_OBJ_TYPE_TASK, ...).
+ * @param[out]  info        pointer to the information struct.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_OBJ_PTR_NULL             info is NULL.
+ * @retval  #K_ERR_OBJ_INVALID              no cache for the type, it can not be created by a *_create_dyn.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_slab_check(knl_obj_type_t type, k_slab_info_t *info);
+
+/**
+ * @brief Reap the kernel object caches.
+ * Give every slab with no object in use back to the heap.
+ *
+ * @attention the caches keep their slabs to serve the next creates, call this after a burst of
+ * *_destroy_dyn to get the memory back.
+ *
+ * @return  None
+ */
+__API__ void    tos_slab_reap(void);
+
+__KNL__ void   *slab_obj_alloc(knl_obj_type_t type, size_t obj_size, k_slab_ctor_t ctor);
+
+__KNL__ void    slab_obj_free(knl_obj_type_t type, void *obj);
+
+#else
+
+__KNL__ __STATIC_INLINE__ void *slab_obj_alloc(knl_obj_type_t type, size_t obj_size, k_slab_ctor_t ctor)
+{
+    void *obj;
+
+    obj = mmheap_shared_alloc(obj_size);
+    if (obj) {
+        memset(obj, 0, obj_size);
+    }
+    if (obj && ctor) {
+        ctor(obj);
+    }
+
+    return obj;
+}
+
+__KNL__ __STATIC_INLINE__ void slab_obj_free(knl_obj_type_t type, void *obj)
+{
+    mmheap_shared_free(obj);
+}
+
+#endif
+
+#endif
+
+__CDECLS_END
+
+#endif /* _TOS_SLAB_H_ */
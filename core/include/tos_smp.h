@@ -0,0 +1,123 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+
+#ifndef _TOS_SMP_H_
+#define  _TOS_SMP_H_
+
+__CDECLS_BEGIN
+
+#if TOS_CFG_SMP_EN > 0u
+
+#define K_CPU_AFFINITY_BIT(cpu_id)      ((k_cpu_affinity_t)1u << (cpu_id))
+#define K_CPU_AFFINITY_ALL              ((k_cpu_affinity_t)(((uint64_t)1u << TOS_CFG_CPU_NUM) - 1u))
+
+/**
+ * a spinlock for the sections shared by the cpus.
+ * the kernel itself is protected by k_knl_lock, taken by TOS_CPU_INT_DISABLE(the outermost one)
+ * and released by the TOS_CPU_INT_ENABLE paired with it.
+ */
+typedef struct k_spinlock_st {
+    volatile uint32_t   locked;
+} k_spinlock_t;
+
+/**
+ * the kernel state of a cpu, k_curr_task/k_next_task/k_rdyq/... are the ones of the calling cpu
+ */
+typedef struct k_cpu_st {
+    k_task_t       *curr_task;              /**< task running on the cpu */
+    k_task_t       *next_task;              /**< task to run on the cpu */
+    k_nesting_t     irq_nest_cnt;           /**< interrupt nesting count of the cpu */
+    k_nesting_t     sched_lock_nest_cnt;    /**< schedule lock nesting count, the lock only holds the cpu */
+    uint32_t        task_cnt;               /**< how many tasks live on the cpu, a new task goes to the one with the fewest */
+    readyqueue_t    rdyq;                   /**< ready queue of the tasks living on the cpu */
+} k_cpu_t;
+
+/**
+ * @brief Initialize a spinlock.
+ *
+ * @param[in]   lock        the spinlock.
+ *
+ * @return  None
+ */
+__API__ void tos_spin_lock_init(k_spinlock_t *lock);
+
+/**
+ * @brief Take a spinlock.
+ * spin until the lock is taken.
+ *
+ * @attention never try to take a spinlock in a task while an interrupt of the same cpu may take
+ *            it too, disable the interrupt first.
+ *
+ * @param[in]   lock        the spinlock.
+ *
+ * @return  None
+ */
+__API__ void tos_spin_lock(k_spinlock_t *lock);
+
+/**
+ * @brief Try to take a spinlock.
+ *
+ * @param[in]   lock        the spinlock.
+ *
+ * @return  whether the lock is taken
+ * @retval  #K_TRUE         the lock is taken.
+ * @retval  #K_FALSE        the lock is held by someone else.
+ */
+__API__ int tos_spin_trylock(k_spinlock_t *lock);
+
+/**
+ * @brief Release a spinlock.
+ *
+ * @param[in]   lock        the spinlock.
+ *
+ * @return  None
+ */
+__API__ void tos_spin_unlock(k_spinlock_t *lock);
+
+/**
+ * @brief Get the id of the calling cpu.
+ *
+ * @attention a task may be moved to another cpu(tos_task_affinity_set), the id is only stable
+ *            while the interrupt is disabled.
+ *
+ * @return  the cpu id, in [0, TOS_CFG_CPU_NUM)
+ */
+__API__ uint32_t tos_cpu_id_get(void);
+
+__KNL__ void smp_init(void);
+
+__KNL__ void smp_sched_prepare(void);
+
+__KNL__ void smp_task_place(k_task_t *task);
+
+__KNL__ void smp_task_leave(k_task_t *task);
+
+__KNL__ void smp_task_migrate(k_task_t *task, uint32_t cpu_id);
+
+__KNL__ uint32_t smp_cpu_pick(k_cpu_affinity_t affinity);
+
+__KNL__ int smp_task_is_running(k_task_t *task);
+
+__KNL__ void smp_resched_notify(k_task_t *task);
+
+#endif
+
+__CDECLS_END
+
+#endif /* _TOS_SMP_H_ */
+
@@ -42,6 +42,8 @@ typedef enum knl_obj_type_en {
     KNL_OBJ_TYPE_STOPWATCH                      = 0xDAD7,
     KNL_OBJ_TYPE_TASK                           = 0xDAD8,
     KNL_OBJ_TYPE_TIMER                          = 0xDAD9,
+    KNL_OBJ_TYPE_HRTIMER                        = 0xDADA,
+    KNL_OBJ_TYPE_MMHEAP_ARENA                   = 0xDADB,
 
     // ipc object
     KNL_OBJ_TYPE_BARRIER                        = 0x0BEE,
@@ -166,7 +168,7 @@ __API__ k_err_t tos_knl_sched_lock(void);
  */
 __API__ k_err_t tos_knl_sched_unlock(void);
 
-#if TOS_CFG_TICKLESS_EN > 0u
+#if (TOS_CFG_TICKLESS_EN > 0u) || (TOS_CFG_VIRTUAL_TIME_EN > 0u)
 __KNL__ k_tick_t knl_next_expires_get(void);
 #endif
 
@@ -65,10 +65,35 @@ __CDECLS_BEGIN
 #define K_TASK_PRIO_IDLE                                (k_prio_t)(TOS_CFG_TASK_PRIO_MAX - (k_prio_t)1u)
 #define K_TASK_PRIO_INVALID                             (k_prio_t)(TOS_CFG_TASK_PRIO_MAX)
 
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+// if we are waiting for any of the notification bits expected
+#define TOS_OPT_TASK_NOTIFY_WAIT_ANY                    (k_opt_t)0x0001
+
+// if we are waiting for all of the notification bits expected
+#define TOS_OPT_TASK_NOTIFY_WAIT_ALL                    (k_opt_t)0x0002
+
+// clear the bits expected from the notification word when the wait is satisfied,
+// pass (TOS_OPT_TASK_NOTIFY_WAIT_CLR | TOS_OPT_TASK_NOTIFY_WAIT_ANY) or (TOS_OPT_TASK_NOTIFY_WAIT_CLR | TOS_OPT_TASK_NOTIFY_WAIT_ALL)
+#define TOS_OPT_TASK_NOTIFY_WAIT_CLR                    (k_opt_t)0x0004
+#endif
+
 typedef void (*k_task_entry_t)(void *arg);
 
 typedef void (*k_task_walker_t)(k_task_t *task);
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+/**
+ * runtime statistics of a task, taken by tos_task_runtime_snapshot
+ */
+typedef struct k_task_runtime_st {
+    k_task_t           *task;
+    uint64_t            runtime;        /**< how long the task has been running, in the unit of cpu_task_runtime_get(nanosecond on the Linux port) */
+    uint32_t            switch_cnt;     /**< how many times the task has been switched in */
+    uint32_t            preempt_cnt;    /**< how many times the task was switched out while still ready */
+    k_tick_t            last_run;       /**< the tick when the task was switched in last time */
+} k_task_runtime_t;
+#endif
+
 /**
  * task control block
  */
@@ -92,7 +117,8 @@ struct k_task_st {
 
     k_list_t            stat_list;              /**< list for hooking us to the k_stat_list */
 
-    k_tick_t            tick_expires;           /**< if we are in k_tick_list, how much time will we wait for? */
+    k_tick_t            tick_expires;           /**< if we are in k_tick_list, how much time will we wait for?
+                                                    if we are in k_tick_wheel(TOS_CFG_TICK_WHEEL_EN), at which tick of the wheel shall we wakeup? */
 
     k_list_t            tick_list;              /**< list for hooking us to the k_tick_list */
     k_list_t            pend_list;              /**< when we are ready, our pend_list is in readyqueue; when pend, in a certain pend object's list. */
@@ -108,9 +134,46 @@ struct k_task_st {
                                                     change in the right time(mutex_old_owner_release) later. */
 #endif
 
+#if TOS_CFG_HRTIMER_EN > 0u
+    k_hrtimer_t         hrtimer;                /**< if we delay or pend with a nanosecond timeout, we are waken up by this hrtimer instead of the k_tick_list */
+#endif
+
     pend_obj_t         *pending_obj;            /**< if we are pending, which pend object's list we are in? */
+
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    pend_any_t         *pend_any;               /**< if we are in tos_wait_any, the objects we are waiting for. */
+#endif
     pend_state_t        pend_state;             /**< why we wakeup from a pend */
 
+#if TOS_CFG_SMP_EN > 0u
+    uint32_t            cpu_id;             /**< the cpu we live on, we are in its readyqueue when ready */
+    k_cpu_affinity_t    cpu_affinity;       /**< bit n set if we are allowed to run on cpu n */
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    uint64_t            runtime;            /**< how long we have been running, not including the time since we were switched in this time */
+    uint64_t            runtime_stamp;      /**< cpu_task_runtime_get when we were switched in */
+    uint32_t            switch_cnt;         /**< how many times we have been switched in */
+    uint32_t            preempt_cnt;        /**< how many times we were switched out while still ready(preempted) */
+    k_tick_t            last_run;           /**< the tick when we were switched in last time */
+#endif
+
+#if TOS_CFG_EDF_EN > 0u
+    k_tick_t            edf_period;         /**< period of an EDF task, 0 if we are a fixed priority task */
+    k_tick_t            edf_runtime;        /**< how many ticks we may run in every period */
+    k_tick_t            edf_deadline;       /**< deadline relative to the beginning of the period */
+    k_tick_t            edf_release;        /**< at which tick the current period begins */
+    k_tick_t            edf_abs_deadline;   /**< absolute deadline of the current period, we are kept in the EDF band of the readyqueue in this order */
+    k_tick_t            edf_budget;         /**< how many ticks left in the current period, when used up we are throttled until the next period */
+    uint32_t            edf_density;        /**< runtime / deadline in K_EDF_DENSITY_ONE units, the bandwidth we reserved when created */
+#endif
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    k_evtdrv_handler_t  evtdrv_handler;     /**< handler of an event-driven task, K_NULL if we are a task with a stack of our own */
+    k_event_flag_t      evtdrv_event;       /**< events posted to us, not handled yet */
+    k_list_t            evtdrv_msg_list;    /**< messages posted to us, not handled yet */
+#endif
+
 #if TOS_CFG_ROUND_ROBIN_EN > 0u
     k_timeslice_t       timeslice_reload;   /**< if current time slice is used up, use time_slice_reload to reload our time slice */
     k_timeslice_t       timeslice;          /**< how much time slice left for us? */
@@ -125,6 +188,17 @@ struct k_task_st {
     size_t              mail_size;
 #endif
 
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+    uint32_t            notify;             /**< the notification word, bits set by tos_task_notify */
+    uint32_t            notify_expect;      /**< if we are in tos_task_notify_wait, the bits we are waiting for, 0 if we are not */
+    k_opt_t             notify_opt;         /**< if we are in tos_task_notify_wait, the option(TOS_OPT_TASK_NOTIFY_WAIT_*) */
+    uint32_t           *notify_ret;         /**< if the wait is satisfied, the notification word is returned here by the notifier */
+#endif
+
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    struct k_mmheap_arena_st   *mmheap_arena;   /**< the heap arena our allocations go to, K_NULL for the shared heap */
+#endif
+
 #if TOS_CFG_EVENT_EN > 0u
     k_opt_t             opt_event_pend;     /**< if we are pending an event, what's the option for the pending(TOS_OPT_EVENT_PEND_*)? */
     k_event_flag_t      flag_expect;        /**< if we are pending an event, what event flag are we pending for ? */
@@ -150,7 +224,7 @@ struct k_task_st {
  *
  * @return  errcode
  * @retval  #K_ERR_TASK_STK_SIZE_INVALID    stack size is invalid.
- * @retval  #K_ERR_TASK_PRIO_INVALID        priority is invalid.
+ * @retval  #K_ERR_TASK_PRIO_INVALID        priority is invalid, or TOS_CFG_EDF_PRIO(for the EDF tasks only).
  * @retval  #K_ERR_NONE                     return successfully.
  */
 __API__ k_err_t tos_task_create(k_task_t *task,
@@ -172,10 +246,101 @@ __API__ k_err_t tos_task_create(k_task_t *task,
  *
  * @return  errcode
  * @retval  #K_ERR_TASK_DESTROY_IDLE    attempt to destroy idle task.
+ * @retval  #K_ERR_TASK_EVTDRV_BUSY     the handler of the event-driven task is preempted, not returned yet.
  * @retval  #K_ERR_NONE                 return successfully.
  */
 __API__ k_err_t tos_task_destroy(k_task_t *task);
 
+#if TOS_CFG_EDF_EN > 0u
+
+/**
+ * @brief Create an EDF(earliest deadline first) task.
+ * create a periodic task scheduled by its deadline instead of a fixed priority.
+ * all the EDF tasks share the priority TOS_CFG_EDF_PRIO, so the EDF band runs below the fixed
+ * priority tasks with a higher priority and above the ones with a lower priority; inside the band,
+ * the task with the earliest absolute deadline runs first.
+ * every period the task may run for runtime ticks, when the budget is used up the task is throttled
+ * until the next period begins.
+ *
+ * @attention the task should call tos_task_edf_yield when the job of the current period is done.
+ *            the task is admitted only if the sum of runtime / deadline of all the EDF tasks does
+ *            not exceed TOS_CFG_EDF_UTIL_MAX percent.
+ *
+ * @param[in]   task        pointer to the handler of the task.
+ * @param[in]   name        name of the task.
+ * @param[in]   entry       running entry of the task.
+ * @param[in]   arg         argument for the entry of the task.
+ * @param[in]   stk_base    stack base address of the task.
+ * @param[in]   stk_size    stack size of the task.
+ * @param[in]   period      period of the task, in ticks.
+ * @param[in]   runtime     budget of the task in every period, in ticks.
+ * @param[in]   deadline    deadline relative to the beginning of the period, in ticks(0 means the same as period).
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_EDF_PARAM_INVALID   runtime <= deadline <= period is not satisfied.
+ * @retval  #K_ERR_TASK_EDF_OVERLOAD        admission control failed, not enough bandwidth left.
+ * @retval  #K_ERR_TASK_STK_SIZE_INVALID    stack size is invalid.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_task_create_edf(k_task_t *task,
+                                                    const char *name,
+                                                    k_task_entry_t entry,
+                                                    void *arg,
+                                                    k_stack_t *stk_base,
+                                                    size_t stk_size,
+                                                    k_tick_t period,
+                                                    k_tick_t runtime,
+                                                    k_tick_t deadline);
+
+/**
+ * @brief Finish the job of the current period.
+ * give up the budget left, current EDF task sleeps until the next period begins.
+ *
+ * @attention None
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_NOT_EDF     current task is not an EDF task.
+ * @retval  #K_ERR_SCHED_LOCKED     scheduler is locked.
+ * @retval  #K_ERR_NONE             return successfully.
+ */
+__API__ k_err_t tos_task_edf_yield(void);
+
+#endif
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+
+/**
+ * @brief Create an event-driven task.
+ * create a run-to-completion task without a stack of its own: the handler is called on the
+ * shared stack(TOS_CFG_EVTDRV_STK_SIZE) every time events or messages are posted to the task
+ * (tos_evtdrv_event_post/tos_evtdrv_msg_post), and returns when done.
+ * the event-driven tasks are in the readyqueue with the other tasks and dispatched by priority:
+ * a task with a higher priority preempts a handler, while an event-driven task with a higher
+ * priority waits until the handler running returns(the handlers are nested never, so one stack
+ * is enough for all of them). the next handler is called right on the shared stack, no context
+ * switch in between.
+ *
+ * @attention the handler must not block, the blocking calls fail in a handler as if the scheduler
+ *            was locked.
+ *
+ * @param[in]   task        pointer to the handler of the task.
+ * @param[in]   name        name of the task.
+ * @param[in]   handler     handler of the task.
+ * @param[in]   arg         argument for the handler.
+ * @param[in]   prio        priority of the task.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_PRIO_INVALID        priority is invalid, or TOS_CFG_EDF_PRIO(for the EDF tasks only).
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_task_create_evtdrv(k_task_t *task,
+                                                        const char *name,
+                                                        k_evtdrv_handler_t handler,
+                                                        void *arg,
+                                                        k_prio_t prio);
+
+#endif
+
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 
 /**
@@ -192,7 +357,7 @@ __API__ k_err_t tos_task_destroy(k_task_t *task);
  *
  * @return  errcode
  * @retval  #K_ERR_TASK_STK_SIZE_INVALID    stack size is invalid.
- * @retval  #K_ERR_TASK_PRIO_INVALID        priority is invalid.
+ * @retval  #K_ERR_TASK_PRIO_INVALID        priority is invalid, or TOS_CFG_EDF_PRIO(for the EDF tasks only).
  * @retval  #K_ERR_TASK_OUT_OF_MEMORY       out of memory(insufficient heap memory).
  * @retval  #K_ERR_NONE                     return successfully.
  */
@@ -234,6 +399,25 @@ __API__ k_err_t tos_task_destroy_dyn(k_task_t *task);
  */
 __API__ k_err_t tos_task_delay(k_tick_t delay);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/**
+ * @brief Delay current task for nanoseconds.
+ * Delay for a specified amount of nanoseconds, the task is waken up by a high resolution timer
+ * instead of the systick, so the delay is not limited to the resolution of the systick.
+ *
+ * @attention None
+ *
+ * @param[in]   ns          amount of nanoseconds to delay.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_SCHED_LOCKED   scheduler is locked.
+ * @retval  #K_ERR_NONE           return successfully.
+ */
+__API__ k_err_t tos_task_delay_ns(k_hrtime_t ns);
+
+#endif
+
 /**
  * @brief Resume task from delay.
  * Resume a delayed task from delay.
@@ -249,6 +433,72 @@ __API__ k_err_t tos_task_delay(k_tick_t delay);
  */
 __API__ k_err_t tos_task_delay_abort(k_task_t *task);
 
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+
+/**
+ * @brief Notify a task.
+ * set bits in the notification word of a task, wakeup the task if it is waiting for them.
+ *
+ * @attention a task's notification word works like an event of its own, without any pend object.
+ *            can be called in the interrupt.
+ *
+ * @param[in]   task        the pointer to the handler of the task.
+ * @param[in]   bits        the bits to set.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_task_notify(k_task_t *task, uint32_t bits);
+
+/**
+ * @brief Wait for notification.
+ * wait until the bits expected are set in the notification word of current task.
+ *
+ * @attention if opt is TOS_OPT_TASK_NOTIFY_WAIT_ANY, any of the bits_expect is set is ok;
+ *            if opt is TOS_OPT_TASK_NOTIFY_WAIT_ALL, must all the bits_expect is set is ok.
+ *            with TOS_OPT_TASK_NOTIFY_WAIT_CLR, the bits_expect are cleared when the wait is satisfied.
+ *
+ * @param[in]   bits_expect the bits we are waiting for.
+ * @param[out]  notify      the notification word when the wait is satisfied(before the bits are cleared).
+ * @param[in]   timeout     how much time(in k_tick_t) we would like to wait.
+ * @param[in]   opt         option for the wait.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_NOTIFY_OPT_INVALID    bits_expect is zero, or opt is invalid.
+ * @retval  #K_ERR_PEND_NOWAIT                the bits are not set, and we don't wanna wait.
+ * @retval  #K_ERR_PEND_SCHED_LOCKED          we can wait, but scheduler is locked.
+ * @retval  #K_ERR_PEND_TIMEOUT               the time we wait is up, the bits are not set.
+ * @retval  #K_ERR_PEND_ABNORMAL              we are suspended while waiting.
+ * @retval  #K_ERR_NONE                       return successfully.
+ */
+__API__ k_err_t tos_task_notify_wait(uint32_t bits_expect, uint32_t *notify, k_tick_t timeout, k_opt_t opt);
+
+/**
+ * @brief Clear notification bits.
+ * clear bits in the notification word of current task.
+ *
+ * @attention None
+ *
+ * @param[in]   bits        the bits to clear.
+ *
+ * @return  the notification word before the bits are cleared.
+ */
+__API__ uint32_t tos_task_notify_clear(uint32_t bits);
+
+/**
+ * @brief Get the notification word.
+ * get the notification word of a task.
+ *
+ * @attention None
+ *
+ * @param[in]   task        the pointer to the handler of the task, K_NULL for current task.
+ *
+ * @return  the notification word.
+ */
+__API__ uint32_t tos_task_notify_get(k_task_t *task);
+
+#endif
+
 /**
  * @brief Suspend a task.
  * Bring a task to sleep.
@@ -259,6 +509,7 @@ __API__ k_err_t tos_task_delay_abort(k_task_t *task);
  *
  * @return  errcode
  * @retval  #K_ERR_TASK_SUSPEND_IDLE  attempt to suspend idle task.
+ * @retval  #K_ERR_TASK_EVTDRV_BUSY   the handler of the event-driven task is preempted, not returned yet.
  * @retval  #K_ERR_NONE               return successfully.
  */
 __API__ k_err_t tos_task_suspend(k_task_t *task);
@@ -281,17 +532,39 @@ __API__ k_err_t tos_task_resume(k_task_t *task);
  * @brief Change task priority.
  * Change a priority of the task.
  *
- * @attention None
+ * @attention with TOS_CFG_EDF_EN, TOS_CFG_EDF_PRIO is for the EDF tasks only, and the priority of an
+ * EDF task can not be changed.
  *
  * @param[in]   task        pointer to the handler of the task to be resume.
  * @param[in]   prio_new    new priority.
  *
  * @return  errcode
- * @retval  #K_ERR_TASK_PRIO_INVALID  new priority is invalid.
+ * @retval  #K_ERR_TASK_PRIO_INVALID  new priority is invalid, or moves the task in or out of the EDF band.
  * @retval  #K_ERR_NONE               return successfully.
  */
 __API__ k_err_t tos_task_prio_change(k_task_t *task, k_prio_t prio_new);
 
+#if TOS_CFG_SMP_EN > 0u
+
+/**
+ * @brief Set the cpu affinity of a task.
+ * a new task may run on any cpu and lives on the one with the fewest tasks, if the cpu it lives
+ * on is not in the new affinity, the task moves to the one with the fewest tasks in the affinity.
+ *
+ * @attention a task running on another cpu right now moves the next time it becomes ready.
+ *
+ * @param[in]   task        pointer to the handler of the task, K_NULL for the current task.
+ * @param[in]   affinity    bit n set if the task may run on cpu n(K_CPU_AFFINITY_BIT).
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TASK_AFFINITY_INVALID    no cpu in the affinity, or the task is an idle task.
+ * @retval  #K_ERR_SCHED_LOCKED             move the current task while the schedule is locked.
+ * @retval  #K_ERR_NONE                     return successfully.
+ */
+__API__ k_err_t tos_task_affinity_set(k_task_t *task, k_cpu_affinity_t affinity);
+
+#endif
+
 /**
  * @brief Quit schedule this time.
  * Quit the cpu this time.
@@ -366,8 +639,45 @@ __API__ void tos_task_walkthru(k_task_walker_t walker);
  */
 __DEBUG__ void tos_task_info_display(void);
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+/**
+ * @brief Take a snapshot of the runtime statistics of all the tasks.
+ * walk through the k_stat_list and copy the runtime statistics of every task, the time current
+ * task has been running since it was switched in is included.
+ *
+ * @attention None
+ *
+ * @param[out]  snapshot    buffer to hold the statistics.
+ * @param[in]   cnt         how many k_task_runtime_t the buffer can hold.
+ *
+ * @return  how many tasks are in the snapshot.
+ */
+__API__ size_t tos_task_runtime_snapshot(k_task_runtime_t *snapshot, size_t cnt);
+
+/**
+ * @brief Get the system load.
+ * the load is derived from the runtime of the idle task in the last TOS_CFG_TASK_RUNTIME_LOAD_WINDOW
+ * ticks, smoothed with the former windows.
+ *
+ * @attention None
+ *
+ * @param   None
+ *
+ * @return  the system load in per mille.
+ */
+__API__ uint32_t tos_task_load_get(void);
+
+__KNL__ void task_runtime_switch(k_task_t *from, k_task_t *to);
+
+__KNL__ void task_runtime_load_update(void);
+
+#endif
+
 __KNL__ void task_free_all(void);
 
+__KNL__ void task_prio_change(k_task_t *task, k_prio_t prio_new);
+
 __KNL__ __STATIC_INLINE__ int task_state_is_ready(k_task_t *task)
 {
     return task->state == K_TASK_STATE_READY;
@@ -428,6 +738,20 @@ __KNL__ __STATIC_INLINE__ void task_state_set_sleeping(k_task_t *task)
     task->state |= K_TASK_STATE_SLEEP;
 }
 
+#if TOS_CFG_EDF_EN > 0u
+__KNL__ __STATIC_INLINE__ int task_is_edf(k_task_t *task)
+{
+    return task->edf_period != (k_tick_t)0u;
+}
+#endif
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+__KNL__ __STATIC_INLINE__ int task_is_evtdrv(k_task_t *task)
+{
+    return task->evtdrv_handler != K_NULL;
+}
+#endif
+
 __DEBUG__ __STATIC_INLINE__ void task_default_walker(k_task_t *task)
 {
     char *state_str = "ABNORMAL";
@@ -456,6 +780,11 @@ __DEBUG__ __STATIC_INLINE__ void task_default_walker(k_task_t *task)
     }
     tos_kprintln("tsk stat: %s", state_str);
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    tos_kprintln("runtime : %llu", (unsigned long long)task->runtime);
+    tos_kprintln("switches: %u, preempted: %u", task->switch_cnt, task->preempt_cnt);
+#endif
+
     tos_kprintln("stk size: %d", task->stk_size);
     tos_kprintln("stk base: 0x%p", task->stk_base);
     tos_kprintln("stk top : 0x%p", task->stk_base + task->stk_size);
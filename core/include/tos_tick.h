@@ -20,6 +20,21 @@
 
 __CDECLS_BEGIN
 
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+
+#define K_TICK_WHEEL_SLOT_NUM           (TOS_CFG_TICK_WHEEL_SIZE)
+#define K_TICK_WHEEL_SLOT_MASK          (K_TICK_WHEEL_SLOT_NUM - 1u)
+
+/**
+ * timing wheel holding all the tasks delayed or pend for timeout
+ */
+typedef struct tick_wheel_st {
+    k_tick_t    now;                            /**< ticks the wheel has turned, the tick_expires of a task in the wheel is based on this */
+    k_list_t    slot[K_TICK_WHEEL_SLOT_NUM];    /**< task sleeping until tick "expires" is in slot[expires & K_TICK_WHEEL_SLOT_MASK] */
+} tick_wheel_t;
+
+#endif
+
 /**
  * @brief Systick interrupt handler.
  * systick interrupt handler.
@@ -38,7 +53,11 @@ __KNL__ void tick_list_add(k_task_t *task, k_tick_t timeout);
 
 __KNL__ void tick_list_remove(k_task_t *task);
 
-#if TOS_CFG_TICKLESS_EN > 0u
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+__KNL__ void tick_wheel_init(void);
+#endif
+
+#if (TOS_CFG_TICKLESS_EN > 0u) || (TOS_CFG_VIRTUAL_TIME_EN > 0u)
 __KNL__ k_tick_t tick_next_expires_get(void);
 #endif
 
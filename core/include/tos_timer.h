@@ -31,6 +31,7 @@ __CDECLS_BEGIN
 typedef enum timer_change_type_en {
     TIMER_CHANGE_TYPE_DELAY,
     TIMER_CHANGE_TYPE_PERIOD,
+    TIMER_CHANGE_TYPE_SLACK,
 } timer_change_type_t;
 
 /**
@@ -54,19 +55,35 @@ typedef struct k_timer_st {
 
     k_timer_callback_t      cb;         /**< callback when time is up */
     void                   *cb_arg;     /**< argument for callback */
-    k_list_t                list;       /**< list for hooking us to the k_tick_list */
+    k_list_t                list;       /**< list for hooking us to the k_timer_ctl */
     k_tick_t                expires;    /**< how much time left until time expires */
     k_tick_t                delay;      /**< how much time from now to begin the first run of the timer */
     k_tick_t                period;     /**< if the time expires, how much time after should we begin the next round */
+    k_tick_t                slack;      /**< how much later than expires the timer is allowed to fire, so that it can be batched with others */
     k_opt_t                 opt;        /**< option for the timer, see TOS_OPT_TIMER_* */
     timer_state_t           state;      /**< state for the timer, see TIMER_STATE_* */
 } k_timer_t;
 
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+
+#define K_TIMER_WHEEL_SLOT_NUM          (TOS_CFG_TIMER_WHEEL_SIZE)
+#define K_TIMER_WHEEL_SLOT_MASK         (K_TIMER_WHEEL_SLOT_NUM - 1u)
+
+typedef struct timer_control_st {
+    k_tick_t    next_expires;                   /**< never later than the first timer to expire, but maybe earlier */
+    k_tick_t    now;                            /**< the tick the wheel has been turned to */
+    k_list_t    slot[K_TIMER_WHEEL_SLOT_NUM];   /**< timer expires at tick "expires" is in slot[expires & K_TIMER_WHEEL_SLOT_MASK] */
+} timer_ctl_t;
+
+#else
+
 typedef struct timer_control_st {
     k_tick_t    next_expires;
     k_list_t    list;
 } timer_ctl_t;
 
+#endif
+
 /**
  * @brief Create a timer.
  * Create a timer.
@@ -88,6 +105,31 @@ typedef struct timer_control_st {
 __API__ k_err_t tos_timer_create(k_timer_t *tmr, k_tick_t delay, k_tick_t period,
                                         k_timer_callback_t callback, void *cb_arg, k_opt_t opt);
 
+/**
+ * @brief Create a timer with slack.
+ * Create a timer which is allowed to fire at most slack ticks later than its expires.
+ *
+ * @attention timers whose slack windows overlap are batched to fire on the same tick,
+ *            which saves wakeups(and makes the tickless sleep longer). a timer created by
+ *            tos_timer_create has no slack.
+ *
+ * @param[in]   tmr         pointer to the handler of the timer.
+ * @param[in]   delay       time interval for a timer to run.
+ * @param[in]   period      period for a timer to restart to run.
+ * @param[in]   slack       how much later than expires the timer is allowed to fire.
+ * @param[in]   callback    callback function called when the timer expires.
+ * @param[in]   cb_arg      argument for the callback.
+ * @param[in]   opt         option for the function call.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INVALID_PERIOD   period is invalid.
+ * @retval  #K_ERR_TIMER_INVALID_DELAY    delay is invalid.
+ * @retval  #K_ERR_TIMER_SLACK_FOREVER    slack is TOS_TIME_FOREVER.
+ * @retval  #K_ERR_NONE                   return successfully.
+ */
+__API__ k_err_t tos_timer_create_slack(k_timer_t *tmr, k_tick_t delay, k_tick_t period, k_tick_t slack,
+                                                k_timer_callback_t callback, void *cb_arg, k_opt_t opt);
+
 /**
  * @brief Delete a timer.
  * Delete the timer.
@@ -203,6 +245,22 @@ __API__ k_err_t tos_timer_delay_change(k_timer_t *tmr, k_tick_t delay);
  */
 __API__ k_err_t tos_timer_period_change(k_timer_t *tmr, k_tick_t period);
 
+/**
+ * @brief Change a timer's slack.
+ *
+ * @attention None
+ *
+ * @param[in]   tmr         pointer to the handler of the timer.
+ * @param[in]   slack       new slack of the timer.
+ *
+ * @return  errcode
+ * @retval  #K_ERR_TIMER_INACTIVE       the timer is not active yet.
+ * @retval  #K_ERR_TIMER_RUNNING        the timer is running.
+ * @retval  #K_ERR_TIMER_SLACK_FOREVER  the slack is TOS_TIME_FOREVER.
+ * @retval  #K_ERR_NONE                 return successfully.
+ */
+__API__ k_err_t tos_timer_slack_change(k_timer_t *tmr, k_tick_t slack);
+
 
 #if TOS_CFG_TIMER_AS_PROC > 0u
 
@@ -0,0 +1,107 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#ifndef _TOS_TRACE_H_
+#define  _TOS_TRACE_H_
+
+__CDECLS_BEGIN
+
+#if TOS_CFG_TRACE_EN > 0u
+
+#define K_TRACE_EVENT_NUM               TOS_CFG_TRACE_BUF_SIZE
+#define K_TRACE_EVENT_MASK              (K_TRACE_EVENT_NUM - 1u)
+
+/*
+ * seq of a slot in the buffer: the sequence number of its event shifted up by one, the low bit set while
+ * the slot is being written(or was never written), so a busy slot never looks like a done one
+ */
+#define K_TRACE_SEQ_BUSY                1u
+#define K_TRACE_SEQ_DONE(seq)           ((uint32_t)(seq) << 1)
+
+/**
+ * type of a trace event, and what obj/arg/info of the event mean
+ */
+typedef enum k_trace_event_type_en {
+    K_TRACE_EVENT_NONE,
+    K_TRACE_EVENT_TASK_CREATE,      /**< obj: task,  arg: the first 8 chars of the task name */
+    K_TRACE_EVENT_TASK_SWITCH,      /**< obj: task switched out(0 when the kernel starts),  arg: task switched in */
+    K_TRACE_EVENT_PEND,             /**< obj: pend object,  arg: task blocked on the object */
+    K_TRACE_EVENT_WAKEUP,           /**< obj: pend object(0 if just delayed),  arg: task waken up,  info: pend_state_t */
+    K_TRACE_EVENT_TICK,             /**< arg: k_tick_count */
+    K_TRACE_EVENT_MMHEAP_ALLOC,     /**< obj: memory allocated,  arg: size */
+    K_TRACE_EVENT_MMHEAP_FREE,      /**< obj: memory freed */
+    K_TRACE_EVENT_TIMER_FIRE,       /**< obj: timer,  arg: callback */
+    K_TRACE_EVENT_POST,             /**< obj: pend object(0 for a task notify),  arg: message/mail/event flag/notify bits posted(count of a post_n, 0 for the others),  info: opt_post_t */
+} k_trace_event_type_t;
+
+/**
+ * a trace event, fixed width fields so that a raw dump of the buffer can be parsed on any host
+ */
+typedef struct k_trace_event_st {
+    uint64_t    timestamp;  /**< cpu_trace_clock_get when the event happened(nanosecond on the Linux port) */
+    uint32_t    seq;        /**< sequence number of the event(K_TRACE_SEQ_DONE/K_TRACE_SEQ_BUSY in the buffer) */
+    uint16_t    type;       /**< K_TRACE_EVENT_* */
+    uint16_t    info;       /**< small argument, depends on type */
+    uint64_t    obj;        /**< the object of the event, depends on type */
+    uint64_t    arg;        /**< argument, depends on type */
+} k_trace_event_t;
+
+/**
+ * trace ring buffer, the newest event overwrites the oldest one
+ */
+typedef struct k_trace_st {
+    uint32_t            head;                       /**< sequence number of the next event */
+    k_trace_event_t     event[K_TRACE_EVENT_NUM];
+} k_trace_t;
+
+#define TOS_TRACE(type, obj, arg, info) \
+    trace_event_record((type), (uint64_t)(cpu_addr_t)(obj), (uint64_t)(cpu_addr_t)(arg), (uint16_t)(info))
+
+#define TOS_TRACE_TASK_CREATE(task)     trace_task_create(task)
+
+/**
+ * @brief Read the trace buffer.
+ * copy the events in the trace buffer out, the oldest first.
+ *
+ * @attention the buffer is not locked, an event being written or overwritten while we are
+ *            reading is just skipped.
+ *
+ * @param[out]  event       buffer to hold the events.
+ * @param[in]   cnt         how many events the buffer can hold.
+ *
+ * @return  how many events are copied.
+ */
+__API__ size_t tos_trace_read(k_trace_event_t *event, size_t cnt);
+
+__KNL__ void trace_init(void);
+
+__KNL__ void trace_event_record(uint16_t type, uint64_t obj, uint64_t arg, uint16_t info);
+
+__KNL__ void trace_task_create(k_task_t *task);
+
+#else
+
+#define TOS_TRACE(type, obj, arg, info)
+
+#define TOS_TRACE_TASK_CREATE(task)
+
+#endif
+
+__CDECLS_END
+
+#endif /* _TOS_TRACE_H_ */
+
@@ -72,6 +72,7 @@ __API__ k_err_t tos_barrier_pend(k_barrier_t *barrier)
 
     if (barrier->count == (k_barrier_cnt_t)1u) {
         barrier->count = (k_barrier_cnt_t)0u;
+        TOS_TRACE(K_TRACE_EVENT_POST, &barrier->pend_obj, 0u, OPT_POST_ALL);
         pend_wakeup_all(&barrier->pend_obj, PEND_STATE_POST);
 
         TOS_CPU_INT_ENABLE();
@@ -160,7 +160,7 @@ __API__ k_err_t tos_bin_heap_create_dyn(k_bin_heap_t *bin_heap, size_t item_cnt,
     TOS_PTR_SANITY_CHECK(bin_heap);
     TOS_PTR_SANITY_CHECK(cmp);
 
-    pool = tos_mmheap_alloc(item_cnt * item_size);
+    pool = mmheap_shared_alloc(item_cnt * item_size);
     if (!pool) {
         return K_ERR_OUT_OF_MEMORY;
     }
@@ -186,7 +186,7 @@ __API__ k_err_t tos_bin_heap_destroy_dyn(k_bin_heap_t *bin_heap)
         return K_ERR_OBJ_INVALID_ALLOC_TYPE;
     }
 
-    tos_mmheap_free(bin_heap->pool);
+    mmheap_shared_free(bin_heap->pool);
 
     bin_heap->total     = 0;
     bin_heap->cmp       = K_NULL;
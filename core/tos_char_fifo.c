@@ -107,25 +107,23 @@ __API__ k_err_t tos_chr_fifo_push(k_chr_fifo_t *chr_fifo, uint8_t data)
 __API__ int tos_chr_fifo_push_stream(k_chr_fifo_t *chr_fifo, uint8_t *stream, size_t size)
 {
     TOS_CPU_CPSR_ALLOC();
-    k_err_t err;
-    int i = 0;
+    k_ring_q_span_t span;
+    size_t cnt;
 
     TOS_PTR_SANITY_CHECK_RC(chr_fifo, 0);
     TOS_OBJ_VERIFY_RC(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO, 0);
 
     TOS_CPU_INT_DISABLE();
 
-    while (i < size) {
-        err = tos_ring_q_enqueue(&chr_fifo->ring_q, &stream[i], sizeof(uint8_t));
-        if (err != K_ERR_NONE) {
-            TOS_CPU_INT_ENABLE();
-            return i;
-        }
-        ++i;
+    cnt = tos_ring_q_reserve(&chr_fifo->ring_q, size, &span);
+    memcpy(span.item[0], stream, span.cnt[0]);
+    if (span.cnt[1] > 0u) {
+        memcpy(span.item[1], stream + span.cnt[0], span.cnt[1]);
     }
+    tos_ring_q_commit(&chr_fifo->ring_q, cnt);
 
     TOS_CPU_INT_ENABLE();
-    return i;
+    return cnt;
 }
 
 __API__ k_err_t tos_chr_fifo_pop(k_chr_fifo_t *chr_fifo, uint8_t *out)
@@ -139,24 +137,55 @@ __API__ k_err_t tos_chr_fifo_pop(k_chr_fifo_t *chr_fifo, uint8_t *out)
 __API__ int tos_chr_fifo_pop_stream(k_chr_fifo_t *chr_fifo, uint8_t *buffer, size_t size)
 {
     TOS_CPU_CPSR_ALLOC();
-    int i = 0;
-    uint8_t data;
+    k_ring_q_span_t span;
+    size_t cnt;
 
     TOS_PTR_SANITY_CHECK_RC(chr_fifo, 0);
     TOS_OBJ_VERIFY_RC(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO, 0);
 
     TOS_CPU_INT_DISABLE();
 
-    while (i < size) {
-        if (tos_ring_q_dequeue(&chr_fifo->ring_q, &data, K_NULL) != K_ERR_NONE) {
-            TOS_CPU_INT_ENABLE();
-            return i;
-        }
-        buffer[i++] = data;
+    cnt = tos_ring_q_peek(&chr_fifo->ring_q, size, &span);
+    memcpy(buffer, span.item[0], span.cnt[0]);
+    if (span.cnt[1] > 0u) {
+        memcpy(buffer + span.cnt[0], span.item[1], span.cnt[1]);
     }
+    tos_ring_q_release(&chr_fifo->ring_q, cnt);
 
     TOS_CPU_INT_ENABLE();
-    return i;
+    return cnt;
+}
+
+__API__ size_t tos_chr_fifo_reserve(k_chr_fifo_t *chr_fifo, size_t size, k_ring_q_span_t *span)
+{
+    TOS_PTR_SANITY_CHECK_RC(chr_fifo, 0u);
+    TOS_OBJ_VERIFY_RC(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO, 0u);
+
+    return tos_ring_q_reserve(&chr_fifo->ring_q, size, span);
+}
+
+__API__ k_err_t tos_chr_fifo_commit(k_chr_fifo_t *chr_fifo, size_t size)
+{
+    TOS_PTR_SANITY_CHECK(chr_fifo);
+    TOS_OBJ_VERIFY(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO);
+
+    return tos_ring_q_commit(&chr_fifo->ring_q, size);
+}
+
+__API__ size_t tos_chr_fifo_peek(k_chr_fifo_t *chr_fifo, size_t size, k_ring_q_span_t *span)
+{
+    TOS_PTR_SANITY_CHECK_RC(chr_fifo, 0u);
+    TOS_OBJ_VERIFY_RC(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO, 0u);
+
+    return tos_ring_q_peek(&chr_fifo->ring_q, size, span);
+}
+
+__API__ k_err_t tos_chr_fifo_release(k_chr_fifo_t *chr_fifo, size_t size)
+{
+    TOS_PTR_SANITY_CHECK(chr_fifo);
+    TOS_OBJ_VERIFY(chr_fifo, KNL_OBJ_TYPE_CHAR_FIFO);
+
+    return tos_ring_q_release(&chr_fifo->ring_q, size);
 }
 
 __API__ k_err_t tos_chr_fifo_flush(k_chr_fifo_t *chr_fifo)
@@ -51,7 +51,7 @@ __API__ k_err_t tos_completion_destroy(k_completion_t *completion)
     return K_ERR_NONE;
 }
 
-__API__ k_err_t tos_completion_pend_timed(k_completion_t *completion, k_tick_t timeout)
+__STATIC__ k_err_t completion_do_pend(k_completion_t *completion, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
 
@@ -76,7 +76,7 @@ __API__ k_err_t tos_completion_pend_timed(k_completion_t *completion, k_tick_t t
         return K_ERR_PEND_SCHED_LOCKED;
     }
 
-    pend_task_block(k_curr_task, &completion->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &completion->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -84,6 +84,20 @@ __API__ k_err_t tos_completion_pend_timed(k_completion_t *completion, k_tick_t t
     return pend_state2errno(k_curr_task->pend_state);
 }
 
+__API__ k_err_t tos_completion_pend_timed(k_completion_t *completion, k_tick_t timeout)
+{
+    return completion_do_pend(completion, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_completion_pend_ns(k_completion_t *completion, k_hrtime_t ns)
+{
+    return completion_do_pend(completion, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __API__ k_err_t tos_completion_pend(k_completion_t *completion)
 {
     return tos_completion_pend_timed(completion, TOS_TIME_FOREVER);
@@ -98,6 +112,8 @@ __STATIC__ k_err_t completion_do_post(k_completion_t *completion, opt_post_t opt
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &completion->pend_obj, 0u, opt);
+
     if (completion->done == (completion_done_t)-1) {
         TOS_CPU_INT_ENABLE();
         return K_ERR_COMPLETION_OVERFLOW;
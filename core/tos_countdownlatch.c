@@ -51,7 +51,7 @@ __API__ k_err_t tos_countdownlatch_destroy(k_countdownlatch_t *countdownlatch)
     return K_ERR_NONE;
 }
 
-__API__ k_err_t tos_countdownlatch_pend_timed(k_countdownlatch_t *countdownlatch, k_tick_t timeout)
+__STATIC__ k_err_t countdownlatch_do_pend(k_countdownlatch_t *countdownlatch, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
 
@@ -76,7 +76,7 @@ __API__ k_err_t tos_countdownlatch_pend_timed(k_countdownlatch_t *countdownlatch
         return K_ERR_PEND_SCHED_LOCKED;
     }
 
-    pend_task_block(k_curr_task, &countdownlatch->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &countdownlatch->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -84,6 +84,20 @@ __API__ k_err_t tos_countdownlatch_pend_timed(k_countdownlatch_t *countdownlatch
     return pend_state2errno(k_curr_task->pend_state);
 }
 
+__API__ k_err_t tos_countdownlatch_pend_timed(k_countdownlatch_t *countdownlatch, k_tick_t timeout)
+{
+    return countdownlatch_do_pend(countdownlatch, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_countdownlatch_pend_ns(k_countdownlatch_t *countdownlatch, k_hrtime_t ns)
+{
+    return countdownlatch_do_pend(countdownlatch, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __API__ k_err_t tos_countdownlatch_pend(k_countdownlatch_t *countdownlatch)
 {
     return tos_countdownlatch_pend_timed(countdownlatch, TOS_TIME_FOREVER);
@@ -98,6 +112,8 @@ __API__ k_err_t tos_countdownlatch_post(k_countdownlatch_t *countdownlatch)
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &countdownlatch->pend_obj, 0u, OPT_POST_ONE);
+
     if (countdownlatch->count == (k_countdownlatch_cnt_t)0) {
         TOS_CPU_INT_ENABLE();
         return K_ERR_COUNTDOWNLATCH_OVERFLOW;
@@ -19,12 +19,24 @@
 
 #if TOS_CFG_EVENT_EN > 0
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+__STATIC__ int event_is_ready(pend_obj_t *object)
+{
+    k_event_t *event = TOS_CONTAINER_OF_FIELD(object, k_event_t, pend_obj);
+
+    return event->flag != (k_event_flag_t)0u;
+}
+
+#endif
+
 __API__ k_err_t tos_event_create(k_event_t *event, k_event_flag_t init_flag)
 {
     TOS_PTR_SANITY_CHECK(event);
 
     event->flag = init_flag;
     pend_object_init(&event->pend_obj);
+    PEND_OBJ_READY_SET(&event->pend_obj, event_is_ready);
     TOS_OBJ_INIT(event, KNL_OBJ_TYPE_EVENT);
 
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
@@ -69,6 +81,14 @@ __API__ k_err_t tos_event_destroy(k_event_t *event)
 
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 
+__STATIC__ void event_obj_ctor(void *obj)
+{
+    k_event_t *event = (k_event_t *)obj;
+
+    pend_object_init(&event->pend_obj);
+    knl_object_alloc_set_dynamic(&event->knl_obj);
+}
+
 __API__ k_err_t tos_event_create_dyn(k_event_t **event, k_event_flag_t init_flag)
 {
     k_event_t *the_event;
@@ -76,17 +96,15 @@ __API__ k_err_t tos_event_create_dyn(k_event_t **event, k_event_flag_t init_flag
     TOS_IN_IRQ_CHECK();
     TOS_PTR_SANITY_CHECK(event);
 
-    the_event = tos_mmheap_calloc(1, sizeof(k_event_t));
+    the_event = slab_obj_alloc(KNL_OBJ_TYPE_EVENT, sizeof(k_event_t), event_obj_ctor);
     if (!the_event) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
     the_event->flag = init_flag;
-    pend_object_init(&the_event->pend_obj);
+    PEND_OBJ_READY_SET(&the_event->pend_obj, event_is_ready);
     TOS_OBJ_INIT(the_event, KNL_OBJ_TYPE_EVENT);
 
-    knl_object_alloc_set_dynamic(&the_event->knl_obj);
-
     *event = the_event;
 
     return K_ERR_NONE;
@@ -113,7 +131,7 @@ __API__ k_err_t tos_event_destroy_dyn(k_event_t *event)
 
     TOS_OBJ_DEINIT(event);
 
-    tos_mmheap_free(event);
+    slab_obj_free(KNL_OBJ_TYPE_EVENT, event);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -139,7 +157,7 @@ __STATIC__ int event_is_match(k_event_flag_t event, k_event_flag_t flag_expect,
     return K_FALSE;
 }
 
-__API__ k_err_t tos_event_pend(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_tick_t timeout, k_opt_t opt_pend)
+__STATIC__ k_err_t event_do_pend(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_tick_t timeout, k_hrtime_t ns, k_opt_t opt_pend)
 {
     TOS_CPU_CPSR_ALLOC();
 
@@ -180,7 +198,7 @@ __API__ k_err_t tos_event_pend(k_event_t *event, k_event_flag_t flag_expect, k_e
     k_curr_task->flag_match       = flag_match;
     k_curr_task->opt_event_pend   = opt_pend;
 
-    pend_task_block(k_curr_task, &event->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &event->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -192,6 +210,20 @@ __API__ k_err_t tos_event_pend(k_event_t *event, k_event_flag_t flag_expect, k_e
     return pend_state2errno(k_curr_task->pend_state);
 }
 
+__API__ k_err_t tos_event_pend(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_tick_t timeout, k_opt_t opt_pend)
+{
+    return event_do_pend(event, flag_expect, flag_match, timeout, (k_hrtime_t)0u, opt_pend);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_event_pend_ns(k_event_t *event, k_event_flag_t flag_expect, k_event_flag_t *flag_match, k_hrtime_t ns, k_opt_t opt_pend)
+{
+    return event_do_pend(event, flag_expect, flag_match, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns, opt_pend);
+}
+
+#endif
+
 __STATIC__ k_err_t event_do_post(k_event_t *event, k_event_flag_t flag, opt_event_post_t opt_post)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -208,6 +240,8 @@ __STATIC__ k_err_t event_do_post(k_event_t *event, k_event_flag_t flag, opt_even
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &event->pend_obj, flag, OPT_POST_ALL);
+
     TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, pend_list, &event->pend_obj.list) {
         if (event_is_match(event->flag, task->flag_expect, task->flag_match, task->opt_event_pend)) {
             pend_task_wakeup(task, PEND_STATE_POST);
@@ -220,6 +254,12 @@ __STATIC__ k_err_t event_do_post(k_event_t *event, k_event_flag_t flag, opt_even
         }
     }
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    if (event->flag != (k_event_flag_t)0u) {
+        pend_any_wakeup(&event->pend_obj, PEND_STATE_POST);
+    }
+#endif
+
     TOS_CPU_INT_ENABLE();
     knl_sched();
 
@@ -0,0 +1,202 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#include "tos_k.h"
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+
+/*
+ * event-driven tasks: no stack of their own, the handlers run to completion on k_evtdrv_stk.
+ * they are in the readyqueue like the other tasks, an idle one(nothing posted) is pending
+ * for nothing(K_TASK_STATE_PEND without a pend object).
+ * the shared stack holds one context at most, made when an event-driven task is switched in
+ * with the stack free; that context calls the handler of every event-driven task coming up next
+ * in a row, and is given up once a task with a stack of its own comes up.
+ * handlers are never nested: when one is preempted by a task, an event-driven task coming up
+ * later resumes it(see evtdrv_task_next_get), it runs on the behalf of the one coming up until
+ * its handler returns.
+ */
+
+__KNL__ void evtdrv_task_idle(k_task_t *task)
+{
+    tos_list_init(&task->pend_list);
+    task->state = K_TASK_STATE_PEND;
+}
+
+__STATIC__ void evtdrv_task_wakeup(k_task_t *task)
+{
+    if (!task_state_is_pending(task)) {
+        // ready already, or suspended while ready(tos_task_resume brings it back)
+        return;
+    }
+
+    task_state_reset_pending(task);
+    if (task_state_is_ready(task)) {
+        readyqueue_add_tail(task);
+    }
+}
+
+__STATIC__ void evtdrv_task_dispatch(k_task_t *task)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_event_flag_t event;
+    k_evtdrv_msg_t *msg = K_NULL;
+
+    TOS_CPU_INT_DISABLE();
+
+    event = task->evtdrv_event;
+    task->evtdrv_event = (k_event_flag_t)0u;
+
+    if (!tos_list_empty(&task->evtdrv_msg_list)) {
+        msg = TOS_LIST_FIRST_ENTRY(&task->evtdrv_msg_list, k_evtdrv_msg_t, list);
+        tos_list_del(&msg->list);
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    // nothing posted if just resumed(tos_task_resume)
+    if (event || msg) {
+        task->evtdrv_handler(task->arg, event, msg);
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    if (task_state_is_ready(task)) {
+        readyqueue_remove(task);
+
+        if (task->evtdrv_event == (k_event_flag_t)0u && tos_list_empty(&task->evtdrv_msg_list)) {
+            evtdrv_task_idle(task);
+        } else {
+            // more to do, behind the others of the same priority
+            readyqueue_add_tail(task);
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__KNL__ void evtdrv_task_entry(void *arg)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *task;
+
+    arg = arg; // make compiler happy
+
+    while (K_TRUE) {
+        evtdrv_task_dispatch(k_curr_task);
+
+        TOS_CPU_INT_DISABLE();
+
+        task = readyqueue_highest_ready_task_get();
+        if (task_is_evtdrv(task)) {
+            if (!knl_is_self(task)) {
+                // just call the next handler, the context goes with it
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+                task_runtime_switch(k_curr_task, task);
+#endif
+                TOS_TRACE(K_TRACE_EVENT_TASK_SWITCH, k_curr_task, task, 0u);
+
+                task->sp    = k_curr_task->sp;
+                k_curr_task = task;
+                k_next_task = task;
+            }
+            k_evtdrv_curr = task;
+
+            TOS_CPU_INT_ENABLE();
+            continue;
+        }
+
+        // the context is of no use now, a new one is made the next time
+        k_evtdrv_curr = K_NULL;
+
+        TOS_CPU_INT_ENABLE();
+
+        // returns if an event-driven task comes up before we are switched out
+        knl_sched();
+    }
+}
+
+__KNL__ k_task_t *evtdrv_task_next_get(k_task_t *task)
+{
+    if (!task_is_evtdrv(task)) {
+        return task;
+    }
+
+    if (k_curr_task && task_is_evtdrv(k_curr_task)) {
+        // the context on the shared stack is running, it calls the handler when the one running returns
+        return k_curr_task;
+    }
+
+    if (k_evtdrv_curr) {
+        // a handler is preempted, finish it first
+        return k_evtdrv_curr;
+    }
+
+    task->sp = cpu_task_stk_init((void *)evtdrv_task_entry, K_NULL, (void *)evtdrv_task_entry,
+                                    k_evtdrv_stk_addr, k_evtdrv_stk_size);
+    k_evtdrv_curr = task;
+
+    return task;
+}
+
+__API__ k_err_t tos_evtdrv_event_post(k_task_t *task, k_event_flag_t event)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(task);
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+
+    if (!task_is_evtdrv(task)) {
+        return K_ERR_TASK_NOT_EVTDRV;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    task->evtdrv_event |= event;
+    evtdrv_task_wakeup(task);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_evtdrv_msg_post(k_task_t *task, k_evtdrv_msg_t *msg)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(task);
+    TOS_PTR_SANITY_CHECK(msg);
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+
+    if (!task_is_evtdrv(task)) {
+        return K_ERR_TASK_NOT_EVTDRV;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    tos_list_add_tail(&msg->list, &task->evtdrv_msg_list);
+    evtdrv_task_wakeup(task);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    return K_ERR_NONE;
+}
+
+#endif
+
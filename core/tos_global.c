@@ -17,18 +17,30 @@
 
 #include <tos_k.h>
 
+#if TOS_CFG_SMP_EN > 0u
+k_cpu_t             k_cpu[TOS_CFG_CPU_NUM];
+k_spinlock_t        k_knl_lock;
+#else
 k_nesting_t         k_irq_nest_cnt              = (k_nesting_t)0;
 k_nesting_t         k_sched_lock_nest_cnt       = (k_nesting_t)0;
-knl_state_t         k_knl_state                 = KNL_STATE_STOPPED;
 
 readyqueue_t        k_rdyq;
 
-k_tick_t            k_tick_count                = (k_tick_t)0u;
 k_task_t           *k_curr_task                 = K_NULL;
 k_task_t           *k_next_task                 = K_NULL;
+#endif
+
+knl_state_t         k_knl_state                 = KNL_STATE_STOPPED;
+
+k_tick_t            k_tick_count                = (k_tick_t)0u;
 
+#if TOS_CFG_SMP_EN > 0u
+k_task_t            k_idle_task[TOS_CFG_CPU_NUM];
+k_stack_t           k_idle_task_stk[TOS_CFG_CPU_NUM * TOS_CFG_IDLE_TASK_STK_SIZE];
+#else
 k_task_t            k_idle_task;
 k_stack_t           k_idle_task_stk[TOS_CFG_IDLE_TASK_STK_SIZE];
+#endif
 k_stack_t          *const k_idle_task_stk_addr  = &k_idle_task_stk[0];
 size_t              const k_idle_task_stk_size  = TOS_CFG_IDLE_TASK_STK_SIZE;
 
@@ -36,13 +48,33 @@ k_tick_t            k_cpu_tick_per_second       = TOS_CFG_CPU_TICK_PER_SECOND;
 
 k_cycle_t           k_cpu_cycle_per_tick        = (k_cycle_t)0u;
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+k_stack_t           k_evtdrv_stk[TOS_CFG_EVTDRV_STK_SIZE];
+k_stack_t          *const k_evtdrv_stk_addr     = &k_evtdrv_stk[0];
+size_t              const k_evtdrv_stk_size     = TOS_CFG_EVTDRV_STK_SIZE;
+k_task_t           *k_evtdrv_curr               = K_NULL;
+#endif
+
+#if TOS_CFG_EDF_EN > 0u
+uint32_t            k_edf_density               = 0u;
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+uint64_t            k_runtime_total             = 0u;
+uint32_t            k_knl_load                  = 0u;
+#endif
+
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 TOS_LIST_DEFINE(k_dead_task_list);
 #endif
 
 TOS_LIST_DEFINE(k_stat_list);
 
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+tick_wheel_t        k_tick_wheel;
+#else
 TOS_LIST_DEFINE(k_tick_list);
+#endif
 
 #if TOS_CFG_FAULT_BACKTRACE_EN > 0u
 k_fault_log_writer_t    k_fault_log_writer = fault_default_log_writer;
@@ -55,12 +87,33 @@ uint8_t             k_mmheap_default_pool[TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE] __AL
 k_mmheap_ctl_t      k_mmheap_ctl;
 #endif
 
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+TOS_LIST_DEFINE(k_mmheap_arena_list);
+cpu_addr_t          k_mmheap_arena_addr_lo = (cpu_addr_t)-1;
+cpu_addr_t          k_mmheap_arena_addr_hi = (cpu_addr_t)0u;
+#endif
+
+#if (TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u) && (TOS_CFG_SLAB_EN > 0u)
+k_slab_cache_t      k_slab_cache[K_SLAB_CACHE_NUM] = {
+    { KNL_OBJ_TYPE_TASK },
+    { KNL_OBJ_TYPE_TIMER },
+    { KNL_OBJ_TYPE_MMBLK_POOL },
+    { KNL_OBJ_TYPE_EVENT },
+    { KNL_OBJ_TYPE_MUTEX },
+    { KNL_OBJ_TYPE_SEMAPHORE },
+};
+#endif
+
 #if TOS_CFG_ROUND_ROBIN_EN > 0u
 k_timeslice_t       k_robin_default_timeslice       = TOS_CFG_CPU_TICK_PER_SECOND / 10;
 #endif
 
 #if TOS_CFG_TIMER_EN > 0u
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+timer_ctl_t         k_timer_ctl = { TOS_TIME_FOREVER };
+#else
 timer_ctl_t         k_timer_ctl = { TOS_TIME_FOREVER, TOS_LIST_NODE(k_timer_ctl.list) };
+#endif
 
 #if TOS_CFG_TIMER_AS_PROC == 0u
 k_task_t            k_timer_task;
@@ -72,6 +125,14 @@ size_t              const k_timer_task_stk_size     = TOS_CFG_TIMER_TASK_STK_SIZ
 
 #endif
 
+#if TOS_CFG_HRTIMER_EN > 0u
+TOS_LIST_DEFINE(k_hrtimer_list);
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+k_trace_t           k_trace;
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0u
 pm_device_ctl_t     k_pm_device_ctl             = { 0u };
 
@@ -0,0 +1,267 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#include "tos_k.h"
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+/*
+ * running hrtimers are kept in deadline order, the first one is programmed
+ * into the deadline hardware(or the host timer), no systick involved.
+ */
+
+__STATIC__ void hrtimer_deadline_reprogram(void)
+{
+    k_hrtimer_t *first;
+
+    first = TOS_LIST_FIRST_ENTRY_OR_NULL(&k_hrtimer_list, k_hrtimer_t, list);
+    if (first) {
+        cpu_hrtimer_deadline_set(first->deadline);
+    } else {
+        cpu_hrtimer_deadline_cancel();
+    }
+}
+
+__STATIC__ void hrtimer_place(k_hrtimer_t *hrtimer)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_hrtimer_t *iter = K_NULL;
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_LIST_FOR_EACH_ENTRY(iter, k_hrtimer_t, list, &k_hrtimer_list) {
+        if (hrtimer->deadline < iter->deadline) {
+            break;
+        }
+    }
+    tos_list_add_tail(&hrtimer->list, &iter->list);
+    hrtimer->state = HRTIMER_STATE_RUNNING;
+
+    if (k_hrtimer_list.next == &hrtimer->list) {
+        // we are the first guy now
+        hrtimer_deadline_reprogram();
+    }
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void hrtimer_takeoff(k_hrtimer_t *hrtimer)
+{
+    TOS_CPU_CPSR_ALLOC();
+    int is_first;
+
+    TOS_CPU_INT_DISABLE();
+
+    is_first = k_hrtimer_list.next == &hrtimer->list;
+
+    tos_list_del_init(&hrtimer->list);
+
+    if (is_first) {
+        hrtimer_deadline_reprogram();
+    }
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__API__ k_err_t tos_hrtimer_create(k_hrtimer_t *hrtimer, k_hrtimer_callback_t callback, void *cb_arg)
+{
+    TOS_PTR_SANITY_CHECK(hrtimer);
+    TOS_PTR_SANITY_CHECK(callback);
+
+    hrtimer->state      = HRTIMER_STATE_STOPPED;
+    hrtimer->deadline   = (k_hrtime_t)0u;
+    hrtimer->cb         = callback;
+    hrtimer->cb_arg     = cb_arg;
+    tos_list_init(&hrtimer->list);
+
+    TOS_OBJ_INIT(hrtimer, KNL_OBJ_TYPE_HRTIMER);
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_hrtimer_destroy(k_hrtimer_t *hrtimer)
+{
+    TOS_PTR_SANITY_CHECK(hrtimer);
+    TOS_OBJ_VERIFY(hrtimer, KNL_OBJ_TYPE_HRTIMER);
+
+    if (hrtimer->state == HRTIMER_STATE_UNUSED) {
+        return K_ERR_TIMER_INACTIVE;
+    }
+
+    if (hrtimer->state == HRTIMER_STATE_RUNNING) {
+        hrtimer_takeoff(hrtimer);
+    }
+
+    hrtimer->state      = HRTIMER_STATE_UNUSED;
+    hrtimer->cb         = K_NULL;
+    hrtimer->cb_arg     = K_NULL;
+
+    TOS_OBJ_DEINIT(hrtimer);
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_hrtimer_start_abs(k_hrtimer_t *hrtimer, k_hrtime_t deadline)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(hrtimer);
+    TOS_OBJ_VERIFY(hrtimer, KNL_OBJ_TYPE_HRTIMER);
+
+    if (hrtimer->state == HRTIMER_STATE_UNUSED) {
+        return K_ERR_TIMER_INACTIVE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    if (hrtimer->state == HRTIMER_STATE_RUNNING) {
+        hrtimer_takeoff(hrtimer);
+    }
+
+    hrtimer->deadline = deadline;
+    hrtimer_place(hrtimer);
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_hrtimer_start(k_hrtimer_t *hrtimer, k_hrtime_t ns)
+{
+    k_hrtime_t now;
+
+    if (ns == (k_hrtime_t)0u) {
+        return K_ERR_TIMER_INVALID_DELAY;
+    }
+
+    now = cpu_hrtimer_clock_get();
+    if (ns > K_HRTIME_MAX - now) {
+        ns = K_HRTIME_MAX - now;
+    }
+
+    return tos_hrtimer_start_abs(hrtimer, now + ns);
+}
+
+__API__ k_err_t tos_hrtimer_stop(k_hrtimer_t *hrtimer)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(hrtimer);
+    TOS_OBJ_VERIFY(hrtimer, KNL_OBJ_TYPE_HRTIMER);
+
+    if (hrtimer->state == HRTIMER_STATE_UNUSED) {
+        return K_ERR_TIMER_INACTIVE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    if (hrtimer->state != HRTIMER_STATE_RUNNING) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_TIMER_STOPPED;
+    }
+
+    hrtimer_takeoff(hrtimer);
+    hrtimer->state = HRTIMER_STATE_STOPPED;
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_hrtime_t tos_hrtime_get(void)
+{
+    return cpu_hrtimer_clock_get();
+}
+
+__API__ void tos_hrtimer_handler(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_hrtimer_t *hrtimer;
+
+    TOS_CPU_INT_DISABLE();
+
+    while (!tos_list_empty(&k_hrtimer_list)) {
+        hrtimer = TOS_LIST_FIRST_ENTRY(&k_hrtimer_list, k_hrtimer_t, list);
+        if (hrtimer->deadline > cpu_hrtimer_clock_get()) { // not yet
+            break;
+        }
+
+        // deadline comes
+        tos_list_del_init(&hrtimer->list);
+        hrtimer->state = HRTIMER_STATE_COMPLETED;
+
+        TOS_CPU_INT_ENABLE();
+        (*hrtimer->cb)(hrtimer->cb_arg);
+        TOS_CPU_INT_DISABLE();
+    }
+
+    hrtimer_deadline_reprogram();
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void hrtimer_task_timeout(void *arg)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *task = (k_task_t *)arg;
+
+    TOS_CPU_INT_DISABLE();
+
+    // someone may have waken the task up before us, or the task is sleeping on another deadline now
+    if (task->hrtimer.state == HRTIMER_STATE_COMPLETED && task_state_is_sleeping(task)) {
+        // we are pending for something, but deadline's up, no longer waitting
+        pend_task_wakeup(task, PEND_STATE_TIMEOUT);
+    }
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__KNL__ void hrtimer_task_init(k_task_t *task)
+{
+    tos_hrtimer_create(&task->hrtimer, hrtimer_task_timeout, task);
+}
+
+/**
+ * the same as tick_list_add, but the task is waken up by its own hrtimer instead of the systick.
+ */
+__KNL__ void hrtimer_task_sleep(k_task_t *task, k_hrtime_t ns)
+{
+    tos_hrtimer_start(&task->hrtimer, ns);
+    task_state_set_sleeping(task);
+}
+
+__KNL__ int hrtimer_task_is_sleeping(k_task_t *task)
+{
+    return task->hrtimer.state == HRTIMER_STATE_RUNNING ||
+            task->hrtimer.state == HRTIMER_STATE_COMPLETED;
+}
+
+__KNL__ void hrtimer_task_takeoff(k_task_t *task)
+{
+    if (task->hrtimer.state == HRTIMER_STATE_RUNNING) {
+        hrtimer_takeoff(&task->hrtimer);
+    }
+    task->hrtimer.state = HRTIMER_STATE_STOPPED;
+}
+
+__KNL__ void hrtimer_init(void)
+{
+    cpu_hrtimer_deadline_init();
+}
+
+#endif
+
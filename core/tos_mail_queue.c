@@ -19,6 +19,17 @@
 
 #if TOS_CFG_MAIL_QUEUE_EN > 0u
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+__STATIC__ int mail_q_is_ready(pend_obj_t *object)
+{
+    k_mail_q_t *mail_q = TOS_CONTAINER_OF_FIELD(object, k_mail_q_t, pend_obj);
+
+    return !tos_ring_q_is_empty(&mail_q->ring_q);
+}
+
+#endif
+
 __API__ k_err_t tos_mail_q_create(k_mail_q_t *mail_q, void *pool, size_t mail_cnt, size_t mail_size)
 {
     k_err_t err;
@@ -31,6 +42,7 @@ __API__ k_err_t tos_mail_q_create(k_mail_q_t *mail_q, void *pool, size_t mail_cn
     }
 
     pend_object_init(&mail_q->pend_obj);
+    PEND_OBJ_READY_SET(&mail_q->pend_obj, mail_q_is_ready);
 
     TOS_OBJ_INIT(mail_q, KNL_OBJ_TYPE_MAIL_QUEUE);
     knl_object_alloc_set_static(&mail_q->knl_obj);
@@ -83,6 +95,7 @@ __API__ k_err_t tos_mail_q_create_dyn(k_mail_q_t *mail_q, size_t mail_cnt, size_
     }
 
     pend_object_init(&mail_q->pend_obj);
+    PEND_OBJ_READY_SET(&mail_q->pend_obj, mail_q_is_ready);
 
     TOS_OBJ_INIT(mail_q, KNL_OBJ_TYPE_MAIL_QUEUE);
     knl_object_alloc_set_dynamic(&mail_q->knl_obj);
@@ -131,7 +144,7 @@ __API__ k_err_t tos_mail_q_flush(k_mail_q_t *mail_q)
     return tos_ring_q_flush(&mail_q->ring_q);
 }
 
-__API__ k_err_t tos_mail_q_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout)
+__STATIC__ k_err_t mail_q_do_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
     k_err_t err;
@@ -160,7 +173,7 @@ __API__ k_err_t tos_mail_q_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail
     }
 
     k_curr_task->mail = mail_buf;
-    pend_task_block(k_curr_task, &mail_q->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &mail_q->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -175,6 +188,20 @@ __API__ k_err_t tos_mail_q_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail
     return err;
 }
 
+__API__ k_err_t tos_mail_q_pend(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout)
+{
+    return mail_q_do_pend(mail_q, mail_buf, mail_size, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_mail_q_pend_ns(k_mail_q_t *mail_q, void *mail_buf, size_t *mail_size, k_hrtime_t ns)
+{
+    return mail_q_do_pend(mail_q, mail_buf, mail_size, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __STATIC__ void mail_task_recv(k_task_t *task, void *mail_buf, size_t mail_size)
 {
     memcpy(task->mail, mail_buf, mail_size);
@@ -194,12 +221,21 @@ __STATIC__ k_err_t mail_q_do_post(k_mail_q_t *mail_q, void *mail_buf, size_t mai
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &mail_q->pend_obj, mail_buf, opt);
+
     if (pend_is_nopending(&mail_q->pend_obj)) {
         err = tos_ring_q_enqueue(&mail_q->ring_q, mail_buf, mail_size);
         if (err != K_ERR_NONE) {
             TOS_CPU_INT_ENABLE();
             return err;
         }
+#if TOS_CFG_WAIT_ANY_EN > 0u
+        if (pend_any_wakeup(&mail_q->pend_obj, PEND_STATE_POST)) {
+            TOS_CPU_INT_ENABLE();
+            knl_sched();
+            return K_ERR_NONE;
+        }
+#endif
         TOS_CPU_INT_ENABLE();
         return K_ERR_NONE;
     }
@@ -229,5 +265,144 @@ __API__ k_err_t tos_mail_q_post_all(k_mail_q_t *mail_q, void *mail_buf, size_t m
     return mail_q_do_post(mail_q, mail_buf, mail_size, OPT_POST_ALL);
 }
 
+__STATIC__ size_t mail_q_enqueue_n(k_mail_q_t *mail_q, uint8_t *mail_buf, size_t mail_cnt)
+{
+    size_t cnt, mail_size = mail_q->ring_q.item_size;
+    k_ring_q_span_t span;
+
+    cnt = tos_ring_q_reserve(&mail_q->ring_q, mail_cnt, &span);
+    memcpy(span.item[0], mail_buf, span.cnt[0] * mail_size);
+    if (span.cnt[1] > 0u) {
+        memcpy(span.item[1], mail_buf + span.cnt[0] * mail_size, span.cnt[1] * mail_size);
+    }
+    tos_ring_q_commit(&mail_q->ring_q, cnt);
+
+    return cnt;
+}
+
+__STATIC__ size_t mail_q_dequeue_n(k_mail_q_t *mail_q, uint8_t *mail_buf, size_t mail_cnt)
+{
+    size_t cnt, mail_size = mail_q->ring_q.item_size;
+    k_ring_q_span_t span;
+
+    cnt = tos_ring_q_peek(&mail_q->ring_q, mail_cnt, &span);
+    memcpy(mail_buf, span.item[0], span.cnt[0] * mail_size);
+    if (span.cnt[1] > 0u) {
+        memcpy(mail_buf + span.cnt[0] * mail_size, span.item[1], span.cnt[1] * mail_size);
+    }
+    tos_ring_q_release(&mail_q->ring_q, cnt);
+
+    return cnt;
+}
+
+__API__ k_err_t tos_mail_q_post_n(k_mail_q_t *mail_q, void *mail_buf, size_t mail_cnt, size_t mail_size, size_t *mail_sent)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t cnt = 0u, enqueued = 0u;
+    int is_woken = K_FALSE;
+    k_task_t *task, *tmp;
+
+    TOS_PTR_SANITY_CHECK(mail_q);
+    TOS_PTR_SANITY_CHECK(mail_buf);
+    TOS_PTR_SANITY_CHECK(mail_sent);
+    TOS_OBJ_VERIFY(mail_q, KNL_OBJ_TYPE_MAIL_QUEUE);
+
+    if (mail_size != mail_q->ring_q.item_size) {
+        return K_ERR_RING_Q_ITEM_SIZE_NOT_MATCH;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, &mail_q->pend_obj, mail_cnt, OPT_POST_ONE);
+
+    /* the queue is empty while anyone is pending, the first mails go straight to the pending
+       tasks, one each, in the order they wait */
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, pend_list, &mail_q->pend_obj.list) {
+        if (cnt == mail_cnt) {
+            break;
+        }
+        mail_task_recv(task, (uint8_t *)mail_buf + cnt * mail_size, mail_size);
+        ++cnt;
+        is_woken = K_TRUE;
+    }
+
+    if (cnt < mail_cnt) {
+        enqueued = mail_q_enqueue_n(mail_q, (uint8_t *)mail_buf + cnt * mail_size, mail_cnt - cnt);
+        cnt += enqueued;
+    }
+
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    if (enqueued > 0u && pend_any_wakeup(&mail_q->pend_obj, PEND_STATE_POST)) {
+        is_woken = K_TRUE;
+    }
+#endif
+
+    TOS_CPU_INT_ENABLE();
+
+    *mail_sent = cnt;
+
+    if (is_woken) {
+        knl_sched();
+    }
+
+    return cnt == 0u && mail_cnt > 0u ? K_ERR_RING_Q_FULL : K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mail_q_pend_n(k_mail_q_t *mail_q, void *mail_buf, size_t mail_cnt, size_t *mail_recv, k_tick_t timeout)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_err_t err;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(mail_q);
+    TOS_PTR_SANITY_CHECK(mail_buf);
+    TOS_PTR_SANITY_CHECK(mail_recv);
+    TOS_OBJ_VERIFY(mail_q, KNL_OBJ_TYPE_MAIL_QUEUE);
+
+    *mail_recv = 0u;
+    if (mail_cnt == 0u) {
+        return K_ERR_NONE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    *mail_recv = mail_q_dequeue_n(mail_q, (uint8_t *)mail_buf, mail_cnt);
+    if (*mail_recv > 0u) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_NONE;
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    k_curr_task->mail = mail_buf;
+    pend_task_block(k_curr_task, &mail_q->pend_obj, timeout);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    err = pend_state2errno(k_curr_task->pend_state);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    /* we are woken up with one mail in the first slot, take whatever else is queued meanwhile */
+    k_curr_task->mail       = K_NULL;
+    k_curr_task->mail_size  = 0;
+
+    TOS_CPU_INT_DISABLE();
+    *mail_recv = 1u + mail_q_dequeue_n(mail_q, (uint8_t *)mail_buf + mail_q->ring_q.item_size, mail_cnt - 1u);
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
 #endif
 
@@ -19,6 +19,17 @@
 
 #if TOS_CFG_MESSAGE_QUEUE_EN > 0u
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+__STATIC__ int msg_q_is_ready(pend_obj_t *object)
+{
+    k_msg_q_t *msg_q = TOS_CONTAINER_OF_FIELD(object, k_msg_q_t, pend_obj);
+
+    return !tos_ring_q_is_empty(&msg_q->ring_q);
+}
+
+#endif
+
 __API__ k_err_t tos_msg_q_create(k_msg_q_t *msg_q, void *pool, size_t msg_cnt)
 {
     k_err_t err;
@@ -32,6 +43,7 @@ __API__ k_err_t tos_msg_q_create(k_msg_q_t *msg_q, void *pool, size_t msg_cnt)
     }
 
     pend_object_init(&msg_q->pend_obj);
+    PEND_OBJ_READY_SET(&msg_q->pend_obj, msg_q_is_ready);
 
     TOS_OBJ_INIT(msg_q, KNL_OBJ_TYPE_MESSAGE_QUEUE);
 
@@ -92,6 +104,7 @@ __API__ k_err_t tos_msg_q_create_dyn(k_msg_q_t *msg_q, size_t msg_cnt)
     }
 
     pend_object_init(&msg_q->pend_obj);
+    PEND_OBJ_READY_SET(&msg_q->pend_obj, msg_q_is_ready);
 
     TOS_OBJ_INIT(msg_q, KNL_OBJ_TYPE_MESSAGE_QUEUE);
     knl_object_alloc_set_dynamic(&msg_q->knl_obj);
@@ -140,7 +153,7 @@ __API__ k_err_t tos_msg_q_flush(k_msg_q_t *msg_q)
     return tos_ring_q_flush(&msg_q->ring_q);
 }
 
-__API__ k_err_t tos_msg_q_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeout)
+__STATIC__ k_err_t msg_q_do_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
     k_err_t err;
@@ -168,7 +181,7 @@ __API__ k_err_t tos_msg_q_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeou
         return K_ERR_PEND_SCHED_LOCKED;
     }
 
-    pend_task_block(k_curr_task, &msg_q->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &msg_q->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -182,6 +195,20 @@ __API__ k_err_t tos_msg_q_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeou
     return err;
 }
 
+__API__ k_err_t tos_msg_q_pend(k_msg_q_t *msg_q, void **msg_ptr, k_tick_t timeout)
+{
+    return msg_q_do_pend(msg_q, msg_ptr, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_msg_q_pend_ns(k_msg_q_t *msg_q, void **msg_ptr, k_hrtime_t ns)
+{
+    return msg_q_do_pend(msg_q, msg_ptr, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __STATIC__ void msg_q_task_recv(k_task_t *task, void *msg_ptr)
 {
     task->msg = msg_ptr;
@@ -199,12 +226,21 @@ __STATIC__ k_err_t msg_q_do_post(k_msg_q_t *msg_q, void *msg_ptr, opt_post_t opt
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &msg_q->pend_obj, msg_ptr, opt);
+
     if (pend_is_nopending(&msg_q->pend_obj)) {
         err = tos_ring_q_enqueue(&msg_q->ring_q, &msg_ptr, sizeof(void*));
         if (err != K_ERR_NONE) {
             TOS_CPU_INT_ENABLE();
             return err;
         }
+#if TOS_CFG_WAIT_ANY_EN > 0u
+        if (pend_any_wakeup(&msg_q->pend_obj, PEND_STATE_POST)) {
+            TOS_CPU_INT_ENABLE();
+            knl_sched();
+            return K_ERR_NONE;
+        }
+#endif
         TOS_CPU_INT_ENABLE();
         return K_ERR_NONE;
     }
@@ -233,5 +269,138 @@ __API__ k_err_t tos_msg_q_post_all(k_msg_q_t *msg_q, void *msg_ptr)
     return msg_q_do_post(msg_q, msg_ptr, OPT_POST_ALL);
 }
 
+__STATIC__ size_t msg_q_enqueue_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt)
+{
+    size_t cnt;
+    k_ring_q_span_t span;
+
+    cnt = tos_ring_q_reserve(&msg_q->ring_q, msg_cnt, &span);
+    memcpy(span.item[0], msg_ptr, span.cnt[0] * sizeof(void *));
+    if (span.cnt[1] > 0u) {
+        memcpy(span.item[1], &msg_ptr[span.cnt[0]], span.cnt[1] * sizeof(void *));
+    }
+    tos_ring_q_commit(&msg_q->ring_q, cnt);
+
+    return cnt;
+}
+
+__STATIC__ size_t msg_q_dequeue_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt)
+{
+    size_t cnt;
+    k_ring_q_span_t span;
+
+    cnt = tos_ring_q_peek(&msg_q->ring_q, msg_cnt, &span);
+    memcpy(msg_ptr, span.item[0], span.cnt[0] * sizeof(void *));
+    if (span.cnt[1] > 0u) {
+        memcpy(&msg_ptr[span.cnt[0]], span.item[1], span.cnt[1] * sizeof(void *));
+    }
+    tos_ring_q_release(&msg_q->ring_q, cnt);
+
+    return cnt;
+}
+
+__API__ k_err_t tos_msg_q_post_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt, size_t *msg_sent)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t cnt = 0u, enqueued = 0u;
+    int is_woken = K_FALSE;
+    k_task_t *task, *tmp;
+
+    TOS_PTR_SANITY_CHECK(msg_q);
+    TOS_PTR_SANITY_CHECK(msg_ptr);
+    TOS_PTR_SANITY_CHECK(msg_sent);
+    TOS_OBJ_VERIFY(msg_q, KNL_OBJ_TYPE_MESSAGE_QUEUE);
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, &msg_q->pend_obj, msg_cnt, OPT_POST_ONE);
+
+    /* the queue is empty while anyone is pending, the first messages go straight to the pending
+       tasks, one each, in the order they wait */
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, pend_list, &msg_q->pend_obj.list) {
+        if (cnt == msg_cnt) {
+            break;
+        }
+        msg_q_task_recv(task, msg_ptr[cnt++]);
+        is_woken = K_TRUE;
+    }
+
+    if (cnt < msg_cnt) {
+        enqueued = msg_q_enqueue_n(msg_q, &msg_ptr[cnt], msg_cnt - cnt);
+        cnt += enqueued;
+    }
+
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    if (enqueued > 0u && pend_any_wakeup(&msg_q->pend_obj, PEND_STATE_POST)) {
+        is_woken = K_TRUE;
+    }
+#endif
+
+    TOS_CPU_INT_ENABLE();
+
+    *msg_sent = cnt;
+
+    if (is_woken) {
+        knl_sched();
+    }
+
+    return cnt == 0u && msg_cnt > 0u ? K_ERR_RING_Q_FULL : K_ERR_NONE;
+}
+
+__API__ k_err_t tos_msg_q_pend_n(k_msg_q_t *msg_q, void *msg_ptr[], size_t msg_cnt, size_t *msg_recv, k_tick_t timeout)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_err_t err;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(msg_q);
+    TOS_PTR_SANITY_CHECK(msg_ptr);
+    TOS_PTR_SANITY_CHECK(msg_recv);
+    TOS_OBJ_VERIFY(msg_q, KNL_OBJ_TYPE_MESSAGE_QUEUE);
+
+    *msg_recv = 0u;
+    if (msg_cnt == 0u) {
+        return K_ERR_NONE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    *msg_recv = msg_q_dequeue_n(msg_q, msg_ptr, msg_cnt);
+    if (*msg_recv > 0u) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_NONE;
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    pend_task_block(k_curr_task, &msg_q->pend_obj, timeout);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    err = pend_state2errno(k_curr_task->pend_state);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    /* we are woken up with one message, take whatever else is queued meanwhile */
+    msg_ptr[0]          = k_curr_task->msg;
+    k_curr_task->msg    = K_NULL;
+
+    TOS_CPU_INT_DISABLE();
+    *msg_recv = 1u + msg_q_dequeue_n(msg_q, &msg_ptr[1], msg_cnt - 1u);
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
 #endif
 
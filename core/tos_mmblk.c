@@ -17,22 +17,200 @@
 
 #include "tos_k.h"
 
-__API__ k_err_t tos_mmblk_pool_create(k_mmblk_pool_t *mbp, void *pool_start, size_t blk_num, size_t blk_size)
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+
+/*
+ * lock-free mode: the free list is a stack of block indexes, every free block keeps the index of the
+ * next one in its first cpu_addr_t, and the head(mbp->free_head) is swapped in with a compare-and-swap.
+ * the tag in the high half of the head makes the compare-and-swap fail if the head was popped and
+ * pushed back in between, so a pop never takes a stale next index.
+ * blk_free is claimed before a pop and reserved before a push, so it never runs below 0 or above
+ * blk_max, whatever the order the pops and pushes land in.
+ */
+
+#define MMBLK_LF_IDX2BLK(mbp, idx)      ((void *)((cpu_addr_t)(mbp)->pool_start + ((idx) - 1u) * (mbp)->blk_size))
+#define MMBLK_LF_NEXT(blk)              (*(cpu_addr_t *)(blk))
+
+__STATIC_INLINE__ cpu_addr_t mmblk_lf_blk2idx(k_mmblk_pool_t *mbp, void *blk)
 {
-    uint32_t    i;
-    void       *blk_curr, *blk_next;
+    return ((cpu_addr_t)blk - (cpu_addr_t)mbp->pool_start) / mbp->blk_size + 1u;
+}
 
-    TOS_IN_IRQ_CHECK();
-    TOS_PTR_SANITY_CHECK(pool_start);
+/* take up to cnt off blk_free, return how many we got */
+__STATIC__ size_t mmblk_lf_claim(k_mmblk_pool_t *mbp, size_t cnt)
+{
+    size_t blk_free;
+
+    blk_free = __atomic_load_n(&mbp->blk_free, __ATOMIC_RELAXED);
+    do {
+        if (blk_free == 0u) {
+            return 0u;
+        }
+        if (cnt > blk_free) {
+            cnt = blk_free;
+        }
+    } while (!__atomic_compare_exchange_n(&mbp->blk_free, &blk_free, blk_free - cnt,
+                                            K_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return cnt;
+}
 
-    if (((cpu_addr_t)pool_start & K_MMBLK_ALIGN_MASK) != 0u) {
-        return K_ERR_MMBLK_INVALID_POOL_ADDR;
+/* put cnt onto blk_free, all or nothing */
+__STATIC__ int mmblk_lf_reserve(k_mmblk_pool_t *mbp, size_t cnt)
+{
+    size_t blk_free;
+
+    blk_free = __atomic_load_n(&mbp->blk_free, __ATOMIC_RELAXED);
+    do {
+        if (cnt > mbp->blk_max - blk_free) {
+            return K_FALSE;
+        }
+    } while (!__atomic_compare_exchange_n(&mbp->blk_free, &blk_free, blk_free + cnt,
+                                            K_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return K_TRUE;
+}
+
+__STATIC__ size_t mmblk_lf_pop(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    cpu_addr_t head, head_new, idx;
+    size_t cnt;
+
+    head = __atomic_load_n(&mbp->free_head, __ATOMIC_ACQUIRE);
+    do {
+        idx = head & K_MMBLK_LF_IDX_MASK;
+        for (cnt = 0u; cnt < blk_cnt && idx != 0u; ++cnt) {
+            blk[cnt]    = MMBLK_LF_IDX2BLK(mbp, idx);
+            idx         = __atomic_load_n(&MMBLK_LF_NEXT(blk[cnt]), __ATOMIC_RELAXED);
+            if (idx > mbp->blk_max) {
+                // someone popped the block and wrote it since we loaded the head, the swap fails anyway
+                idx = 0u;
+            }
+        }
+
+        if (cnt == 0u) {
+            return 0u;
+        }
+
+        head_new = ((head & ~K_MMBLK_LF_IDX_MASK) + K_MMBLK_LF_TAG_ONE) | idx;
+    } while (!__atomic_compare_exchange_n(&mbp->free_head, &head, head_new,
+                                            K_TRUE, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    return cnt;
+}
+
+/* push a chain of blocks already linked from first to last */
+__STATIC__ void mmblk_lf_push(k_mmblk_pool_t *mbp, void *first, void *last)
+{
+    cpu_addr_t head, head_new, first_idx;
+
+    first_idx = mmblk_lf_blk2idx(mbp, first);
+
+    head = __atomic_load_n(&mbp->free_head, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&MMBLK_LF_NEXT(last), head & K_MMBLK_LF_IDX_MASK, __ATOMIC_RELAXED);
+        head_new = ((head & ~K_MMBLK_LF_IDX_MASK) + K_MMBLK_LF_TAG_ONE) | first_idx;
+    } while (!__atomic_compare_exchange_n(&mbp->free_head, &head, head_new,
+                                            K_TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+__STATIC__ size_t mmblk_alloc_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    size_t claimed, cnt;
+
+    claimed = mmblk_lf_claim(mbp, blk_cnt);
+    if (claimed == 0u) {
+        return 0u;
     }
 
-    if ((blk_size & K_MMBLK_ALIGN_MASK) != 0u) {
-        return K_ERR_MMBLK_INVALID_BLK_SIZE;
+    cnt = mmblk_lf_pop(mbp, blk, claimed);
+    if (cnt < claimed) {
+        // a free reserved its blocks but has not pushed them yet, give the claim back
+        __atomic_fetch_add(&mbp->blk_free, claimed - cnt, __ATOMIC_RELAXED);
     }
 
+    return cnt;
+}
+
+__STATIC__ k_err_t mmblk_free_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    size_t i;
+
+    if (!mmblk_lf_reserve(mbp, blk_cnt)) {
+        return K_ERR_MMBLK_POOL_FULL;
+    }
+
+    // a pop that loaded a stale head may read these links at the same time, its swap fails anyway
+    for (i = 0u; i < blk_cnt - 1u; ++i) {
+        __atomic_store_n(&MMBLK_LF_NEXT(blk[i]), mmblk_lf_blk2idx(mbp, blk[i + 1u]), __ATOMIC_RELAXED);
+    }
+    mmblk_lf_push(mbp, blk[0], blk[blk_cnt - 1u]);
+
+    return K_ERR_NONE;
+}
+
+#else
+
+__STATIC__ size_t mmblk_alloc_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t cnt;
+
+    TOS_CPU_INT_DISABLE();
+    for (cnt = 0u; cnt < blk_cnt && mbp->blk_free > 0u; ++cnt) {
+        blk[cnt]        = mbp->free_list;
+        mbp->free_list  = *(void **)mbp->free_list;
+        --mbp->blk_free;
+    }
+    TOS_CPU_INT_ENABLE();
+
+    return cnt;
+}
+
+__STATIC__ k_err_t mmblk_free_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t i;
+
+    // chain the blocks outside the critical section, then splice the chain in
+    for (i = 0u; i < blk_cnt - 1u; ++i) {
+        *(void **)blk[i] = blk[i + 1u];
+    }
+
+    TOS_CPU_INT_DISABLE();
+    if (blk_cnt > mbp->blk_max - mbp->blk_free) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_MMBLK_POOL_FULL;
+    }
+
+    *(void **)blk[blk_cnt - 1u] = mbp->free_list;
+    mbp->free_list              = blk[0];
+    mbp->blk_free              += blk_cnt;
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+#endif
+
+__STATIC__ void mmblk_pool_init(k_mmblk_pool_t *mbp, void *pool_start, size_t blk_num, size_t blk_size)
+{
+    size_t      i;
+    void       *blk_curr;
+#if TOS_CFG_MMBLK_LOCKFREE_EN == 0u
+    void       *blk_next;
+#endif
+
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    blk_curr = pool_start;
+    for (i = 0; i < blk_num - 1u; ++i) {
+        __atomic_store_n(&MMBLK_LF_NEXT(blk_curr), i + 2u, __ATOMIC_RELAXED);
+        blk_curr = K_MMBLK_NEXT_BLK(blk_curr, blk_size);
+    }
+    __atomic_store_n(&MMBLK_LF_NEXT(blk_curr), 0u, __ATOMIC_RELAXED);
+
+    mbp->free_head  = 1u;
+#else
     blk_curr = pool_start;
     blk_next = K_MMBLK_NEXT_BLK(blk_curr, blk_size);
 
@@ -43,11 +221,51 @@ __API__ k_err_t tos_mmblk_pool_create(k_mmblk_pool_t *mbp, void *pool_start, siz
     }
     *(void **)blk_curr = K_NULL;
 
-    mbp->pool_start = pool_start;
     mbp->free_list  = pool_start;
+#endif
+
+    mbp->pool_start = pool_start;
     mbp->blk_free   = blk_num;
     mbp->blk_max    = blk_num;
     mbp->blk_size   = blk_size;
+}
+
+__STATIC__ k_err_t mmblk_pool_param_check(size_t blk_num, size_t blk_size)
+{
+    if (blk_size == 0u || (blk_size & K_MMBLK_ALIGN_MASK) != 0u) {
+        return K_ERR_MMBLK_INVALID_BLK_SIZE;
+    }
+
+    if (blk_num == 0u) {
+        return K_ERR_MMBLK_INVALID_BLK_NUM;
+    }
+
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    if (blk_num > K_MMBLK_LF_BLK_NUM_MAX) {
+        return K_ERR_MMBLK_INVALID_BLK_NUM;
+    }
+#endif
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmblk_pool_create(k_mmblk_pool_t *mbp, void *pool_start, size_t blk_num, size_t blk_size)
+{
+    k_err_t err;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(pool_start);
+
+    if (((cpu_addr_t)pool_start & K_MMBLK_ALIGN_MASK) != 0u) {
+        return K_ERR_MMBLK_INVALID_POOL_ADDR;
+    }
+
+    err = mmblk_pool_param_check(blk_num, blk_size);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    mmblk_pool_init(mbp, pool_start, blk_num, blk_size);
 
     TOS_OBJ_INIT(mbp, KNL_OBJ_TYPE_MMBLK_POOL);
 
@@ -70,7 +288,11 @@ __API__ k_err_t tos_mmblk_pool_destroy(k_mmblk_pool_t *mbp)
 #endif
 
     mbp->pool_start = K_NULL;
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    mbp->free_head  = 0u;
+#else
     mbp->free_list  = K_NULL;
+#endif
     mbp->blk_free   = 0;
     mbp->blk_max    = 0;
     mbp->blk_size   = 0;
@@ -84,44 +306,30 @@ __API__ k_err_t tos_mmblk_pool_destroy(k_mmblk_pool_t *mbp)
 
 __API__ k_err_t tos_mmblk_pool_create_dyn(k_mmblk_pool_t **mbp, size_t blk_num, size_t blk_size)
 {
-    uint32_t    i;
+    k_err_t err;
     void *pool_start;
     k_mmblk_pool_t *the_mbp;
-    void       *blk_curr, *blk_next;
 
     TOS_IN_IRQ_CHECK();
     TOS_PTR_SANITY_CHECK(mbp);
 
-    if ((blk_size & K_MMBLK_ALIGN_MASK) != 0u) {
-        return K_ERR_MMBLK_INVALID_BLK_SIZE;
+    err = mmblk_pool_param_check(blk_num, blk_size);
+    if (err != K_ERR_NONE) {
+        return err;
     }
 
-    the_mbp = tos_mmheap_calloc(1, sizeof(k_mmblk_pool_t));
+    the_mbp = slab_obj_alloc(KNL_OBJ_TYPE_MMBLK_POOL, sizeof(k_mmblk_pool_t), K_NULL);
     if (!the_mbp) {
         return K_ERR_MMBLK_OUT_OF_MEMORY;
     }
 
-    pool_start = tos_mmheap_alloc(blk_num * blk_size);
+    pool_start = mmheap_shared_alloc(blk_num * blk_size);
     if (!pool_start) {
+        slab_obj_free(KNL_OBJ_TYPE_MMBLK_POOL, the_mbp);
         return K_ERR_MMBLK_POOL_OUT_OF_MEMORY;
     }
 
-    blk_curr = pool_start;
-    blk_next = K_MMBLK_NEXT_BLK(blk_curr, blk_size);
-
-    for (i = 0; i < blk_num - 1u; ++i) {
-        *(void **)blk_curr  = blk_next;
-        blk_curr            = blk_next;
-        blk_next            = K_MMBLK_NEXT_BLK(blk_next, blk_size);
-    }
-
-    *(void **)blk_curr = K_NULL;
-
-    the_mbp->pool_start = pool_start;
-    the_mbp->free_list  = pool_start;
-    the_mbp->blk_free   = blk_num;
-    the_mbp->blk_max    = blk_num;
-    the_mbp->blk_size   = blk_size;
+    mmblk_pool_init(the_mbp, pool_start, blk_num, blk_size);
 
     TOS_OBJ_INIT(the_mbp, KNL_OBJ_TYPE_MMBLK_POOL);
 
@@ -141,16 +349,20 @@ __API__ k_err_t tos_mmblk_pool_destroy_dyn(k_mmblk_pool_t *mbp)
         return K_ERR_OBJ_INVALID_ALLOC_TYPE;
     }
 
-    tos_mmheap_free(mbp->pool_start);
+    mmheap_shared_free(mbp->pool_start);
 
     mbp->pool_start = K_NULL;
+#if TOS_CFG_MMBLK_LOCKFREE_EN > 0u
+    mbp->free_head  = 0u;
+#else
     mbp->free_list  = K_NULL;
+#endif
     mbp->blk_free   = 0;
     mbp->blk_max    = 0;
     mbp->blk_size   = 0;
 
     TOS_OBJ_DEINIT(mbp);
-    tos_mmheap_free(mbp);
+    slab_obj_free(KNL_OBJ_TYPE_MMBLK_POOL, mbp);
 
     return K_ERR_NONE;
 }
@@ -159,42 +371,65 @@ __API__ k_err_t tos_mmblk_pool_destroy_dyn(k_mmblk_pool_t *mbp)
 
 __API__ k_err_t tos_mmblk_alloc(k_mmblk_pool_t *mbp, void **blk)
 {
-    TOS_CPU_CPSR_ALLOC();
-
     TOS_PTR_SANITY_CHECK(mbp);
+    TOS_PTR_SANITY_CHECK(blk);
     TOS_OBJ_VERIFY(mbp, KNL_OBJ_TYPE_MMBLK_POOL);
 
-    TOS_CPU_INT_DISABLE();
-    if (mbp->blk_free == 0) {
-        TOS_CPU_INT_ENABLE();
+    if (mmblk_alloc_n(mbp, blk, 1u) == 0u) {
         *blk = K_NULL;
         return K_ERR_MMBLK_POOL_EMPTY;
     }
-    *blk            = mbp->free_list;
-    mbp->free_list  = *(void **)mbp->free_list;
-    --mbp->blk_free;
-    TOS_CPU_INT_ENABLE();
     return K_ERR_NONE;
 }
 
 __API__ k_err_t tos_mmblk_free(k_mmblk_pool_t *mbp, void *blk)
 {
-    TOS_CPU_CPSR_ALLOC();
+    TOS_PTR_SANITY_CHECK(mbp);
+    TOS_PTR_SANITY_CHECK(blk);
+    TOS_OBJ_VERIFY(mbp, KNL_OBJ_TYPE_MMBLK_POOL);
+
+    return mmblk_free_n(mbp, &blk, 1u);
+}
+
+__API__ k_err_t tos_mmblk_alloc_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt, size_t *blk_alloc)
+{
+    size_t cnt;
 
     TOS_PTR_SANITY_CHECK(mbp);
     TOS_PTR_SANITY_CHECK(blk);
+    TOS_PTR_SANITY_CHECK(blk_alloc);
     TOS_OBJ_VERIFY(mbp, KNL_OBJ_TYPE_MMBLK_POOL);
 
-    TOS_CPU_INT_DISABLE();
-    if (mbp->blk_free >= mbp->blk_max) {
-        TOS_CPU_INT_ENABLE();
-        return K_ERR_MMBLK_POOL_FULL;
+    if (blk_cnt == 0u) {
+        *blk_alloc = 0u;
+        return K_ERR_NONE;
     }
 
-    *(void **)blk   = mbp->free_list;
-    mbp->free_list  = blk;
-    ++mbp->blk_free;
-    TOS_CPU_INT_ENABLE();
+    cnt = mmblk_alloc_n(mbp, blk, blk_cnt);
+    *blk_alloc = cnt;
+
+    if (cnt == 0u) {
+        return K_ERR_MMBLK_POOL_EMPTY;
+    }
     return K_ERR_NONE;
 }
 
+__API__ k_err_t tos_mmblk_free_n(k_mmblk_pool_t *mbp, void *blk[], size_t blk_cnt)
+{
+    size_t i;
+
+    TOS_PTR_SANITY_CHECK(mbp);
+    TOS_PTR_SANITY_CHECK(blk);
+    TOS_OBJ_VERIFY(mbp, KNL_OBJ_TYPE_MMBLK_POOL);
+
+    if (blk_cnt == 0u) {
+        return K_ERR_NONE;
+    }
+
+    for (i = 0u; i < blk_cnt; ++i) {
+        TOS_PTR_SANITY_CHECK(blk[i]);
+    }
+
+    return mmblk_free_n(mbp, blk, blk_cnt);
+}
+
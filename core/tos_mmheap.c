@@ -256,26 +256,26 @@ __STATIC_INLINE__ void *align_ptr(const void *ptr, size_t align)
 }
 
 /* Insert a free block into the free block list. */
-__STATIC__ void insert_free_block(mmheap_blk_t *blk, int fl, int sl)
+__STATIC__ void insert_free_block(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, int fl, int sl)
 {
     mmheap_blk_t *curr;
 
-    curr = k_mmheap_ctl.blocks[fl][sl];
+    curr = ctl->blocks[fl][sl];
     blk->next_free = curr;
-    blk->prev_free = &k_mmheap_ctl.block_null;
+    blk->prev_free = &ctl->block_null;
     curr->prev_free = blk;
 
 	/*
 	** Insert the new block at the head of the list, and mark the first-
 	** and second-level bitmaps appropriately.
 	*/
-    k_mmheap_ctl.blocks[fl][sl] = blk;
-    k_mmheap_ctl.fl_bitmap |= (1 << fl);
-    k_mmheap_ctl.sl_bitmap[fl] |= (1 << sl);
+    ctl->blocks[fl][sl] = blk;
+    ctl->fl_bitmap |= (1 << fl);
+    ctl->sl_bitmap[fl] |= (1 << sl);
 }
 
 /* Remove a free block from the free list.*/
-__STATIC__ void remove_free_block(mmheap_blk_t *blk, int fl, int sl)
+__STATIC__ void remove_free_block(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, int fl, int sl)
 {
     mmheap_blk_t *prev_blk;
     mmheap_blk_t *next_blk;
@@ -286,37 +286,37 @@ __STATIC__ void remove_free_block(mmheap_blk_t *blk, int fl, int sl)
     prev_blk->next_free = next_blk;
 
     /* If this block is the head of the free list, set new head. */
-    if (k_mmheap_ctl.blocks[fl][sl] == blk) {
-        k_mmheap_ctl.blocks[fl][sl] = next_blk;
+    if (ctl->blocks[fl][sl] == blk) {
+        ctl->blocks[fl][sl] = next_blk;
 
         /* If the new head is null, clear the bitmap. */
-        if (next_blk == &k_mmheap_ctl.block_null) {
-            k_mmheap_ctl.sl_bitmap[fl] &= ~(1 << sl);
+        if (next_blk == &ctl->block_null) {
+            ctl->sl_bitmap[fl] &= ~(1 << sl);
 
             /* If the second bitmap is now empty, clear the fl bitmap. */
-            if (!k_mmheap_ctl.sl_bitmap[fl]) {
-                k_mmheap_ctl.fl_bitmap &= ~(1 << fl);
+            if (!ctl->sl_bitmap[fl]) {
+                ctl->fl_bitmap &= ~(1 << fl);
             }
         }
     }
 }
 
 /* Remove a given block from the free list. */
-__STATIC__ void blk_remove(mmheap_blk_t *blk)
+__STATIC__ void blk_remove(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk)
 {
     int fl, sl;
 
     mapping_insert(blk_size(blk), &fl, &sl);
-    remove_free_block(blk, fl, sl);
+    remove_free_block(ctl, blk, fl, sl);
 }
 
 /* Insert a given block into the free list. */
-__STATIC__ void blk_insert(mmheap_blk_t *blk)
+__STATIC__ void blk_insert(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk)
 {
     int fl, sl;
 
     mapping_insert(blk_size(blk), &fl, &sl);
-    insert_free_block(blk, fl, sl);
+    insert_free_block(ctl, blk, fl, sl);
 }
 
 __STATIC__ int blk_can_split(mmheap_blk_t *blk, size_t size)
@@ -351,13 +351,13 @@ __STATIC__ mmheap_blk_t *blk_absorb(mmheap_blk_t *prev_blk, mmheap_blk_t *blk)
 }
 
 /* Merge a just-freed block with an adjacent previous free block. */
-__STATIC__ mmheap_blk_t *blk_merge_prev(mmheap_blk_t *blk)
+__STATIC__ mmheap_blk_t *blk_merge_prev(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk)
 {
     mmheap_blk_t *prev_blk;
 
     if (blk_is_prev_free(blk)) {
         prev_blk = blk_prev(blk);
-        blk_remove(prev_blk);
+        blk_remove(ctl, prev_blk);
         blk = blk_absorb(prev_blk, blk);
     }
 
@@ -365,13 +365,13 @@ __STATIC__ mmheap_blk_t *blk_merge_prev(mmheap_blk_t *blk)
 }
 
 /* Merge a just-freed block with an adjacent free block. */
-__STATIC__ mmheap_blk_t *blk_merge_next(mmheap_blk_t *blk)
+__STATIC__ mmheap_blk_t *blk_merge_next(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk)
 {
     mmheap_blk_t *next_blk;
 
     next_blk = blk_next(blk);
     if (blk_is_free(next_blk)) {
-        blk_remove(next_blk);
+        blk_remove(ctl, next_blk);
         blk = blk_absorb(blk, next_blk);
     }
 
@@ -379,7 +379,7 @@ __STATIC__ mmheap_blk_t *blk_merge_next(mmheap_blk_t *blk)
 }
 
 /* Trim any trailing block space off the end of a block, return to pool. */
-__STATIC__ void blk_trim_free(mmheap_blk_t *blk, size_t size)
+__STATIC__ void blk_trim_free(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, size_t size)
 {
     mmheap_blk_t *remaining_blk;
 
@@ -387,12 +387,12 @@ __STATIC__ void blk_trim_free(mmheap_blk_t *blk, size_t size)
         remaining_blk = blk_split(blk, size);
         blk_link_next(blk);
         blk_set_prev_free(remaining_blk);
-        blk_insert(remaining_blk);
+        blk_insert(ctl, remaining_blk);
     }
 }
 
 /* Trim any trailing block space off the end of a used block, return to pool. */
-__STATIC__ void blk_trim_used(mmheap_blk_t *blk, size_t size)
+__STATIC__ void blk_trim_used(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, size_t size)
 {
     mmheap_blk_t *remaining_blk;
 
@@ -401,12 +401,12 @@ __STATIC__ void blk_trim_used(mmheap_blk_t *blk, size_t size)
         remaining_blk = blk_split(blk, size);
         blk_set_prev_used(remaining_blk);
 
-        remaining_blk = blk_merge_next(remaining_blk);
-        blk_insert(remaining_blk);
+        remaining_blk = blk_merge_next(ctl, remaining_blk);
+        blk_insert(ctl, remaining_blk);
     }
 }
 
-__STATIC__ mmheap_blk_t *blk_trim_free_leading(mmheap_blk_t *blk, size_t size)
+__STATIC__ mmheap_blk_t *blk_trim_free_leading(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, size_t size)
 {
     mmheap_blk_t *remaining_blk;
 
@@ -417,13 +417,13 @@ __STATIC__ mmheap_blk_t *blk_trim_free_leading(mmheap_blk_t *blk, size_t size)
         blk_set_prev_free(remaining_blk);
 
         blk_link_next(blk);
-        blk_insert(blk);
+        blk_insert(ctl, blk);
     }
 
     return remaining_blk;
 }
 
-__STATIC__ mmheap_blk_t *blk_search_suitable(int *fli, int *sli)
+__STATIC__ mmheap_blk_t *blk_search_suitable(k_mmheap_ctl_t *ctl, int *fli, int *sli)
 {
     int fl, sl;
     uint32_t sl_map, fl_map;
@@ -435,10 +435,10 @@ __STATIC__ mmheap_blk_t *blk_search_suitable(int *fli, int *sli)
 	** First, search for a block in the list associated with the given
 	** fl/sl index.
 	*/
-    sl_map = k_mmheap_ctl.sl_bitmap[fl] & (~0U << sl);
+    sl_map = ctl->sl_bitmap[fl] & (~0U << sl);
     if (!sl_map) {
         /* No block exists. Search in the next largest first-level list. */
-        fl_map = k_mmheap_ctl.fl_bitmap & (~0U << (fl + 1));
+        fl_map = ctl->fl_bitmap & (~0U << (fl + 1));
         if (!fl_map) {
             /* No free blocks available, memory has been exhausted. */
             return 0;
@@ -446,16 +446,16 @@ __STATIC__ mmheap_blk_t *blk_search_suitable(int *fli, int *sli)
 
         fl = __ffs(fl_map);
         *fli = fl;
-        sl_map = k_mmheap_ctl.sl_bitmap[fl];
+        sl_map = ctl->sl_bitmap[fl];
     }
     sl = __ffs(sl_map);
     *sli = sl;
 
     /* Return the first block in the free list. */
-    return k_mmheap_ctl.blocks[fl][sl];
+    return ctl->blocks[fl][sl];
 }
 
-__STATIC__ mmheap_blk_t *blk_locate_free(size_t size)
+__STATIC__ mmheap_blk_t *blk_locate_free(k_mmheap_ctl_t *ctl, size_t size)
 {
     int fl = 0, sl = 0;
     mmheap_blk_t *blk = K_NULL;
@@ -473,11 +473,11 @@ __STATIC__ mmheap_blk_t *blk_locate_free(size_t size)
     ** Note that we don't need to check sl, since it comes from a modulo operation that guarantees it's always in range.
     */
     if (fl < K_MMHEAP_FL_INDEX_COUNT) {
-        blk = blk_search_suitable(&fl, &sl);
+        blk = blk_search_suitable(ctl, &fl, &sl);
     }
 
     if (blk) {
-        remove_free_block(blk, fl, sl);
+        remove_free_block(ctl, blk, fl, sl);
     }
 
     return blk;
@@ -504,118 +504,427 @@ __STATIC__ size_t adjust_request_size(size_t size, size_t align)
     return adjust_size > K_MMHEAP_BLK_SIZE_MIN ? adjust_size : K_MMHEAP_BLK_SIZE_MIN;
 }
 
-__STATIC__ void *blk_prepare_used(mmheap_blk_t *blk, size_t size)
+__STATIC__ void *blk_prepare_used(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk, size_t size)
 {
     if (!blk) {
         return K_NULL;
     }
-    blk_trim_free(blk, size);
+    blk_trim_free(ctl, blk, size);
     blk_mark_as_used(blk);
     return blk_to_ptr(blk);
 }
 
-__STATIC_INLINE__ int mmheap_pool_is_full(void)
+/* Give a used block back to the free lists, merging it with its free neighbors. */
+__STATIC__ void blk_release(k_mmheap_ctl_t *ctl, mmheap_blk_t *blk)
 {
-    return k_mmheap_ctl.pool_cnt == K_MMHEAP_POOL_MAX;
+    blk_mark_as_free(blk);
+    blk = blk_merge_prev(ctl, blk);
+    blk = blk_merge_next(ctl, blk);
+    blk_insert(ctl, blk);
+}
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+/* The profiler tag, in the last bytes of a used block. */
+__STATIC_INLINE__ uint32_t *blk_tag(const mmheap_blk_t *blk)
+{
+    return (uint32_t *)((cpu_addr_t)blk_to_ptr(blk) + blk_size(blk) - K_MMHEAP_TAG_SIZE);
+}
+
+#endif
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+/* Cut a used block into a used block of the given size and a used remainder, return the remainder. */
+__STATIC__ mmheap_blk_t *blk_carve_used(mmheap_blk_t *blk, size_t size)
+{
+    mmheap_blk_t   *remaining;
+
+    remaining       = offset_to_blk(blk_to_ptr(blk), size - K_MMHEAP_BLK_HEADER_OVERHEAD);
+    remaining->size = blk_size(blk) - (size + K_MMHEAP_BLK_HEADER_OVERHEAD);
+
+    blk_set_size(blk, size);
+
+    return remaining;
+}
+
+#endif
+
+__STATIC_INLINE__ int mmheap_pool_is_full(k_mmheap_ctl_t *ctl)
+{
+    return ctl->pool_cnt == K_MMHEAP_POOL_MAX;
 }
 
-__STATIC__ int mmheap_pool_is_exist(void *pool_start)
+__STATIC__ int mmheap_pool_is_exist(k_mmheap_ctl_t *ctl, void *pool_start)
 {
     int i = 0;
 
-    for (i = 0; i < k_mmheap_ctl.pool_cnt; ++i) {
-        if (k_mmheap_ctl.pool_start[i] == pool_start) {
+    for (i = 0; i < ctl->pool_cnt; ++i) {
+        if (ctl->pool_start[i] == pool_start) {
             return K_TRUE;
         }
     }
     return K_FALSE;
 }
 
-__STATIC_INLINE__ void mmheap_pool_record(void *pool_start)
+__STATIC_INLINE__ void mmheap_pool_record(k_mmheap_ctl_t *ctl, void *pool_start)
 {
-    k_mmheap_ctl.pool_start[k_mmheap_ctl.pool_cnt++] = pool_start;
+    ctl->pool_start[ctl->pool_cnt++] = pool_start;
 }
 
-__STATIC__ void mmheap_pool_unrecord(void *pool_start)
+__STATIC__ void mmheap_pool_unrecord(k_mmheap_ctl_t *ctl, void *pool_start)
 {
     int i = 0;
 
-    for (i = 0; i < k_mmheap_ctl.pool_cnt; ++i) {
-        if (k_mmheap_ctl.pool_start[i] == pool_start) {
+    for (i = 0; i < ctl->pool_cnt; ++i) {
+        if (ctl->pool_start[i] == pool_start) {
             break;
         }
     }
-    if (i != k_mmheap_ctl.pool_cnt - 1) {
-        k_mmheap_ctl.pool_start[i] = k_mmheap_ctl.pool_start[k_mmheap_ctl.pool_cnt - 1];
+    if (i != ctl->pool_cnt - 1) {
+        ctl->pool_start[i] = ctl->pool_start[ctl->pool_cnt - 1];
+    }
+    --ctl->pool_cnt;
+}
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+/* Size class serving an adjusted request size. */
+__STATIC_INLINE__ int mmheap_cache_class(size_t size)
+{
+    size -= K_MMHEAP_TAG_SIZE;
+    if (size <= K_MMHEAP_CACHE_CLASS_SIZE_MIN) {
+        return 0;
+    }
+    return __fls(size - 1) + 1 - K_MMHEAP_CACHE_CLASS_SIZE_MIN_LOG2;
+}
+
+__STATIC_INLINE__ void mmheap_cache_push(mmheap_cache_class_t *cache, mmheap_blk_t *blk)
+{
+    blk->next_free  = cache->free;
+    cache->free     = blk;
+    ++cache->cnt;
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    *blk_tag(blk) = K_MMHEAP_TAG_CACHED;
+#endif
+}
+
+__STATIC_INLINE__ mmheap_blk_t *mmheap_cache_pop(mmheap_cache_class_t *cache)
+{
+    mmheap_blk_t *blk;
+
+    blk             = cache->free;
+    cache->free     = blk->next_free;
+    --cache->cnt;
+
+    return blk;
+}
+
+/*
+** Refill a size class from one slab of the heap: a single free block big enough
+** for TOS_CFG_MMHEAP_CACHE_SLAB_CNT blocks of the class, carved into used blocks
+** which can be given back to the heap one by one later.
+*/
+__STATIC__ int mmheap_cache_refill(int cls)
+{
+    mmheap_cache_class_t   *cache;
+    mmheap_blk_t           *blk, *remaining;
+    size_t                  cls_size, slab_size, cnt, i;
+
+    cache       = &k_mmheap_ctl.cache[cls];
+    cls_size    = K_MMHEAP_CACHE_CLASS_SIZE(cls);
+    cnt         = TOS_CFG_MMHEAP_CACHE_SLAB_CNT;
+    slab_size   = cnt * (cls_size + K_MMHEAP_BLK_HEADER_OVERHEAD) - K_MMHEAP_BLK_HEADER_OVERHEAD;
+
+    blk = blk_locate_free(&k_mmheap_ctl, slab_size);
+    if (!blk) {
+        /* no room for a whole slab, fall back to a single block */
+        cnt         = 1;
+        slab_size   = cls_size;
+        blk         = blk_locate_free(&k_mmheap_ctl, slab_size);
+        if (!blk) {
+            return K_FALSE;
+        }
+    }
+
+    blk_prepare_used(&k_mmheap_ctl, blk, slab_size);
+
+    for (i = 0; i < cnt - 1; ++i) {
+        remaining = blk_carve_used(blk, cls_size);
+        mmheap_cache_push(cache, blk);
+        blk = remaining;
+    }
+    /* the last one keeps whatever could not be trimmed off the slab */
+    mmheap_cache_push(cache, blk);
+
+    return K_TRUE;
+}
+
+__STATIC__ void *mmheap_cache_alloc(size_t size)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_cache_class_t   *cache;
+    mmheap_blk_t           *blk = K_NULL;
+    int                     cls;
+
+    cls     = mmheap_cache_class(size);
+    cache   = &k_mmheap_ctl.cache[cls];
+
+    TOS_CPU_INT_DISABLE();
+
+    if (cache->free || mmheap_cache_refill(cls)) {
+        blk = mmheap_cache_pop(cache);
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return blk ? blk_to_ptr(blk) : K_NULL;
+}
+
+/* Cache a block to be freed if its size is exactly the size of a class. */
+__STATIC__ int mmheap_cache_free(mmheap_blk_t *blk)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t size;
+
+    size = blk_size(blk) - K_MMHEAP_TAG_SIZE;
+    if (size < K_MMHEAP_CACHE_CLASS_SIZE_MIN ||
+        size > K_MMHEAP_CACHE_CLASS_SIZE_MAX - K_MMHEAP_TAG_SIZE ||
+        (size & (size - 1)) != 0u) {
+        return K_FALSE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+    mmheap_cache_push(&k_mmheap_ctl.cache[__fls(size) - K_MMHEAP_CACHE_CLASS_SIZE_MIN_LOG2], blk);
+    TOS_CPU_INT_ENABLE();
+
+    return K_TRUE;
+}
+
+/* Give the blocks of every class above keep_cnt back to the heap, one block per critical section. */
+__STATIC__ void mmheap_cache_shrink(size_t keep_cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_cache_class_t *cache;
+    int cls;
+
+    for (cls = 0; cls < TOS_CFG_MMHEAP_CACHE_CLASS_NUM; ++cls) {
+        cache = &k_mmheap_ctl.cache[cls];
+
+        while (cache->cnt > keep_cnt) {
+            TOS_CPU_INT_DISABLE();
+            if (cache->cnt > keep_cnt) {
+                blk_release(&k_mmheap_ctl, mmheap_cache_pop(cache));
+            }
+            TOS_CPU_INT_ENABLE();
+        }
+    }
+}
+
+/* Bytes held by the cache, they are used blocks of the heap. */
+__STATIC__ size_t mmheap_cache_size(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_blk_t *blk;
+    size_t size = 0u;
+    int cls;
+
+    TOS_CPU_INT_DISABLE();
+
+    for (cls = 0; cls < TOS_CFG_MMHEAP_CACHE_CLASS_NUM; ++cls) {
+        for (blk = k_mmheap_ctl.cache[cls].free; blk; blk = blk->next_free) {
+            size += blk_size(blk);
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return size;
+}
+
+#endif
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+/* The room for the tag is asked for on top of the size of the user. */
+#define MMHEAP_REQUEST_SIZE(size)   \
+    ((size) != 0u && (size) <= K_MMHEAP_BLK_SIZE_MAX ? (size) + K_MMHEAP_TAG_SIZE : (size))
+
+/* Index of a callsite in the tally, a new site takes a free slot, open addressing. */
+__STATIC__ uint32_t mmheap_site_index(void *site)
+{
+    uint32_t i, idx;
+
+    if (!site) {
+        return K_MMHEAP_TAG_SITE_OTHER;
+    }
+
+    idx = (uint32_t)(((cpu_addr_t)site >> 2) % TOS_CFG_MMHEAP_PROFILE_SITE_NUM);
+
+    for (i = 0; i < TOS_CFG_MMHEAP_PROFILE_SITE_NUM; ++i) {
+        if (k_mmheap_ctl.site[idx].site == site) {
+            return idx;
+        }
+
+        if (!k_mmheap_ctl.site[idx].site) {
+            k_mmheap_ctl.site[idx].site = site;
+            return idx;
+        }
+
+        if (++idx == TOS_CFG_MMHEAP_PROFILE_SITE_NUM) {
+            idx = 0;
+        }
+    }
+
+    return K_MMHEAP_TAG_SITE_OTHER;
+}
+
+/* Tag a block just allocated with the site, and add it to the tally, called with the interrupt disabled. */
+__STATIC__ void mmheap_site_add(void *ptr, uint32_t idx)
+{
+    k_mmheap_site_t *site;
+    mmheap_blk_t *blk;
+
+    blk     = blk_from_ptr(ptr);
+    site    = &k_mmheap_ctl.site[idx];
+
+    *blk_tag(blk) = idx;
+
+    site->bytes += blk_size(blk);
+    ++site->count;
+    if (site->bytes > site->bytes_peak) {
+        site->bytes_peak = site->bytes;
+    }
+}
+
+/* Take a block to be freed off the tally, return the index of its site. */
+__STATIC__ uint32_t mmheap_site_sub(void *ptr)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_mmheap_site_t *site;
+    mmheap_blk_t *blk;
+    uint32_t idx;
+
+    blk = blk_from_ptr(ptr);
+
+    TOS_CPU_INT_DISABLE();
+
+    idx = *blk_tag(blk);
+    if (idx <= K_MMHEAP_TAG_SITE_OTHER) {
+        site = &k_mmheap_ctl.site[idx];
+        site->bytes -= blk_size(blk);
+        --site->count;
     }
-    --k_mmheap_ctl.pool_cnt;
+
+    TOS_CPU_INT_ENABLE();
+
+    return idx;
+}
+
+__STATIC__ void mmheap_site_tally(void *ptr, void *site)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+    mmheap_site_add(ptr, mmheap_site_index(site));
+    TOS_CPU_INT_ENABLE();
 }
 
-__STATIC__ void mmheap_ctl_init(void)
+#define MMHEAP_SITE_TALLY(ptr)      mmheap_site_tally((ptr), __RETURN_ADDRESS__())
+#define MMHEAP_SITE_UNTALLY(ptr)    mmheap_site_sub(ptr)
+
+#else
+
+#define MMHEAP_REQUEST_SIZE(size)   (size)
+
+#define MMHEAP_SITE_TALLY(ptr)
+#define MMHEAP_SITE_UNTALLY(ptr)
+
+#endif
+
+__STATIC__ void mmheap_ctl_init(k_mmheap_ctl_t *ctl)
 {
     int i, j;
 
-    k_mmheap_ctl.pool_cnt = 0u;
+    ctl->pool_cnt = 0u;
     for (i = 0; i < K_MMHEAP_POOL_MAX; ++i) {
-        k_mmheap_ctl.pool_start[i] = (void *)K_NULL;
+        ctl->pool_start[i] = (void *)K_NULL;
     }
 
-    k_mmheap_ctl.block_null.next_free = &k_mmheap_ctl.block_null;
-    k_mmheap_ctl.block_null.prev_free = &k_mmheap_ctl.block_null;
+    ctl->block_null.next_free = &ctl->block_null;
+    ctl->block_null.prev_free = &ctl->block_null;
 
-    k_mmheap_ctl.fl_bitmap = 0;
+    ctl->fl_bitmap = 0;
     for (i = 0; i < K_MMHEAP_FL_INDEX_COUNT; ++i) {
-        k_mmheap_ctl.sl_bitmap[i] = 0;
+        ctl->sl_bitmap[i] = 0;
         for (j = 0; j < K_MMHEAP_SL_INDEX_COUNT; ++j) {
-            k_mmheap_ctl.blocks[i][j] = &k_mmheap_ctl.block_null;
+            ctl->blocks[i][j] = &ctl->block_null;
         }
     }
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    for (i = 0; i < TOS_CFG_MMHEAP_CACHE_CLASS_NUM; ++i) {
+        ctl->cache[i].free  = K_NULL;
+        ctl->cache[i].cnt   = 0u;
+    }
+#endif
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    memset(ctl->site, 0, sizeof(ctl->site));
+#endif
 }
 
 __KNL__ k_err_t mmheap_init(void)
 {
-    mmheap_ctl_init();
+    mmheap_ctl_init(&k_mmheap_ctl);
     return K_ERR_NONE;
 }
 
 __KNL__ k_err_t mmheap_init_with_pool(void *pool_start, size_t pool_size)
 {
-    mmheap_ctl_init();
+    mmheap_ctl_init(&k_mmheap_ctl);
 
     return tos_mmheap_pool_add(pool_start, pool_size);
 }
 
-__API__ void *tos_mmheap_alloc(size_t size)
+__STATIC__ void *mmheap_alloc(k_mmheap_ctl_t *ctl, size_t size)
 {
     size_t          adjust_size;
     mmheap_blk_t   *blk;
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    void           *ptr;
+#endif
 
     if (size > K_MMHEAP_BLK_SIZE_MAX) {
         return K_NULL;
     }
 
     adjust_size     = adjust_request_size(size, K_MMHEAP_ALIGN_SIZE);
-    blk             = blk_locate_free(adjust_size);
-    if (!blk) {
-        return K_NULL;
-    }
 
-    return blk_prepare_used(blk, adjust_size);
-}
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    /* only the shared heap is behind the cache */
+    if (ctl == &k_mmheap_ctl && adjust_size && adjust_size <= K_MMHEAP_CACHE_CLASS_SIZE_MAX) {
+        ptr = mmheap_cache_alloc(adjust_size);
+        if (!ptr) {
+            /* the room may be sitting in the other classes */
+            tos_mmheap_cache_drain();
+            ptr = mmheap_cache_alloc(adjust_size);
+        }
 
-__API__ void *tos_mmheap_calloc(size_t num, size_t size)
-{
-    void *ptr;
+        return ptr;
+    }
+#endif
 
-    ptr = tos_mmheap_alloc(num * size);
-    if (ptr) {
-        memset(ptr, 0, num * size);
+    blk             = blk_locate_free(ctl, adjust_size);
+    if (!blk) {
+        return K_NULL;
     }
 
-    return ptr;
+    return blk_prepare_used(ctl, blk, adjust_size);
 }
 
-__API__ void *tos_mmheap_aligned_alloc(size_t size, size_t align)
+__STATIC__ void *mmheap_aligned_alloc(k_mmheap_ctl_t *ctl, size_t size, size_t align)
 {
     mmheap_blk_t *blk;
     void *ptr, *aligned, *next_aligned;
@@ -627,7 +936,7 @@ __API__ void *tos_mmheap_aligned_alloc(size_t size, size_t align)
     size_with_gap   = adjust_request_size(adjust_size + align + gap_minimum, align);
     aligned_size    = (adjust_size && align > K_MMHEAP_ALIGN_SIZE) ? size_with_gap : adjust_size;
 
-    blk = blk_locate_free(aligned_size);
+    blk = blk_locate_free(ctl, aligned_size);
     if (!blk) {
         return K_NULL;
     }
@@ -646,40 +955,40 @@ __API__ void *tos_mmheap_aligned_alloc(size_t size, size_t align)
     }
 
     if (gap) {
-        blk = blk_trim_free_leading(blk, gap);
+        blk = blk_trim_free_leading(ctl, blk, gap);
     }
 
-    return blk_prepare_used(blk, adjust_size);
+    return blk_prepare_used(ctl, blk, adjust_size);
 }
 
-__API__ void tos_mmheap_free(void *ptr)
+__STATIC__ void mmheap_free(k_mmheap_ctl_t *ctl, void *ptr)
 {
     mmheap_blk_t *blk;
 
-    if (!ptr) {
+    blk = blk_from_ptr(ptr);
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    if (ctl == &k_mmheap_ctl && mmheap_cache_free(blk)) {
         return;
     }
+#endif
 
-    blk = blk_from_ptr(ptr);
-    blk_mark_as_free(blk);
-    blk = blk_merge_prev(blk);
-    blk = blk_merge_next(blk);
-    blk_insert(blk);
+    blk_release(ctl, blk);
 }
 
-__API__ void *tos_mmheap_realloc(void *ptr, size_t size)
+__STATIC__ void *mmheap_realloc(k_mmheap_ctl_t *ctl, void *ptr, size_t size)
 {
     void *p = 0;
     mmheap_blk_t *curr_blk, *next_blk;
     size_t curr_size, combined_size, adjust_size, min_size;
 
     if (ptr && size == 0) {
-        tos_mmheap_free(ptr);
+        mmheap_free(ctl, ptr);
         return K_NULL;
     }
 
     if (!ptr) {
-        return tos_mmheap_alloc(size);
+        return mmheap_alloc(ctl, size);
     }
 
     curr_blk = blk_from_ptr(ptr);
@@ -690,119 +999,517 @@ __API__ void *tos_mmheap_realloc(void *ptr, size_t size)
     adjust_size = adjust_request_size(size, K_MMHEAP_ALIGN_SIZE);
 
     if (adjust_size > curr_size && (!blk_is_free(next_blk) || adjust_size > combined_size)) {
-        p = tos_mmheap_alloc(size);
+        p = mmheap_alloc(ctl, size);
         if (p) {
             min_size = curr_size < size ? curr_size : size;
             memcpy(p, ptr, min_size);
-            tos_mmheap_free(ptr);
+            mmheap_free(ctl, ptr);
         }
     } else {
         if (adjust_size > curr_size) {
-            blk_merge_next(curr_blk);
+            blk_merge_next(ctl, curr_blk);
             blk_mark_as_used(curr_blk);
         }
 
-        blk_trim_used(curr_blk, adjust_size);
+        blk_trim_used(ctl, curr_blk, adjust_size);
         p = ptr;
     }
 
     return p;
 }
 
-__API__ k_err_t tos_mmheap_pool_add(void *pool_start, size_t pool_size)
-{
-    mmheap_blk_t   *curr_blk;
-    mmheap_blk_t   *next_blk;
-    size_t          size_aligned;
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
 
-    if (mmheap_pool_is_full()) {
-        return K_ERR_MMHEAP_POOL_OVERFLOW;
-    }
+/*
+** The free lists of an arena are only touched by tasks, with the scheduler locked: the interrupts
+** stay enabled through the TLSF work. A block of an arena freed in interrupt context is queued on
+** irq_free, and given back by the next call on the arena in a task. With TOS_CFG_SMP_EN the scheduler
+** lock only holds the local cpu, the arena stays behind the critical section.
+*/
+#if TOS_CFG_SMP_EN > 0u
 
-    if (mmheap_pool_is_exist(pool_start)) {
-        return K_ERR_MMHEAP_POOL_ALREADY_EXIST;
-    }
+#define MMHEAP_ARENA_LOCK_ALLOC()   cpu_cpsr_t arena_cpsr = (cpu_cpsr_t)0u
+#define MMHEAP_ARENA_LOCK()         (arena_cpsr = tos_cpu_cpsr_save())
+#define MMHEAP_ARENA_UNLOCK()       tos_cpu_cpsr_restore(arena_cpsr)
 
-    size_aligned = align_down(pool_size - 2 * K_MMHEAP_BLK_HEADER_OVERHEAD, K_MMHEAP_ALIGN_SIZE);
+#else
 
-    if (((cpu_addr_t)pool_start % K_MMHEAP_ALIGN_SIZE) != 0u) {
-        return K_ERR_MMHEAP_INVALID_POOL_ADDR;
+#define MMHEAP_ARENA_LOCK_ALLOC()
+#define MMHEAP_ARENA_LOCK()         tos_knl_sched_lock()
+#define MMHEAP_ARENA_UNLOCK()       tos_knl_sched_unlock()
+
+#endif
+
+/* The arena of the current task, the allocations in interrupt context go to the shared heap. */
+__STATIC__ k_mmheap_arena_t *mmheap_arena_curr(void)
+{
+    if (!tos_knl_is_running() || knl_is_inirq()) {
+        return K_NULL;
     }
+    return k_curr_task->mmheap_arena;
+}
 
-    if (size_aligned < K_MMHEAP_BLK_SIZE_MIN ||
-        size_aligned > K_MMHEAP_BLK_SIZE_MAX) {
-        return K_ERR_MMHEAP_INVALID_POOL_SIZE;
+/* The arena a block is from, K_NULL for the shared heap. */
+__STATIC__ k_mmheap_arena_t *mmheap_arena_of(void *ptr)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_mmheap_arena_t *arena;
+    int i;
+
+    /* no arena, or out of every pool an arena ever had: from the shared heap, no need to walk the list */
+    if ((cpu_addr_t)ptr < k_mmheap_arena_addr_lo || (cpu_addr_t)ptr >= k_mmheap_arena_addr_hi) {
+        return K_NULL;
     }
 
-    /*
-     ** Create the main free block. Offset the start of the block slightly
-     ** so that the prev_phys_block field falls outside of the pool -
-     ** it will never be used.
-     */
-    curr_blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
-    blk_set_size(curr_blk, size_aligned);
-    blk_set_free(curr_blk);
-    blk_set_prev_used(curr_blk);
-    blk_insert(curr_blk);
+    TOS_CPU_INT_DISABLE();
 
-    /* Split the block to create a zero-size sentinel block. */
-    next_blk = blk_link_next(curr_blk);
-    blk_set_size(next_blk, 0);
-    blk_set_used(next_blk);
-    blk_set_prev_free(next_blk);
+    TOS_LIST_FOR_EACH_ENTRY(arena, k_mmheap_arena_t, list, &k_mmheap_arena_list) {
+        for (i = 0; i < arena->ctl.pool_cnt; ++i) {
+            if ((cpu_addr_t)ptr >= (cpu_addr_t)arena->ctl.pool_start[i] &&
+                (cpu_addr_t)ptr < arena->pool_end[i]) {
+                TOS_CPU_INT_ENABLE();
+                return arena;
+            }
+        }
+    }
 
-    mmheap_pool_record(pool_start);
+    TOS_CPU_INT_ENABLE();
 
-    return K_ERR_NONE;
+    return K_NULL;
 }
 
-__API__ k_err_t tos_mmheap_pool_rmv(void *pool_start)
+/* Widen the range of the arena pools to a new pool, called with the interrupt disabled. */
+__STATIC__ void mmheap_arena_addr_add(void *pool_start, size_t pool_size)
 {
-    int fl = 0, sl = 0;
-    mmheap_blk_t *blk;
+    if ((cpu_addr_t)pool_start < k_mmheap_arena_addr_lo) {
+        k_mmheap_arena_addr_lo = (cpu_addr_t)pool_start;
+    }
+    if ((cpu_addr_t)pool_start + pool_size > k_mmheap_arena_addr_hi) {
+        k_mmheap_arena_addr_hi = (cpu_addr_t)pool_start + pool_size;
+    }
+}
 
-    TOS_PTR_SANITY_CHECK(pool_start);
+/* Give a block back to an arena, called with the arena locked. */
+__STATIC__ void mmheap_arena_release(k_mmheap_arena_t *arena, void *ptr)
+{
+    arena->used -= blk_size(blk_from_ptr(ptr));
+    ++arena->free_cnt;
+    mmheap_free(&arena->ctl, ptr);
+}
 
-    if (!mmheap_pool_is_exist(pool_start)) {
-        return K_ERR_MMHEAP_POOL_NOT_EXIST;
+/* Give the blocks freed in interrupt context back to an arena, called with the arena locked. */
+__STATIC__ void mmheap_arena_irq_free_drain(k_mmheap_arena_t *arena)
+{
+    TOS_CPU_CPSR_ALLOC();
+    void *ptr, *next;
+
+    if (!arena->irq_free) {
+        return;
     }
 
-    blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
-    mapping_insert(blk_size(blk), &fl, &sl);
-    remove_free_block(blk, fl, sl);
+    TOS_CPU_INT_DISABLE();
+    ptr = arena->irq_free;
+    arena->irq_free = K_NULL;
+    TOS_CPU_INT_ENABLE();
 
-    mmheap_pool_unrecord(pool_start);
-    return K_ERR_NONE;
+    while (ptr) {
+        next = *(void **)ptr;
+        mmheap_arena_release(arena, ptr);
+        ptr = next;
+    }
 }
 
-__API__ k_err_t tos_mmheap_pool_check(void *pool_start, k_mmheap_info_t *info)
+/* Queue a block freed in interrupt context, the block itself holds the link. */
+__STATIC__ void mmheap_arena_irq_free(k_mmheap_arena_t *arena, void *ptr)
 {
-    mmheap_blk_t* blk;
+    TOS_CPU_CPSR_ALLOC();
 
-    TOS_PTR_SANITY_CHECK(pool_start);
-    TOS_PTR_SANITY_CHECK(info);
+    TOS_CPU_INT_DISABLE();
+    *(void **)ptr = arena->irq_free;
+    arena->irq_free = ptr;
+    TOS_CPU_INT_ENABLE();
+}
 
-    memset(info, 0, sizeof(k_mmheap_info_t));
+/* Charge a block just allocated to the budget, give it back if the budget is used up. */
+__STATIC__ void *mmheap_arena_charge(k_mmheap_arena_t *arena, void *ptr)
+{
+    size_t size;
 
-    blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
+    if (!ptr) {
+        ++arena->fail_cnt;
+        return K_NULL;
+    }
 
-    while (blk && !blk_is_last(blk)) {
-        if (blk_is_free(blk)) {
-            info->free += blk_size(blk);
-        } else {
-            info->used += blk_size(blk);
-        }
-        blk = blk_next(blk);
+    size = blk_size(blk_from_ptr(ptr));
+    if (arena->budget && arena->used + size > arena->budget) {
+        mmheap_free(&arena->ctl, ptr);
+        ++arena->fail_cnt;
+        return K_NULL;
     }
 
-    return K_ERR_NONE;
+    arena->used += size;
+    if (arena->used > arena->used_peak) {
+        arena->used_peak = arena->used;
+    }
+    ++arena->alloc_cnt;
+
+    return ptr;
 }
 
-__API__ k_err_t tos_mmheap_check(k_mmheap_info_t *info)
+/* Allocate from an arena, align 0 for no alignment beyond K_MMHEAP_ALIGN_SIZE. */
+__STATIC__ void *mmheap_arena_alloc(k_mmheap_arena_t *arena, size_t size, size_t align)
 {
-    int i;
+    MMHEAP_ARENA_LOCK_ALLOC();
+    void *ptr;
+
+    MMHEAP_ARENA_LOCK();
+
+    mmheap_arena_irq_free_drain(arena);
+
+    if (align) {
+        ptr = mmheap_aligned_alloc(&arena->ctl, size, align);
+    } else {
+        ptr = mmheap_alloc(&arena->ctl, size);
+    }
+    ptr = mmheap_arena_charge(arena, ptr);
+
+    MMHEAP_ARENA_UNLOCK();
+
+    return ptr;
+}
+
+__STATIC__ void mmheap_arena_free(k_mmheap_arena_t *arena, void *ptr)
+{
+    MMHEAP_ARENA_LOCK_ALLOC();
+
+    if (knl_is_inirq()) {
+        mmheap_arena_irq_free(arena, ptr);
+        return;
+    }
+
+    MMHEAP_ARENA_LOCK();
+
+    mmheap_arena_irq_free_drain(arena);
+    mmheap_arena_release(arena, ptr);
+
+    MMHEAP_ARENA_UNLOCK();
+}
+
+/* A block of an arena is only shrunk in place, every byte more is a new block charged to the budget. */
+__STATIC__ void *mmheap_arena_realloc(k_mmheap_arena_t *arena, void *ptr, size_t size)
+{
+    MMHEAP_ARENA_LOCK_ALLOC();
+    mmheap_blk_t *blk;
+    size_t curr_size, adjust_size;
+    void *p;
+
+    if (!ptr) {
+        return mmheap_arena_alloc(arena, size, 0u);
+    }
+
+    if (!size) {
+        mmheap_arena_free(arena, ptr);
+        return K_NULL;
+    }
+
+    /* the free lists of an arena are not for the interrupt context */
+    if (knl_is_inirq()) {
+        return K_NULL;
+    }
+
+    blk         = blk_from_ptr(ptr);
+    curr_size   = blk_size(blk);
+    adjust_size = adjust_request_size(size, K_MMHEAP_ALIGN_SIZE);
+    if (!adjust_size) {
+        return K_NULL;
+    }
+
+    if (adjust_size <= curr_size) {
+        MMHEAP_ARENA_LOCK();
+        blk_trim_used(&arena->ctl, blk, adjust_size);
+        arena->used -= curr_size - blk_size(blk);
+        MMHEAP_ARENA_UNLOCK();
+
+        return ptr;
+    }
+
+    p = mmheap_arena_alloc(arena, size, 0u);
+    if (p) {
+        memcpy(p, ptr, curr_size);
+        mmheap_arena_free(arena, ptr);
+    }
+
+    return p;
+}
+
+#endif
+
+/* Route an allocation to the arena of the current task or to the shared heap, align 0 for no alignment. */
+__STATIC__ void *mmheap_route_alloc(size_t size, size_t align)
+{
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    k_mmheap_arena_t *arena;
+
+    arena = mmheap_arena_curr();
+    if (arena) {
+        return mmheap_arena_alloc(arena, size, align);
+    }
+#endif
+
+    if (align) {
+        return mmheap_aligned_alloc(&k_mmheap_ctl, size, align);
+    }
+    return mmheap_alloc(&k_mmheap_ctl, size);
+}
+
+/* Give a block back to where it is from. */
+__STATIC__ void mmheap_route_free(void *ptr)
+{
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    k_mmheap_arena_t *arena;
+
+    arena = mmheap_arena_of(ptr);
+    if (arena) {
+        mmheap_arena_free(arena, ptr);
+        return;
+    }
+#endif
+
+    mmheap_free(&k_mmheap_ctl, ptr);
+}
+
+/* A block is resized where it is from, a new one goes to the arena of the current task. */
+__STATIC__ void *mmheap_route_realloc(void *ptr, size_t size)
+{
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    k_mmheap_arena_t *arena;
+
+    arena = ptr ? mmheap_arena_of(ptr) : mmheap_arena_curr();
+    if (arena) {
+        return mmheap_arena_realloc(arena, ptr, size);
+    }
+#endif
+
+    return mmheap_realloc(&k_mmheap_ctl, ptr, size);
+}
+
+__API__ void *tos_mmheap_alloc(size_t size)
+{
+    void *ptr;
+
+    ptr = mmheap_route_alloc(MMHEAP_REQUEST_SIZE(size), 0u);
+    if (ptr) {
+        MMHEAP_SITE_TALLY(ptr);
+        TOS_TRACE(K_TRACE_EVENT_MMHEAP_ALLOC, ptr, size, 0u);
+    }
+
+    return ptr;
+}
+
+__API__ void *tos_mmheap_calloc(size_t num, size_t size)
+{
+    void *ptr;
+
+    ptr = mmheap_route_alloc(MMHEAP_REQUEST_SIZE(num * size), 0u);
+    if (ptr) {
+        MMHEAP_SITE_TALLY(ptr);
+        TOS_TRACE(K_TRACE_EVENT_MMHEAP_ALLOC, ptr, num * size, 0u);
+        memset(ptr, 0, num * size);
+    }
+
+    return ptr;
+}
+
+__API__ void *tos_mmheap_aligned_alloc(size_t size, size_t align)
+{
+    void *ptr;
+
+    ptr = mmheap_route_alloc(MMHEAP_REQUEST_SIZE(size), align);
+    if (ptr) {
+        MMHEAP_SITE_TALLY(ptr);
+        TOS_TRACE(K_TRACE_EVENT_MMHEAP_ALLOC, ptr, size, 0u);
+    }
+
+    return ptr;
+}
+
+__API__ void tos_mmheap_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    TOS_TRACE(K_TRACE_EVENT_MMHEAP_FREE, ptr, 0u, 0u);
+
+    MMHEAP_SITE_UNTALLY(ptr);
+    mmheap_route_free(ptr);
+}
+
+__API__ void *tos_mmheap_realloc(void *ptr, size_t size)
+{
+    void *p;
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t idx = 0u;
+
+    if (ptr) {
+        idx = mmheap_site_sub(ptr);
+    }
+#endif
+
+    p = mmheap_route_realloc(ptr, MMHEAP_REQUEST_SIZE(size));
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+    if (p) {
+        MMHEAP_SITE_TALLY(p);
+    } else if (ptr && size) {
+        /* failed, the old block is still there and still the caller's */
+        TOS_CPU_INT_DISABLE();
+        mmheap_site_add(ptr, idx);
+        TOS_CPU_INT_ENABLE();
+    }
+#endif
+
+    if (p != ptr) {
+        if (ptr && (p || !size)) {
+            TOS_TRACE(K_TRACE_EVENT_MMHEAP_FREE, ptr, 0u, 0u);
+        }
+        if (p) {
+            TOS_TRACE(K_TRACE_EVENT_MMHEAP_ALLOC, p, size, 0u);
+        }
+    }
+
+    return p;
+}
+
+/* The kernel's own allocations(task stacks, object pools, slabs) stay out of the arenas of the tasks. */
+__KNL__ void *mmheap_shared_alloc(size_t size)
+{
+    void *ptr;
+
+    ptr = mmheap_alloc(&k_mmheap_ctl, MMHEAP_REQUEST_SIZE(size));
+    if (ptr) {
+        MMHEAP_SITE_TALLY(ptr);
+        TOS_TRACE(K_TRACE_EVENT_MMHEAP_ALLOC, ptr, size, 0u);
+    }
+
+    return ptr;
+}
+
+__KNL__ void mmheap_shared_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    TOS_TRACE(K_TRACE_EVENT_MMHEAP_FREE, ptr, 0u, 0u);
+
+    MMHEAP_SITE_UNTALLY(ptr);
+    mmheap_free(&k_mmheap_ctl, ptr);
+}
+
+__STATIC__ k_err_t mmheap_pool_add(k_mmheap_ctl_t *ctl, void *pool_start, size_t pool_size)
+{
+    mmheap_blk_t   *curr_blk;
+    mmheap_blk_t   *next_blk;
+    size_t          size_aligned;
+
+    if (mmheap_pool_is_full(ctl)) {
+        return K_ERR_MMHEAP_POOL_OVERFLOW;
+    }
+
+    if (mmheap_pool_is_exist(ctl, pool_start)) {
+        return K_ERR_MMHEAP_POOL_ALREADY_EXIST;
+    }
+
+    size_aligned = align_down(pool_size - 2 * K_MMHEAP_BLK_HEADER_OVERHEAD, K_MMHEAP_ALIGN_SIZE);
+
+    if (((cpu_addr_t)pool_start % K_MMHEAP_ALIGN_SIZE) != 0u) {
+        return K_ERR_MMHEAP_INVALID_POOL_ADDR;
+    }
+
+    if (size_aligned < K_MMHEAP_BLK_SIZE_MIN ||
+        size_aligned > K_MMHEAP_BLK_SIZE_MAX) {
+        return K_ERR_MMHEAP_INVALID_POOL_SIZE;
+    }
+
+    /*
+     ** Create the main free block. Offset the start of the block slightly
+     ** so that the prev_phys_block field falls outside of the pool -
+     ** it will never be used.
+     */
+    curr_blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
+    blk_set_size(curr_blk, size_aligned);
+    blk_set_free(curr_blk);
+    blk_set_prev_used(curr_blk);
+    blk_insert(ctl, curr_blk);
+
+    /* Split the block to create a zero-size sentinel block. */
+    next_blk = blk_link_next(curr_blk);
+    blk_set_size(next_blk, 0);
+    blk_set_used(next_blk);
+    blk_set_prev_free(next_blk);
+
+    mmheap_pool_record(ctl, pool_start);
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_pool_add(void *pool_start, size_t pool_size)
+{
+    return mmheap_pool_add(&k_mmheap_ctl, pool_start, pool_size);
+}
+
+__API__ k_err_t tos_mmheap_pool_rmv(void *pool_start)
+{
+    int fl = 0, sl = 0;
+    mmheap_blk_t *blk;
+
+    TOS_PTR_SANITY_CHECK(pool_start);
+
+    if (!mmheap_pool_is_exist(&k_mmheap_ctl, pool_start)) {
+        return K_ERR_MMHEAP_POOL_NOT_EXIST;
+    }
+
+    blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
+    mapping_insert(blk_size(blk), &fl, &sl);
+    remove_free_block(&k_mmheap_ctl, blk, fl, sl);
+
+    mmheap_pool_unrecord(&k_mmheap_ctl, pool_start);
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_pool_check(void *pool_start, k_mmheap_info_t *info)
+{
+    mmheap_blk_t* blk;
+
+    TOS_PTR_SANITY_CHECK(pool_start);
+    TOS_PTR_SANITY_CHECK(info);
+
+    memset(info, 0, sizeof(k_mmheap_info_t));
+
+    blk = offset_to_blk(pool_start, -K_MMHEAP_BLK_HEADER_OVERHEAD);
+
+    while (blk && !blk_is_last(blk)) {
+        if (blk_is_free(blk)) {
+            info->free += blk_size(blk);
+        } else {
+            info->used += blk_size(blk);
+        }
+        blk = blk_next(blk);
+    }
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_check(k_mmheap_info_t *info)
+{
+    int i;
     k_err_t err;
     k_mmheap_info_t pool_info;
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    size_t cache_size;
+#endif
 
     TOS_PTR_SANITY_CHECK(info);
 
@@ -818,8 +1525,376 @@ __API__ k_err_t tos_mmheap_check(k_mmheap_info_t *info)
         info->used += pool_info.used;
     }
 
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    /* the blocks in the cache are free to the user */
+    cache_size = mmheap_cache_size();
+    info->free += cache_size;
+    info->used -= cache_size;
+#endif
+
+    return K_ERR_NONE;
+}
+
+__API__ size_t tos_mmheap_largest_free(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_blk_t *blk;
+    size_t largest = 0u;
+    int fl, sl;
+
+    TOS_CPU_INT_DISABLE();
+
+    /* the largest block is in the highest non-empty list */
+    if (k_mmheap_ctl.fl_bitmap) {
+        fl = __fls(k_mmheap_ctl.fl_bitmap);
+        sl = __fls(k_mmheap_ctl.sl_bitmap[fl]);
+
+        for (blk = k_mmheap_ctl.blocks[fl][sl]; blk != &k_mmheap_ctl.block_null; blk = blk->next_free) {
+            if (blk_size(blk) > largest) {
+                largest = blk_size(blk);
+            }
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return largest;
+}
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+/* the blocks in the cache are free to the user, count them as tos_mmheap_check does */
+__STATIC__ void mmheap_cache_frag_check(k_mmheap_frag_t *frag)
+{
+    mmheap_blk_t *blk;
+    int cls, fl, sl;
+
+    for (cls = 0; cls < TOS_CFG_MMHEAP_CACHE_CLASS_NUM; ++cls) {
+        for (blk = k_mmheap_ctl.cache[cls].free; blk; blk = blk->next_free) {
+            mapping_insert(blk_size(blk), &fl, &sl);
+            ++frag->free_cnt[fl];
+            frag->free_bytes[fl] += blk_size(blk);
+            frag->free_cached += blk_size(blk);
+
+            if (blk_size(blk) > frag->free_largest) {
+                frag->free_largest = blk_size(blk);
+            }
+        }
+    }
+
+    frag->free_total += frag->free_cached;
+}
+
+#endif
+
+__API__ k_err_t tos_mmheap_frag_check(k_mmheap_frag_t *frag)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_blk_t *blk;
+    int fl, sl;
+
+    TOS_PTR_SANITY_CHECK(frag);
+
+    memset(frag, 0, sizeof(k_mmheap_frag_t));
+
+    TOS_CPU_INT_DISABLE();
+
+    for (fl = 0; fl < K_MMHEAP_FL_INDEX_COUNT; ++fl) {
+        if (!(k_mmheap_ctl.fl_bitmap & (1 << fl))) {
+            continue;
+        }
+
+        for (sl = 0; sl < K_MMHEAP_SL_INDEX_COUNT; ++sl) {
+            for (blk = k_mmheap_ctl.blocks[fl][sl]; blk != &k_mmheap_ctl.block_null; blk = blk->next_free) {
+                ++frag->free_cnt[fl];
+                frag->free_bytes[fl] += blk_size(blk);
+
+                if (blk_size(blk) > frag->free_largest) {
+                    frag->free_largest = blk_size(blk);
+                }
+            }
+        }
+
+        frag->free_total += frag->free_bytes[fl];
+    }
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+    mmheap_cache_frag_check(frag);
+#endif
+
+    TOS_CPU_INT_ENABLE();
+
+    if (frag->free_total) {
+        frag->frag_index = 1000u - (uint32_t)((uint64_t)frag->free_largest * 1000u / frag->free_total);
+    }
+
+    return K_ERR_NONE;
+}
+
+#if TOS_CFG_MMHEAP_PROFILE_EN > 0u
+
+__API__ size_t tos_mmheap_site_read(k_mmheap_site_t *site, size_t cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t n = 0u;
+    uint32_t i;
+
+    if (!site) {
+        return 0u;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    for (i = 0; i <= K_MMHEAP_TAG_SITE_OTHER && n < cnt; ++i) {
+        if (k_mmheap_ctl.site[i].site || k_mmheap_ctl.site[i].bytes_peak) {
+            site[n++] = k_mmheap_ctl.site[i];
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return n;
+}
+
+__API__ size_t tos_mmheap_map_read(size_t first, k_mmheap_blk_rec_t *rec, size_t cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    mmheap_blk_t *blk;
+    size_t idx = 0u, n = 0u;
+    uint32_t tag;
+    int i;
+
+    if (!rec) {
+        return 0u;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    for (i = 0; i < k_mmheap_ctl.pool_cnt && n < cnt; ++i) {
+        blk = offset_to_blk(k_mmheap_ctl.pool_start[i], -K_MMHEAP_BLK_HEADER_OVERHEAD);
+
+        for (; !blk_is_last(blk) && n < cnt; blk = blk_next(blk), ++idx) {
+            if (idx < first) {
+                continue;
+            }
+
+            rec[n].addr = blk_to_ptr(blk);
+            rec[n].size = blk_size(blk);
+            rec[n].site = K_NULL;
+
+            if (blk_is_free(blk)) {
+                rec[n].state = K_MMHEAP_BLK_STATE_FREE;
+            } else {
+                tag = *blk_tag(blk);
+                if (tag == K_MMHEAP_TAG_CACHED) {
+                    rec[n].state = K_MMHEAP_BLK_STATE_CACHED;
+                } else {
+                    rec[n].state = K_MMHEAP_BLK_STATE_USED;
+                    if (tag <= K_MMHEAP_TAG_SITE_OTHER) {
+                        rec[n].site = k_mmheap_ctl.site[tag].site;
+                    }
+                }
+            }
+            ++n;
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return n;
+}
+
+#endif
+
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+
+__API__ void tos_mmheap_cache_drain(void)
+{
+    mmheap_cache_shrink(0u);
+}
+
+__KNL__ void mmheap_cache_trim(void)
+{
+    mmheap_cache_shrink(TOS_CFG_MMHEAP_CACHE_KEEP_CNT);
+}
+
+#endif
+
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+
+__API__ k_err_t tos_mmheap_arena_create(k_mmheap_arena_t *arena, void *pool_start, size_t pool_size, size_t budget)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_err_t err;
+
+    TOS_PTR_SANITY_CHECK(arena);
+    TOS_PTR_SANITY_CHECK(pool_start);
+    TOS_OBJ_TEST_RC(arena, KNL_OBJ_TYPE_MMHEAP_ARENA, K_ERR_MMHEAP_ARENA_ALREADY_CREATED);
+
+    mmheap_ctl_init(&arena->ctl);
+
+    err = mmheap_pool_add(&arena->ctl, pool_start, pool_size);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+    arena->pool_end[0]  = (cpu_addr_t)pool_start + pool_size;
+
+    arena->budget       = budget;
+    arena->used         = 0u;
+    arena->used_peak    = 0u;
+    arena->alloc_cnt    = 0u;
+    arena->free_cnt     = 0u;
+    arena->fail_cnt     = 0u;
+    arena->task_cnt     = 0u;
+    arena->irq_free     = K_NULL;
+
+    TOS_OBJ_INIT(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+
+    TOS_CPU_INT_DISABLE();
+    tos_list_add(&arena->list, &k_mmheap_arena_list);
+    mmheap_arena_addr_add(pool_start, pool_size);
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_arena_destroy(k_mmheap_arena_t *arena)
+{
+    TOS_CPU_CPSR_ALLOC();
+    MMHEAP_ARENA_LOCK_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(arena);
+    TOS_OBJ_VERIFY(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+
+    MMHEAP_ARENA_LOCK();
+
+    mmheap_arena_irq_free_drain(arena);
+
+    TOS_CPU_INT_DISABLE();
+
+    if (arena->used || arena->task_cnt) {
+        TOS_CPU_INT_ENABLE();
+        MMHEAP_ARENA_UNLOCK();
+        return K_ERR_MMHEAP_ARENA_BUSY;
+    }
+
+    tos_list_del(&arena->list);
+
+    TOS_CPU_INT_ENABLE();
+    MMHEAP_ARENA_UNLOCK();
+
+    TOS_OBJ_DEINIT(arena);
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_arena_pool_add(k_mmheap_arena_t *arena, void *pool_start, size_t pool_size)
+{
+    TOS_CPU_CPSR_ALLOC();
+    MMHEAP_ARENA_LOCK_ALLOC();
+    k_err_t err;
+
+    TOS_PTR_SANITY_CHECK(arena);
+    TOS_OBJ_VERIFY(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+
+    MMHEAP_ARENA_LOCK();
+
+    err = mmheap_pool_add(&arena->ctl, pool_start, pool_size);
+    if (err == K_ERR_NONE) {
+        TOS_CPU_INT_DISABLE();
+        arena->pool_end[arena->ctl.pool_cnt - 1] = (cpu_addr_t)pool_start + pool_size;
+        mmheap_arena_addr_add(pool_start, pool_size);
+        TOS_CPU_INT_ENABLE();
+    }
+
+    MMHEAP_ARENA_UNLOCK();
+
+    return err;
+}
+
+__API__ k_err_t tos_mmheap_arena_budget_set(k_mmheap_arena_t *arena, size_t budget)
+{
+    TOS_PTR_SANITY_CHECK(arena);
+    TOS_OBJ_VERIFY(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+
+    arena->budget = budget;
+
     return K_ERR_NONE;
 }
 
+__API__ k_err_t tos_mmheap_arena_bind(k_task_t *task, k_mmheap_arena_t *arena)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    if (!task) {
+        task = k_curr_task;
+    }
+
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+    if (arena) {
+        TOS_OBJ_VERIFY(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    mmheap_arena_unbind(task);
+    if (arena) {
+        task->mmheap_arena = arena;
+        ++arena->task_cnt;
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_mmheap_arena_check(k_mmheap_arena_t *arena, k_mmheap_arena_info_t *info)
+{
+    TOS_CPU_CPSR_ALLOC();
+    MMHEAP_ARENA_LOCK_ALLOC();
+    k_mmheap_info_t pool_info;
+    int i;
+
+    TOS_PTR_SANITY_CHECK(arena);
+    TOS_PTR_SANITY_CHECK(info);
+    TOS_OBJ_VERIFY(arena, KNL_OBJ_TYPE_MMHEAP_ARENA);
+
+    MMHEAP_ARENA_LOCK();
+
+    mmheap_arena_irq_free_drain(arena);
+
+    TOS_CPU_INT_DISABLE();
+
+    info->budget    = arena->budget;
+    info->used      = arena->used;
+    info->used_peak = arena->used_peak;
+    info->alloc_cnt = arena->alloc_cnt;
+    info->free_cnt  = arena->free_cnt;
+    info->fail_cnt  = arena->fail_cnt;
+    info->task_cnt  = arena->task_cnt;
+
+    TOS_CPU_INT_ENABLE();
+
+    info->free = 0u;
+    for (i = 0; i < arena->ctl.pool_cnt; ++i) {
+        tos_mmheap_pool_check(arena->ctl.pool_start[i], &pool_info);
+        info->free += pool_info.free;
+    }
+
+    MMHEAP_ARENA_UNLOCK();
+
+    return K_ERR_NONE;
+}
+
+__KNL__ void mmheap_arena_unbind(k_task_t *task)
+{
+    if (task->mmheap_arena) {
+        --task->mmheap_arena->task_cnt;
+        task->mmheap_arena = K_NULL;
+    }
+}
+
+#endif
+
 #endif
 
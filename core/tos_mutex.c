@@ -31,10 +31,10 @@ __STATIC_INLINE__ void mutex_old_owner_release(k_mutex_t *mutex)
 
     // the right time comes! let's do it!
     if (owner->prio_pending != K_TASK_PRIO_INVALID) {
-        tos_task_prio_change(owner, owner->prio_pending);
+        task_prio_change(owner, owner->prio_pending);
         owner->prio_pending = K_TASK_PRIO_INVALID;
     } else if (owner->prio != mutex->owner_orig_prio) {
-        tos_task_prio_change(owner, mutex->owner_orig_prio);
+        task_prio_change(owner, mutex->owner_orig_prio);
         mutex->owner_orig_prio = K_TASK_PRIO_INVALID;
     }
 }
@@ -57,7 +57,7 @@ __STATIC_INLINE__ void mutex_new_owner_mark(k_mutex_t *mutex, k_task_t *task)
     // we own the mutex now, make sure our priority is higher than any one in the pend list.
     highest_pending_prio = pend_highest_pending_prio_get(&mutex->pend_obj);
     if (task->prio > highest_pending_prio) {
-        tos_task_prio_change(task, highest_pending_prio);
+        task_prio_change(task, highest_pending_prio);
     }
 }
 
@@ -125,6 +125,14 @@ __API__ k_err_t tos_mutex_destroy(k_mutex_t *mutex)
 
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 
+__STATIC__ void mutex_obj_ctor(void *obj)
+{
+    k_mutex_t *mutex = (k_mutex_t *)obj;
+
+    pend_object_init(&mutex->pend_obj);
+    knl_object_alloc_set_dynamic(&mutex->knl_obj);
+}
+
 __API__ k_err_t tos_mutex_create_dyn(k_mutex_t **mutex)
 {
     k_mutex_t *the_mutex;
@@ -132,20 +140,17 @@ __API__ k_err_t tos_mutex_create_dyn(k_mutex_t **mutex)
     TOS_IN_IRQ_CHECK();
     TOS_PTR_SANITY_CHECK(mutex);
 
-    the_mutex = tos_mmheap_calloc(1, sizeof(k_mutex_t));
+    the_mutex = slab_obj_alloc(KNL_OBJ_TYPE_MUTEX, sizeof(k_mutex_t), mutex_obj_ctor);
     if (!the_mutex) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
-    pend_object_init(&the_mutex->pend_obj);
     the_mutex->pend_nesting     = (k_nesting_t)0u;
     the_mutex->owner            = K_NULL;
     the_mutex->owner_orig_prio  = K_TASK_PRIO_INVALID;
     tos_list_init(&the_mutex->owner_anchor);
     TOS_OBJ_INIT(the_mutex, KNL_OBJ_TYPE_MUTEX);
 
-    knl_object_alloc_set_dynamic(&the_mutex->knl_obj);
-
     *mutex = the_mutex;
 
     return K_ERR_NONE;
@@ -175,7 +180,7 @@ __API__ k_err_t tos_mutex_destroy_dyn(k_mutex_t *mutex)
 
     TOS_OBJ_DEINIT(mutex);
 
-    tos_mmheap_free(mutex);
+    slab_obj_free(KNL_OBJ_TYPE_MUTEX, mutex);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -185,7 +190,7 @@ __API__ k_err_t tos_mutex_destroy_dyn(k_mutex_t *mutex)
 
 #endif
 
-__API__ k_err_t tos_mutex_pend_timed(k_mutex_t *mutex, k_tick_t timeout)
+__STATIC__ k_err_t mutex_do_pend(k_mutex_t *mutex, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
 
@@ -224,10 +229,10 @@ __API__ k_err_t tos_mutex_pend_timed(k_mutex_t *mutex, k_tick_t timeout)
         // PRIORITY INVERSION:
         // we are declaring a mutex, which's owner has a lower(numerically bigger) priority.
         // make owner the same priority with us.
-        tos_task_prio_change(mutex->owner, k_curr_task->prio);
+        task_prio_change(mutex->owner, k_curr_task->prio);
     }
 
-    pend_task_block(k_curr_task, &mutex->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &mutex->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -235,6 +240,20 @@ __API__ k_err_t tos_mutex_pend_timed(k_mutex_t *mutex, k_tick_t timeout)
     return pend_state2errno(k_curr_task->pend_state);
 }
 
+__API__ k_err_t tos_mutex_pend_timed(k_mutex_t *mutex, k_tick_t timeout)
+{
+    return mutex_do_pend(mutex, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_mutex_pend_ns(k_mutex_t *mutex, k_hrtime_t ns)
+{
+    return mutex_do_pend(mutex, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __API__ k_err_t tos_mutex_pend(k_mutex_t *mutex)
 {
     return tos_mutex_pend_timed(mutex, TOS_TIME_FOREVER);
@@ -250,6 +269,8 @@ __API__ k_err_t tos_mutex_post(k_mutex_t *mutex)
     TOS_OBJ_VERIFY(mutex, KNL_OBJ_TYPE_MUTEX);
 
     TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, &mutex->pend_obj, 0u, OPT_POST_ONE);
     if (!knl_is_self(mutex->owner)) {
         TOS_CPU_INT_ENABLE();
         return K_ERR_MUTEX_NOT_OWNER;
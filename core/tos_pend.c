@@ -17,6 +17,91 @@
 
 #include "tos_k.h"
 
+#if TOS_CFG_PEND_PRIO_BITMAP_EN > 0u
+
+/**
+ * the highest priority pending which is lower(numerically greater) than prio,
+ * K_TASK_PRIO_INVALID if there is none.
+ */
+__STATIC__ k_prio_t pend_prio_next_get(pend_obj_t *object, k_prio_t prio)
+{
+    uint32_t ndx, mask, group;
+
+    ndx = K_PRIO_NDX(prio);
+
+    // the bits after prio's in the same slot(MSB first)
+    mask = object->prio_mask[ndx] & (K_PRIO_BIT(prio) - 1u);
+    if (mask != 0u) {
+        return (k_prio_t)(ndx * K_PRIO_TBL_SLOT_SIZE + tos_cpu_clz(mask));
+    }
+
+    group = object->prio_group & (K_PRIO_GRP_BIT(ndx) - 1u);
+    if (group == 0u) {
+        return K_TASK_PRIO_INVALID;
+    }
+
+    ndx = tos_cpu_clz(group);
+    return (k_prio_t)(ndx * K_PRIO_TBL_SLOT_SIZE + tos_cpu_clz(object->prio_mask[ndx]));
+}
+
+__STATIC__ void pend_list_add(k_task_t *task, pend_obj_t *object)
+{
+    k_prio_t prio, prio_next;
+
+    prio = task->prio;
+
+    /* keep priority in descending order, the boss(task with highest priority,
+       numerically smallest) always comes first, we go right before the first
+       task of the next lower priority(or to the tail if there is none).
+    */
+    prio_next = pend_prio_next_get(object, prio);
+    if (prio_next == K_TASK_PRIO_INVALID) {
+        tos_list_add_tail(&task->pend_list, &object->list);
+    } else {
+        tos_list_add_tail(&task->pend_list, &object->prio_first[prio_next]->pend_list);
+    }
+
+    if (!(object->prio_mask[K_PRIO_NDX(prio)] & K_PRIO_BIT(prio))) {
+        object->prio_first[prio] = task;
+        object->prio_mask[K_PRIO_NDX(prio)] |= K_PRIO_BIT(prio);
+        object->prio_group |= K_PRIO_GRP_BIT(K_PRIO_NDX(prio));
+    }
+
+    // remember me, you may use me someday
+    task->pending_obj = object;
+    task_state_set_pend(task);
+}
+
+__STATIC__ void pend_list_del(k_task_t *task)
+{
+    k_prio_t prio;
+    uint32_t ndx;
+    k_task_t *next;
+    pend_obj_t *object;
+
+    object  = task->pending_obj;
+    prio    = task->prio;
+
+    if (object->prio_first[prio] == task) {
+        next = TOS_LIST_FIRST_ENTRY(&task->pend_list, k_task_t, pend_list);
+
+        if (task->pend_list.next != &object->list && next->prio == prio) {
+            object->prio_first[prio] = next;
+        } else {
+            // we are the last one of the priority
+            ndx = K_PRIO_NDX(prio);
+            object->prio_mask[ndx] &= ~K_PRIO_BIT(prio);
+            if (object->prio_mask[ndx] == 0u) {
+                object->prio_group &= ~K_PRIO_GRP_BIT(ndx);
+            }
+        }
+    }
+
+    tos_list_del(&task->pend_list);
+}
+
+#else
+
 __STATIC__ void pend_list_add(k_task_t *task, pend_obj_t *pend_obj)
 {
     k_task_t *iter;
@@ -36,6 +121,13 @@ __STATIC__ void pend_list_add(k_task_t *task, pend_obj_t *pend_obj)
     task_state_set_pend(task);
 }
 
+__STATIC_INLINE__ void pend_list_del(k_task_t *task)
+{
+    tos_list_del(&task->pend_list);
+}
+
+#endif
+
 __KNL__ k_prio_t pend_highest_pending_prio_get(pend_obj_t *object)
 {
     k_task_t *task;
@@ -52,7 +144,18 @@ __KNL__ k_task_t *pend_highest_pending_task_get(pend_obj_t *object)
 
 __KNL__ void pend_list_remove(k_task_t *task)
 {
-    tos_list_del(&task->pend_list);
+    // a task waiting for notification(TOS_CFG_TASK_NOTIFY_EN) pends for nothing
+    if (task->pending_obj) {
+        pend_list_del(task);
+    }
+
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    // however we leave the tos_wait_any(post, timeout, suspend or destroy), leave all the objects
+    if (task->pend_any) {
+        pend_any_detach(task->pend_any);
+        task->pend_any = (pend_any_t *)K_NULL;
+    }
+#endif
 
     task->pending_obj = (pend_obj_t *)K_NULL;
     task_state_reset_pending(task);
@@ -60,12 +163,30 @@ __KNL__ void pend_list_remove(k_task_t *task)
 
 __KNL__ void pend_object_init(pend_obj_t *object)
 {
+#if TOS_CFG_PEND_PRIO_BITMAP_EN > 0u
+    uint32_t i;
+
+    object->prio_group = 0u;
+    for (i = 0; i < K_PRIO_TBL_SIZE; ++i) {
+        object->prio_mask[i] = 0u;
+    }
+#endif
+
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    tos_list_init(&object->any_list);
+    object->is_ready = K_NULL;
+#endif
+
     tos_list_init(&object->list);
 }
 
 __KNL__ void pend_object_deinit(pend_obj_t *object)
 {
-    tos_list_init(&object->list);
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    pend_any_wakeup(object, PEND_STATE_DESTROY);
+#endif
+
+    pend_object_init(object);
 }
 
 __KNL__ int pend_is_nopending(pend_obj_t *object)
@@ -73,10 +194,17 @@ __KNL__ int pend_is_nopending(pend_obj_t *object)
     return tos_list_empty(&object->list);
 }
 
-__KNL__ void pend_list_adjust(k_task_t *task)
+__KNL__ void pend_list_adjust(k_task_t *task, k_prio_t prio_new)
 {
     // we may be the boss, so re-enter the pend list
-    tos_list_del(&task->pend_list);
+    pend_list_del(task);
+
+    /* ATTENTION:
+        must do the prio assignment after pend_list_del, the task leaves the
+        priority it was added with.
+     */
+    task->prio = prio_new;
+
     // the "someday" comes
     pend_list_add(task, task->pending_obj);
 }
@@ -98,6 +226,8 @@ __KNL__ k_err_t pend_state2errno(pend_state_t state)
 
 __KNL__ void pend_task_wakeup(k_task_t *task, pend_state_t state)
 {
+    TOS_TRACE(K_TRACE_EVENT_WAKEUP, task->pending_obj, task, state);
+
     if (task_state_is_pending(task)) {
         // mark why we wakeup
         task->pend_state = state;
@@ -112,6 +242,12 @@ __KNL__ void pend_task_wakeup(k_task_t *task, pend_state_t state)
         return;
     }
 
+#if TOS_CFG_EDF_EN > 0u
+    if (task_is_edf(task)) {
+        edf_task_wakeup(task);
+    }
+#endif
+
     readyqueue_add(task);
 }
 
@@ -121,12 +257,43 @@ __KNL__ void pend_task_block(k_task_t *task, pend_obj_t *object, k_tick_t timeou
 
     task->pend_state = PEND_STATE_NONE;
     pend_list_add(task, object);
+    TOS_TRACE(K_TRACE_EVENT_PEND, object, task, 0u);
 
     if (timeout != TOS_TIME_FOREVER) {
         tick_list_add(task, timeout);
     }
 }
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__KNL__ void pend_task_block_ns(k_task_t *task, pend_obj_t *object, k_hrtime_t ns)
+{
+    readyqueue_remove(task);
+
+    task->pend_state = PEND_STATE_NONE;
+    pend_list_add(task, object);
+    TOS_TRACE(K_TRACE_EVENT_PEND, object, task, 0u);
+
+    hrtimer_task_sleep(task, ns);
+}
+
+#endif
+
+/* block on a tick timeout, or on a nanosecond one(hrtimer) if ns is not 0 */
+__KNL__ void pend_task_block_timed(k_task_t *task, pend_obj_t *object, k_tick_t timeout, k_hrtime_t ns)
+{
+#if TOS_CFG_HRTIMER_EN > 0u
+    if (ns > (k_hrtime_t)0u) {
+        pend_task_block_ns(task, object, ns);
+        return;
+    }
+#else
+    ns = ns; // make compiler happy
+#endif
+
+    pend_task_block(task, object, timeout);
+}
+
 __KNL__ void pend_wakeup_one(pend_obj_t *object, pend_state_t state)
 {
     pend_task_wakeup(TOS_LIST_FIRST_ENTRY(&object->list, k_task_t, pend_list), state);
@@ -150,3 +317,101 @@ __KNL__ void pend_wakeup(pend_obj_t *object, pend_state_t state, opt_post_t opt)
     }
 }
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+/**
+ * the object gets ready(or is destroyed), wakeup all the tos_wait_any callers waiting for it.
+ * return whether anyone is woken up.
+ */
+__KNL__ int pend_any_wakeup(pend_obj_t *object, pend_state_t state)
+{
+    pend_any_t *any;
+    pend_any_node_t *node;
+    int is_woken = K_FALSE;
+
+    // a caller woken up leaves all the objects(pend_list_remove), so the list gets shorter every round
+    while (!tos_list_empty(&object->any_list)) {
+        node    = TOS_LIST_FIRST_ENTRY(&object->any_list, pend_any_node_t, list);
+        any     = node->any;
+
+        any->ready = (uint32_t)(node - &any->node[0]);
+        pend_wakeup_all(&any->pend_obj, state);
+
+        is_woken = K_TRUE;
+    }
+
+    return is_woken;
+}
+
+__KNL__ void pend_any_detach(pend_any_t *any)
+{
+    uint32_t i;
+
+    for (i = 0; i < any->count; ++i) {
+        tos_list_del(&any->node[i].list);
+    }
+}
+
+__API__ k_err_t tos_wait_any(pend_obj_t *objects[], uint32_t count, k_tick_t timeout, uint32_t *ready)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t i;
+    pend_any_t any;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(objects);
+    TOS_PTR_SANITY_CHECK(ready);
+
+    if (unlikely(count == 0u || count > TOS_CFG_WAIT_ANY_OBJ_MAX)) {
+        return K_ERR_PEND_ANY_COUNT_INVALID;
+    }
+
+    for (i = 0; i < count; ++i) {
+        TOS_PTR_SANITY_CHECK(objects[i]);
+
+        if (!objects[i]->is_ready) {
+            return K_ERR_PEND_ANY_NOT_SUPPORTED;
+        }
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    for (i = 0; i < count; ++i) {
+        if (objects[i]->is_ready(objects[i])) {
+            TOS_CPU_INT_ENABLE();
+            *ready = i;
+            return K_ERR_NONE;
+        }
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) { // no wait, return immediately
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    // we pend for a pend object of our own, every object waited for has a node linking to it
+    pend_object_init(&any.pend_obj);
+    any.count = count;
+    any.ready = count;
+
+    for (i = 0; i < count; ++i) {
+        any.node[i].any = &any;
+        tos_list_add_tail(&any.node[i].list, &objects[i]->any_list);
+    }
+    k_curr_task->pend_any = &any;
+
+    pend_task_block(k_curr_task, &any.pend_obj, timeout);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    *ready = any.ready;
+    return pend_state2errno(k_curr_task->pend_state);
+}
+
+#endif
@@ -26,14 +26,14 @@ __API__ k_err_t tos_prio_mail_q_create(k_prio_mail_q_t *prio_mail_q, void *pool,
 
     TOS_PTR_SANITY_CHECK(prio_mail_q);
 
-    prio_q_mgr_array = tos_mmheap_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(mail_cnt));
+    prio_q_mgr_array = mmheap_shared_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(mail_cnt));
     if (!prio_q_mgr_array) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
     err = tos_prio_q_create(&prio_mail_q->prio_q, prio_q_mgr_array, pool, mail_cnt, mail_size);
     if (err != K_ERR_NONE) {
-        tos_mmheap_free(prio_q_mgr_array);
+        mmheap_shared_free(prio_q_mgr_array);
         return err;
     }
 
@@ -68,7 +68,7 @@ __API__ k_err_t tos_prio_mail_q_destroy(k_prio_mail_q_t *prio_mail_q)
 
     pend_wakeup_all(&prio_mail_q->pend_obj, PEND_STATE_DESTROY);
 
-    tos_mmheap_free(prio_mail_q->prio_q_mgr_array);
+    mmheap_shared_free(prio_mail_q->prio_q_mgr_array);
     prio_mail_q->prio_q_mgr_array = K_NULL;
 
     pend_object_deinit(&prio_mail_q->pend_obj);
@@ -142,7 +142,7 @@ __API__ k_err_t tos_prio_mail_q_flush(k_prio_mail_q_t *prio_mail_q)
     return tos_prio_q_flush(&prio_mail_q->prio_q);
 }
 
-__API__ k_err_t tos_prio_mail_q_pend(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout)
+__STATIC__ k_err_t prio_mail_q_do_pend(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
     k_err_t err;
@@ -171,7 +171,7 @@ __API__ k_err_t tos_prio_mail_q_pend(k_prio_mail_q_t *prio_mail_q, void *mail_bu
     }
 
     k_curr_task->mail = mail_buf;
-    pend_task_block(k_curr_task, &prio_mail_q->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &prio_mail_q->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -186,6 +186,20 @@ __API__ k_err_t tos_prio_mail_q_pend(k_prio_mail_q_t *prio_mail_q, void *mail_bu
     return err;
 }
 
+__API__ k_err_t tos_prio_mail_q_pend(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_tick_t timeout)
+{
+    return prio_mail_q_do_pend(prio_mail_q, mail_buf, mail_size, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_prio_mail_q_pend_ns(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t *mail_size, k_hrtime_t ns)
+{
+    return prio_mail_q_do_pend(prio_mail_q, mail_buf, mail_size, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __STATIC__ void prio_mail_task_recv(k_task_t *task, void *mail_buf, size_t mail_size)
 {
     memcpy(task->mail, mail_buf, mail_size);
@@ -205,6 +219,8 @@ __STATIC__ k_err_t prio_mail_q_do_post(k_prio_mail_q_t *prio_mail_q, void *mail_
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &prio_mail_q->pend_obj, mail_buf, opt);
+
     if (pend_is_nopending(&prio_mail_q->pend_obj)) {
         err = tos_prio_q_enqueue(&prio_mail_q->prio_q, mail_buf, mail_size, prio);
         if (err != K_ERR_NONE) {
@@ -240,5 +256,125 @@ __API__ k_err_t tos_prio_mail_q_post_all(k_prio_mail_q_t *prio_mail_q, void *mai
     return prio_mail_q_do_post(prio_mail_q, mail_buf, mail_size, prio, OPT_POST_ALL);
 }
 
+__API__ k_err_t tos_prio_mail_q_post_n(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t mail_cnt, size_t mail_size, k_prio_t prio, size_t *mail_sent)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t cnt = 0u;
+    int is_woken = K_FALSE;
+    k_task_t *task, *tmp;
+    uint8_t *mail = (uint8_t *)mail_buf;
+
+    TOS_PTR_SANITY_CHECK(prio_mail_q);
+    TOS_PTR_SANITY_CHECK(mail_buf);
+    TOS_PTR_SANITY_CHECK(mail_sent);
+    TOS_OBJ_VERIFY(prio_mail_q, KNL_OBJ_TYPE_PRIORITY_MAIL_QUEUE);
+
+    if (mail_size != prio_mail_q->prio_q.item_size) {
+        return K_ERR_PRIO_Q_ITEM_SIZE_NOT_MATCH;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, &prio_mail_q->pend_obj, mail_cnt, OPT_POST_ONE);
+
+    /* the queue is empty while anyone is pending, the first mails go straight to the pending
+       tasks, one each, in the order they wait */
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, pend_list, &prio_mail_q->pend_obj.list) {
+        if (cnt == mail_cnt) {
+            break;
+        }
+        prio_mail_task_recv(task, &mail[cnt * mail_size], mail_size);
+        ++cnt;
+        is_woken = K_TRUE;
+    }
+
+    while (cnt < mail_cnt &&
+            tos_prio_q_enqueue(&prio_mail_q->prio_q, &mail[cnt * mail_size], mail_size, prio) == K_ERR_NONE) {
+        ++cnt;
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    *mail_sent = cnt;
+
+    if (is_woken) {
+        knl_sched();
+    }
+
+    return cnt == 0u && mail_cnt > 0u ? K_ERR_PRIO_Q_FULL : K_ERR_NONE;
+}
+
+__API__ k_err_t tos_prio_mail_q_pend_n(k_prio_mail_q_t *prio_mail_q, void *mail_buf, size_t mail_cnt, size_t *mail_recv, k_tick_t timeout)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_err_t err;
+    size_t cnt = 0u, mail_size;
+    uint8_t *mail = (uint8_t *)mail_buf;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(prio_mail_q);
+    TOS_PTR_SANITY_CHECK(mail_buf);
+    TOS_PTR_SANITY_CHECK(mail_recv);
+    TOS_OBJ_VERIFY(prio_mail_q, KNL_OBJ_TYPE_PRIORITY_MAIL_QUEUE);
+
+    *mail_recv = 0u;
+    if (mail_cnt == 0u) {
+        return K_ERR_NONE;
+    }
+
+    mail_size = prio_mail_q->prio_q.item_size;
+
+    TOS_CPU_INT_DISABLE();
+
+    while (cnt < mail_cnt &&
+            tos_prio_q_dequeue(&prio_mail_q->prio_q, &mail[cnt * mail_size], K_NULL, K_NULL) == K_ERR_NONE) {
+        ++cnt;
+    }
+
+    if (cnt > 0u) {
+        TOS_CPU_INT_ENABLE();
+        *mail_recv = cnt;
+        return K_ERR_NONE;
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    k_curr_task->mail = mail_buf;
+    pend_task_block(k_curr_task, &prio_mail_q->pend_obj, timeout);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    err = pend_state2errno(k_curr_task->pend_state);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    /* we are woken up with one mail in the first slot, take whatever else is queued meanwhile */
+    k_curr_task->mail       = K_NULL;
+    k_curr_task->mail_size  = 0;
+
+    cnt = 1u;
+
+    TOS_CPU_INT_DISABLE();
+    while (cnt < mail_cnt &&
+            tos_prio_q_dequeue(&prio_mail_q->prio_q, &mail[cnt * mail_size], K_NULL, K_NULL) == K_ERR_NONE) {
+        ++cnt;
+    }
+    TOS_CPU_INT_ENABLE();
+
+    *mail_recv = cnt;
+
+    return K_ERR_NONE;
+}
+
 #endif
 
@@ -26,14 +26,14 @@ __API__ k_err_t tos_prio_msg_q_create(k_prio_msg_q_t *prio_msg_q, void *pool, si
 
     TOS_PTR_SANITY_CHECK(prio_msg_q);
 
-    prio_q_mgr_array = tos_mmheap_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(msg_cnt));
+    prio_q_mgr_array = mmheap_shared_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(msg_cnt));
     if (!prio_q_mgr_array) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
     err = tos_prio_q_create(&prio_msg_q->prio_q, prio_q_mgr_array, pool, msg_cnt, sizeof(void *));
     if (err != K_ERR_NONE) {
-        tos_mmheap_free(prio_q_mgr_array);
+        mmheap_shared_free(prio_q_mgr_array);
         return err;
     }
 
@@ -68,7 +68,7 @@ __API__ k_err_t tos_prio_msg_q_destroy(k_prio_msg_q_t *prio_msg_q)
 
     pend_wakeup_all(&prio_msg_q->pend_obj, PEND_STATE_DESTROY);
 
-    tos_mmheap_free(prio_msg_q->prio_q_mgr_array);
+    mmheap_shared_free(prio_msg_q->prio_q_mgr_array);
     prio_msg_q->prio_q_mgr_array = K_NULL;
 
     pend_object_deinit(&prio_msg_q->pend_obj);
@@ -123,7 +123,7 @@ __API__ k_err_t tos_prio_msg_q_destroy_dyn(k_prio_msg_q_t *prio_msg_q)
 
     pend_wakeup_all(&prio_msg_q->pend_obj, PEND_STATE_DESTROY);
 
-    tos_mmheap_free(prio_msg_q->prio_q_mgr_array);
+    mmheap_shared_free(prio_msg_q->prio_q_mgr_array);
     prio_msg_q->prio_q_mgr_array = K_NULL;
 
     pend_object_deinit(&prio_msg_q->pend_obj);
@@ -145,7 +145,7 @@ __API__ k_err_t tos_prio_msg_q_flush(k_prio_msg_q_t *prio_msg_q)
     return tos_prio_q_flush(&prio_msg_q->prio_q);
 }
 
-__API__ k_err_t tos_prio_msg_q_pend(k_prio_msg_q_t *prio_msg_q, void **msg_ptr, k_tick_t timeout)
+__STATIC__ k_err_t prio_msg_q_do_pend(k_prio_msg_q_t *prio_msg_q, void **msg_ptr, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
     k_err_t err;
@@ -173,7 +173,7 @@ __API__ k_err_t tos_prio_msg_q_pend(k_prio_msg_q_t *prio_msg_q, void **msg_ptr,
         return K_ERR_PEND_SCHED_LOCKED;
     }
 
-    pend_task_block(k_curr_task, &prio_msg_q->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &prio_msg_q->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -187,6 +187,20 @@ __API__ k_err_t tos_prio_msg_q_pend(k_prio_msg_q_t *prio_msg_q, void **msg_ptr,
     return err;
 }
 
+__API__ k_err_t tos_prio_msg_q_pend(k_prio_msg_q_t *prio_msg_q, void **msg_ptr, k_tick_t timeout)
+{
+    return prio_msg_q_do_pend(prio_msg_q, msg_ptr, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_prio_msg_q_pend_ns(k_prio_msg_q_t *prio_msg_q, void **msg_ptr, k_hrtime_t ns)
+{
+    return prio_msg_q_do_pend(prio_msg_q, msg_ptr, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 __STATIC__ void prio_msg_q_task_recv(k_task_t *task, void *msg_ptr)
 {
     task->msg = msg_ptr;
@@ -204,6 +218,8 @@ __STATIC__ k_err_t prio_msg_q_do_post(k_prio_msg_q_t *prio_msg_q, void *msg_ptr,
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &prio_msg_q->pend_obj, msg_ptr, opt);
+
     if (pend_is_nopending(&prio_msg_q->pend_obj)) {
         err = tos_prio_q_enqueue(&prio_msg_q->prio_q, &msg_ptr, sizeof(void *), prio);
         if (err != K_ERR_NONE) {
@@ -238,5 +254,115 @@ __API__ k_err_t tos_prio_msg_q_post_all(k_prio_msg_q_t *prio_msg_q, void *msg_pt
     return prio_msg_q_do_post(prio_msg_q, msg_ptr, prio, OPT_POST_ALL);
 }
 
+__API__ k_err_t tos_prio_msg_q_post_n(k_prio_msg_q_t *prio_msg_q, void *msg_ptr[], size_t msg_cnt, k_prio_t prio, size_t *msg_sent)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t cnt = 0u;
+    int is_woken = K_FALSE;
+    k_task_t *task, *tmp;
+
+    TOS_PTR_SANITY_CHECK(prio_msg_q);
+    TOS_PTR_SANITY_CHECK(msg_ptr);
+    TOS_PTR_SANITY_CHECK(msg_sent);
+    TOS_OBJ_VERIFY(prio_msg_q, KNL_OBJ_TYPE_PRIORITY_MESSAGE_QUEUE);
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, &prio_msg_q->pend_obj, msg_cnt, OPT_POST_ONE);
+
+    /* the queue is empty while anyone is pending, the first messages go straight to the pending
+       tasks, one each, in the order they wait */
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, pend_list, &prio_msg_q->pend_obj.list) {
+        if (cnt == msg_cnt) {
+            break;
+        }
+        prio_msg_q_task_recv(task, msg_ptr[cnt++]);
+        is_woken = K_TRUE;
+    }
+
+    while (cnt < msg_cnt &&
+            tos_prio_q_enqueue(&prio_msg_q->prio_q, &msg_ptr[cnt], sizeof(void *), prio) == K_ERR_NONE) {
+        ++cnt;
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    *msg_sent = cnt;
+
+    if (is_woken) {
+        knl_sched();
+    }
+
+    return cnt == 0u && msg_cnt > 0u ? K_ERR_PRIO_Q_FULL : K_ERR_NONE;
+}
+
+__API__ k_err_t tos_prio_msg_q_pend_n(k_prio_msg_q_t *prio_msg_q, void *msg_ptr[], size_t msg_cnt, size_t *msg_recv, k_tick_t timeout)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_err_t err;
+    size_t cnt = 0u;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(prio_msg_q);
+    TOS_PTR_SANITY_CHECK(msg_ptr);
+    TOS_PTR_SANITY_CHECK(msg_recv);
+    TOS_OBJ_VERIFY(prio_msg_q, KNL_OBJ_TYPE_PRIORITY_MESSAGE_QUEUE);
+
+    *msg_recv = 0u;
+    if (msg_cnt == 0u) {
+        return K_ERR_NONE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    while (cnt < msg_cnt &&
+            tos_prio_q_dequeue(&prio_msg_q->prio_q, &msg_ptr[cnt], K_NULL, K_NULL) == K_ERR_NONE) {
+        ++cnt;
+    }
+
+    if (cnt > 0u) {
+        TOS_CPU_INT_ENABLE();
+        *msg_recv = cnt;
+        return K_ERR_NONE;
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    pend_task_block(k_curr_task, &prio_msg_q->pend_obj, timeout);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    err = pend_state2errno(k_curr_task->pend_state);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    /* we are woken up with one message, take whatever else is queued meanwhile */
+    msg_ptr[0]          = k_curr_task->msg;
+    k_curr_task->msg    = K_NULL;
+
+    cnt = 1u;
+
+    TOS_CPU_INT_DISABLE();
+    while (cnt < msg_cnt &&
+            tos_prio_q_dequeue(&prio_msg_q->prio_q, &msg_ptr[cnt], K_NULL, K_NULL) == K_ERR_NONE) {
+        ++cnt;
+    }
+    TOS_CPU_INT_ENABLE();
+
+    *msg_recv = cnt;
+
+    return K_ERR_NONE;
+}
+
 #endif
 
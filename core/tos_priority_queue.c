@@ -216,21 +216,21 @@ __API__ k_err_t tos_prio_q_create_dyn(k_prio_q_t *prio_q, size_t item_cnt, size_
 
     TOS_PTR_SANITY_CHECK(prio_q);
 
-    mgr_pool = tos_mmheap_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(item_cnt));
+    mgr_pool = mmheap_shared_alloc(TOS_PRIO_Q_MGR_ARRAY_SIZE(item_cnt));
     if (!mgr_pool) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
-    data_pool = tos_mmheap_alloc(item_cnt * item_size);
+    data_pool = mmheap_shared_alloc(item_cnt * item_size);
     if (!data_pool) {
-        tos_mmheap_free(mgr_pool);
+        mmheap_shared_free(mgr_pool);
         return K_ERR_OUT_OF_MEMORY;
     }
 
     err = tos_prio_q_create(prio_q, mgr_pool, data_pool, item_cnt, item_size);
     if (err != K_ERR_NONE) {
-        tos_mmheap_free(data_pool);
-        tos_mmheap_free(mgr_pool);
+        mmheap_shared_free(data_pool);
+        mmheap_shared_free(mgr_pool);
     }
 
     knl_object_alloc_set_dynamic(&prio_q->knl_obj);
@@ -250,8 +250,8 @@ __API__ k_err_t tos_prio_q_destroy_dyn(k_prio_q_t *prio_q)
     prio_q_pool_mgr_deinit(&prio_q->pool_mgr);
     prio_q_prio_mgr_deinit(&prio_q->prio_mgr);
 
-    tos_mmheap_free(prio_q->mgr_pool);
-    tos_mmheap_free(prio_q->data_pool);
+    mmheap_shared_free(prio_q->mgr_pool);
+    mmheap_shared_free(prio_q->data_pool);
 
     prio_q->total       = 0;
     prio_q->item_size   = 0;
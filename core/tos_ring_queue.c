@@ -42,6 +42,83 @@ __STATIC_INLINE__ void ring_q_item_decrease(k_ring_q_t *ring_q)
     --ring_q->total;
 }
 
+__STATIC__ void ring_q_span_fill(k_ring_q_t *ring_q, size_t index, size_t item_cnt, k_ring_q_span_t *span)
+{
+    size_t cnt = ring_q->item_cnt - index;
+
+    if (cnt > item_cnt) {
+        cnt = item_cnt;
+    }
+
+    span->item[0]   = &ring_q->pool[index * ring_q->item_size];
+    span->cnt[0]    = cnt;
+    span->item[1]   = cnt < item_cnt ? ring_q->pool : K_NULL;
+    span->cnt[1]    = item_cnt - cnt;
+}
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+
+__STATIC_INLINE__ int ring_q_is_spsc(k_ring_q_t *ring_q)
+{
+    return ring_q->mode == RING_Q_MODE_SPSC;
+}
+
+__STATIC_INLINE__ void ring_q_mode_set(k_ring_q_t *ring_q, ring_q_mode_t mode, size_t mask)
+{
+    ring_q->mode        = mode;
+    ring_q->mask        = mask;
+    ring_q->spsc_head   = 0u;
+    ring_q->spsc_tail   = 0u;
+}
+
+__STATIC_INLINE__ cpu_data_t ring_q_spsc_cnt(k_ring_q_t *ring_q)
+{
+    return (cpu_data_t)(ring_q->spsc_tail - ring_q->spsc_head);
+}
+
+__STATIC__ k_err_t ring_q_spsc_enqueue(k_ring_q_t *ring_q, void *item)
+{
+    cpu_data_t tail = ring_q->spsc_tail;
+
+    if ((cpu_data_t)(tail - ring_q->spsc_head) == ring_q->item_cnt) {
+        return K_ERR_RING_Q_FULL;
+    }
+
+    /* the consumer must be done reading the slot before we overwrite it */
+    __MEMORY_BARRIER__();
+    memcpy(RING_SPSC_ITEM(ring_q, tail), item, ring_q->item_size);
+
+    /* the item must be in the slot before the consumer sees the new tail */
+    __MEMORY_BARRIER__();
+    ring_q->spsc_tail = tail + 1u;
+
+    return K_ERR_NONE;
+}
+
+__STATIC__ k_err_t ring_q_spsc_dequeue(k_ring_q_t *ring_q, void *item, size_t *item_size)
+{
+    cpu_data_t head = ring_q->spsc_head;
+
+    if (ring_q->spsc_tail == head) {
+        return K_ERR_RING_Q_EMPTY;
+    }
+
+    /* the slot must not be read before the tail that published it */
+    __MEMORY_BARRIER__();
+    memcpy(item, RING_SPSC_ITEM(ring_q, head), ring_q->item_size);
+    if (item_size) {
+        *item_size = ring_q->item_size;
+    }
+
+    /* the slot must be read before the producer sees it free */
+    __MEMORY_BARRIER__();
+    ring_q->spsc_head = head + 1u;
+
+    return K_ERR_NONE;
+}
+
+#endif
+
  __API__ k_err_t tos_ring_q_create(k_ring_q_t *ring_q, void *pool, size_t item_cnt, size_t item_size)
 {
     TOS_PTR_SANITY_CHECK(ring_q);
@@ -55,12 +132,38 @@ __STATIC_INLINE__ void ring_q_item_decrease(k_ring_q_t *ring_q)
     ring_q->item_size   = item_size;
     ring_q->item_cnt    = item_cnt;
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    ring_q_mode_set(ring_q, RING_Q_MODE_LOCKED, 0u);
+#endif
+
     TOS_OBJ_INIT(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
     knl_object_alloc_set_static(&ring_q->knl_obj);
 
     return K_ERR_NONE;
 }
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+
+__API__ k_err_t tos_ring_q_create_spsc(k_ring_q_t *ring_q, void *pool, size_t item_cnt, size_t item_size)
+{
+    k_err_t err;
+
+    if (item_cnt == 0u || (item_cnt & (item_cnt - 1u)) != 0u || item_cnt > RING_SPSC_CNT_MAX) {
+        return K_ERR_RING_Q_ITEM_CNT_INVALID;
+    }
+
+    err = tos_ring_q_create(ring_q, pool, item_cnt, item_size);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    ring_q_mode_set(ring_q, RING_Q_MODE_SPSC, item_cnt - 1u);
+
+    return K_ERR_NONE;
+}
+
+#endif
+
 __API__ k_err_t tos_ring_q_destroy(k_ring_q_t *ring_q)
 {
     TOS_PTR_SANITY_CHECK(ring_q);
@@ -78,6 +181,10 @@ __API__ k_err_t tos_ring_q_destroy(k_ring_q_t *ring_q)
     ring_q->item_size   = 0u;
     ring_q->item_cnt    = 0u;
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    ring_q_mode_set(ring_q, RING_Q_MODE_LOCKED, 0u);
+#endif
+
     TOS_OBJ_DEINIT(ring_q);
     knl_object_alloc_reset(&ring_q->knl_obj);
 
@@ -90,7 +197,7 @@ __API__ k_err_t tos_ring_q_destroy(k_ring_q_t *ring_q)
 
     TOS_PTR_SANITY_CHECK(ring_q);
 
-    pool = tos_mmheap_alloc(item_cnt * item_size);
+    pool = mmheap_shared_alloc(item_cnt * item_size);
     if (!pool) {
         return K_ERR_OUT_OF_MEMORY;
     }
@@ -103,6 +210,10 @@ __API__ k_err_t tos_ring_q_destroy(k_ring_q_t *ring_q)
     ring_q->item_size   = item_size;
     ring_q->item_cnt    = item_cnt;
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    ring_q_mode_set(ring_q, RING_Q_MODE_LOCKED, 0u);
+#endif
+
     TOS_OBJ_INIT(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
     knl_object_alloc_set_dynamic(&ring_q->knl_obj);
 
@@ -118,7 +229,7 @@ __API__ k_err_t tos_ring_q_destroy_dyn(k_ring_q_t *ring_q)
         return K_ERR_OBJ_INVALID_ALLOC_TYPE;
     }
 
-    tos_mmheap_free(ring_q->pool);
+    mmheap_shared_free(ring_q->pool);
 
     ring_q->head        = 0u;
     ring_q->tail        = 0u;
@@ -128,6 +239,10 @@ __API__ k_err_t tos_ring_q_destroy_dyn(k_ring_q_t *ring_q)
     ring_q->item_size   = 0u;
     ring_q->item_cnt    = 0u;
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    ring_q_mode_set(ring_q, RING_Q_MODE_LOCKED, 0u);
+#endif
+
     TOS_OBJ_DEINIT(ring_q);
     knl_object_alloc_reset(&ring_q->knl_obj);
 
@@ -146,6 +261,12 @@ __API__ k_err_t tos_ring_q_enqueue(k_ring_q_t *ring_q, void *item, size_t item_s
         return K_ERR_RING_Q_ITEM_SIZE_NOT_MATCH;
     }
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        return ring_q_spsc_enqueue(ring_q, item);
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
 
     if (tos_ring_q_is_full(ring_q)) {
@@ -168,6 +289,12 @@ __API__ k_err_t tos_ring_q_dequeue(k_ring_q_t *ring_q, void *item, size_t *item_
     TOS_PTR_SANITY_CHECK(item);
     TOS_OBJ_VERIFY(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        return ring_q_spsc_dequeue(ring_q, item, item_size);
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
 
     if (tos_ring_q_is_empty(ring_q)) {
@@ -190,6 +317,14 @@ __API__ k_err_t tos_ring_q_flush(k_ring_q_t *ring_q)
     TOS_PTR_SANITY_CHECK(ring_q);
     TOS_OBJ_VERIFY(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        /* only the consumer flushes, it drops everything published so far */
+        ring_q->spsc_head = ring_q->spsc_tail;
+        return K_ERR_NONE;
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
 
     ring_q->head    = 0u;
@@ -209,6 +344,12 @@ __API__ int tos_ring_q_is_empty(k_ring_q_t *ring_q)
     TOS_PTR_SANITY_CHECK_RC(ring_q, K_FALSE);
     TOS_OBJ_VERIFY_RC(ring_q, KNL_OBJ_TYPE_RING_QUEUE, K_FALSE);
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        return ring_q_spsc_cnt(ring_q) == 0u ? K_TRUE : K_FALSE;
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
     is_empty = (ring_q->total == 0 ? K_TRUE : K_FALSE);
     TOS_CPU_INT_ENABLE();
@@ -216,6 +357,142 @@ __API__ int tos_ring_q_is_empty(k_ring_q_t *ring_q)
     return is_empty;
 }
 
+__API__ size_t tos_ring_q_reserve(k_ring_q_t *ring_q, size_t item_cnt, k_ring_q_span_t *span)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t index, room;
+
+    TOS_PTR_SANITY_CHECK_RC(ring_q, 0u);
+    TOS_PTR_SANITY_CHECK_RC(span, 0u);
+    TOS_OBJ_VERIFY_RC(ring_q, KNL_OBJ_TYPE_RING_QUEUE, 0u);
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        index   = ring_q->spsc_tail & ring_q->mask;
+        room    = ring_q->item_cnt - ring_q_spsc_cnt(ring_q);
+
+        /* the consumer must be done reading the slots before the caller overwrites them */
+        __MEMORY_BARRIER__();
+
+        room = room < item_cnt ? room : item_cnt;
+        ring_q_span_fill(ring_q, index, room, span);
+        return room;
+    }
+#endif
+
+    TOS_CPU_INT_DISABLE();
+    index   = ring_q->tail;
+    room    = ring_q->item_cnt - ring_q->total;
+    TOS_CPU_INT_ENABLE();
+
+    room = room < item_cnt ? room : item_cnt;
+    ring_q_span_fill(ring_q, index, room, span);
+    return room;
+}
+
+__API__ k_err_t tos_ring_q_commit(k_ring_q_t *ring_q, size_t item_cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(ring_q);
+    TOS_OBJ_VERIFY(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        if (item_cnt > ring_q->item_cnt - ring_q_spsc_cnt(ring_q)) {
+            return K_ERR_RING_Q_ITEM_CNT_INVALID;
+        }
+
+        /* the items must be in the slots before the consumer sees the new tail */
+        __MEMORY_BARRIER__();
+        ring_q->spsc_tail += item_cnt;
+        return K_ERR_NONE;
+    }
+#endif
+
+    TOS_CPU_INT_DISABLE();
+
+    if (item_cnt > ring_q->item_cnt - ring_q->total) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_RING_Q_ITEM_CNT_INVALID;
+    }
+
+    ring_q->tail    = (ring_q->tail + item_cnt) % ring_q->item_cnt;
+    ring_q->total  += item_cnt;
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ size_t tos_ring_q_peek(k_ring_q_t *ring_q, size_t item_cnt, k_ring_q_span_t *span)
+{
+    TOS_CPU_CPSR_ALLOC();
+    size_t index, used;
+
+    TOS_PTR_SANITY_CHECK_RC(ring_q, 0u);
+    TOS_PTR_SANITY_CHECK_RC(span, 0u);
+    TOS_OBJ_VERIFY_RC(ring_q, KNL_OBJ_TYPE_RING_QUEUE, 0u);
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        index   = ring_q->spsc_head & ring_q->mask;
+        used    = ring_q_spsc_cnt(ring_q);
+
+        /* the slots must not be read before the tail that published them */
+        __MEMORY_BARRIER__();
+
+        used = used < item_cnt ? used : item_cnt;
+        ring_q_span_fill(ring_q, index, used, span);
+        return used;
+    }
+#endif
+
+    TOS_CPU_INT_DISABLE();
+    index   = ring_q->head;
+    used    = ring_q->total;
+    TOS_CPU_INT_ENABLE();
+
+    used = used < item_cnt ? used : item_cnt;
+    ring_q_span_fill(ring_q, index, used, span);
+    return used;
+}
+
+__API__ k_err_t tos_ring_q_release(k_ring_q_t *ring_q, size_t item_cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(ring_q);
+    TOS_OBJ_VERIFY(ring_q, KNL_OBJ_TYPE_RING_QUEUE);
+
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        if (item_cnt > ring_q_spsc_cnt(ring_q)) {
+            return K_ERR_RING_Q_ITEM_CNT_INVALID;
+        }
+
+        /* the slots must be read before the producer sees them free */
+        __MEMORY_BARRIER__();
+        ring_q->spsc_head += item_cnt;
+        return K_ERR_NONE;
+    }
+#endif
+
+    TOS_CPU_INT_DISABLE();
+
+    if (item_cnt > ring_q->total) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_RING_Q_ITEM_CNT_INVALID;
+    }
+
+    ring_q->head    = (ring_q->head + item_cnt) % ring_q->item_cnt;
+    ring_q->total  -= item_cnt;
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
 __API__ int tos_ring_q_is_full(k_ring_q_t *ring_q)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -224,6 +501,12 @@ __API__ int tos_ring_q_is_full(k_ring_q_t *ring_q)
     TOS_PTR_SANITY_CHECK_RC(ring_q, K_FALSE);
     TOS_OBJ_VERIFY_RC(ring_q, KNL_OBJ_TYPE_RING_QUEUE, K_FALSE);
 
+#if TOS_CFG_RING_QUEUE_SPSC_EN > 0u
+    if (ring_q_is_spsc(ring_q)) {
+        return ring_q_spsc_cnt(ring_q) == ring_q->item_cnt ? K_TRUE : K_FALSE;
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
     is_full = (ring_q->total == ring_q->item_cnt ? K_TRUE : K_FALSE);
     TOS_CPU_INT_ENABLE();
@@ -61,6 +61,13 @@ __KNL__ void robin_sched(k_prio_t prio)
     TOS_CPU_CPSR_ALLOC();
     k_task_t *task;
 
+#if TOS_CFG_EDF_EN > 0u
+    if (prio == (k_prio_t)TOS_CFG_EDF_PRIO) {
+        // the EDF band is kept in deadline order, no time slice here
+        return;
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
 
     task = readyqueue_first_task_get(prio);
@@ -17,41 +17,231 @@
 
 #include "tos_k.h"
 
-__STATIC__ k_prio_t readyqueue_prio_highest_get(void)
+#if TOS_CFG_SMP_EN > 0u
+/* a task is in the readyqueue of the cpu it lives on */
+#define READYQUEUE_OF(task)         (&k_cpu[(task)->cpu_id].rdyq)
+#define READYQUEUE_CURR_TASK(task)  (k_cpu[(task)->cpu_id].curr_task)
+#else
+#define READYQUEUE_OF(task)         (&k_rdyq)
+#define READYQUEUE_CURR_TASK(task)  (k_curr_task)
+#endif
+
+/**
+ * two-level lookup: the first clz on prio_group locates the first non-empty
+ * prio_mask slot, the second one locates the priority inside the slot.
+ * the cost does not depend on TOS_CFG_TASK_PRIO_MAX.
+ */
+__STATIC__ k_prio_t readyqueue_prio_highest_get(readyqueue_t *rdyq)
+{
+    uint32_t ndx;
+
+    if (rdyq->prio_group == 0u) {
+        return K_TASK_PRIO_INVALID;
+    }
+
+    ndx = tos_cpu_clz(rdyq->prio_group);
+    return (k_prio_t)(ndx * K_PRIO_TBL_SLOT_SIZE + tos_cpu_clz(rdyq->prio_mask[ndx]));
+}
+
+__STATIC_INLINE__ void readyqueue_prio_insert(readyqueue_t *rdyq, k_prio_t prio)
+{
+    rdyq->prio_mask[K_PRIO_NDX(prio)] |= K_PRIO_BIT(prio);
+    rdyq->prio_group |= K_PRIO_GRP_BIT(K_PRIO_NDX(prio));
+}
+
+__STATIC_INLINE__ void readyqueue_prio_remove(readyqueue_t *rdyq, k_prio_t prio)
+{
+    uint32_t ndx = K_PRIO_NDX(prio);
+
+    rdyq->prio_mask[ndx] &= ~K_PRIO_BIT(prio);
+
+    if (rdyq->prio_mask[ndx] == 0u) {
+        rdyq->prio_group &= ~K_PRIO_GRP_BIT(ndx);
+    }
+}
+
+__STATIC_INLINE__ void readyqueue_prio_mark(readyqueue_t *rdyq, k_prio_t prio)
+{
+    readyqueue_prio_insert(rdyq, prio);
+
+    if (prio < rdyq->highest_prio) {
+        rdyq->highest_prio = prio;
+    }
+}
+
+#if TOS_CFG_EDF_EN > 0u
+
+/* a fixed priority task is in the EDF band only when boosted to it by the priority inheritance of
+   a mutex(no task is created at TOS_CFG_EDF_PRIO but by tos_task_create_edf), it comes first */
+__STATIC_INLINE__ k_tick_t readyqueue_edf_key(k_task_t *task)
 {
-    uint32_t *tbl;
-    k_prio_t prio;
+    return task_is_edf(task) ? task->edf_abs_deadline : (k_tick_t)0u;
+}
+
+/**
+ * keep the task list of the EDF band in absolute deadline order, the earliest one comes first.
+ * is_head decides whether we go before or after the tasks with the same deadline.
+ */
+__STATIC__ void readyqueue_edf_add(k_task_t *task, k_list_t *task_list, int is_head)
+{
+    k_task_t *iter;
+    k_tick_t key, iter_key;
+
+    key = readyqueue_edf_key(task);
+
+    TOS_LIST_FOR_EACH_ENTRY(iter, k_task_t, pend_list, task_list) {
+        iter_key = readyqueue_edf_key(iter);
+        if (key < iter_key || (is_head && key == iter_key)) {
+            break;
+        }
+    }
+    tos_list_add_tail(&task->pend_list, &iter->pend_list);
+}
+
+__STATIC__ void edf_task_replenish(k_task_t *task, k_tick_t release)
+{
+    task->edf_release       = release;
+    task->edf_abs_deadline  = release + task->edf_deadline;
+    task->edf_budget        = task->edf_runtime;
+}
 
-    prio    = 0;
-    tbl     = &k_rdyq.prio_mask[0];
+/**
+ * an EDF task wakes up(from a pend, a delay, a suspend or a throttle), decide the deadline and budget
+ * it runs with. not for a task just moved around in the readyqueue, it keeps what it has.
+ */
+__KNL__ void edf_task_wakeup(k_task_t *task)
+{
+    k_tick_t now, release;
+
+    now = k_tick_count;
+
+    if (task->edf_budget == (k_tick_t)0u) {
+        /* throttled, or the job of the last period is done.
+           move to the next period, skip the periods we have missed(if any).
+         */
+        release = task->edf_release + task->edf_period;
+        if (now > release) {
+            release += ((now - release) / task->edf_period) * task->edf_period;
+        }
+        edf_task_replenish(task, release);
+    } else if (now >= task->edf_abs_deadline ||
+                task->edf_budget * task->edf_deadline > (task->edf_abs_deadline - now) * task->edf_runtime) {
+        /* back from a block(CBS wakeup rule): the budget left cannot be consumed before the deadline
+           without exceeding the bandwidth we reserved, so start a new period right now.
+         */
+        edf_task_replenish(task, now);
+    }
+}
+
+__KNL__ k_err_t edf_bandwidth_reserve(k_tick_t runtime, k_tick_t deadline, uint32_t *density)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t the_density;
+
+    /* density test(sum of runtime / min(deadline, period) <= 1) is a sufficient condition for EDF */
+    the_density = (uint32_t)(((uint64_t)runtime << K_EDF_DENSITY_SHIFT) / deadline);
+
+    TOS_CPU_INT_DISABLE();
 
-    while (*tbl == 0) {
-        prio += K_PRIO_TBL_SLOT_SIZE;
-        ++tbl;
+    if (the_density > K_EDF_DENSITY_MAX - k_edf_density) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_TASK_EDF_OVERLOAD;
     }
-    prio += tos_cpu_clz(*tbl);
-    return prio;
+
+    k_edf_density += the_density;
+
+    TOS_CPU_INT_ENABLE();
+
+    *density = the_density;
+    return K_ERR_NONE;
 }
 
-__STATIC_INLINE__ void readyqueue_prio_insert(k_prio_t prio)
+__KNL__ void edf_bandwidth_release(uint32_t density)
 {
-    k_rdyq.prio_mask[K_PRIO_NDX(prio)] |= K_PRIO_BIT(prio);
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+    k_edf_density -= density;
+    TOS_CPU_INT_ENABLE();
+}
+
+__KNL__ void edf_task_init(k_task_t *task, k_tick_t period, k_tick_t runtime, k_tick_t deadline, uint32_t density)
+{
+    task->edf_period    = period;
+    task->edf_runtime   = runtime;
+    task->edf_deadline  = deadline;
+    task->edf_density   = density;
+
+    edf_task_replenish(task, k_tick_count);
+}
+
+__KNL__ void edf_task_exit(k_task_t *task)
+{
+    edf_bandwidth_release(task->edf_density);
+
+    task->edf_period    = (k_tick_t)0u;
+    task->edf_density   = 0u;
 }
 
-__STATIC_INLINE__ void readyqueue_prio_remove(k_prio_t prio)
+/**
+ * give up the budget left and sleep until the next period begins.
+ * must be called with the interrupt disabled, the task must be ready.
+ */
+__KNL__ void edf_task_throttle(k_task_t *task)
 {
-    k_rdyq.prio_mask[K_PRIO_NDX(prio)] &= ~K_PRIO_BIT(prio);
+    k_tick_t next_release;
+
+    task->edf_budget = (k_tick_t)0u;
+    next_release = task->edf_release + task->edf_period;
+
+    readyqueue_remove(task);
+
+    if (next_release > k_tick_count) {
+        tick_list_add(task, next_release - k_tick_count);
+    } else {
+        // we are late, the next period has already begun
+        edf_task_wakeup(task);
+        readyqueue_add(task);
+    }
 }
 
-__STATIC_INLINE__ void readyqueue_prio_mark(k_prio_t prio)
+/**
+ * charge the tick to current task, called from tos_tick_handler.
+ */
+__KNL__ void edf_tick(void)
 {
-    readyqueue_prio_insert(prio);
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *task;
+
+    TOS_CPU_INT_DISABLE();
+
+    task = k_curr_task;
+
+    /* a boosted EDF task(priority inheritance of a mutex) runs as a fixed priority task,
+       the budget is not enforced until it comes back to the EDF band.
+     */
+    if (!task_is_edf(task) || task->prio != (k_prio_t)TOS_CFG_EDF_PRIO || !task_state_is_ready(task)) {
+        TOS_CPU_INT_ENABLE();
+        return;
+    }
 
-    if (prio < k_rdyq.highest_prio) {
-        k_rdyq.highest_prio = prio;
+    if (task->edf_budget > (k_tick_t)0u) {
+        --task->edf_budget;
     }
+
+    if (task->edf_budget > (k_tick_t)0u) {
+        TOS_CPU_INT_ENABLE();
+        return;
+    }
+
+    edf_task_throttle(task);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
 }
 
+#endif
+
 /**
  * when this function involved, must be at least one task in the task list of the certain priority
  */
@@ -81,54 +271,101 @@ __KNL__ k_task_t *readyqueue_highest_ready_task_get(void)
     return TOS_LIST_FIRST_ENTRY(task_list, k_task_t, pend_list);
 }
 
-__KNL__ void readyqueue_init(void)
+__STATIC__ void readyqueue_do_init(readyqueue_t *rdyq)
 {
-    uint8_t i;
+    uint32_t i;
 
-    k_rdyq.highest_prio = TOS_CFG_TASK_PRIO_MAX;
+    rdyq->highest_prio  = TOS_CFG_TASK_PRIO_MAX;
+    rdyq->prio_group    = 0u;
 
     for (i = 0; i < TOS_CFG_TASK_PRIO_MAX; ++i) {
-        tos_list_init(&k_rdyq.task_list_head[i]);
+        tos_list_init(&rdyq->task_list_head[i]);
     }
 
     for (i = 0; i < K_PRIO_TBL_SIZE; ++i) {
-        k_rdyq.prio_mask[i] = 0;
+        rdyq->prio_mask[i] = 0;
+    }
+}
+
+__KNL__ void readyqueue_init(void)
+{
+#if TOS_CFG_SMP_EN > 0u
+    uint32_t i;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        readyqueue_do_init(&k_cpu[i].rdyq);
     }
+#else
+    readyqueue_do_init(&k_rdyq);
+#endif
 }
 
 __KNL__ void readyqueue_add_head(k_task_t *task)
 {
     k_prio_t task_prio;
     k_list_t *task_list;
+    readyqueue_t *rdyq;
 
+    rdyq = READYQUEUE_OF(task);
     task_prio = task->prio;
-    task_list = &k_rdyq.task_list_head[task_prio];
+    task_list = &rdyq->task_list_head[task_prio];
 
     if (tos_list_empty(task_list)) {
-        readyqueue_prio_mark(task_prio);
+        readyqueue_prio_mark(rdyq, task_prio);
+    }
+
+#if TOS_CFG_EDF_EN > 0u
+    if (task_prio == (k_prio_t)TOS_CFG_EDF_PRIO) {
+        readyqueue_edf_add(task, task_list, K_TRUE);
+        return;
     }
+#endif
 
     tos_list_add(&task->pend_list, task_list);
+
+#if TOS_CFG_SMP_EN > 0u
+    smp_resched_notify(task);
+#endif
 }
 
 __KNL__ void readyqueue_add_tail(k_task_t *task)
 {
     k_prio_t task_prio;
     k_list_t *task_list;
+    readyqueue_t *rdyq;
 
+    rdyq = READYQUEUE_OF(task);
     task_prio = task->prio;
-    task_list = &k_rdyq.task_list_head[task_prio];
+    task_list = &rdyq->task_list_head[task_prio];
 
     if (tos_list_empty(task_list)) {
-        readyqueue_prio_mark(task_prio);
+        readyqueue_prio_mark(rdyq, task_prio);
+    }
+
+#if TOS_CFG_EDF_EN > 0u
+    if (task_prio == (k_prio_t)TOS_CFG_EDF_PRIO) {
+        readyqueue_edf_add(task, task_list, K_FALSE);
+        return;
     }
+#endif
 
     tos_list_add_tail(&task->pend_list, task_list);
+
+#if TOS_CFG_SMP_EN > 0u
+    smp_resched_notify(task);
+#endif
 }
 
 __KNL__ void readyqueue_add(k_task_t *task)
 {
-    if (task->prio == k_curr_task->prio) {
+#if TOS_CFG_SMP_EN > 0u
+    /* the affinity is changed while we were running on another cpu, move now */
+    if (!(task->cpu_affinity & K_CPU_AFFINITY_BIT(task->cpu_id)) && !smp_task_is_running(task)) {
+        smp_task_migrate(task, smp_cpu_pick(task->cpu_affinity));
+    }
+#endif
+
+    if (task->prio == READYQUEUE_CURR_TASK(task)->prio) {
         readyqueue_add_tail(task);
     } else {
         readyqueue_add_head(task);
@@ -139,24 +376,30 @@ __KNL__ void readyqueue_remove(k_task_t *task)
 {
     k_prio_t task_prio;
     k_list_t *task_list;
+    readyqueue_t *rdyq;
 
     // protect the idle task.
     if (knl_is_idle(task)) {
         return;
     }
 
+    rdyq = READYQUEUE_OF(task);
     task_prio = task->prio;
-    task_list = &k_rdyq.task_list_head[task_prio];
+    task_list = &rdyq->task_list_head[task_prio];
 
     tos_list_del(&task->pend_list);
 
     if (tos_list_empty(task_list)) {
-        readyqueue_prio_remove(task_prio);
+        readyqueue_prio_remove(rdyq, task_prio);
     }
 
-    if (task_prio == k_rdyq.highest_prio) {
-        k_rdyq.highest_prio = readyqueue_prio_highest_get();
+    if (task_prio == rdyq->highest_prio) {
+        rdyq->highest_prio = readyqueue_prio_highest_get(rdyq);
     }
+
+#if TOS_CFG_SMP_EN > 0u
+    smp_resched_notify(task);
+#endif
 }
 
 __KNL__ void readyqueue_move_head_to_tail(k_prio_t prio)
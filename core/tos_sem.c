@@ -19,6 +19,17 @@
 
 #if TOS_CFG_SEM_EN > 0u
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+
+__STATIC__ int sem_is_ready(pend_obj_t *object)
+{
+    k_sem_t *sem = TOS_CONTAINER_OF_FIELD(object, k_sem_t, pend_obj);
+
+    return sem->count > (k_sem_cnt_t)0u;
+}
+
+#endif
+
 __API__ k_err_t tos_sem_create_max(k_sem_t *sem, k_sem_cnt_t init_count, k_sem_cnt_t max_count)
 {
     TOS_PTR_SANITY_CHECK(sem);
@@ -31,6 +42,7 @@ __API__ k_err_t tos_sem_create_max(k_sem_t *sem, k_sem_cnt_t init_count, k_sem_c
     sem->count_max  = max_count;
 
     pend_object_init(&sem->pend_obj);
+    PEND_OBJ_READY_SET(&sem->pend_obj, sem_is_ready);
     TOS_OBJ_INIT(sem, KNL_OBJ_TYPE_SEMAPHORE);
 
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
@@ -78,6 +90,14 @@ __API__ k_err_t tos_sem_destroy(k_sem_t *sem)
 
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
 
+__STATIC__ void sem_obj_ctor(void *obj)
+{
+    k_sem_t *sem = (k_sem_t *)obj;
+
+    pend_object_init(&sem->pend_obj);
+    knl_object_alloc_set_dynamic(&sem->knl_obj);
+}
+
 __API__ k_err_t tos_sem_create_max_dyn(k_sem_t **sem, k_sem_cnt_t init_count, k_sem_cnt_t max_count)
 {
     k_sem_t *the_sem;
@@ -89,7 +109,7 @@ __API__ k_err_t tos_sem_create_max_dyn(k_sem_t **sem, k_sem_cnt_t init_count, k_
         init_count = max_count;
     }
 
-    the_sem = tos_mmheap_calloc(1, sizeof(k_sem_t));
+    the_sem = slab_obj_alloc(KNL_OBJ_TYPE_SEMAPHORE, sizeof(k_sem_t), sem_obj_ctor);
     if (!the_sem) {
         return K_ERR_OUT_OF_MEMORY;
     }
@@ -97,11 +117,9 @@ __API__ k_err_t tos_sem_create_max_dyn(k_sem_t **sem, k_sem_cnt_t init_count, k_
     the_sem->count = init_count;
     the_sem->count_max = max_count;
 
-    pend_object_init(&the_sem->pend_obj);
+    PEND_OBJ_READY_SET(&the_sem->pend_obj, sem_is_ready);
     TOS_OBJ_INIT(the_sem, KNL_OBJ_TYPE_SEMAPHORE);
 
-    knl_object_alloc_set_dynamic(&the_sem->knl_obj);
-
     *sem = the_sem;
 
     return K_ERR_NONE;
@@ -131,7 +149,7 @@ __API__ k_err_t tos_sem_destroy_dyn(k_sem_t *sem)
 
     TOS_OBJ_DEINIT(sem);
 
-    tos_mmheap_free(sem);
+    slab_obj_free(KNL_OBJ_TYPE_SEMAPHORE, sem);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -150,6 +168,8 @@ __STATIC__ k_err_t sem_do_post(k_sem_t *sem, opt_post_t opt)
 
     TOS_CPU_INT_DISABLE();
 
+    TOS_TRACE(K_TRACE_EVENT_POST, &sem->pend_obj, 0u, opt);
+
     if (sem->count == sem->count_max) {
         TOS_CPU_INT_ENABLE();
         return K_ERR_SEM_OVERFLOW;
@@ -157,6 +177,13 @@ __STATIC__ k_err_t sem_do_post(k_sem_t *sem, opt_post_t opt)
 
     if (pend_is_nopending(&sem->pend_obj)) {
         ++sem->count;
+#if TOS_CFG_WAIT_ANY_EN > 0u
+        if (pend_any_wakeup(&sem->pend_obj, PEND_STATE_POST)) {
+            TOS_CPU_INT_ENABLE();
+            knl_sched();
+            return K_ERR_NONE;
+        }
+#endif
         TOS_CPU_INT_ENABLE();
         return K_ERR_NONE;
     }
@@ -179,7 +206,7 @@ __API__ k_err_t tos_sem_post_all(k_sem_t *sem)
     return sem_do_post(sem, OPT_POST_ALL);
 }
 
-__API__ k_err_t tos_sem_pend(k_sem_t *sem, k_tick_t timeout)
+__STATIC__ k_err_t sem_do_pend(k_sem_t *sem, k_tick_t timeout, k_hrtime_t ns)
 {
     TOS_CPU_CPSR_ALLOC();
 
@@ -205,7 +232,7 @@ __API__ k_err_t tos_sem_pend(k_sem_t *sem, k_tick_t timeout)
         return K_ERR_PEND_SCHED_LOCKED;
     }
 
-    pend_task_block(k_curr_task, &sem->pend_obj, timeout);
+    pend_task_block_timed(k_curr_task, &sem->pend_obj, timeout, ns);
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
@@ -213,5 +240,19 @@ __API__ k_err_t tos_sem_pend(k_sem_t *sem, k_tick_t timeout)
     return pend_state2errno(k_curr_task->pend_state);
 }
 
+__API__ k_err_t tos_sem_pend(k_sem_t *sem, k_tick_t timeout)
+{
+    return sem_do_pend(sem, timeout, (k_hrtime_t)0u);
+}
+
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_sem_pend_ns(k_sem_t *sem, k_hrtime_t ns)
+{
+    return sem_do_pend(sem, ns == (k_hrtime_t)0u ? TOS_TIME_NOWAIT : TOS_TIME_FOREVER, ns);
+}
+
+#endif
+
 #endif // TOS_CFG_SEM_EN
 
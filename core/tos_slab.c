@@ -0,0 +1,233 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#include "tos_k.h"
+
+#if (TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u) && (TOS_CFG_SLAB_EN > 0u)
+
+#define SLAB_ALIGN(size)            (((size) + sizeof(cpu_addr_t) - 1u) & ~(sizeof(cpu_addr_t) - 1u))
+
+#define SLAB_OBJ_STRIDE(cache)      (sizeof(slab_obj_hdr_t) + SLAB_ALIGN((cache)->obj_size))
+
+#define SLAB_OBJ_HDR(slab, cache, i)    \
+    ((slab_obj_hdr_t *)((cpu_addr_t)(slab) + SLAB_ALIGN(sizeof(slab_t)) + (i) * SLAB_OBJ_STRIDE(cache)))
+
+#define SLAB_HDR_TO_OBJ(hdr)        ((void *)((slab_obj_hdr_t *)(hdr) + 1))
+#define SLAB_OBJ_TO_HDR(obj)        ((slab_obj_hdr_t *)(obj) - 1)
+
+__STATIC__ k_slab_cache_t *slab_cache_get(knl_obj_type_t type)
+{
+    uint32_t i;
+
+    for (i = 0; i < K_SLAB_CACHE_NUM; ++i) {
+        if (k_slab_cache[i].type == type) {
+            return &k_slab_cache[i];
+        }
+    }
+
+    return K_NULL;
+}
+
+/* Take one slab from the heap and construct all of its objects, with the interrupts enabled. */
+__STATIC__ slab_t *slab_make(k_slab_cache_t *cache, k_slab_ctor_t ctor)
+{
+    slab_t *slab;
+    slab_obj_hdr_t *hdr;
+    uint32_t i;
+
+    slab = mmheap_shared_alloc(SLAB_ALIGN(sizeof(slab_t)) + TOS_CFG_SLAB_OBJ_CNT * SLAB_OBJ_STRIDE(cache));
+    if (!slab) {
+        return K_NULL;
+    }
+
+    slab->obj_inuse = 0u;
+
+    for (i = 0; i < TOS_CFG_SLAB_OBJ_CNT; ++i) {
+        hdr = SLAB_OBJ_HDR(slab, cache, i);
+        hdr->slab = slab;
+        hdr->next_free = i + 1u < TOS_CFG_SLAB_OBJ_CNT ? SLAB_OBJ_HDR(slab, cache, i + 1u) : K_NULL;
+
+        memset(SLAB_HDR_TO_OBJ(hdr), 0, cache->obj_size);
+        if (ctor) {
+            ctor(SLAB_HDR_TO_OBJ(hdr));
+        }
+    }
+
+    return slab;
+}
+
+/* Cache the objects of a slab made by slab_make, with the interrupts disabled. */
+__STATIC__ void slab_add(k_slab_cache_t *cache, slab_t *slab)
+{
+    slab->next          = cache->slab_list;
+    cache->slab_list    = slab;
+    ++cache->slab_cnt;
+
+    SLAB_OBJ_HDR(slab, cache, TOS_CFG_SLAB_OBJ_CNT - 1u)->next_free = cache->free_list;
+    cache->free_list    = SLAB_OBJ_HDR(slab, cache, 0u);
+    cache->obj_free    += TOS_CFG_SLAB_OBJ_CNT;
+}
+
+__KNL__ void *slab_obj_alloc(knl_obj_type_t type, size_t obj_size, k_slab_ctor_t ctor)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_slab_cache_t *cache;
+    slab_obj_hdr_t *hdr;
+    slab_t *slab;
+
+    cache = slab_cache_get(type);
+    if (!cache) {
+        return K_NULL;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    if (cache->obj_size == 0u) {
+        cache->obj_size = obj_size;
+    }
+
+    if (!cache->free_list) {
+        // the heap and the constructors are not worth keeping the interrupts off
+        TOS_CPU_INT_ENABLE();
+
+        slab = slab_make(cache, ctor);
+        if (!slab) {
+            return K_NULL;
+        }
+
+        TOS_CPU_INT_DISABLE();
+        slab_add(cache, slab);
+    }
+
+    hdr                 = cache->free_list;
+    cache->free_list    = hdr->next_free;
+    --cache->obj_free;
+
+    ++hdr->slab->obj_inuse;
+    if (++cache->obj_inuse > cache->obj_inuse_max) {
+        cache->obj_inuse_max = cache->obj_inuse;
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    /* without a constructor the object is handed out zeroed, as tos_mmheap_calloc did */
+    if (!ctor) {
+        memset(SLAB_HDR_TO_OBJ(hdr), 0, cache->obj_size);
+    }
+
+    return SLAB_HDR_TO_OBJ(hdr);
+}
+
+__KNL__ void slab_obj_free(knl_obj_type_t type, void *obj)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_slab_cache_t *cache;
+    slab_obj_hdr_t *hdr;
+
+    cache = slab_cache_get(type);
+    if (!cache || !obj) {
+        return;
+    }
+
+    hdr = SLAB_OBJ_TO_HDR(obj);
+
+    TOS_CPU_INT_DISABLE();
+
+    --hdr->slab->obj_inuse;
+    --cache->obj_inuse;
+
+    hdr->next_free      = cache->free_list;
+    cache->free_list    = hdr;
+    ++cache->obj_free;
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__API__ k_err_t tos_slab_check(knl_obj_type_t type, k_slab_info_t *info)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_slab_cache_t *cache;
+
+    TOS_PTR_SANITY_CHECK(info);
+
+    cache = slab_cache_get(type);
+    if (!cache) {
+        return K_ERR_OBJ_INVALID;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    info->obj_size      = cache->obj_size;
+    info->slab_cnt      = cache->slab_cnt;
+    info->obj_inuse     = cache->obj_inuse;
+    info->obj_inuse_max = cache->obj_inuse_max;
+    info->obj_free      = cache->obj_free;
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+__API__ void tos_slab_reap(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_slab_cache_t *cache;
+    slab_obj_hdr_t **hdr_prev, *hdr;
+    slab_t **slab_prev, *slab, *empty;
+    uint32_t i;
+
+    for (i = 0; i < K_SLAB_CACHE_NUM; ++i) {
+        empty = K_NULL;
+        cache = &k_slab_cache[i];
+
+        TOS_CPU_INT_DISABLE();
+
+        // the objects of an empty slab are all on the free list, take them off first
+        hdr_prev = &cache->free_list;
+        while ((hdr = *hdr_prev) != K_NULL) {
+            if (hdr->slab->obj_inuse == 0u) {
+                *hdr_prev = hdr->next_free;
+                --cache->obj_free;
+            } else {
+                hdr_prev = &hdr->next_free;
+            }
+        }
+
+        slab_prev = &cache->slab_list;
+        while ((slab = *slab_prev) != K_NULL) {
+            if (slab->obj_inuse == 0u) {
+                *slab_prev = slab->next;
+                --cache->slab_cnt;
+
+                slab->next = empty;
+                empty = slab;
+            } else {
+                slab_prev = &slab->next;
+            }
+        }
+
+        TOS_CPU_INT_ENABLE();
+
+        // off the cache, back to the heap with the interrupts enabled
+        while ((slab = empty) != K_NULL) {
+            empty = slab->next;
+            mmheap_shared_free(slab);
+        }
+    }
+}
+
+#endif
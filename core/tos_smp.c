@@ -0,0 +1,198 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+
+#include "tos_k.h"
+
+#if TOS_CFG_SMP_EN > 0u
+
+/*
+ * SMP with partitioned scheduling: every task lives on one cpu and is in the readyqueue of that
+ * cpu when ready, every cpu runs the highest priority task of its own readyqueue.
+ * the kernel data is protected by one big kernel lock(k_knl_lock), taken by the outermost
+ * TOS_CPU_INT_DISABLE of a cpu, so the kernel code written for one cpu still works.
+ * when a cpu changes the readyqueue of another one(wakes up a task living there, say), it sends
+ * an IPI to make that cpu reschedule.
+ * a task moves to another cpu only when its affinity changes.
+ */
+
+__API__ void tos_spin_lock_init(k_spinlock_t *lock)
+{
+    lock->locked = 0u;
+}
+
+__API__ void tos_spin_lock(k_spinlock_t *lock)
+{
+    while (__atomic_exchange_n(&lock->locked, 1u, __ATOMIC_ACQUIRE)) {
+        // spin on a plain read, do not bounce the cache line with the exchange
+        while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED)) {
+            cpu_relax();
+        }
+    }
+}
+
+__API__ int tos_spin_trylock(k_spinlock_t *lock)
+{
+    return __atomic_exchange_n(&lock->locked, 1u, __ATOMIC_ACQUIRE) == 0u;
+}
+
+__API__ void tos_spin_unlock(k_spinlock_t *lock)
+{
+    __atomic_store_n(&lock->locked, 0u, __ATOMIC_RELEASE);
+}
+
+__API__ uint32_t tos_cpu_id_get(void)
+{
+    return cpu_id_get();
+}
+
+__KNL__ void smp_init(void)
+{
+    uint32_t i;
+
+    tos_spin_lock_init(&k_knl_lock);
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        k_cpu[i].curr_task              = K_NULL;
+        k_cpu[i].next_task              = K_NULL;
+        k_cpu[i].irq_nest_cnt           = (k_nesting_t)0u;
+        k_cpu[i].sched_lock_nest_cnt    = (k_nesting_t)0u;
+        k_cpu[i].task_cnt               = 0u;
+    }
+}
+
+/**
+ * every cpu starts with the highest priority task of its own, must be called with the
+ * interrupt disabled.
+ */
+__KNL__ void smp_sched_prepare(void)
+{
+    uint32_t i;
+    readyqueue_t *rdyq;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        rdyq = &k_cpu[i].rdyq;
+        k_cpu[i].next_task = TOS_LIST_FIRST_ENTRY(&rdyq->task_list_head[rdyq->highest_prio], k_task_t, pend_list);
+        k_cpu[i].curr_task = k_cpu[i].next_task;
+    }
+}
+
+/**
+ * the cpu with the fewest tasks in the affinity.
+ */
+__KNL__ uint32_t smp_cpu_pick(k_cpu_affinity_t affinity)
+{
+    uint32_t i, cpu_id = 0u, task_cnt = (uint32_t)-1;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        if ((affinity & K_CPU_AFFINITY_BIT(i)) && k_cpu[i].task_cnt < task_cnt) {
+            cpu_id      = i;
+            task_cnt    = k_cpu[i].task_cnt;
+        }
+    }
+
+    return cpu_id;
+}
+
+/**
+ * decide where a new task lives, the idle task of a cpu is bound to it.
+ */
+__KNL__ void smp_task_place(k_task_t *task)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+
+    if (knl_is_idle(task)) {
+        task->cpu_id        = (uint32_t)(task - &k_idle_task[0]);
+        task->cpu_affinity  = K_CPU_AFFINITY_BIT(task->cpu_id);
+    } else {
+        task->cpu_affinity  = K_CPU_AFFINITY_ALL;
+        task->cpu_id        = smp_cpu_pick(task->cpu_affinity);
+    }
+
+    ++k_cpu[task->cpu_id].task_cnt;
+
+    TOS_CPU_INT_ENABLE();
+}
+
+/**
+ * the task is destroyed, must be called with the interrupt disabled.
+ */
+__KNL__ void smp_task_leave(k_task_t *task)
+{
+    --k_cpu[task->cpu_id].task_cnt;
+}
+
+/**
+ * whether the task is the one running on its cpu.
+ * a task switched out on a cpu is not "curr_task" any more, while the kernel lock is held until
+ * the context is saved, so a task not running can be switched in anywhere.
+ */
+__KNL__ int smp_task_is_running(k_task_t *task)
+{
+    return k_cpu[task->cpu_id].curr_task == task;
+}
+
+/**
+ * move a task not running to another cpu, must be called with the interrupt disabled.
+ */
+__KNL__ void smp_task_migrate(k_task_t *task, uint32_t cpu_id)
+{
+    int is_ready;
+
+    if (task->cpu_id == cpu_id) {
+        return;
+    }
+
+    is_ready = task_state_is_ready(task);
+    if (is_ready) {
+        readyqueue_remove(task);
+    }
+
+    --k_cpu[task->cpu_id].task_cnt;
+    task->cpu_id = cpu_id;
+    ++k_cpu[task->cpu_id].task_cnt;
+
+    if (is_ready) {
+        readyqueue_add_tail(task);
+    }
+}
+
+/**
+ * the readyqueue of the cpu the task lives on is changed(the task is added or removed), if the
+ * cpu is not us and has to reschedule, send it an IPI.
+ * must be called with the interrupt disabled.
+ */
+__KNL__ void smp_resched_notify(k_task_t *task)
+{
+    k_cpu_t *cpu;
+
+    if (task->cpu_id == cpu_id_get() || !tos_knl_is_running()) {
+        return;
+    }
+
+    cpu = &k_cpu[task->cpu_id];
+
+    /* the task running there is not ready any more, or the one added preempts it */
+    if (cpu->curr_task == task || task->prio < cpu->curr_task->prio) {
+        cpu_ipi_send(task->cpu_id);
+    }
+}
+
+#endif
+
@@ -23,8 +23,20 @@ __API__ k_err_t tos_knl_init(void)
 
     cpu_init();
 
+#if TOS_CFG_SMP_EN > 0u
+    smp_init();
+#endif
+
+#if TOS_CFG_TRACE_EN > 0u
+    trace_init();
+#endif
+
     readyqueue_init();
 
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+    tick_wheel_init();
+#endif
+
 #if TOS_CFG_MMHEAP_EN > 0
 #if TOS_CFG_MMHEAP_DEFAULT_POOL_EN > 0u
     err = mmheap_init_with_pool(k_mmheap_default_pool, TOS_CFG_MMHEAP_DEFAULT_POOL_SIZE);
@@ -48,6 +60,10 @@ __API__ k_err_t tos_knl_init(void)
     }
 #endif
 
+#if TOS_CFG_HRTIMER_EN > 0u
+    hrtimer_init();
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0U
     pm_init();
 #endif
@@ -93,17 +109,25 @@ __API__ void tos_knl_irq_leave(void)
         return;
     }
 
-    if (knl_is_sched_locked()) {
+    if (k_sched_lock_nest_cnt > 0u) {
         TOS_CPU_INT_ENABLE();
         return;
     }
 
     k_next_task = readyqueue_highest_ready_task_get();
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    k_next_task = evtdrv_task_next_get(k_next_task);
+#endif
     if (knl_is_self(k_next_task)) {
         TOS_CPU_INT_ENABLE();
         return;
     }
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    task_runtime_switch(k_curr_task, k_next_task);
+#endif
+    TOS_TRACE(K_TRACE_EVENT_TASK_SWITCH, k_curr_task, k_next_task, 0u);
+
     cpu_irq_context_switch();
     TOS_CPU_INT_ENABLE();
 }
@@ -138,7 +162,7 @@ __API__ k_err_t tos_knl_sched_unlock(void)
         return K_ERR_KNL_NOT_RUNNING;
     }
 
-    if (!knl_is_sched_locked()) {
+    if (k_sched_lock_nest_cnt == 0u) {
         return K_ERR_SCHED_NOT_LOCKED;
     }
 
@@ -156,10 +180,22 @@ __API__ k_err_t tos_knl_start(void)
         return K_ERR_KNL_RUNNING;
     }
 
+#if TOS_CFG_SMP_EN > 0u
+    smp_sched_prepare();
+#else
     k_next_task = readyqueue_highest_ready_task_get();
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    k_next_task = evtdrv_task_next_get(k_next_task);
+#endif
     k_curr_task = k_next_task;
+#endif
     k_knl_state = KNL_STATE_RUNNING;
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    task_runtime_switch(K_NULL, k_curr_task);
+#endif
+    TOS_TRACE(K_TRACE_EVENT_TASK_SWITCH, K_NULL, k_curr_task, 0u);
+
     cpu_sched_start();
 
     return K_ERR_NONE;
@@ -170,7 +206,7 @@ __API__ int tos_knl_is_running(void)
     return k_knl_state == KNL_STATE_RUNNING;
 }
 
-#if TOS_CFG_TICKLESS_EN > 0u
+#if (TOS_CFG_TICKLESS_EN > 0u) || (TOS_CFG_VIRTUAL_TIME_EN > 0u)
 
 /**
  * @brief Get the remain ticks of the first oncoming task.
@@ -211,23 +247,39 @@ __KNL__ void knl_sched(void)
         return;
     }
 
-    if (knl_is_sched_locked()) {
+    if (k_sched_lock_nest_cnt > 0u) {
         return;
     }
 
     TOS_CPU_INT_DISABLE();
     k_next_task = readyqueue_highest_ready_task_get();
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    k_next_task = evtdrv_task_next_get(k_next_task);
+#endif
     if (knl_is_self(k_next_task)) {
         TOS_CPU_INT_ENABLE();
         return;
     }
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    task_runtime_switch(k_curr_task, k_next_task);
+#endif
+    TOS_TRACE(K_TRACE_EVENT_TASK_SWITCH, k_curr_task, k_next_task, 0u);
+
     cpu_context_switch();
     TOS_CPU_INT_ENABLE();
 }
 
 __KNL__ int knl_is_sched_locked(void)
 {
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    /* a handler of an event-driven task must run to completion, to the blocking calls it is
+       just like running with the scheduler locked; a task with a higher priority still preempts it.
+     */
+    if (k_curr_task && task_is_evtdrv(k_curr_task)) {
+        return K_TRUE;
+    }
+#endif
     return k_sched_lock_nest_cnt > 0u;
 }
 
@@ -238,7 +290,11 @@ __KNL__ int knl_is_inirq(void)
 
 __KNL__ int knl_is_idle(k_task_t *task)
 {
+#if TOS_CFG_SMP_EN > 0u
+    return task >= &k_idle_task[0] && task < &k_idle_task[TOS_CFG_CPU_NUM];
+#else
     return task == &k_idle_task;
+#endif
 }
 
 __KNL__ int knl_is_self(k_task_t *task)
@@ -246,6 +302,44 @@ __KNL__ int knl_is_self(k_task_t *task)
     return task == k_curr_task;
 }
 
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+
+/*
+ * virtual time: the tick does not come from a clock, the time only goes on when every task is
+ * waiting, and it jumps to the first expiry at once.
+ */
+__STATIC__ void knl_virtual_time_advance(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_tick_t next_expires;
+
+    TOS_CPU_INT_DISABLE();
+
+    next_expires = knl_next_expires_get();
+    if (next_expires == TOS_TIME_FOREVER) {
+        TOS_CPU_INT_ENABLE();
+        // nothing is going to expire, only an interrupt can wake anyone up
+        cpu_virtual_time_stall();
+        return;
+    }
+
+    if (next_expires == (k_tick_t)0u) {
+        next_expires = (k_tick_t)1u;
+    }
+
+    tick_update(next_expires);
+
+#if TOS_CFG_TIMER_EN > 0u && TOS_CFG_TIMER_AS_PROC > 0u
+    soft_timer_update();
+#endif
+
+    TOS_CPU_INT_ENABLE();
+
+    knl_sched();
+}
+
+#endif
+
 __STATIC__ void knl_idle_entry(void *arg)
 {
     arg = arg; // make compiler happy
@@ -255,12 +349,49 @@ __STATIC__ void knl_idle_entry(void *arg)
         task_free_all();
 #endif
 
+#if TOS_CFG_MMHEAP_CACHE_EN > 0u
+        mmheap_cache_trim();
+#endif
+
+#if TOS_CFG_VIRTUAL_TIME_EN > 0u
+        knl_virtual_time_advance();
+#endif
+
 #if TOS_CFG_PWR_MGR_EN > 0u
         pm_power_manager();
 #endif
+
+#if TOS_CFG_SMP_EN > 0u
+        // nothing to do on this cpu, give way to the others
+        cpu_relax();
+#endif
+    }
+}
+
+#if TOS_CFG_SMP_EN > 0u
+
+__KNL__ k_err_t knl_idle_init(void)
+{
+    k_err_t err;
+    uint32_t i;
+
+    for (i = 0; i < TOS_CFG_CPU_NUM; ++i) {
+        err = tos_task_create(&k_idle_task[i], "idle",
+                knl_idle_entry, K_NULL,
+                K_TASK_PRIO_IDLE,
+                k_idle_task_stk_addr + i * k_idle_task_stk_size,
+                k_idle_task_stk_size,
+                0);
+        if (err != K_ERR_NONE) {
+            return err;
+        }
     }
+
+    return K_ERR_NONE;
 }
 
+#else
+
 __KNL__ k_err_t knl_idle_init(void)
 {
     return tos_task_create(&k_idle_task, "idle",
@@ -271,3 +402,5 @@ __KNL__ k_err_t knl_idle_init(void)
             0);
 }
 
+#endif
+
@@ -36,6 +36,28 @@ __STATIC_INLINE__ void task_reset(k_task_t *task)
     task->pend_state    = PEND_STATE_NONE;
     task->pending_obj   = (pend_obj_t *)K_NULL;
 
+#if TOS_CFG_WAIT_ANY_EN > 0u
+    task->pend_any      = (pend_any_t *)K_NULL;
+#endif
+
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+    task->notify        = 0u;
+    task->notify_expect = 0u;
+#endif
+
+#if TOS_CFG_EDF_EN > 0u
+    task->edf_period    = (k_tick_t)0u;
+    task->edf_density   = 0u;
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    task->runtime       = 0u;
+    task->runtime_stamp = 0u;
+    task->switch_cnt    = 0u;
+    task->preempt_cnt   = 0u;
+    task->last_run      = (k_tick_t)0u;
+#endif
+
 #if TOS_CFG_MESSAGE_QUEUE_EN > 0u
     task->msg           = K_NULL;
 #endif
@@ -45,6 +67,16 @@ __STATIC_INLINE__ void task_reset(k_task_t *task)
     task->mail_size     = 0;
 #endif
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    task->evtdrv_handler    = K_NULL;
+    task->evtdrv_event      = (k_event_flag_t)0u;
+    tos_list_init(&task->evtdrv_msg_list);
+#endif
+
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    task->mmheap_arena  = K_NULL;
+#endif
+
     TOS_OBJ_DEINIT(task);
 }
 
@@ -79,7 +111,7 @@ __STATIC__ void task_mutex_release(k_task_t *task)
 }
 #endif
 
-__API__ k_err_t tos_task_create(k_task_t *task,
+__STATIC__ k_err_t task_do_create(k_task_t *task,
                                             const char *name,
                                             k_task_entry_t entry,
                                             void *arg,
@@ -88,8 +120,6 @@ __API__ k_err_t tos_task_create(k_task_t *task,
                                             size_t stk_size,
                                             k_timeslice_t timeslice)
 {
-    TOS_CPU_CPSR_ALLOC();
-
     TOS_IN_IRQ_CHECK();
 
     TOS_PTR_SANITY_CHECK(task);
@@ -114,12 +144,22 @@ __API__ k_err_t tos_task_create(k_task_t *task,
     task_reset(task);
     tos_list_add(&task->stat_list, &k_stat_list);
 
+#if TOS_CFG_HRTIMER_EN > 0u
+    hrtimer_task_init(task);
+#endif
+
     TOS_OBJ_INIT(task, KNL_OBJ_TYPE_TASK);
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
     knl_object_alloc_set_static(&task->knl_obj);
 #endif
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    // an event-driven task gets a context on the shared stack only when dispatched(evtdrv_task_next_get)
+    task->sp        = entry == evtdrv_task_entry ? K_NULL :
+                        cpu_task_stk_init((void *)entry, arg, (void *)task_exit, stk_base, stk_size);
+#else
     task->sp        = cpu_task_stk_init((void *)entry, arg, (void *)task_exit, stk_base, stk_size);
+#endif
     task->entry     = entry;
     task->arg       = arg;
     task->prio      = prio;
@@ -127,6 +167,12 @@ __API__ k_err_t tos_task_create(k_task_t *task,
     task->stk_size  = stk_size;
     strncpy(task->name, name, K_TASK_NAME_LEN_MAX);
 
+#if TOS_CFG_SMP_EN > 0u
+    smp_task_place(task);
+#endif
+
+    TOS_TRACE_TASK_CREATE(task);
+
 #if TOS_CFG_ROUND_ROBIN_EN > 0u
     task->timeslice_reload = timeslice;
 
@@ -137,6 +183,13 @@ __API__ k_err_t tos_task_create(k_task_t *task,
     }
 #endif
 
+    return K_ERR_NONE;
+}
+
+__STATIC__ void task_do_ready(k_task_t *task)
+{
+    TOS_CPU_CPSR_ALLOC();
+
     TOS_CPU_INT_DISABLE();
     task_state_set_ready(task);
     readyqueue_add_tail(task);
@@ -145,10 +198,138 @@ __API__ k_err_t tos_task_create(k_task_t *task,
     if (tos_knl_is_running()) {
         knl_sched();
     }
+}
+
+__API__ k_err_t tos_task_create(k_task_t *task,
+                                            const char *name,
+                                            k_task_entry_t entry,
+                                            void *arg,
+                                            k_prio_t prio,
+                                            k_stack_t *stk_base,
+                                            size_t stk_size,
+                                            k_timeslice_t timeslice)
+{
+    k_err_t err;
+
+#if TOS_CFG_EDF_EN > 0u
+    // the EDF band is for the EDF tasks only(tos_task_create_edf)
+    if (unlikely(prio == (k_prio_t)TOS_CFG_EDF_PRIO)) {
+        return K_ERR_TASK_PRIO_INVALID;
+    }
+#endif
+
+    err = task_do_create(task, name, entry, arg, prio, stk_base, stk_size, timeslice);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    task_do_ready(task);
+
+    return K_ERR_NONE;
+}
+
+#if TOS_CFG_EDF_EN > 0u
+
+__API__ k_err_t tos_task_create_edf(k_task_t *task,
+                                                    const char *name,
+                                                    k_task_entry_t entry,
+                                                    void *arg,
+                                                    k_stack_t *stk_base,
+                                                    size_t stk_size,
+                                                    k_tick_t period,
+                                                    k_tick_t runtime,
+                                                    k_tick_t deadline)
+{
+    k_err_t err;
+    uint32_t density;
+
+    TOS_IN_IRQ_CHECK();
+
+    if (deadline == (k_tick_t)0u) {
+        deadline = period;
+    }
+
+    if (unlikely(runtime == (k_tick_t)0u || runtime > deadline || deadline > period)) {
+        return K_ERR_TASK_EDF_PARAM_INVALID;
+    }
+
+    // admission control
+    err = edf_bandwidth_reserve(runtime, deadline, &density);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    err = task_do_create(task, name, entry, arg, (k_prio_t)TOS_CFG_EDF_PRIO, stk_base, stk_size, (k_timeslice_t)0u);
+    if (err != K_ERR_NONE) {
+        edf_bandwidth_release(density);
+        return err;
+    }
+
+    edf_task_init(task, period, runtime, deadline, density);
+    task_do_ready(task);
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_task_edf_yield(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_IN_IRQ_CHECK();
+
+    if (!task_is_edf(k_curr_task)) {
+        return K_ERR_TASK_NOT_EDF;
+    }
+
+    if (knl_is_sched_locked()) {
+        return K_ERR_SCHED_LOCKED;
+    }
+
+    TOS_CPU_INT_DISABLE();
+    edf_task_throttle(k_curr_task);
+    TOS_CPU_INT_ENABLE();
+
+    knl_sched();
 
     return K_ERR_NONE;
 }
 
+#endif
+
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+
+__API__ k_err_t tos_task_create_evtdrv(k_task_t *task,
+                                                        const char *name,
+                                                        k_evtdrv_handler_t handler,
+                                                        void *arg,
+                                                        k_prio_t prio)
+{
+    k_err_t err;
+
+    TOS_PTR_SANITY_CHECK(handler);
+
+#if TOS_CFG_EDF_EN > 0u
+    if (unlikely(prio == (k_prio_t)TOS_CFG_EDF_PRIO)) {
+        return K_ERR_TASK_PRIO_INVALID;
+    }
+#endif
+
+    err = task_do_create(task, name, evtdrv_task_entry, arg, prio,
+                            k_evtdrv_stk_addr, k_evtdrv_stk_size, (k_timeslice_t)0u);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    task->evtdrv_handler = handler;
+
+    // nothing posted yet, wait for the first event or message
+    evtdrv_task_idle(task);
+
+    return K_ERR_NONE;
+}
+
+#endif
+
 __STATIC__ k_err_t task_do_destroy(k_task_t *task)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -176,6 +357,24 @@ __STATIC__ k_err_t task_do_destroy(k_task_t *task)
         pend_list_remove(task);
     }
 
+#if TOS_CFG_EDF_EN > 0u
+    if (task_is_edf(task)) {
+        edf_task_exit(task);
+    }
+#endif
+
+#if TOS_CFG_SMP_EN > 0u
+    smp_task_leave(task);
+#endif
+
+#if TOS_CFG_MMHEAP_ARENA_EN > 0u
+    mmheap_arena_unbind(task);
+#endif
+
+#if TOS_CFG_CPU_TASK_STK_DEINIT_EN > 0u
+    cpu_task_stk_deinit(task);
+#endif
+
     tos_list_del(&task->stat_list);
     task_reset(task);
 
@@ -201,6 +400,12 @@ __API__ k_err_t tos_task_destroy(k_task_t *task)
         return K_ERR_SCHED_LOCKED;
     }
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    if (task == k_evtdrv_curr) {
+        return K_ERR_TASK_EVTDRV_BUSY;
+    }
+#endif
+
 #if TOS_CFG_OBJ_DYNAMIC_CREATE_EN > 0u
     if (!knl_object_alloc_is_static(&task->knl_obj)) {
         return K_ERR_OBJ_INVALID_ALLOC_TYPE;
@@ -214,8 +419,8 @@ __API__ k_err_t tos_task_destroy(k_task_t *task)
 
 __STATIC__ void task_free(k_task_t *task)
 {
-    tos_mmheap_free(task->stk_base);
-    tos_mmheap_free(task);
+    mmheap_shared_free(task->stk_base);
+    slab_obj_free(KNL_OBJ_TYPE_TASK, task);
 }
 
 __KNL__ void task_free_all(void)
@@ -226,6 +431,12 @@ __KNL__ void task_free_all(void)
     TOS_CPU_INT_DISABLE();
 
     TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, dead_list, &k_dead_task_list) {
+#if TOS_CFG_SMP_EN > 0u
+        if (smp_task_is_running(task)) {
+            // still on the stack, its cpu has not switched it out yet
+            continue;
+        }
+#endif
         tos_list_del(&task->dead_list);
         task_free(task);
     }
@@ -250,14 +461,21 @@ __API__ k_err_t tos_task_create_dyn(k_task_t **task,
     TOS_PTR_SANITY_CHECK(task);
     TOS_PTR_SANITY_CHECK(entry);
 
-    the_task = tos_mmheap_calloc(1, sizeof(k_task_t));
+#if TOS_CFG_EDF_EN > 0u
+    // refused before anything is allocated, tos_task_create would refuse it anyway
+    if (unlikely(prio == (k_prio_t)TOS_CFG_EDF_PRIO)) {
+        return K_ERR_TASK_PRIO_INVALID;
+    }
+#endif
+
+    the_task = slab_obj_alloc(KNL_OBJ_TYPE_TASK, sizeof(k_task_t), K_NULL);
     if (!the_task) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
-    stk_base = tos_mmheap_alloc(stk_size);
+    stk_base = mmheap_shared_alloc(stk_size);
     if (!stk_base) {
-        tos_mmheap_free(the_task);
+        slab_obj_free(KNL_OBJ_TYPE_TASK, the_task);
         return K_ERR_OUT_OF_MEMORY;
     }
     TOS_CPU_CPSR_ALLOC();
@@ -306,7 +524,11 @@ __API__ k_err_t tos_task_destroy_dyn(k_task_t *task)
         return err;
     }
 
+#if TOS_CFG_SMP_EN > 0u
+    if (knl_is_self(task) || smp_task_is_running(task)) {
+#else
     if (knl_is_self(task)) { // we are destroying ourself
+#endif
         // in this situation, we cannot just free ourself's task stack because we are using it
         // we count on the idle task to free the memory
         tos_list_add(&task->dead_list, &k_dead_task_list);
@@ -338,27 +560,20 @@ __API__ void tos_task_yield(void)
     knl_sched();
 }
 
-__API__ k_err_t tos_task_prio_change(k_task_t *task, k_prio_t prio_new)
+/* the priority inheritance of the mutexes may move a task in or out of the EDF band, the API may not */
+__KNL__ void task_prio_change(k_task_t *task, k_prio_t prio_new)
 {
     TOS_CPU_CPSR_ALLOC();
 #if TOS_CFG_MUTEX_EN > 0u
     k_prio_t highest_pending_prio;
 #endif
 
-    TOS_IN_IRQ_CHECK();
-    TOS_PTR_SANITY_CHECK(task);
-    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
-
-    if (unlikely(prio_new >= K_TASK_PRIO_IDLE)) {
-        return K_ERR_TASK_PRIO_INVALID;
-    }
-
     TOS_CPU_INT_DISABLE();
 
     if (task->prio == prio_new) { // just kidding
         TOS_CPU_INT_ENABLE();
         knl_sched();
-        return K_ERR_NONE;
+        return;
     }
 
 #if TOS_CFG_MUTEX_EN > 0u
@@ -372,8 +587,11 @@ __API__ k_err_t tos_task_prio_change(k_task_t *task, k_prio_t prio_new)
 #endif
 
     if (task_state_is_pending(task)) {
-        task->prio = prio_new;
-        pend_list_adjust(task);
+        if (task->pending_obj) {
+            pend_list_adjust(task, prio_new);
+        } else { // waiting for notification, or an idle event-driven task, we pend for nothing
+            task->prio = prio_new;
+        }
     } else if (task_state_is_sleeping(task)) {
         task->prio = prio_new;
     } else if (task_state_is_ready(task)) { // good kid
@@ -393,10 +611,80 @@ __API__ k_err_t tos_task_prio_change(k_task_t *task, k_prio_t prio_new)
 
     TOS_CPU_INT_ENABLE();
     knl_sched();
+}
+
+__API__ k_err_t tos_task_prio_change(k_task_t *task, k_prio_t prio_new)
+{
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(task);
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+
+    if (unlikely(prio_new >= K_TASK_PRIO_IDLE)) {
+        return K_ERR_TASK_PRIO_INVALID;
+    }
+
+#if TOS_CFG_EDF_EN > 0u
+    // the EDF band is for the EDF tasks only, and an EDF task never leaves it
+    if (task_is_edf(task) ? prio_new != (k_prio_t)TOS_CFG_EDF_PRIO : prio_new == (k_prio_t)TOS_CFG_EDF_PRIO) {
+        return K_ERR_TASK_PRIO_INVALID;
+    }
+#endif
+
+    task_prio_change(task, prio_new);
 
     return K_ERR_NONE;
 }
 
+#if TOS_CFG_SMP_EN > 0u
+
+__API__ k_err_t tos_task_affinity_set(k_task_t *task, k_cpu_affinity_t affinity)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_IN_IRQ_CHECK();
+
+    if (unlikely(!task)) {
+        task = k_curr_task;
+    }
+
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+
+    affinity &= K_CPU_AFFINITY_ALL;
+    if (unlikely(affinity == (k_cpu_affinity_t)0u || knl_is_idle(task))) {
+        return K_ERR_TASK_AFFINITY_INVALID;
+    }
+
+    if (knl_is_self(task) && knl_is_sched_locked()) {
+        return K_ERR_SCHED_LOCKED;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    task->cpu_affinity = affinity;
+
+    if (affinity & K_CPU_AFFINITY_BIT(task->cpu_id)) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_NONE;
+    }
+
+    if (knl_is_self(task)) {
+        /* the cpu we are going to may switch us in as soon as the kernel lock is released,
+           so switch out with the lock held, we get it back when switched in over there.
+         */
+        smp_task_migrate(task, smp_cpu_pick(affinity));
+        knl_sched();
+    } else if (!smp_task_is_running(task)) {
+        smp_task_migrate(task, smp_cpu_pick(affinity));
+    }
+    /* else: running on another cpu, moves the next time it becomes ready(see readyqueue_add) */
+
+    TOS_CPU_INT_ENABLE();
+
+    return K_ERR_NONE;
+}
+
+#endif
+
 __API__ k_err_t tos_task_suspend(k_task_t *task)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -415,6 +703,12 @@ __API__ k_err_t tos_task_suspend(k_task_t *task)
         return K_ERR_SCHED_LOCKED;
     }
 
+#if TOS_CFG_EVENT_DRIVEN_EN > 0u
+    if (task == k_evtdrv_curr) {
+        return K_ERR_TASK_EVTDRV_BUSY;
+    }
+#endif
+
     TOS_CPU_INT_DISABLE();
 
     if (task_state_is_ready(task)) { // kill the good kid
@@ -455,6 +749,11 @@ __API__ k_err_t tos_task_resume(k_task_t *task)
 
     task_state_reset_suspended(task);
     if (task_state_is_ready(task)) { // we are good kid now
+#if TOS_CFG_EDF_EN > 0u
+        if (task_is_edf(task)) {
+            edf_task_wakeup(task);
+        }
+#endif
         readyqueue_add(task);
     }
 
@@ -495,6 +794,36 @@ __API__ k_err_t tos_task_delay(k_tick_t delay)
     return K_ERR_NONE;
 }
 
+#if TOS_CFG_HRTIMER_EN > 0u
+
+__API__ k_err_t tos_task_delay_ns(k_hrtime_t ns)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_IN_IRQ_CHECK();
+
+    if (knl_is_sched_locked()) {
+        return K_ERR_SCHED_LOCKED;
+    }
+
+    if (unlikely(ns == (k_hrtime_t)0u)) {
+        tos_task_yield();
+        return K_ERR_NONE;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    hrtimer_task_sleep(k_curr_task, ns);
+    readyqueue_remove(k_curr_task);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    return K_ERR_NONE;
+}
+
+#endif
+
 __API__ k_err_t tos_task_delay_abort(k_task_t *task)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -516,6 +845,11 @@ __API__ k_err_t tos_task_delay_abort(k_task_t *task)
     }
 
     tick_list_remove(task);
+#if TOS_CFG_EDF_EN > 0u
+    if (task_is_edf(task)) {
+        edf_task_wakeup(task);
+    }
+#endif
     readyqueue_add(task);
 
     TOS_CPU_INT_ENABLE();
@@ -524,6 +858,140 @@ __API__ k_err_t tos_task_delay_abort(k_task_t *task)
     return K_ERR_NONE;
 }
 
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+
+__STATIC__ int task_notify_is_match(uint32_t notify, uint32_t bits_expect, k_opt_t opt)
+{
+    if (opt & TOS_OPT_TASK_NOTIFY_WAIT_ALL) {
+        return (notify & bits_expect) == bits_expect;
+    }
+    return (notify & bits_expect) != 0u;
+}
+
+__STATIC__ void task_notify_take(k_task_t *task, uint32_t bits_expect, uint32_t *notify, k_opt_t opt)
+{
+    *notify = task->notify;
+
+    if (opt & TOS_OPT_TASK_NOTIFY_WAIT_CLR) {
+        task->notify &= ~bits_expect;
+    }
+}
+
+__API__ k_err_t tos_task_notify(k_task_t *task, uint32_t bits)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_PTR_SANITY_CHECK(task);
+    TOS_OBJ_VERIFY(task, KNL_OBJ_TYPE_TASK);
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_TRACE(K_TRACE_EVENT_POST, K_NULL, bits, OPT_POST_ONE);
+
+    task->notify |= bits;
+
+    // notify_expect is not zero only if the task is in tos_task_notify_wait, no pend object to look up.
+    // a task suspended meanwhile is not pending any more, it does not take the bits
+    if (task->notify_expect == 0u || !task_state_is_pending(task) ||
+        !task_notify_is_match(task->notify, task->notify_expect, task->notify_opt)) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_NONE;
+    }
+
+    task_notify_take(task, task->notify_expect, task->notify_ret, task->notify_opt);
+    task->notify_expect = 0u;
+
+    pend_task_wakeup(task, PEND_STATE_POST);
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    return K_ERR_NONE;
+}
+
+__API__ k_err_t tos_task_notify_wait(uint32_t bits_expect, uint32_t *notify, k_tick_t timeout, k_opt_t opt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *self;
+
+    TOS_IN_IRQ_CHECK();
+    TOS_PTR_SANITY_CHECK(notify);
+
+    if (bits_expect == 0u ||
+        !(opt & (TOS_OPT_TASK_NOTIFY_WAIT_ANY | TOS_OPT_TASK_NOTIFY_WAIT_ALL)) ||
+        ((opt & TOS_OPT_TASK_NOTIFY_WAIT_ANY) && (opt & TOS_OPT_TASK_NOTIFY_WAIT_ALL))) {
+        return K_ERR_TASK_NOTIFY_OPT_INVALID;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    self = k_curr_task;
+
+    if (task_notify_is_match(self->notify, bits_expect, opt)) {
+        task_notify_take(self, bits_expect, notify, opt);
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_NONE;
+    }
+
+    if (timeout == TOS_TIME_NOWAIT) { // no wait, return immediately
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_NOWAIT;
+    }
+
+    if (knl_is_sched_locked()) {
+        TOS_CPU_INT_ENABLE();
+        return K_ERR_PEND_SCHED_LOCKED;
+    }
+
+    self->notify_expect = bits_expect;
+    self->notify_opt    = opt;
+    self->notify_ret    = notify;
+
+    // pend for nothing, tos_task_notify wakes us up directly
+    readyqueue_remove(self);
+    self->pend_state = PEND_STATE_NONE;
+    task_state_set_pend(self);
+
+    if (timeout != TOS_TIME_FOREVER) {
+        tick_list_add(self, timeout);
+    }
+
+    TOS_CPU_INT_ENABLE();
+    knl_sched();
+
+    // timeout, or suspended
+    TOS_CPU_INT_DISABLE();
+    self->notify_expect = 0u;
+    TOS_CPU_INT_ENABLE();
+
+    return pend_state2errno(self->pend_state);
+}
+
+__API__ uint32_t tos_task_notify_clear(uint32_t bits)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t notify;
+
+    TOS_CPU_INT_DISABLE();
+
+    notify = k_curr_task->notify;
+    k_curr_task->notify &= ~bits;
+
+    TOS_CPU_INT_ENABLE();
+
+    return notify;
+}
+
+__API__ uint32_t tos_task_notify_get(k_task_t *task)
+{
+    if (!task) {
+        task = k_curr_task;
+    }
+    return task->notify;
+}
+
+#endif
+
 __API__ k_task_t *tos_task_curr_task_get(void)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -607,3 +1075,120 @@ __API__ k_err_t tos_task_stack_draught_depth(k_task_t *task, int *depth)
 
 #endif
 
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+
+/* the runtime of the task, including the time since it was switched in if it is running */
+__STATIC__ uint64_t task_runtime_get(k_task_t *task)
+{
+    if (knl_is_self(task)) {
+        return task->runtime + (cpu_task_runtime_get(task) - task->runtime_stamp);
+    }
+    return task->runtime;
+}
+
+/**
+ * called right before the context switch from "from" to "to"(from is K_NULL when the kernel starts)
+ */
+__KNL__ void task_runtime_switch(k_task_t *from, k_task_t *to)
+{
+    uint64_t now, delta;
+
+    // a task destroying itself has already been reset, nothing to account
+    if (from && from->state != K_TASK_STATE_DELETED) {
+        now     = cpu_task_runtime_get(from);
+        delta   = now - from->runtime_stamp;
+
+        from->runtime       += delta;
+        /* the switch may be decided again before it really happens(a pending context switch),
+           restamp so that the same time is never counted twice.
+         */
+        from->runtime_stamp = now;
+        k_runtime_total     += delta;
+
+        if (task_state_is_ready(from)) {
+            ++from->preempt_cnt;
+        }
+    }
+
+    to->runtime_stamp = cpu_task_runtime_get(to);
+    to->last_run = k_tick_count;
+    ++to->switch_cnt;
+}
+
+/**
+ * called every tick, refresh the system load every TOS_CFG_TASK_RUNTIME_LOAD_WINDOW ticks
+ */
+__KNL__ void task_runtime_load_update(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    static k_tick_t window_tick = (k_tick_t)0u;
+    static uint64_t last_total = 0u, last_idle = 0u;
+    uint64_t total, idle;
+    uint32_t load;
+
+    if (++window_tick < (k_tick_t)TOS_CFG_TASK_RUNTIME_LOAD_WINDOW) {
+        return;
+    }
+    window_tick = (k_tick_t)0u;
+
+    TOS_CPU_INT_DISABLE();
+
+    total = k_runtime_total;
+    if (k_curr_task) {
+        total += cpu_task_runtime_get(k_curr_task) - k_curr_task->runtime_stamp;
+    }
+    idle = task_runtime_get(&k_idle_task);
+
+    if (total > last_total && idle >= last_idle) {
+        if (idle - last_idle >= total - last_total) {
+            load = 0u;
+        } else {
+            load = 1000u - (uint32_t)((idle - last_idle) * 1000u / (total - last_total));
+        }
+
+        // rolling average, the latest window weighs a half
+        k_knl_load = (k_knl_load + load) / 2u;
+    }
+
+    last_total  = total;
+    last_idle   = idle;
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__API__ size_t tos_task_runtime_snapshot(k_task_runtime_t *snapshot, size_t cnt)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_task_t *task;
+    size_t i = 0;
+
+    if (!snapshot) {
+        return 0;
+    }
+
+    TOS_CPU_INT_DISABLE();
+
+    TOS_LIST_FOR_EACH_ENTRY(task, k_task_t, stat_list, &k_stat_list) {
+        if (i == cnt) {
+            break;
+        }
+
+        snapshot[i].task        = task;
+        snapshot[i].runtime     = task_runtime_get(task);
+        snapshot[i].switch_cnt  = task->switch_cnt;
+        snapshot[i].preempt_cnt = task->preempt_cnt;
+        snapshot[i].last_run    = task->last_run;
+        ++i;
+    }
+
+    TOS_CPU_INT_ENABLE();
+
+    return i;
+}
+
+__API__ uint32_t tos_task_load_get(void)
+{
+    return k_knl_load;
+}
+
+#endif
@@ -17,6 +17,132 @@
 
 #include "tos_k.h"
 
+#if TOS_CFG_TICK_WHEEL_EN > 0u
+
+/*
+ * hashed timing wheel: a task sleeping until tick "expires" is hooked to slot
+ * (expires & K_TICK_WHEEL_SLOT_MASK), so placing and taking off a task is O(1).
+ * every tick only the slot the wheel just turned to needs to be visited, tasks
+ * in that slot which belong to a later round of the wheel are simply skipped.
+ */
+
+__STATIC_INLINE__ k_list_t *tick_wheel_slot_get(k_tick_t expires)
+{
+    return &k_tick_wheel.slot[expires & K_TICK_WHEEL_SLOT_MASK];
+}
+
+__STATIC__ void tick_task_place(k_task_t *task, k_tick_t timeout)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+
+    if (timeout <= K_TIME_MAX - k_tick_wheel.now) {
+        task->tick_expires = k_tick_wheel.now + timeout;
+    } else {
+        task->tick_expires = K_TIME_MAX;
+    }
+    tos_list_add_tail(&task->tick_list, tick_wheel_slot_get(task->tick_expires));
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void tick_task_takeoff(k_task_t *task)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+
+    tos_list_del(&task->tick_list);
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void tick_wheel_slot_expire(k_list_t *slot)
+{
+    k_task_t *task, *tmp;
+
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(task, tmp, k_task_t, tick_list, slot) {
+        if (task->tick_expires > k_tick_wheel.now) {
+            // not this round
+            continue;
+        }
+
+        // we are pending for something, but tick's up, no longer waitting
+        pend_task_wakeup(task, PEND_STATE_TIMEOUT);
+    }
+}
+
+__KNL__ void tick_wheel_init(void)
+{
+    uint32_t i;
+
+    k_tick_wheel.now = (k_tick_t)0u;
+
+    for (i = 0; i < K_TICK_WHEEL_SLOT_NUM; ++i) {
+        tos_list_init(&k_tick_wheel.slot[i]);
+    }
+}
+
+__KNL__ void tick_update(k_tick_t tick)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t i;
+
+    TOS_CPU_INT_DISABLE();
+    k_tick_count += tick;
+
+    if (tick >= (k_tick_t)K_TICK_WHEEL_SLOT_NUM) {
+        // the wheel turns a full round(or even more), every slot may expire
+        k_tick_wheel.now += tick;
+
+        for (i = 0; i < K_TICK_WHEEL_SLOT_NUM; ++i) {
+            tick_wheel_slot_expire(&k_tick_wheel.slot[i]);
+        }
+    } else {
+        while (tick--) {
+            ++k_tick_wheel.now;
+            tick_wheel_slot_expire(tick_wheel_slot_get(k_tick_wheel.now));
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__KNL__ k_tick_t tick_next_expires_get(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_tick_t next_expires = TOS_TIME_FOREVER, remain, distance;
+    k_list_t *slot;
+    k_task_t *task;
+
+    TOS_CPU_INT_DISABLE();
+
+    /* a task in the slot "distance" ahead of us expires at least "distance" ticks later,
+       so once we hold something no later than the distance, the rest of the wheel is useless.
+     */
+    for (distance = 1u; distance <= K_TICK_WHEEL_SLOT_NUM && next_expires > distance; ++distance) {
+        slot = tick_wheel_slot_get(k_tick_wheel.now + distance);
+
+        TOS_LIST_FOR_EACH_ENTRY(task, k_task_t, tick_list, slot) {
+            if (task->tick_expires <= k_tick_wheel.now) {
+                remain = (k_tick_t)0u;
+            } else {
+                remain = task->tick_expires - k_tick_wheel.now;
+            }
+
+            if (remain < next_expires) {
+                next_expires = remain;
+            }
+        }
+    }
+
+    TOS_CPU_INT_ENABLE();
+    return next_expires;
+}
+
+#else /* TOS_CFG_TICK_WHEEL_EN */
+
 __STATIC__ void tick_task_place(k_task_t *task, k_tick_t timeout)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -69,18 +195,6 @@ __STATIC__ void tick_task_takeoff(k_task_t *task)
     TOS_CPU_INT_ENABLE();
 }
 
-__KNL__ void tick_list_add(k_task_t *task, k_tick_t timeout)
-{
-    tick_task_place(task, timeout);
-    task_state_set_sleeping(task);
-}
-
-__KNL__ void tick_list_remove(k_task_t *task)
-{
-    tick_task_takeoff(task);
-    task_state_reset_sleeping(task);
-}
-
 __KNL__ void tick_update(k_tick_t tick)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -130,14 +244,47 @@ __KNL__ k_tick_t tick_next_expires_get(void)
     return next_expires;
 }
 
+#endif /* TOS_CFG_TICK_WHEEL_EN */
+
+__KNL__ void tick_list_add(k_task_t *task, k_tick_t timeout)
+{
+    tick_task_place(task, timeout);
+    task_state_set_sleeping(task);
+}
+
+__KNL__ void tick_list_remove(k_task_t *task)
+{
+#if TOS_CFG_HRTIMER_EN > 0u
+    if (hrtimer_task_is_sleeping(task)) {
+        // we are sleeping on our own hrtimer, not in the tick list
+        hrtimer_task_takeoff(task);
+        task_state_reset_sleeping(task);
+        return;
+    }
+#endif
+
+    tick_task_takeoff(task);
+    task_state_reset_sleeping(task);
+}
+
 __API__ void tos_tick_handler(void)
 {
     if (unlikely(!tos_knl_is_running())) {
         return;
     }
 
+    TOS_TRACE(K_TRACE_EVENT_TICK, K_NULL, k_tick_count + 1u, 0u);
+
     tick_update((k_tick_t)1u);
 
+#if TOS_CFG_EDF_EN > 0u
+    edf_tick();
+#endif
+
+#if TOS_CFG_TASK_RUNTIME_EN > 0u
+    task_runtime_load_update();
+#endif
+
 #if TOS_CFG_TIMER_EN > 0u && TOS_CFG_TIMER_AS_PROC > 0u
     soft_timer_update();
 #endif
@@ -19,6 +19,225 @@
 
 #if TOS_CFG_TIMER_EN > 0u
 
+/**
+ * a timer with slack is allowed to expire anywhere in [expires, expires + slack],
+ * choose a tick in the window so that timers nearby are batched into one wakeup.
+ */
+__STATIC__ k_tick_t timer_slack_apply(k_timer_t *tmr)
+{
+    k_tick_t expires, expires_limit, mask;
+
+    expires = tmr->expires;
+    if (tmr->slack == (k_tick_t)0u) {
+        return expires;
+    }
+
+    if (tmr->slack <= K_TIME_MAX - expires) {
+        expires_limit = expires + tmr->slack;
+    } else {
+        expires_limit = K_TIME_MAX;
+    }
+
+    // someone is going to be waken up inside our window anyway, go with him
+    if (k_timer_ctl.next_expires >= expires &&
+        k_timer_ctl.next_expires <= expires_limit) {
+        return k_timer_ctl.next_expires;
+    }
+
+    /* otherwise round the expires up, clear all the bits lower than the highest bit
+       where expires and expires_limit differ, timers with nearby windows will meet on the same tick.
+     */
+    mask = expires ^ expires_limit;
+    while (mask & (mask - 1u)) {
+        mask &= mask - 1u;
+    }
+
+    return expires_limit & ~(mask - 1u);
+}
+
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+
+/*
+ * hashed timing wheel: a running timer expiring at tick "expires" is hooked to slot
+ * (expires & K_TIMER_WHEEL_SLOT_MASK), so starting or stopping a timer is O(1).
+ * k_timer_ctl.now is the last tick the wheel has been turned to, and k_timer_ctl.next_expires
+ * is only a hint here: it is never later than the first expiring timer, but maybe earlier.
+ */
+
+__STATIC_INLINE__ k_list_t *timer_wheel_slot_get(k_tick_t expires)
+{
+    return &k_timer_ctl.slot[expires & K_TIMER_WHEEL_SLOT_MASK];
+}
+
+__STATIC__ void timer_place(k_timer_t *tmr)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+
+    tmr->expires += k_tick_count;
+    tmr->expires = timer_slack_apply(tmr);
+
+    if (tmr->expires <= k_timer_ctl.now) {
+        // the wheel has passed that slot already, we would be a whole revolution late
+        tmr->expires = k_timer_ctl.now + 1u;
+    }
+
+    tos_list_add_tail(&tmr->list, timer_wheel_slot_get(tmr->expires));
+
+    if (tmr->expires < k_timer_ctl.next_expires) {
+        // we may be the first guy now
+        k_timer_ctl.next_expires = tmr->expires;
+
+#if TOS_CFG_TIMER_AS_PROC == 0u
+        if (task_state_is_sleeping(&k_timer_task)) {
+            tos_task_delay_abort(&k_timer_task);
+        }
+#endif
+    }
+
+#if TOS_CFG_TIMER_AS_PROC == 0u
+    if (task_state_is_suspended(&k_timer_task)) {
+        tos_task_resume(&k_timer_task);
+    }
+#endif
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void timer_takeoff(k_timer_t *tmr)
+{
+    TOS_CPU_CPSR_ALLOC();
+
+    TOS_CPU_INT_DISABLE();
+
+    // k_timer_ctl.next_expires is allowed to be earlier than the real one, leave it alone
+    tos_list_del(&tmr->list);
+
+    TOS_CPU_INT_ENABLE();
+}
+
+__STATIC__ void timer_wheel_slot_collect(k_list_t *slot, k_list_t *expired)
+{
+    k_timer_t *tmr, *tmp;
+
+    TOS_LIST_FOR_EACH_ENTRY_SAFE(tmr, tmp, k_timer_t, list, slot) {
+        if (tmr->expires > k_tick_count) {
+            // not this round
+            continue;
+        }
+
+        tos_list_move_tail(&tmr->list, expired);
+    }
+}
+
+/**
+ * search the wheel for the first timer to expire, and make k_timer_ctl.next_expires the real one.
+ * return the ticks left before it expires(TOS_TIME_FOREVER if no timer is running).
+ * called with the interrupt disabled.
+ */
+__STATIC__ k_tick_t timer_wheel_next_expires_refresh(void)
+{
+    k_tick_t next_expires = TOS_TIME_FOREVER, remain, distance;
+    k_list_t *slot;
+    k_timer_t *tmr;
+
+    if (k_timer_ctl.next_expires == TOS_TIME_FOREVER) {
+        // the hint is never later than the real one, so there is no timer running at all
+        return TOS_TIME_FOREVER;
+    }
+
+    /* a timer in the slot "distance" ahead of k_timer_ctl.now expires no earlier than
+       (k_timer_ctl.now + distance), once we hold something no later than that, stop searching.
+     */
+    for (distance = 1u; distance <= K_TIMER_WHEEL_SLOT_NUM; ++distance) {
+        if (next_expires != TOS_TIME_FOREVER &&
+            k_timer_ctl.now + distance >= k_tick_count + next_expires) {
+            break;
+        }
+
+        slot = timer_wheel_slot_get(k_timer_ctl.now + distance);
+
+        TOS_LIST_FOR_EACH_ENTRY(tmr, k_timer_t, list, slot) {
+            if (tmr->expires <= k_tick_count) {
+                remain = (k_tick_t)0u;
+            } else {
+                remain = tmr->expires - k_tick_count;
+            }
+
+            if (remain < next_expires) {
+                next_expires = remain;
+            }
+        }
+    }
+
+    if (next_expires == TOS_TIME_FOREVER) {
+        k_timer_ctl.next_expires = TOS_TIME_FOREVER;
+    } else {
+        k_timer_ctl.next_expires = k_tick_count + next_expires;
+    }
+
+    return next_expires;
+}
+
+/**
+ * turn the wheel to k_tick_count, and fire all the timers expired.
+ * the expired timers are moved to a private list before any callback is called,
+ * so a callback is free to start/stop any timer, including the ones expiring together with it.
+ */
+__STATIC__ void timer_wheel_update(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    TOS_LIST_DEFINE(expired);
+    k_timer_t *tmr;
+    uint32_t i;
+
+    TOS_CPU_INT_DISABLE();
+
+    if (k_tick_count < k_timer_ctl.now) {
+        // someone turned the systick back(tos_systick_set), follow him
+        k_timer_ctl.now = k_tick_count;
+    }
+
+    if (k_tick_count - k_timer_ctl.now >= (k_tick_t)K_TIMER_WHEEL_SLOT_NUM) {
+        for (i = 0; i < K_TIMER_WHEEL_SLOT_NUM; ++i) {
+            timer_wheel_slot_collect(&k_timer_ctl.slot[i], &expired);
+        }
+    } else {
+        while (k_timer_ctl.now != k_tick_count) {
+            ++k_timer_ctl.now;
+            timer_wheel_slot_collect(timer_wheel_slot_get(k_timer_ctl.now), &expired);
+        }
+    }
+    k_timer_ctl.now = k_tick_count;
+
+    while (!tos_list_empty(&expired)) {
+        tmr = TOS_LIST_FIRST_ENTRY(&expired, k_timer_t, list);
+
+        // time's up
+        tos_list_del(&tmr->list);
+
+        if (tmr->opt == TOS_OPT_TIMER_PERIODIC) {
+            tmr->expires = tmr->period;
+            timer_place(tmr);
+        } else {
+            tmr->state = TIMER_STATE_COMPLETED;
+        }
+
+        TOS_CPU_INT_ENABLE();
+        TOS_TRACE(K_TRACE_EVENT_TIMER_FIRE, tmr, tmr->cb, 0u);
+        (*tmr->cb)(tmr->cb_arg);
+        TOS_CPU_INT_DISABLE();
+    }
+
+    // the hint is the expires of the timers just fired, bring it forward or every tick would turn the wheel
+    timer_wheel_next_expires_refresh();
+
+    TOS_CPU_INT_ENABLE();
+}
+
+#else /* TOS_CFG_TIMER_WHEEL_EN */
+
 __STATIC__ void timer_place(k_timer_t *tmr)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -27,6 +246,7 @@ __STATIC__ void timer_place(k_timer_t *tmr)
     TOS_CPU_INT_DISABLE();
 
     tmr->expires += k_tick_count;
+    tmr->expires = timer_slack_apply(tmr);
 
     TOS_LIST_FOR_EACH_ENTRY(iter, k_timer_t, list, &k_timer_ctl.list) {
         if (tmr->expires < iter->expires) {
@@ -80,12 +300,15 @@ __STATIC__ void timer_takeoff(k_timer_t *tmr)
     TOS_CPU_INT_ENABLE();
 }
 
+#endif /* TOS_CFG_TIMER_WHEEL_EN */
+
 __STATIC_INLINE__ void timer_reset(k_timer_t *tmr)
 {
     tmr->state          = TIMER_STATE_UNUSED;
     tmr->delay          = (k_tick_t)0u;
     tmr->expires        = (k_tick_t)0u;
     tmr->period         = (k_tick_t)0u;
+    tmr->slack          = (k_tick_t)0u;
     tmr->opt            = (k_opt_t)0u;
     tmr->cb             = K_NULL;
     tmr->cb_arg         = K_NULL;
@@ -129,6 +352,7 @@ __API__ k_err_t tos_timer_create(k_timer_t *tmr,
     tmr->delay          = delay;
     tmr->expires        = (k_tick_t)0u;
     tmr->period         = period;
+    tmr->slack          = (k_tick_t)0u;
     tmr->opt            = opt;
     tmr->cb             = callback;
     tmr->cb_arg         = cb_arg;
@@ -143,6 +367,30 @@ __API__ k_err_t tos_timer_create(k_timer_t *tmr,
     return K_ERR_NONE;
 }
 
+__API__ k_err_t tos_timer_create_slack(k_timer_t *tmr,
+                                            k_tick_t delay,
+                                            k_tick_t period,
+                                            k_tick_t slack,
+                                            k_timer_callback_t callback,
+                                            void *cb_arg,
+                                            k_opt_t opt)
+{
+    k_err_t err;
+
+    if (slack == TOS_TIME_FOREVER) {
+        return K_ERR_TIMER_SLACK_FOREVER;
+    }
+
+    err = tos_timer_create(tmr, delay, period, callback, cb_arg, opt);
+    if (err != K_ERR_NONE) {
+        return err;
+    }
+
+    tmr->slack = slack;
+
+    return K_ERR_NONE;
+}
+
 __API__ k_err_t tos_timer_destroy(k_timer_t *tmr)
 {
     TOS_PTR_SANITY_CHECK(tmr);
@@ -186,14 +434,14 @@ __API__ k_err_t tos_timer_create_dyn(k_timer_t **tmr,
     TOS_PTR_SANITY_CHECK(tmr);
     TOS_PTR_SANITY_CHECK(callback);
 
-    the_timer = tos_mmheap_calloc(1, sizeof(k_timer_t));
+    the_timer = slab_obj_alloc(KNL_OBJ_TYPE_TIMER, sizeof(k_timer_t), K_NULL);
     if (!the_timer) {
         return K_ERR_OUT_OF_MEMORY;
     }
 
     err = tos_timer_create(the_timer, delay, period, callback, cb_arg, opt);
     if (err != K_ERR_NONE) {
-        tos_mmheap_free(the_timer);
+        slab_obj_free(KNL_OBJ_TYPE_TIMER, the_timer);
         return err;
     }
 
@@ -223,7 +471,7 @@ __API__ k_err_t tos_timer_destroy_dyn(k_timer_t *tmr)
 
     timer_reset(tmr);
 
-    tos_mmheap_free(tmr);
+    slab_obj_free(KNL_OBJ_TYPE_TIMER, tmr);
 
     return K_ERR_NONE;
 }
@@ -241,7 +489,11 @@ __API__ k_err_t tos_timer_start(k_timer_t *tmr)
 
     if (tmr->state == TIMER_STATE_RUNNING) {
         timer_takeoff(tmr);
-        tmr->expires = tmr->delay;
+        if (tmr->delay == (k_tick_t)0u) {
+            tmr->expires = tmr->period;
+        } else {
+            tmr->expires = tmr->delay;
+        }
         timer_place(tmr);
         return K_ERR_NONE;
     }
@@ -308,10 +560,17 @@ __STATIC__ k_err_t timer_change(k_timer_t *tmr, k_tick_t new_val, timer_change_t
         return K_ERR_TIMER_INVALID_PERIOD;
     }
 
+    if (change_type == TIMER_CHANGE_TYPE_SLACK &&
+        new_val == TOS_TIME_FOREVER) {
+        return K_ERR_TIMER_SLACK_FOREVER;
+    }
+
     if (change_type == TIMER_CHANGE_TYPE_DELAY) {
         tmr->delay  = new_val;
-    } else {
+    } else if (change_type == TIMER_CHANGE_TYPE_PERIOD) {
         tmr->period = new_val;
+    } else {
+        tmr->slack  = new_val;
     }
 
     return K_ERR_NONE;
@@ -327,6 +586,27 @@ __API__ k_err_t tos_timer_period_change(k_timer_t *tmr, k_tick_t period)
     return timer_change(tmr, period, TIMER_CHANGE_TYPE_PERIOD);
 }
 
+__API__ k_err_t tos_timer_slack_change(k_timer_t *tmr, k_tick_t slack)
+{
+    return timer_change(tmr, slack, TIMER_CHANGE_TYPE_SLACK);
+}
+
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+
+__KNL__ k_tick_t soft_timer_next_expires_get(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    k_tick_t next_expires;
+
+    TOS_CPU_INT_DISABLE();
+    next_expires = timer_wheel_next_expires_refresh();
+    TOS_CPU_INT_ENABLE();
+
+    return next_expires;
+}
+
+#else /* TOS_CFG_TIMER_WHEEL_EN */
+
 __KNL__ k_tick_t soft_timer_next_expires_get(void)
 {
     TOS_CPU_CPSR_ALLOC();
@@ -346,11 +626,15 @@ __KNL__ k_tick_t soft_timer_next_expires_get(void)
     return next_expires;
 }
 
+#endif /* TOS_CFG_TIMER_WHEEL_EN */
+
 #if TOS_CFG_TIMER_AS_PROC > 0u
 
 __KNL__ void soft_timer_update(void)
 {
+#if TOS_CFG_TIMER_WHEEL_EN == 0u
     k_timer_t *tmr, *tmp;
+#endif
 
     if (k_timer_ctl.next_expires > k_tick_count) { // not yet
         return;
@@ -358,6 +642,10 @@ __KNL__ void soft_timer_update(void)
 
     tos_knl_sched_lock();
 
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+    timer_wheel_update();
+#else
+
     TOS_LIST_FOR_EACH_ENTRY_SAFE(tmr, tmp, k_timer_t, list, &k_timer_ctl.list) {
         if (tmr->expires > k_tick_count) {
             break;
@@ -373,8 +661,10 @@ __KNL__ void soft_timer_update(void)
             tmr->state = TIMER_STATE_COMPLETED;
         }
 
+        TOS_TRACE(K_TRACE_EVENT_TIMER_FIRE, tmr, tmr->cb, 0u);
         (*tmr->cb)(tmr->cb_arg);
     }
+#endif
 
     tos_knl_sched_unlock();
 }
@@ -383,7 +673,9 @@ __KNL__ void soft_timer_update(void)
 
 __STATIC__ void timer_task_entry(void *arg)
 {
+#if TOS_CFG_TIMER_WHEEL_EN == 0u
     k_timer_t *tmr, *tmp;
+#endif
     k_tick_t next_expires;
 
     arg = arg; // make compiler happy
@@ -397,6 +689,9 @@ __STATIC__ void timer_task_entry(void *arg)
 
         tos_knl_sched_lock();
 
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+        timer_wheel_update();
+#else
         TOS_LIST_FOR_EACH_ENTRY_SAFE(tmr, tmp, k_timer_t, list, &k_timer_ctl.list) {
             if (tmr->expires > k_tick_count) { // not yet
                 break;
@@ -412,8 +707,10 @@ __STATIC__ void timer_task_entry(void *arg)
                 tmr->state = TIMER_STATE_COMPLETED;
             }
 
+            TOS_TRACE(K_TRACE_EVENT_TIMER_FIRE, tmr, tmr->cb, 0u);
             (*tmr->cb)(tmr->cb_arg);
         }
+#endif
 
         tos_knl_sched_unlock();
     }
@@ -423,6 +720,16 @@ __STATIC__ void timer_task_entry(void *arg)
 
 __KNL__ k_err_t soft_timer_init(void)
 {
+#if TOS_CFG_TIMER_WHEEL_EN > 0u
+    uint32_t i;
+
+    k_timer_ctl.now = k_tick_count;
+
+    for (i = 0; i < K_TIMER_WHEEL_SLOT_NUM; ++i) {
+        tos_list_init(&k_timer_ctl.slot[i]);
+    }
+#endif
+
 #if TOS_CFG_TIMER_AS_PROC > 0u
     return K_ERR_NONE;
 #else
@@ -0,0 +1,147 @@
+/*----------------------------------------------------------------------------
+ * Tencent is pleased to support the open source community by making TencentOS
+ * available.
+ *
+ * Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+ * If you have downloaded a copy of the TencentOS binary from Tencent, please
+ * note that the TencentOS binary is licensed under the BSD 3-Clause License.
+ *
+ * If you have downloaded a copy of the TencentOS source code from Tencent,
+ * please note that TencentOS source code is licensed under the BSD 3-Clause
+ * License, except for the third-party components listed below which are
+ * subject to different license terms. Your integration of TencentOS into your
+ * own projects may require compliance with the BSD 3-Clause License, as well
+ * as the other licenses applicable to the third-party components included
+ * within TencentOS.
+ *---------------------------------------------------------------------------*/
+
+#include "tos_k.h"
+
+#if TOS_CFG_TRACE_EN > 0u
+
+/*
+ * lock-free trace ring buffer: a writer claims a slot by an atomic increment of the head,
+ * so an event recorded from an interrupt in the middle of another one just takes the
+ * next slot, no critical section needed.
+ * every slot works like a seqlock: seq has the K_TRACE_SEQ_BUSY bit set while the slot is being
+ * written, and is K_TRACE_SEQ_DONE(sequence number of the event) when done, a reader validates it
+ * before and after copying the slot. the head wraps, the reader counts back from it unsigned.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+#define TRACE_HEAD_CLAIM()              __atomic_fetch_add(&k_trace.head, 1u, __ATOMIC_RELAXED)
+#define TRACE_HEAD_LOAD()               __atomic_load_n(&k_trace.head, __ATOMIC_ACQUIRE)
+#define TRACE_SEQ_STORE(event, the_seq) __atomic_store_n(&(event)->seq, (the_seq), __ATOMIC_RELEASE)
+#define TRACE_SEQ_LOAD(event)           __atomic_load_n(&(event)->seq, __ATOMIC_ACQUIRE)
+#define TRACE_WRITE_FENCE()             __atomic_thread_fence(__ATOMIC_RELEASE)
+#define TRACE_READ_FENCE()              __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+#else
+
+/* no atomic builtin, fall back to a critical section to claim the slot */
+__STATIC__ uint32_t trace_head_claim(void)
+{
+    TOS_CPU_CPSR_ALLOC();
+    uint32_t head;
+
+    TOS_CPU_INT_DISABLE();
+    head = k_trace.head++;
+    TOS_CPU_INT_ENABLE();
+
+    return head;
+}
+
+#define TRACE_HEAD_CLAIM()              trace_head_claim()
+#define TRACE_HEAD_LOAD()               (*(volatile uint32_t *)&k_trace.head)
+#define TRACE_SEQ_STORE(event, the_seq) ((*(volatile uint32_t *)&(event)->seq) = (the_seq))
+#define TRACE_SEQ_LOAD(event)           (*(volatile uint32_t *)&(event)->seq)
+#define TRACE_WRITE_FENCE()
+#define TRACE_READ_FENCE()
+
+#endif
+
+__KNL__ void trace_init(void)
+{
+    uint32_t i;
+
+    k_trace.head = 0u;
+
+    for (i = 0; i < K_TRACE_EVENT_NUM; ++i) {
+        k_trace.event[i].seq = K_TRACE_SEQ_BUSY;
+    }
+}
+
+__KNL__ void trace_event_record(uint16_t type, uint64_t obj, uint64_t arg, uint16_t info)
+{
+    uint32_t seq;
+    k_trace_event_t *event;
+
+    seq     = TRACE_HEAD_CLAIM();
+    event   = &k_trace.event[seq & K_TRACE_EVENT_MASK];
+
+    TRACE_SEQ_STORE(event, K_TRACE_SEQ_DONE(seq) | K_TRACE_SEQ_BUSY);
+    TRACE_WRITE_FENCE();
+
+    event->timestamp    = cpu_trace_clock_get();
+    event->type         = type;
+    event->info         = info;
+    event->obj          = obj;
+    event->arg          = arg;
+
+    TRACE_SEQ_STORE(event, K_TRACE_SEQ_DONE(seq));
+}
+
+__KNL__ void trace_task_create(k_task_t *task)
+{
+    uint64_t name = 0u;
+    uint8_t i;
+
+    // pack the first 8 chars of the name(little endian), so that a raw dump still tells who is who
+    for (i = 0; i < sizeof(uint64_t) && task->name[i]; ++i) {
+        name |= (uint64_t)(uint8_t)task->name[i] << (i * 8u);
+    }
+
+    trace_event_record(K_TRACE_EVENT_TASK_CREATE, (uint64_t)(cpu_addr_t)task, name, 0u);
+}
+
+__API__ size_t tos_trace_read(k_trace_event_t *event, size_t cnt)
+{
+    uint32_t head, seq;
+    k_trace_event_t *slot;
+    size_t i = 0;
+
+    if (!event) {
+        return 0;
+    }
+
+    head = TRACE_HEAD_LOAD();
+
+    /* the last K_TRACE_EVENT_NUM sequence numbers, counted back unsigned so the wrap of the head does
+       not matter. before the first lap the ones below 0 have never been written, their slots are
+       still busy or hold a smaller sequence number, the check below skips them.
+     */
+    for (seq = head - K_TRACE_EVENT_NUM; seq != head && i < cnt; ++seq) {
+        slot = &k_trace.event[seq & K_TRACE_EVENT_MASK];
+
+        if (TRACE_SEQ_LOAD(slot) != K_TRACE_SEQ_DONE(seq)) {
+            // being written, or already overwritten by a newer one
+            continue;
+        }
+
+        event[i] = *slot;
+        TRACE_READ_FENCE();
+
+        if (TRACE_SEQ_LOAD(slot) != K_TRACE_SEQ_DONE(seq)) {
+            continue;
+        }
+
+        event[i].seq = seq;
+        ++i;
+    }
+
+    return i;
+}
+
+#endif
+
@@ -374,6 +374,80 @@ uint32_t osThreadEnumerate(osThreadId_t* thread_array, uint32_t array_items) {
   return count;
 }
 
+#if TOS_CFG_TASK_NOTIFY_EN > 0u
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
+  k_task_t* taskId = (k_task_t*)thread_id;
+  k_err_t err;
+  uint32_t rflags;
+
+  if (taskId == NULL || (flags & osFlagsError)) {
+    rflags = osFlagsErrorParameter;
+  } else {
+    err = tos_task_notify(taskId, flags);
+    rflags = err == K_ERR_NONE ? tos_task_notify_get(taskId)
+                               : (uint32_t)errno_knl2cmsis(err);
+  }
+
+  return rflags;
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags) {
+  uint32_t rflags;
+
+  if (knl_is_inirq()) {
+    rflags = osFlagsErrorISR;
+  } else if (flags & osFlagsError) {
+    rflags = osFlagsErrorParameter;
+  } else {
+    rflags = tos_task_notify_clear(flags);
+  }
+
+  return rflags;
+}
+
+uint32_t osThreadFlagsGet(void) {
+  uint32_t rflags;
+
+  if (knl_is_inirq()) {
+    rflags = 0U;
+  } else {
+    rflags = tos_task_notify_get(K_NULL);
+  }
+
+  return rflags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout) {
+  k_err_t err;
+  k_opt_t opt = 0;
+  uint32_t rflags;
+
+  if (knl_is_inirq()) {
+    return osFlagsErrorISR;
+  }
+  if (flags & osFlagsError) {
+    return osFlagsErrorParameter;
+  }
+
+  opt |= (options & osFlagsWaitAll) ? TOS_OPT_TASK_NOTIFY_WAIT_ALL : TOS_OPT_TASK_NOTIFY_WAIT_ANY;
+  if (!(options & osFlagsNoClear)) {
+    opt |= TOS_OPT_TASK_NOTIFY_WAIT_CLR;
+  }
+
+  err = tos_task_notify_wait(flags, &rflags,
+                             timeout == osWaitForever ? TOS_TIME_FOREVER : (k_tick_t)timeout, opt);
+  if (err == K_ERR_PEND_NOWAIT) {
+    rflags = osFlagsErrorResource;
+  } else if (err != K_ERR_NONE) {
+    rflags = (uint32_t)errno_knl2cmsis(err);
+  }
+
+  return rflags;
+}
+
+#else
+
 uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
   uint32_t rflags = 0xFFFFFFFF;
   // todo
@@ -398,6 +472,8 @@ uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout) {
   return rflags;
 }
 
+#endif
+
 osStatus_t osDelay(uint32_t ticks) {
   k_tick_t delay;
 